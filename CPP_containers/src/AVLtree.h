@@ -1,24 +1,114 @@
 #ifndef S21_SRC_AVLTREE_H
 #define S21_SRC_AVLTREE_H
 
+#include <algorithm>
 #include <functional>
+#include <future>
 #include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace s21 {
 
-template <typename Key, typename Value, typename Comparator = std::less<Key>>
+// Allocators with a release() member can free every object they handed out
+// at once, which lets a tree drop trivially destructible nodes without
+// visiting them.
+template <typename Alloc, typename = void>
+struct has_bulk_release : std::false_type {};
+
+template <typename Alloc>
+struct has_bulk_release<Alloc,
+                        std::void_t<decltype(std::declval<Alloc&>().release())>>
+    : std::true_type {};
+
+// Enables the heterogeneous lookup overloads for a lookup type K when the
+// comparator declares is_transparent, as std::less<> does.
+template <typename Comparator, typename K, typename = void>
+struct transparent_key {};
+
+template <typename Comparator, typename K>
+struct transparent_key<Comparator, K,
+                       std::void_t<typename Comparator::is_transparent>> {
+  using type = K;
+};
+
+template <typename Comparator, typename K>
+using transparent_key_t = typename transparent_key<Comparator, K>::type;
+
+// The AVL invariant in terms of subtree heights, shared by AVLtree and
+// concurrent_map. Each tree keeps its own node layout, height origin and
+// rotation mechanics; only the arithmetic and the rotation choice live
+// here, so both follow the same rules.
+struct avl_rules {
+  static constexpr int height_above(int left, int right) {
+    return 1 + (left > right ? left : right);
+  }
+  // Positive when the right subtree is the taller one.
+  static constexpr int skew(int left, int right) { return right - left; }
+  static constexpr bool out_of_balance(int left, int right) {
+    return skew(left, right) < -1 || skew(left, right) > 1;
+  }
+  // A node too tall on one side is fixed by lifting its child on that
+  // side. When that child's inner subtree is the taller of its two, a
+  // single rotation would only move the imbalance, so the inner grandchild
+  // is lifted instead.
+  static constexpr bool needs_double_rotation(int outer, int inner) {
+    return inner > outer;
+  }
+};
+
+// Per-node bookkeeping that AVLtree keeps up to date whenever the children
+// of a node change. The augment is a base of every node and update()
+// recomputes it from the two children, either of which may be nullptr, and
+// may read the node's own element by casting this to Node.
+struct no_augment {
+  template <typename Node>
+  void update(const Node*, const Node*) {}
+};
+
+// Subtree sizes, which give the containers nth(), rank() and a logarithmic
+// count().
+struct order_statistics {
+  std::size_t subtree_size = 1;
+
+  template <typename Node>
+  void update(const Node* left, const Node* right) {
+    subtree_size = 1 + (left != nullptr ? left->subtree_size : 0) +
+                   (right != nullptr ? right->subtree_size : 0);
+  }
+};
+
+template <typename Key, typename Value, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, Value>>,
+          typename Augment = no_augment>
 class AVLtree {
  protected:
   struct node;
   struct base_node;
+  using node_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<node>;
+  using node_traits = std::allocator_traits<node_allocator>;
 
  public:
-  using value_type = std::pair<const Key, Value>;
+  // With Value = void a node holds the bare key, which is all set and
+  // multiset need. mapped_type then stands in for Value in the map-only
+  // members, which such a tree never instantiates.
+  using value_type = std::conditional_t<std::is_void_v<Value>, Key,
+                                        std::pair<const Key, Value>>;
+  using mapped_type = std::conditional_t<std::is_void_v<Value>, Key, Value>;
   using value_reference = value_type&;
   using const_reference = const value_type&;
   using value_pointer = value_type*;
   using const_pointer = const value_type*;
   using size_type = size_t;
+  using allocator_type = Allocator;
 
   class iterator {
    public:
@@ -42,8 +132,6 @@ class AVLtree {
 
    protected:
     node* current_node;
-    void move_forward();
-    void move_back();
   };
 
   class const_iterator {
@@ -66,8 +154,41 @@ class AVLtree {
 
    protected:
     const node* current_node;
-    void move_forward();
-    void move_back();
+  };
+
+  // Owns a node extracted from a tree, so it can be inserted into another
+  // tree without reallocating or copying the element. map reads key() and
+  // mapped(), set and multiset read value(), which is their key. Keys stay
+  // read-only because the tree is ordered by them.
+  class node_handle {
+   public:
+    node_handle() = default;
+    node_handle(node_handle&& other) noexcept;
+    node_handle& operator=(node_handle&& other) noexcept;
+    ~node_handle();
+
+    bool empty() const;
+    explicit operator bool() const;
+    allocator_type get_allocator() const;
+    const Key& key() const;
+    mapped_type& mapped() const;
+    const mapped_type& value() const;
+    void swap(node_handle& other) noexcept;
+
+   private:
+    friend AVLtree;
+    node_handle(node* node_ptr, const node_allocator& allocator);
+    void reset();
+
+    node* held_node = nullptr;
+    std::optional<node_allocator> allocator_;
+  };
+
+  template <typename Iterator>
+  struct node_insert_result {
+    Iterator position;
+    bool inserted;
+    node_handle node;
   };
 
   AVLtree();
@@ -78,25 +199,69 @@ class AVLtree {
   AVLtree& operator=(AVLtree&& other);
 
   iterator tree_insert(const_reference data);
+  iterator tree_insert(value_type&& data);
+  template <typename... Args>
+  iterator tree_emplace(Args&&... args);
   std::pair<iterator, bool> tree_unique_insert(const_reference value);
+  std::pair<iterator, bool> tree_unique_insert(value_type&& value);
   std::pair<iterator, bool> tree_unique_insert(const Key& key,
-                                               const Value& obj);
+                                               const mapped_type& obj);
+  template <typename... Args>
+  std::pair<iterator, bool> tree_unique_emplace(Args&&... args);
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> tree_try_emplace(K&& key, Args&&... args);
   std::pair<iterator, bool> tree_insert_or_assign(const Key& key,
-                                                  const Value& obj);
-  Value& at(const Key& key);
-  Value& operator[](const Key& key);
-  void tree_erase(iterator pos);
+                                                  const mapped_type& obj);
+  template <typename K>
+  mapped_type& at(const K& key);
+  mapped_type& operator[](const Key& key);
+  mapped_type& operator[](Key&& key);
+  iterator tree_erase(iterator pos);
+  iterator tree_erase(iterator first, iterator last);
+  size_type tree_erase(const Key& key);
   void tree_clear();
+  template <typename InputIt, typename Maker>
+  void tree_assign(InputIt first, InputIt last, bool unique, Maker make_node);
   void tree_merge(AVLtree& other);
   void tree_merge_unique(AVLtree& other);
+  node_handle tree_extract(iterator pos);
+  node_handle tree_extract(const Key& key);
+  iterator tree_insert(node_handle&& handle);
+  std::pair<iterator, bool> tree_unique_insert(node_handle& handle);
+  void tree_split(const Key& key, AVLtree& greater);
+  void tree_join(AVLtree& greater, bool unique);
+  void tree_set_union(AVLtree& other);
+  void tree_set_intersection(const AVLtree& other);
+  void tree_set_difference(const AVLtree& other);
   void tree_swap(AVLtree& other);
-  iterator tree_find(const Key& key);
-  bool tree_contains(const Key& key) const;
-  size_type tree_count(const Key& key) const;
+  template <typename K>
+  iterator tree_find(const K& key);
+  template <typename K>
+  bool tree_contains(const K& key) const;
+  template <typename It = iterator>
+  std::vector<It> tree_find_many(const Key* keys, size_type count);
+  std::vector<bool> tree_contains_many(const Key* keys,
+                                       size_type count) const;
+  template <typename K>
+  size_type tree_count(const K& key) const;
+  iterator tree_nth(size_type index);
+  const_iterator tree_nth(size_type index) const;
+  size_type tree_rank(const Key& key) const;
   const_iterator tree_lower_bound(const Key& key) const;
   const_iterator tree_upper_bound(const Key& key) const;
   iterator tree_lower_bound(const Key& key);
   iterator tree_upper_bound(const Key& key);
+  template <typename Visit>
+  void tree_for_each_in_range(const Key& lo, const Key& hi, Visit visit);
+  template <typename Visit>
+  void tree_for_each_in_range(const Key& lo, const Key& hi,
+                              Visit visit) const;
+  size_type tree_erase_range(const Key& lo, const Key& hi);
+  template <typename K>
+  std::pair<const_iterator, const_iterator> tree_equal_range(
+      const K& key) const;
+  template <typename K>
+  std::pair<iterator, iterator> tree_equal_range(const K& key);
   size_type tree_size() const;
   size_type tree_max_size() const;
   bool tree_empty() const;
@@ -104,20 +269,28 @@ class AVLtree {
   const_iterator const_tree_begin() const;
   iterator tree_end();
   const_iterator const_tree_end() const;
+  allocator_type get_allocator() const;
 
  protected:
+  // next and prev thread every node onto a circular list in key order that
+  // passes through the header, so the header's next is the first node and
+  // its prev the last. Rotations keep the order and never touch them; only
+  // linking a node in or out and joining pieces do.
   struct base_node {
     node* left;
     node* right;
     node* parent_;
+    node* next;
+    node* prev;
     base_node();
     base_node(node* Left, node* Right, node* Parent);
   };
 
-  struct node : public base_node {
+  struct node : public base_node, public Augment {
     value_type data_;
     int8_t height = 0;
-    node(value_type data, node* parent);
+    template <typename... Args>
+    explicit node(node* parent, Args&&... args);
   };
 
   int8_t get_height(node* node_ptr);
@@ -126,54 +299,138 @@ class AVLtree {
   void rotateright(node*& node_ptr);
   void rotateleft(node*& node_ptr);
   void balance(node*& node_ptr);
-  iterator recursive_insert(node*& root, value_type data);
+  template <typename... Args>
+  node* create_node(node* parent, Args&&... args);
+  void destroy_node(node* node_ptr);
+  static node* reset_node(node* node_ptr, node* parent);
+  node* adopt_node(node_handle& handle, node* parent);
+  iterator insert_node(node* new_node);
+  template <typename Maker>
+  std::pair<iterator, bool> unique_insert(const Key& key, Maker make_node);
+  iterator recursive_insert(node*& root, node* new_node);
+  template <typename Maker>
   std::pair<iterator, bool> unique_recursive_insert(node*& root,
-                                                    value_type data);
-  void recursive_delete(node*& node_ptr, value_type data);
-  std::pair<iterator, node*> recursive_find(node* root, const Key& key) const;
+                                                    const Key& key,
+                                                    Maker& make_node);
+  node*& child_slot(node* node_ptr);
+  void unlink_node(node* target);
+  std::pair<node*, node*> split_before(node* target);
+  void merge_nodes(AVLtree& other, bool unique);
+  template <typename K>
+  node* recursive_find(node* root, const K& key) const;
+  template <typename Visit>
+  void find_batch(const Key* keys, size_type count, Visit visit) const;
+  node* tree_root() const;
+  static const Key& key_of(const value_type& data);
+  template <typename K>
+  node* lower_bound_node(node* node_ptr, node* bound, const K& key) const;
+  template <typename K>
+  node* upper_bound_node(node* node_ptr, node* bound, const K& key) const;
+  template <typename K>
+  std::pair<node*, node*> equal_range_nodes(const K& key) const;
   static node* find_min(node* node_ptr);
   static node* find_max(node* node_ptr);
-  node* remove_min(node* node_ptr);
-  node* copy_tree(node* node_ptr, node* parent);
+  static void link_adjacent(node* lhs, node* rhs);
+  node* copy_tree(node* node_ptr, node* parent, node*& last);
+  node* build_balanced(node** nodes, size_type count, node* parent);
+  void link_sorted(node** nodes, size_type count);
+  std::vector<node*> flatten();
+
+  struct split_parts {
+    node* less;
+    node* equal;
+    node* greater;
+  };
+
+  static constexpr bool counts_subtrees =
+      std::is_base_of_v<order_statistics, Augment>;
+
+  static size_type subtree_size(const node* node_ptr);
+  node* nth_node(size_type index) const;
+  template <typename K>
+  size_type count_before(const K& key, bool inclusive) const;
+
+  // Searches find_batch keeps in flight: enough to cover a cache miss with
+  // the steps of the others.
+  static constexpr size_type batch_width = 16;
+
+  // Subtrees at least this high are worth handing to another thread.
+  static constexpr int8_t parallel_height = 16;
+
+  void set_root(node* new_root, size_type count);
+  static node* next_in_subtree(node* node_ptr);
+  static size_type count_first(node* lhs, node* rhs, size_type total);
+  size_type destroy_counted(node* node_ptr);
+  node* join_nodes(node* less, node* middle, node* greater);
+  node* join_pair(node* less, node* greater);
+  node* join_threaded(node* less, node* middle, node* greater);
+  node* join_pair_threaded(node* less, node* greater);
+  std::pair<node*, node*> split_last(node* node_ptr);
+  split_parts split_nodes(node* node_ptr, const Key& key);
+  static bool worth_forking(const node* lhs, const node* rhs,
+                            unsigned forks);
+  template <typename Less, typename Greater>
+  static std::pair<node*, node*> fork(bool parallel, Less less,
+                                      Greater greater);
+  node* union_nodes(node* lhs, node* rhs, std::vector<node*>& discarded,
+                    unsigned forks);
+  node* intersection_nodes(node* lhs, const node* rhs,
+                           std::vector<node*>& discarded, unsigned forks);
+  node* difference_nodes(node* lhs, const node* rhs,
+                         std::vector<node*>& discarded, unsigned forks);
 
   friend iterator;
   base_node* root;
   size_type size_;
   Comparator tree_comparator;
+  node_allocator allocator_;
 
   void destroy(node* root);
+  void destroy_all();
 };
 
 //----AVLtree-logic-----//
 
-template <typename Key, typename Value, typename Comparator>
-inline AVLtree<Key, Value, Comparator>::AVLtree()
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline AVLtree<Key, Value, Comparator, Allocator, Augment>::AVLtree()
     : root(new base_node), size_(0) {}
 
-template <typename Key, typename Value, typename Comparator>
-AVLtree<Key, Value, Comparator>::AVLtree(const AVLtree& other) : AVLtree() {
-  root->left = copy_tree(other.root->left, nullptr);
-  root->left->parent_ = static_cast<node*>(root);
-  root->parent_ = find_min(root->left);
-  size_ = other.size_;
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::AVLtree(
+    const AVLtree& other)
+    : AVLtree() {
+  allocator_ =
+      node_traits::select_on_container_copy_construction(other.allocator_);
+  tree_comparator = other.tree_comparator;
+  if (other.tree_root() != nullptr) {
+    node* last = static_cast<node*>(root);
+    root->left = copy_tree(other.tree_root(), static_cast<node*>(root), last);
+    link_adjacent(last, static_cast<node*>(root));
+    size_ = other.size_;
+  }
 }
 
-template <typename Key, typename Value, typename Comparator>
-AVLtree<Key, Value, Comparator>::AVLtree(AVLtree&& other) : AVLtree() {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::AVLtree(AVLtree&& other)
+    : AVLtree() {
   tree_swap(other);
 }
 
-template <typename Key, typename Value, typename Comparator>
-AVLtree<Key, Value, Comparator>::~AVLtree() {
-  if (root->left != root) {
-    destroy(root->left);
-  }
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::~AVLtree() {
+  destroy_all();
   delete root;
   root = nullptr;
 }
 
-template <typename Key, typename Value, typename Comparator>
-AVLtree<Key, Value, Comparator>& AVLtree<Key, Value, Comparator>::operator=(
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator, Augment>&
+AVLtree<Key, Value, Comparator, Allocator, Augment>::operator=(
     const AVLtree& other) {
   if (this != &other) {
     if (other.tree_size() > 0) {
@@ -187,8 +444,10 @@ AVLtree<Key, Value, Comparator>& AVLtree<Key, Value, Comparator>::operator=(
   return *this;
 }
 
-template <typename Key, typename Value, typename Comparator>
-AVLtree<Key, Value, Comparator>& AVLtree<Key, Value, Comparator>::operator=(
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator, Augment>&
+AVLtree<Key, Value, Comparator, Allocator, Augment>::operator=(
     AVLtree&& other) {
   if (this != &other) {
     tree_clear();
@@ -197,119 +456,187 @@ AVLtree<Key, Value, Comparator>& AVLtree<Key, Value, Comparator>::operator=(
   return *this;
 }
 
-template <typename Key, typename Value, typename Comparator>
-inline void AVLtree<Key, Value, Comparator>::tree_swap(AVLtree& other) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline void AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_swap(
+    AVLtree& other) {
   std::swap(root, other.root);
   std::swap(size_, other.size_);
   std::swap(tree_comparator, other.tree_comparator);
+  std::swap(allocator_, other.allocator_);
 }
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::destroy(node* root) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::destroy(node* root) {
   if (root == nullptr) {
     return;
   }
   destroy(root->left);
   destroy(root->right);
-  delete root;
+  destroy_node(root);
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::iterator
-AVLtree<Key, Value, Comparator>::tree_begin() {
-  return iterator(root->parent_);
-}
-
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::const_iterator
-AVLtree<Key, Value, Comparator>::const_tree_begin() const {
-  return const_iterator(root->parent_);
+// With a bulk-releasing allocator and trivially destructible payloads no
+// destructor has to run, so the whole tree goes back in O(number of slabs).
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::destroy_all() {
+  if constexpr (has_bulk_release<node_allocator>::value &&
+                std::is_trivially_destructible_v<node>) {
+    allocator_.release();
+  } else {
+    destroy(tree_root());
+  }
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::iterator
-AVLtree<Key, Value, Comparator>::tree_end() {
-  return iterator(static_cast<node*>(root));
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_begin() {
+  return iterator(root->next);
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::const_iterator
-AVLtree<Key, Value, Comparator>::const_tree_end() const {
-  return const_iterator(static_cast<node*>(root));
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::const_tree_begin() const {
+  return const_iterator(root->next);
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::iterator
-AVLtree<Key, Value, Comparator>::tree_insert(const_reference data) {
-  iterator result;
-  if (root->left == static_cast<node*>(root)) {
-    root->left = new node(data, nullptr);
-    root->left->parent_ = static_cast<node*>(root);
-    root->parent_ = root->left;
-    result = root->left;
-  } else {
-    result = recursive_insert(root->left, data);
-    root->parent_ = find_min(root->left);
-  }
-  ++size_;
-  return result;
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_end() {
+  return iterator(static_cast<node*>(root));
 }
 
-template <typename Key, typename Value, typename Comparator>
-std::pair<typename AVLtree<Key, Value, Comparator>::iterator, bool>
-AVLtree<Key, Value, Comparator>::tree_unique_insert(const_reference value) {
-  std::pair<iterator, bool> result;
-  if (root->left == static_cast<node*>(root)) {
-    root->left = new node(value, nullptr);
-    root->left->parent_ = static_cast<node*>(root);
-    root->parent_ = root->left;
-    result.first = root->left;
-    result.second = true;
-  } else {
-    result = unique_recursive_insert(root->left, value);
-    root->parent_ = find_min(root->left);
-  }
-  if (result.second) {
-    ++size_;
-  }
-  return result;
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::const_tree_end() const {
+  return const_iterator(static_cast<node*>(root));
 }
 
-template <typename Key, typename Value, typename Comparator>
-std::pair<typename AVLtree<Key, Value, Comparator>::iterator, bool>
-AVLtree<Key, Value, Comparator>::tree_unique_insert(const Key& key,
-                                                    const Value& obj) {
-  std::pair<iterator, bool> result;
-  value_type value{key, obj};
-  if (root->left == static_cast<node*>(root)) {
-    root->left = new node(value, nullptr);
-    root->left->parent_ = static_cast<node*>(root);
-    root->parent_ = root->left;
-    result.first = root->left;
-    result.second = true;
-  } else {
-    result = unique_recursive_insert(root->left, value);
-    root->parent_ = find_min(root->left);
-  }
-  if (result.second) {
-    ++size_;
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_insert(
+    const_reference data) {
+  return insert_node(create_node(nullptr, data));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_insert(
+    value_type&& data) {
+  return insert_node(create_node(nullptr, std::move(data)));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename... Args>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_emplace(
+    Args&&... args) {
+  return insert_node(create_node(nullptr, std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_unique_insert(
+    const_reference value) {
+  return unique_insert(key_of(value), [this, &value](node* parent) {
+    return create_node(parent, value);
+  });
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_unique_insert(
+    value_type&& value) {
+  return unique_insert(key_of(value), [this, &value](node* parent) {
+    return create_node(parent, std::move(value));
+  });
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_unique_insert(
+    const Key& key, const mapped_type& obj) {
+  return unique_insert(key, [this, &key, &obj](node* parent) {
+    return create_node(parent, key, obj);
+  });
+}
+
+// The element is built before the search because its key is only known after
+// construction, so a rejected duplicate costs one discarded node.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename... Args>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_unique_emplace(
+    Args&&... args) {
+  node* new_node = create_node(nullptr, std::forward<Args>(args)...);
+  std::pair<iterator, bool> result =
+      unique_insert(key_of(new_node->data_), [new_node](node* parent) {
+        new_node->parent_ = parent;
+        return new_node;
+      });
+  if (!result.second) {
+    destroy_node(new_node);
   }
   return result;
 }
 
-template <typename Key, typename Value, typename Comparator>
-std::pair<typename AVLtree<Key, Value, Comparator>::iterator, bool>
-AVLtree<Key, Value, Comparator>::tree_insert_or_assign(const Key& key,
-                                                       const Value& obj) {
-  std::pair<iterator, bool> result = tree_unique_insert(key, obj);
+// Nothing is constructed unless the key is absent: the node is built in
+// place from key and args once the free slot has been found.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K, typename... Args>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_try_emplace(
+    K&& key, Args&&... args) {
+  return unique_insert(key, [&](node* parent) {
+    return create_node(parent, std::piecewise_construct,
+                       std::forward_as_tuple(std::forward<K>(key)),
+                       std::forward_as_tuple(std::forward<Args>(args)...));
+  });
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_insert_or_assign(
+    const Key& key, const mapped_type& obj) {
+  std::pair<iterator, bool> result = tree_try_emplace(key, obj);
   if (result.second == false) {
     result.first.current_node->data_.second = obj;
   }
   return result;
 }
 
-template <typename Key, typename Value, typename Comparator>
-Value& AVLtree<Key, Value, Comparator>::at(const Key& key) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::mapped_type&
+AVLtree<Key, Value, Comparator, Allocator, Augment>::at(const K& key) {
   iterator result = tree_find(key);
   if (result == tree_end()) {
     throw std::out_of_range("There is no element with this key");
@@ -317,167 +644,574 @@ Value& AVLtree<Key, Value, Comparator>::at(const Key& key) {
   return result.current_node->data_.second;
 }
 
-template <typename Key, typename Value, typename Comparator>
-Value& AVLtree<Key, Value, Comparator>::operator[](const Key& key) {
-  iterator search_result = AVLtree<Key, Value, Comparator>::tree_find(key);
-  if (search_result == tree_end()) {
-    auto insert_result =
-        AVLtree<Key, Value, Comparator>::tree_unique_insert(key, Value{});
-    return insert_result.first.current_node->data_.second;
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::mapped_type&
+AVLtree<Key, Value, Comparator, Allocator, Augment>::operator[](
+    const Key& key) {
+  return tree_try_emplace(key).first.current_node->data_.second;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::mapped_type&
+AVLtree<Key, Value, Comparator, Allocator, Augment>::operator[](
+    Key&& key) {
+  return tree_try_emplace(std::move(key)).first.current_node->data_.second;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_erase(
+    iterator pos) {
+  node* target = pos.current_node;
+  ++pos;
+  unlink_node(target);
+  destroy_node(target);
+  return pos;
+}
+
+// Cuts [first, last) out with two positional splits and joins the rest
+// back, so the cost is O(log n) plus the k nodes destroyed instead of
+// O(k log n) for erasing them one at a time.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_erase(
+    iterator first, iterator last) {
+  node* sentinel = static_cast<node*>(root);
+  if (first == last) {
+    return last;
   }
-  return search_result.current_node->data_.second;
-}
-
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::tree_erase(iterator pos) {
-  recursive_delete(root->left, pos.current_node->data_);
-  root->parent_ = find_min(root->left);
-}
-
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::tree_clear() {
-  if (root->left != root) {
-    destroy(root->left);
+  if (first.current_node == root->next && last.current_node == sentinel) {
+    destroy_all();
+    set_root(nullptr, 0);
+    return tree_end();
   }
+  node* rest = nullptr;
+  if (last.current_node != sentinel) {
+    std::pair<node*, node*> tail = split_before(last.current_node);
+    set_root(tail.first, size_);
+    rest = tail.second;
+  }
+  std::pair<node*, node*> head = split_before(first.current_node);
+  size_type erased = destroy_counted(head.second);
+  set_root(join_pair_threaded(head.first, rest), size_ - erased);
+  return last;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::size_type
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_erase(
+    const Key& key) {
+  std::pair<node*, node*> range = equal_range_nodes(key);
+  size_type before = size_;
+  tree_erase(iterator(range.first), iterator(range.second));
+  return before - size_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_clear() {
+  destroy_all();
   delete root;
   root = new base_node;
   size_ = 0;
 }
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::tree_merge(AVLtree& other) {
-  AVLtree copy(other);
-  for (auto i = copy.tree_begin(); i != copy.tree_end(); ++i) {
-    iterator insert_result = tree_insert(i.current_node->data_);
-    other.tree_erase(insert_result);
+// Replaces the contents with [first, last). make_node(emplace, item) builds
+// the node for one element by calling emplace with the constructor arguments
+// of value_type. Sorted input is detected in one pass and anything else is
+// stable-sorted, so the first of several equal keys wins when unique is set.
+// The nodes are then linked from the middle out in O(n) inside a fresh tree
+// that is swapped in, which keeps self-assignment safe and lets the old
+// contents go back to their own allocator in bulk.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename InputIt, typename Maker>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_assign(
+    InputIt first, InputIt last, bool unique, Maker make_node) {
+  AVLtree built;
+  built.tree_comparator = tree_comparator;
+  built.allocator_ = node_traits::select_on_container_copy_construction(
+      allocator_);
+  auto emplace = [&built](auto&&... args) {
+    return built.create_node(nullptr, std::forward<decltype(args)>(args)...);
+  };
+
+  auto less = [this](const node* lhs, const node* rhs) {
+    return tree_comparator(key_of(lhs->data_), key_of(rhs->data_));
+  };
+  std::vector<node*> nodes;
+  if constexpr (std::is_pointer_v<InputIt>) {
+    nodes.reserve(static_cast<size_type>(last - first));
   }
-  if (other.tree_empty()) {
-    other.tree_clear();
+  // Until link_sorted() the nodes belong to nobody but this vector, and the
+  // comparator and stable_sort's buffer can throw as well as make_node. A
+  // throwing sort may leave its range scrambled, so it works on a copy, and
+  // the dedup pass nulls every slot it empties; either way the handler
+  // frees each node exactly once.
+  try {
+    for (; first != last; ++first) {
+      nodes.push_back(nullptr);
+      nodes.back() = make_node(emplace, *first);
+    }
+    if (!std::is_sorted(nodes.begin(), nodes.end(), less)) {
+      std::vector<node*> sorted(nodes);
+      std::stable_sort(sorted.begin(), sorted.end(), less);
+      nodes.swap(sorted);
+    }
+    if (unique && !nodes.empty()) {
+      size_type kept = 1;
+      for (size_type i = 1; i < nodes.size(); ++i) {
+        if (less(nodes[kept - 1], nodes[i])) {
+          nodes[kept++] = nodes[i];
+        } else {
+          built.destroy_node(nodes[i]);
+        }
+        if (kept <= i) {
+          nodes[i] = nullptr;
+        }
+      }
+      nodes.resize(kept);
+    }
+  } catch (...) {
+    for (node* node_ptr : nodes) {
+      if (node_ptr != nullptr) {
+        built.destroy_node(node_ptr);
+      }
+    }
+    throw;
   }
-}
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::tree_merge_unique(AVLtree& other) {
-  AVLtree copy(other);
-  for (auto i = copy.tree_begin(); i != copy.tree_end(); ++i) {
-    std::pair<iterator, bool> insert_result =
-        tree_unique_insert(i.current_node->data_);
-    if (insert_result.second) {
-      other.tree_erase(insert_result.first);
+  built.link_sorted(nodes.data(), nodes.size());
+  tree_swap(built);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_merge(
+    AVLtree& other) {
+  merge_nodes(other, false);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_merge_unique(
+    AVLtree& other) {
+  merge_nodes(other, true);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node_handle
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_extract(
+    iterator pos) {
+  node* target = pos.current_node;
+  unlink_node(target);
+  if constexpr (has_bulk_release<node_allocator>::value) {
+    // Releasing this tree would take the node's slab with it, so the handle
+    // gets a copy of the element in an allocator of its own.
+    node_handle handle(nullptr,
+                       node_traits::select_on_container_copy_construction(
+                           allocator_));
+    node_allocator& handle_allocator = *handle.allocator_;
+    node* moved = node_traits::allocate(handle_allocator, 1);
+    try {
+      node_traits::construct(handle_allocator, moved, nullptr,
+                             std::move(target->data_));
+    } catch (...) {
+      node_traits::deallocate(handle_allocator, moved, 1);
+      insert_node(reset_node(target, nullptr));
+      throw;
     }
+    handle.held_node = moved;
+    destroy_node(target);
+    return handle;
+  } else {
+    return node_handle(target, allocator_);
   }
-  if (other.tree_empty()) {
-    other.tree_clear();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node_handle
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_extract(
+    const Key& key) {
+  node* found = lower_bound_node(tree_root(), static_cast<node*>(root), key);
+  if (found == static_cast<node*>(root) ||
+      tree_comparator(key, key_of(found->data_))) {
+    return node_handle();
   }
+  return tree_extract(iterator(found));
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::iterator
-AVLtree<Key, Value, Comparator>::tree_find(const Key& key) {
-  std::pair<iterator, node*> result = recursive_find(root->left, key);
-  if (result.second == nullptr) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_insert(
+    node_handle&& handle) {
+  if (handle.empty()) {
     return tree_end();
   }
-  return result.first;
+  return insert_node(adopt_node(handle, nullptr));
+}
+
+// On a duplicate key the handle keeps its node, as std::map::insert does.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_unique_insert(
+    node_handle& handle) {
+  if (handle.empty()) {
+    return {tree_end(), false};
+  }
+  return unique_insert(handle.key(), [this, &handle](node* parent) {
+    return adopt_node(handle, parent);
+  });
 }
 
-template <typename Key, typename Value, typename Comparator>
-bool AVLtree<Key, Value, Comparator>::tree_contains(const Key& key) const {
-  return recursive_find(root->left, key).second != nullptr;
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_split(
+    const Key& key, AVLtree& greater) {
+  if (this == &greater) {
+    return;
+  }
+  greater.tree_clear();
+  greater.tree_comparator = tree_comparator;
+  if constexpr (!has_bulk_release<node_allocator>::value) {
+    greater.allocator_ = allocator_;
+  }
+  if (!(greater.allocator_ == allocator_)) {
+    // Arena-backed nodes cannot change owner, move the elements instead.
+    node* sentinel = static_cast<node*>(root);
+    node* first = lower_bound_node(tree_root(), sentinel, key);
+    while (first != sentinel) {
+      iterator next(first);
+      ++next;
+      greater.insert_node(
+          greater.create_node(nullptr, std::move(first->data_)));
+      unlink_node(first);
+      destroy_node(first);
+      first = next.current_node;
+    }
+    return;
+  }
+  if (tree_empty()) {
+    return;
+  }
+
+  split_parts parts = split_nodes(tree_root(), key);
+  node* upper = parts.greater;
+  if (parts.equal != nullptr) {
+    upper = join_nodes(nullptr, parts.equal, parts.greater);
+  }
+  size_type total = size_;
+  size_type lower_count = count_first(parts.less, upper, total);
+  set_root(parts.less, lower_count);
+  greater.set_root(upper, total - lower_count);
+}
+
+// Appends greater in O(|height difference|) when all of its keys follow
+// ours. Overlapping ranges or unequal allocators fall back to a merge.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_join(
+    AVLtree& greater, bool unique) {
+  if (this == &greater || greater.tree_empty()) {
+    return;
+  }
+  bool can_link = allocator_ == greater.allocator_;
+  if (can_link && tree_empty()) {
+    tree_swap(greater);
+    return;
+  }
+  if (!can_link || !tree_comparator(key_of(root->prev->data_),
+                                    key_of(greater.root->next->data_))) {
+    merge_nodes(greater, unique);
+    return;
+  }
+  size_type total = size_ + greater.size_;
+  std::pair<node*, node*> lower = split_last(tree_root());
+  node* joined =
+      join_threaded(lower.first, lower.second, greater.tree_root());
+  greater.set_root(nullptr, 0);
+  set_root(joined, total);
+}
+
+// Join-based set algebra: other is split around each of our subtree roots
+// and the recursive results are joined back, which takes
+// O(m log(n / m + 1)) for sizes m <= n. Independent halves run on separate
+// threads while both sides are large. Union links other's nodes into this
+// tree and keeps our element on equal keys; intersection and difference
+// only ever keep our nodes, so other is left untouched.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_set_union(
+    AVLtree& other) {
+  if (this == &other || other.tree_empty()) {
+    return;
+  }
+  if (!(allocator_ == other.allocator_)) {
+    merge_nodes(other, true);
+    other.tree_clear();
+    return;
+  }
+  size_type total = size_ + other.size_;
+  std::vector<node*> discarded;
+  node* united = union_nodes(tree_root(), other.tree_root(), discarded,
+                             std::thread::hardware_concurrency());
+  other.set_root(nullptr, 0);
+  for (node* duplicate : discarded) {
+    other.destroy_node(duplicate);
+  }
+  set_root(united, total - discarded.size());
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::size_type
-AVLtree<Key, Value, Comparator>::tree_count(const Key& key) const {
-  size_type count = 0;
-  if (tree_contains(key)) {
-    auto lowerbound = tree_lower_bound(key);
-    auto upperbound = tree_upper_bound(key);
-    while (lowerbound != upperbound) {
-      ++count;
-      ++lowerbound;
-    }
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_set_intersection(
+    const AVLtree& other) {
+  if (this == &other) {
+    return;
   }
-  return count;
+  std::vector<node*> discarded;
+  node* common = intersection_nodes(tree_root(), other.tree_root(), discarded,
+                                    std::thread::hardware_concurrency());
+  size_type removed = 0;
+  for (node* subtree : discarded) {
+    removed += destroy_counted(subtree);
+  }
+  set_root(common, size_ - removed);
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::const_iterator
-AVLtree<Key, Value, Comparator>::tree_lower_bound(const Key& key) const {
-  const_iterator result = const_tree_begin();
-  for (; result != const_tree_end(); ++result) {
-    if (result.current_node->data_.first >= key) {
-      break;
-    }
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_set_difference(
+    const AVLtree& other) {
+  if (this == &other) {
+    tree_clear();
+    return;
+  }
+  std::vector<node*> discarded;
+  node* rest = difference_nodes(tree_root(), other.tree_root(), discarded,
+                                std::thread::hardware_concurrency());
+  for (node* removed : discarded) {
+    destroy_node(removed);
   }
+  set_root(rest, size_ - discarded.size());
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_find(const K& key) {
+  node* found = recursive_find(tree_root(), key);
+  return found == nullptr ? tree_end() : iterator(found);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K>
+bool AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_contains(
+    const K& key) const {
+  return recursive_find(tree_root(), key) != nullptr;
+}
+
+// It lets set and multiset collect their own iterator types directly.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename It>
+std::vector<It>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_find_many(
+    const Key* keys, size_type count) {
+  std::vector<It> result(count, It(tree_end()));
+  find_batch(keys, count, [&result](size_type index, node* found) {
+    if (found != nullptr) {
+      result[index] = It(found);
+    }
+  });
   return result;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::const_iterator
-AVLtree<Key, Value, Comparator>::tree_upper_bound(const Key& key) const {
-  const_iterator result = const_tree_end();
-  if (!tree_empty()) {
-    --result;
-    for (; result != const_tree_begin(); --result) {
-      if (result.current_node->data_.first == key) {
-        ++result;
-        break;
-      }
-    }
-    --result;
-    if (result.current_node->data_.first == key) {
-      ++result;
-    } else {
-      result = const_tree_end();
-    }
-  }
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::vector<bool>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_contains_many(
+    const Key* keys, size_type count) const {
+  std::vector<bool> result(count);
+  find_batch(keys, count, [&result](size_type index, node* found) {
+    result[index] = found != nullptr;
+  });
   return result;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::iterator
-AVLtree<Key, Value, Comparator>::tree_lower_bound(const Key& key) {
-  auto result = tree_begin();
-  for (; result != tree_end(); ++result) {
-    if (result.current_node->data_.first >= key) {
-      break;
-    }
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::size_type
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_count(
+    const K& key) const {
+  if constexpr (counts_subtrees) {
+    return count_before(key, true) - count_before(key, false);
   }
-  return result;
+  size_type count = 0;
+  auto range = tree_equal_range(key);
+  for (; range.first != range.second; ++range.first) {
+    ++count;
+  }
+  return count;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::iterator
-AVLtree<Key, Value, Comparator>::tree_upper_bound(const Key& key) {
-  auto result = tree_end();
-  if (!tree_empty()) {
-    --result;
-    for (; result != tree_begin(); --result) {
-      if (result.current_node->data_.first == key) {
-        ++result;
-        break;
-      }
-    }
-    --result;
-    if (result.current_node->data_.first == key) {
-      ++result;
-    } else {
-      result = tree_end();
-    }
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_nth(size_type index) {
+  return iterator(nth_node(index));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_nth(
+    size_type index) const {
+  return const_iterator(nth_node(index));
+}
+
+// Number of keys less than key.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::size_type
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_rank(
+    const Key& key) const {
+  return count_before(key, false);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_lower_bound(
+    const Key& key) const {
+  return const_iterator(
+      lower_bound_node(tree_root(), static_cast<node*>(root), key));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_upper_bound(
+    const Key& key) const {
+  return const_iterator(
+      upper_bound_node(tree_root(), static_cast<node*>(root), key));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_lower_bound(
+    const Key& key) {
+  return iterator(lower_bound_node(tree_root(), static_cast<node*>(root), key));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_upper_bound(
+    const Key& key) {
+  return iterator(upper_bound_node(tree_root(), static_cast<node*>(root), key));
+}
+
+// Calls visit on every element with a key in [lo, hi): one descent to lo,
+// then the in-order thread, so O(log n + k). visit must not insert into or
+// erase from the tree. Only this overload hands out mutable elements; for a
+// set those are the keys, so set and multiset use the const one.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename Visit>
+void AVLtree<Key, Value, Comparator, Allocator,
+             Augment>::tree_for_each_in_range(const Key& lo, const Key& hi,
+                                              Visit visit) {
+  node* sentinel = static_cast<node*>(root);
+  node* current = lower_bound_node(tree_root(), sentinel, lo);
+  while (current != sentinel && tree_comparator(key_of(current->data_), hi)) {
+    visit(current->data_);
+    current = current->next;
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename Visit>
+void AVLtree<Key, Value, Comparator, Allocator,
+             Augment>::tree_for_each_in_range(const Key& lo, const Key& hi,
+                                              Visit visit) const {
+  node* sentinel = static_cast<node*>(root);
+  node* current = lower_bound_node(tree_root(), sentinel, lo);
+  while (current != sentinel && tree_comparator(key_of(current->data_), hi)) {
+    visit(static_cast<const value_type&>(current->data_));
+    current = current->next;
   }
-  return result;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::size_type
-AVLtree<Key, Value, Comparator>::tree_size() const {
+// Removes every key in [lo, hi) by cutting the range out with the
+// positional splits of the iterator range erase: O(log n + k) and a single
+// join, however many elements go.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::size_type
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_erase_range(
+    const Key& lo, const Key& hi) {
+  if (!tree_comparator(lo, hi)) {
+    return 0;
+  }
+  size_type before = size_;
+  tree_erase(tree_lower_bound(lo), tree_lower_bound(hi));
+  return before - size_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator,
+                     Augment>::const_iterator,
+    typename AVLtree<Key, Value, Comparator, Allocator,
+                     Augment>::const_iterator>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_equal_range(
+    const K& key) const {
+  std::pair<node*, node*> range = equal_range_nodes(key);
+  return {const_iterator(range.first), const_iterator(range.second)};
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator,
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_equal_range(
+    const K& key) {
+  std::pair<node*, node*> range = equal_range_nodes(key);
+  return {iterator(range.first), iterator(range.second)};
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::size_type
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_size() const {
   return size_;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::size_type
-AVLtree<Key, Value, Comparator>::tree_max_size() const {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::size_type
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_max_size() const {
   return ((std::numeric_limits<size_type>::max() -
            (sizeof(AVLtree) + sizeof(base_node))) /
           sizeof(node)) /
@@ -485,249 +1219,371 @@ AVLtree<Key, Value, Comparator>::tree_max_size() const {
          1;
 }
 
-template <typename Key, typename Value, typename Comparator>
-bool AVLtree<Key, Value, Comparator>::tree_empty() const {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_empty() const {
   return size_ == 0;
 }
 
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::allocator_type
+AVLtree<Key, Value, Comparator, Allocator, Augment>::get_allocator() const {
+  return allocator_type(allocator_);
+}
+
 //---itarator-logic---/
 
-template <typename Key, typename Value, typename Comparator>
-AVLtree<Key, Value, Comparator>::iterator::iterator() : current_node(nullptr) {}
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::iterator()
+    : current_node(nullptr) {}
 
-template <typename Key, typename Value, typename Comparator>
-AVLtree<Key, Value, Comparator>::iterator::iterator(const iterator& other)
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::iterator(
+    const iterator& other)
     : current_node(other.current_node) {}
 
-template <typename Key, typename Value, typename Comparator>
-inline AVLtree<Key, Value, Comparator>::iterator::iterator(node* node_ptr)
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::iterator(
+    node* node_ptr)
     : current_node(node_ptr) {}
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::iterator::operator=(node* node_ptr) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::operator=(
+    node* node_ptr) {
   current_node = node_ptr;
 }
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::iterator::move_forward() {
-  if (current_node->right != nullptr) {
-    current_node = find_min(current_node->right);
-  } else {
-    while (current_node != nullptr && current_node->parent_ != nullptr &&
-           current_node == current_node->parent_->right) {
-      current_node = current_node->parent_;
-    }
-    if (current_node) {
-      current_node = current_node->parent_;
-    }
-  }
-}
-
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::iterator::move_back() {
-  if (current_node->left != nullptr) {
-    current_node = find_max(current_node->left);
-  } else {
-    node* tmp = current_node->parent_;
-    while (tmp != nullptr && current_node == tmp->left) {
-      current_node = tmp;
-      tmp = current_node->parent_;
-    }
-    current_node = tmp;
-  }
-}
-
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::iterator&
-AVLtree<Key, Value, Comparator>::iterator::operator++() {
-  move_forward();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator&
+AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::operator++() {
+  current_node = current_node->next;
   return *this;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::iterator
-AVLtree<Key, Value, Comparator>::iterator::operator++(int) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::operator++(int) {
   iterator copy = *this;
-  move_forward();
+  current_node = current_node->next;
   return copy;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::iterator&
-AVLtree<Key, Value, Comparator>::iterator::operator--() {
-  move_back();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator&
+AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::operator--() {
+  current_node = current_node->prev;
   return *this;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::iterator
-AVLtree<Key, Value, Comparator>::iterator::operator--(int) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::operator--(int) {
   iterator copy = *this;
-  move_back();
+  current_node = current_node->prev;
   return copy;
 }
 
-template <typename Key, typename Value, typename Comparator>
-bool AVLtree<Key, Value, Comparator>::iterator::operator==(
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::operator==(
     const iterator& other) const {
   return current_node == other.current_node;
 }
 
-template <typename Key, typename Value, typename Comparator>
-bool AVLtree<Key, Value, Comparator>::iterator::operator!=(
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::operator!=(
     const iterator& other) const {
   return !operator==(other);
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::value_reference
-AVLtree<Key, Value, Comparator>::iterator::operator*() {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::value_reference
+AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::operator*() {
   return current_node->data_;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::value_pointer
-AVLtree<Key, Value, Comparator>::iterator::operator->() {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::value_pointer
+AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator::operator->() {
   return &(current_node->data_);
 }
 
 // const-iterator logic//
 
-template <typename Key, typename Value, typename Comparator>
-AVLtree<Key, Value, Comparator>::const_iterator::const_iterator()
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator,
+        Augment>::const_iterator::const_iterator()
     : current_node(nullptr) {}
 
-template <typename Key, typename Value, typename Comparator>
-inline AVLtree<Key, Value, Comparator>::const_iterator::const_iterator(
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator,
+        Augment>::const_iterator::const_iterator(
     node* node_ptr)
     : current_node(node_ptr) {}
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::const_iterator::operator=(
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void
+AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator::operator=(
     node* node_ptr) {
   current_node = node_ptr;
 }
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::const_iterator::move_forward() {
-  if (current_node->right != nullptr) {
-    current_node = find_min(current_node->right);
-  } else {
-    while (current_node != nullptr && current_node->parent_ != nullptr &&
-           current_node == current_node->parent_->right) {
-      current_node = current_node->parent_;
-    }
-    current_node = current_node->parent_;
-  }
-}
-
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::const_iterator::move_back() {
-  if (current_node->left != nullptr) {
-    current_node = find_max(current_node->left);
-  } else {
-    node* tmp = current_node->parent_;
-    while (tmp != nullptr && current_node == tmp->left) {
-      current_node = tmp;
-      tmp = current_node->parent_;
-    }
-    current_node = tmp;
-  }
-}
-
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::const_iterator&
-AVLtree<Key, Value, Comparator>::const_iterator::operator++() {
-  move_forward();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator&
+AVLtree<Key, Value, Comparator, Allocator,
+        Augment>::const_iterator::operator++() {
+  current_node = current_node->next;
   return *this;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::const_iterator
-AVLtree<Key, Value, Comparator>::const_iterator::operator++(int) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator::operator++(
+    int) {
   const_iterator copy = *this;
-  move_forward();
+  current_node = current_node->next;
   return copy;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::const_iterator&
-AVLtree<Key, Value, Comparator>::const_iterator::operator--() {
-  move_back();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator&
+AVLtree<Key, Value, Comparator, Allocator,
+        Augment>::const_iterator::operator--() {
+  current_node = current_node->prev;
   return *this;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::const_iterator
-AVLtree<Key, Value, Comparator>::const_iterator::operator--(int) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator::operator--(
+    int) {
   const_iterator copy = *this;
-  move_back();
+  current_node = current_node->prev;
   return copy;
 }
 
-template <typename Key, typename Value, typename Comparator>
-bool AVLtree<Key, Value, Comparator>::const_iterator::operator==(
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool
+AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator::operator==(
     const const_iterator& other) const {
   return current_node == other.current_node;
 }
 
-template <typename Key, typename Value, typename Comparator>
-bool AVLtree<Key, Value, Comparator>::const_iterator::operator!=(
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool
+AVLtree<Key, Value, Comparator, Allocator, Augment>::const_iterator::operator!=(
     const const_iterator& other) const {
   return !operator==(other);
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::const_reference
-AVLtree<Key, Value, Comparator>::const_iterator::operator*() {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::const_reference
+AVLtree<Key, Value, Comparator, Allocator,
+        Augment>::const_iterator::operator*() {
   return current_node->data_;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::const_pointer
-AVLtree<Key, Value, Comparator>::const_iterator::operator->() {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::const_pointer
+AVLtree<Key, Value, Comparator, Allocator,
+        Augment>::const_iterator::operator->() {
   return &(current_node->data_);
 }
 
-// nodes logic//
+// node handle logic//
 
-template <typename Key, typename Value, typename Comparator>
-inline AVLtree<Key, Value, Comparator>::base_node::base_node()
-    : left(static_cast<node*>(this)),
-      right(nullptr),
-      parent_(static_cast<node*>(this)) {}
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::node_handle::node_handle(
+    node* node_ptr, const node_allocator& allocator)
+    : held_node(node_ptr), allocator_(allocator) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::node_handle::node_handle(
+    node_handle&& other) noexcept
+    : held_node(other.held_node), allocator_(std::move(other.allocator_)) {
+  other.held_node = nullptr;
+  other.allocator_.reset();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node_handle&
+AVLtree<Key, Value, Comparator, Allocator, Augment>::node_handle::operator=(
+    node_handle&& other) noexcept {
+  if (this != &other) {
+    reset();
+    held_node = other.held_node;
+    allocator_ = std::move(other.allocator_);
+    other.held_node = nullptr;
+    other.allocator_.reset();
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator,
+        Augment>::node_handle::~node_handle() {
+  reset();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool AVLtree<Key, Value, Comparator, Allocator,
+             Augment>::node_handle::empty() const {
+  return held_node == nullptr;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+AVLtree<Key, Value, Comparator, Allocator,
+        Augment>::node_handle::operator bool() const {
+  return held_node != nullptr;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::allocator_type
+AVLtree<Key, Value, Comparator, Allocator,
+        Augment>::node_handle::get_allocator() const {
+  return allocator_type(*allocator_);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+const
+Key&
+AVLtree<Key, Value, Comparator, Allocator, Augment>::node_handle::key() const {
+  return key_of(held_node->data_);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::mapped_type&
+AVLtree<Key, Value, Comparator, Allocator,
+        Augment>::node_handle::mapped() const {
+  return held_node->data_.second;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+const typename AVLtree<Key, Value, Comparator, Allocator,
+                       Augment>::mapped_type&
+AVLtree<Key, Value, Comparator, Allocator,
+        Augment>::node_handle::value() const {
+  if constexpr (std::is_void_v<Value>) {
+    return held_node->data_;
+  } else {
+    return held_node->data_.second;
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::node_handle::swap(
+    node_handle& other) noexcept {
+  std::swap(held_node, other.held_node);
+  std::swap(allocator_, other.allocator_);
+}
 
-template <typename Key, typename Value, typename Comparator>
-inline AVLtree<Key, Value, Comparator>::base_node::base_node(node* Left,
-                                                             node* Right,
-                                                             node* Parent)
-    : left(Left), right(Right), parent_(Parent) {}
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::node_handle::reset() {
+  if (held_node != nullptr) {
+    node_traits::destroy(*allocator_, held_node);
+    node_traits::deallocate(*allocator_, held_node, 1);
+    held_node = nullptr;
+  }
+  allocator_.reset();
+}
 
-template <typename Key, typename Value, typename Comparator>
-inline AVLtree<Key, Value, Comparator>::node::node(value_type data,
-                                                   node* parent)
-    : base_node{nullptr, nullptr, parent}, data_(data) {}
+// nodes logic//
 
-template <typename Key, typename Value, typename Comparator>
-inline int8_t AVLtree<Key, Value, Comparator>::get_height(node* node_ptr) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline AVLtree<Key, Value, Comparator, Allocator,
+               Augment>::base_node::base_node()
+    : left(static_cast<node*>(this)),
+      right(nullptr),
+      parent_(static_cast<node*>(this)),
+      next(static_cast<node*>(this)),
+      prev(static_cast<node*>(this)) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline AVLtree<Key, Value, Comparator, Allocator,
+               Augment>::base_node::base_node(
+    node* Left, node* Right, node* Parent)
+    : left(Left),
+      right(Right),
+      parent_(Parent),
+      next(nullptr),
+      prev(nullptr) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename... Args>
+inline AVLtree<Key, Value, Comparator, Allocator, Augment>::node::node(
+    node* parent, Args&&... args)
+    : base_node{nullptr, nullptr, parent}, data_(std::forward<Args>(args)...) {
+  this->update(this->left, this->right);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline int8_t AVLtree<Key, Value, Comparator, Allocator, Augment>::get_height(
+    node* node_ptr) {
   return node_ptr ? node_ptr->height : -1;
 }
 
-template <typename Key, typename Value, typename Comparator>
-inline int AVLtree<Key, Value, Comparator>::balance_factor(node* node_ptr) {
-  return node_ptr ? get_height(node_ptr->right) - get_height(node_ptr->left)
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline int AVLtree<Key, Value, Comparator, Allocator, Augment>::balance_factor(
+    node* node_ptr) {
+  return node_ptr ? avl_rules::skew(get_height(node_ptr->left),
+                                   get_height(node_ptr->right))
                   : 0;
 }
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::set_height(node* node_ptr) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::set_height(
+    node* node_ptr) {
   int8_t hl = get_height(node_ptr->left);
   int8_t hr = get_height(node_ptr->right);
-  node_ptr->height = (hl > hr ? hl : hr) + 1;
+  node_ptr->height = static_cast<int8_t>(avl_rules::height_above(hl, hr));
+  node_ptr->update(node_ptr->left, node_ptr->right);
 }
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::rotateright(node*& node_ptr) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::rotateright(
+    node*& node_ptr) {
   node* tmp = node_ptr->left;
   node_ptr->left = tmp->right;
 
@@ -743,8 +1599,10 @@ void AVLtree<Key, Value, Comparator>::rotateright(node*& node_ptr) {
   node_ptr = tmp;
 }
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::rotateleft(node*& node_ptr) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::rotateleft(
+    node*& node_ptr) {
   node* tmp = node_ptr->right;
   node_ptr->right = tmp->left;
 
@@ -760,40 +1618,153 @@ void AVLtree<Key, Value, Comparator>::rotateleft(node*& node_ptr) {
   node_ptr = tmp;
 }
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::balance(node*& node_ptr) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::balance(
+    node*& node_ptr) {
   if (balance_factor(node_ptr) == 2) {
-    if (balance_factor(node_ptr->right) < 0) {
+    node* heavy = node_ptr->right;
+    if (avl_rules::needs_double_rotation(get_height(heavy->right),
+                                         get_height(heavy->left))) {
       rotateright(node_ptr->right);
     }
     rotateleft(node_ptr);
   }
   if (balance_factor(node_ptr) == -2) {
-    if (balance_factor(node_ptr->left) > 0) {
+    node* heavy = node_ptr->left;
+    if (avl_rules::needs_double_rotation(get_height(heavy->left),
+                                         get_height(heavy->right))) {
       rotateleft(node_ptr->left);
     }
     rotateright(node_ptr);
   }
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::iterator
-AVLtree<Key, Value, Comparator>::recursive_insert(node*& root,
-                                                  value_type data) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename... Args>
+inline typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::create_node(
+    node* parent, Args&&... args) {
+  node* new_node = node_traits::allocate(allocator_, 1);
+  try {
+    node_traits::construct(allocator_, new_node, parent,
+                           std::forward<Args>(args)...);
+  } catch (...) {
+    node_traits::deallocate(allocator_, new_node, 1);
+    throw;
+  }
+  return new_node;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline void AVLtree<Key, Value, Comparator, Allocator, Augment>::destroy_node(
+    node* node_ptr) {
+  node_traits::destroy(allocator_, node_ptr);
+  node_traits::deallocate(allocator_, node_ptr, 1);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::reset_node(node* node_ptr,
+                                                                node* parent) {
+  node_ptr->left = nullptr;
+  node_ptr->right = nullptr;
+  node_ptr->parent_ = parent;
+  node_ptr->height = 0;
+  node_ptr->update(node_ptr->left, node_ptr->right);
+  return node_ptr;
+}
+
+// Takes the node out of handle. A node from an unequal allocator cannot be
+// freed by this tree, so its element is moved into a node of our own and
+// the original is left for the handle to destroy.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::adopt_node(
+    node_handle& handle, node* parent) {
+  if (*handle.allocator_ == allocator_) {
+    node* result = reset_node(handle.held_node, parent);
+    handle.held_node = nullptr;
+    handle.allocator_.reset();
+    return result;
+  }
+  return create_node(parent, std::move(handle.held_node->data_));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::insert_node(
+    node* new_node) {
+  iterator result;
+  if (tree_root() == nullptr) {
+    root->left = new_node;
+    new_node->parent_ = static_cast<node*>(root);
+    link_adjacent(static_cast<node*>(root), new_node);
+    link_adjacent(new_node, static_cast<node*>(root));
+    result = new_node;
+  } else {
+    result = recursive_insert(root->left, new_node);
+  }
+  ++size_;
+  return result;
+}
+
+// make_node(parent) is called at most once, when the free slot for key has
+// been found, and must return a node already holding that key.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename Maker>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::unique_insert(
+    const Key& key, Maker make_node) {
+  std::pair<iterator, bool> result;
+  if (tree_root() == nullptr) {
+    root->left = make_node(static_cast<node*>(root));
+    link_adjacent(static_cast<node*>(root), root->left);
+    link_adjacent(root->left, static_cast<node*>(root));
+    result.first = root->left;
+    result.second = true;
+  } else {
+    result = unique_recursive_insert(root->left, key, make_node);
+  }
+  if (result.second) {
+    ++size_;
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator
+AVLtree<Key, Value, Comparator, Allocator, Augment>::recursive_insert(
+    node*& root, node* new_node) {
   iterator result;
-  if (tree_comparator(data.first, root->data_.first)) {
+  if (tree_comparator(key_of(new_node->data_), key_of(root->data_))) {
     if (root->left == nullptr) {
-      root->left = new node(data, root);
-      result = root->left;
+      root->left = new_node;
+      new_node->parent_ = root;
+      link_adjacent(root->prev, new_node);
+      link_adjacent(new_node, root);
+      result = new_node;
     } else {
-      result = recursive_insert(root->left, data);
+      result = recursive_insert(root->left, new_node);
     }
   } else {
     if (root->right == nullptr) {
-      root->right = new node(data, root);
-      result = root->right;
+      root->right = new_node;
+      new_node->parent_ = root;
+      link_adjacent(new_node, root->next);
+      link_adjacent(root, new_node);
+      result = new_node;
     } else {
-      result = recursive_insert(root->right, data);
+      result = recursive_insert(root->right, new_node);
     }
   }
   set_height(root);
@@ -801,27 +1772,35 @@ AVLtree<Key, Value, Comparator>::recursive_insert(node*& root,
   return result;
 }
 
-template <typename Key, typename Value, typename Comparator>
-std::pair<typename AVLtree<Key, Value, Comparator>::iterator, bool>
-AVLtree<Key, Value, Comparator>::unique_recursive_insert(node*& root,
-                                                         value_type data) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename Maker>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::unique_recursive_insert(
+    node*& root, const Key& key, Maker& make_node) {
   std::pair<iterator, bool> result;
 
-  if (tree_comparator(data.first, root->data_.first)) {
+  if (tree_comparator(key, key_of(root->data_))) {
     if (root->left == nullptr) {
-      root->left = new node(data, root);
+      root->left = make_node(root);
+      link_adjacent(root->prev, root->left);
+      link_adjacent(root->left, root);
       result.first = root->left;
       result.second = true;
     } else {
-      result = unique_recursive_insert(root->left, data);
+      result = unique_recursive_insert(root->left, key, make_node);
     }
-  } else if (tree_comparator(root->data_.first, data.first)) {
+  } else if (tree_comparator(key_of(root->data_), key)) {
     if (root->right == nullptr) {
-      root->right = new node(data, root);
+      root->right = make_node(root);
+      link_adjacent(root->right, root->next);
+      link_adjacent(root, root->right);
       result.first = root->right;
       result.second = true;
     } else {
-      result = unique_recursive_insert(root->right, data);
+      result = unique_recursive_insert(root->right, key, make_node);
     }
   } else {
     result.first = root;
@@ -833,110 +1812,880 @@ AVLtree<Key, Value, Comparator>::unique_recursive_insert(node*& root,
   return result;
 }
 
-template <typename Key, typename Value, typename Comparator>
-void AVLtree<Key, Value, Comparator>::recursive_delete(node*& node_ptr,
-                                                       value_type data) {
-  if (!node_ptr) {
-    node_ptr = nullptr;
-    return;
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*&
+AVLtree<Key, Value, Comparator, Allocator, Augment>::child_slot(
+    node* node_ptr) {
+  node* parent = node_ptr->parent_;
+  if (parent == static_cast<node*>(root)) {
+    return root->left;
   }
-  if (tree_comparator(data.first, node_ptr->data_.first)) {
-    recursive_delete(node_ptr->left, data);
-  } else if (tree_comparator(node_ptr->data_.first, data.first)) {
-    recursive_delete(node_ptr->right, data);
+  return parent->left == node_ptr ? parent->left : parent->right;
+}
+
+// Detaches target without searching for it: the successor takes its place
+// and heights are repaired by walking parent links up to the root. The
+// node itself is left allocated and unlinked.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::unlink_node(
+    node* target) {
+  node* sentinel = static_cast<node*>(root);
+  node*& slot = child_slot(target);
+  node* parent = target->parent_;
+  node* rebalance_from = parent;
+  link_adjacent(target->prev, target->next);
+  if (target->left == nullptr || target->right == nullptr) {
+    node* child = target->left != nullptr ? target->left : target->right;
+    if (child != nullptr) {
+      child->parent_ = parent;
+    }
+    slot = child;
   } else {
-    node* tmp_left = node_ptr->left;
-    node* tmp_right = node_ptr->right;
-    node* deleting_parent = node_ptr->parent_;
-    delete node_ptr;
-    node_ptr = nullptr;
-    --size_;
-    if (!tmp_right) {
-      node_ptr = tmp_left;
-      if (node_ptr) node_ptr->parent_ = deleting_parent;
-      return;
+    node* successor = find_min(target->right);
+    if (successor->parent_ != target) {
+      rebalance_from = successor->parent_;
+      rebalance_from->left = successor->right;
+      if (successor->right != nullptr) {
+        successor->right->parent_ = rebalance_from;
+      }
+      successor->right = target->right;
+      successor->right->parent_ = successor;
+    } else {
+      rebalance_from = successor;
     }
-    node* min = find_min(tmp_right);
-    min->right = remove_min(tmp_right);
-    min->left = tmp_left;
-    if (min->left) {
-      min->left->parent_ = min;
+    successor->left = target->left;
+    successor->left->parent_ = successor;
+    successor->parent_ = parent;
+    successor->height = target->height;
+    slot = successor;
+  }
+
+  while (rebalance_from != sentinel) {
+    node*& subtree = child_slot(rebalance_from);
+    set_height(rebalance_from);
+    balance(subtree);
+    rebalance_from = subtree->parent_;
+  }
+
+  --size_;
+  if (root->left == nullptr) {
+    root->left = sentinel;
+  }
+  reset_node(target, nullptr);
+}
+
+// Splits the whole tree into the nodes before target and the nodes from
+// target on. The tree is cut bottom-up along target's parent links and each
+// ancestor is joined onto the side it belongs to; the join costs telescope,
+// so the split is O(log n). The tree itself is left for the caller to reset.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*,
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::split_before(
+    node* target) {
+  node* sentinel = static_cast<node*>(root);
+  node* parent = target->parent_;
+  node* less = target->left;
+  node* greater = target->right;
+  node* child = target;
+  reset_node(target, nullptr);
+  greater = join_nodes(nullptr, target, greater);
+  while (parent != sentinel) {
+    node* next = parent->parent_;
+    node* left = parent->left;
+    node* right = parent->right;
+    reset_node(parent, nullptr);
+    if (right == child) {
+      less = join_nodes(left, parent, less);
+    } else {
+      greater = join_nodes(greater, parent, right);
     }
-    if (min->right) {
-      min->right->parent_ = min;
+    child = parent;
+    parent = next;
+  }
+  return {less, greater};
+}
+
+// Moves every node of other that this tree accepts without reallocating it.
+// When the incoming count is close to our own, inserting one by one would
+// cost O(m log(n + m)), so both trees are flattened and the two sorted runs
+// are merged and relinked in O(n + m) instead. Keys rejected as duplicates
+// stay behind in other. Nodes from an unequal allocator cannot change owner
+// and are moved element-wise.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::merge_nodes(
+    AVLtree& other, bool unique) {
+  if (this == &other || other.tree_empty()) {
+    return;
+  }
+  if (!(allocator_ == other.allocator_)) {
+    for (iterator pos = other.tree_begin(); pos != other.tree_end();) {
+      node* source = pos.current_node;
+      ++pos;
+      if (unique) {
+        bool inserted =
+            unique_insert(key_of(source->data_), [this, source](node* parent) {
+              return create_node(parent, std::move(source->data_));
+            }).second;
+        if (!inserted) {
+          continue;
+        }
+      } else {
+        insert_node(create_node(nullptr, std::move(source->data_)));
+      }
+      other.unlink_node(source);
+      other.destroy_node(source);
     }
-    min->parent_ = deleting_parent;
-    balance(min);
-    node_ptr = min;
+    return;
+  }
+
+  size_type total = size_ + other.size_;
+  size_type depth = 1;
+  while (depth < std::numeric_limits<size_type>::digits &&
+         (size_type(1) << depth) < total) {
+    ++depth;
   }
-  balance(node_ptr);
+  std::vector<node*> theirs = other.flatten();
+  std::vector<node*> rejected;
+  rejected.reserve(unique ? theirs.size() : 0);
+  auto less = [this](const node* lhs, const node* rhs) {
+    return tree_comparator(key_of(lhs->data_), key_of(rhs->data_));
+  };
+
+  if (other.size_ * depth >= total) {
+    std::vector<node*> mine = flatten();
+    std::vector<node*> merged;
+    merged.reserve(total);
+    auto next = mine.begin();
+    for (node* incoming : theirs) {
+      while (next != mine.end() && !less(incoming, *next)) {
+        merged.push_back(*next++);
+      }
+      if (unique && !merged.empty() && !less(merged.back(), incoming)) {
+        rejected.push_back(incoming);
+      } else {
+        merged.push_back(incoming);
+      }
+    }
+    merged.insert(merged.end(), next, mine.end());
+    link_sorted(merged.data(), merged.size());
+  } else {
+    other.link_sorted(nullptr, 0);
+    for (node* incoming : theirs) {
+      reset_node(incoming, nullptr);
+      if (!unique) {
+        insert_node(incoming);
+        continue;
+      }
+      auto reuse = [incoming](node* parent) {
+        incoming->parent_ = parent;
+        return incoming;
+      };
+      if (!unique_insert(key_of(incoming->data_), reuse).second) {
+        rejected.push_back(incoming);
+      }
+    }
+  }
+  other.link_sorted(rejected.data(), rejected.size());
 }
 
-template <typename Key, typename Value, typename Comparator>
-std::pair<typename AVLtree<Key, Value, Comparator>::iterator,
-          typename AVLtree<Key, Value, Comparator>::node*>
-AVLtree<Key, Value, Comparator>::recursive_find(node* root,
-                                                const Key& key) const {
-  std::pair<iterator, node*> result;
+// Returns the node equivalent to key, or nullptr. Only the comparator is
+// used, so key may be of any type it accepts next to Key.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::recursive_find(
+    node* root, const K& key) const {
   if (root == nullptr) {
-    result.second = root;
-    return result;
+    return nullptr;
   }
-  if (root->data_.first == key) {
-    result.first = root;
-    result.second = root;
-    return result;
+  if (tree_comparator(key_of(root->data_), key)) {
+    return recursive_find(root->right, key);
+  }
+  if (tree_comparator(key, key_of(root->data_))) {
+    return recursive_find(root->left, key);
+  }
+  return root;
+}
+
+// Looks keys up batch_width at a time, interleaved: each search takes one
+// step down the tree and prefetches the child it is heading for, then
+// yields to the next, so the misses of up to batch_width searches overlap
+// instead of being paid one level at a time. Each search works through its
+// own run of consecutive keys and reports visit(index, node) for each, with
+// nullptr when the key is absent. The descent is lower_bound's, so in a
+// multiset the first equal node is found. When the keys are sorted, a
+// search keeps its path and starts the next key from the deepest node
+// whose subtree can still hold it rather than from the root.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename Visit>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::find_batch(
+    const Key* keys, size_type count, Visit visit) const {
+  node* top = tree_root();
+  if (top == nullptr) {
+    for (size_type index = 0; index < count; ++index) {
+      visit(index, nullptr);
+    }
+    return;
+  }
+  bool sorted = true;
+  for (size_type index = 1; index < count && sorted; ++index) {
+    sorted = !tree_comparator(keys[index], keys[index - 1]);
+  }
+
+  struct search {
+    size_type next;
+    size_type stop;
+    node* current;
+    // Smallest node on the path so far not less than the key.
+    node* bound;
+    size_type depth;
+  };
+  // A path entry is a node and the bound on arriving at it; every key in
+  // the node's subtree is less than that bound.
+  struct step {
+    node* at;
+    node* bound;
+  };
+  size_type path_length = static_cast<size_type>(top->height) + 1;
+  size_type run = (count + batch_width - 1) / batch_width;
+  search searches[batch_width];
+  std::vector<step> paths(sorted ? batch_width * path_length : 0);
+  size_type active = 0;
+  for (size_type first = 0; first < count; first += run) {
+    searches[active++] = {first, std::min(first + run, count), top, nullptr,
+                          0};
+  }
+
+  while (active > 0) {
+    for (size_type slot = 0; slot < active;) {
+      search& current = searches[slot];
+      const Key& key = keys[current.next];
+      node* at = current.current;
+      if (sorted) {
+        paths[slot * path_length + current.depth++] = {at, current.bound};
+      }
+      node* child;
+      if (!tree_comparator(key_of(at->data_), key)) {
+        current.bound = at;
+        child = at->left;
+      } else {
+        child = at->right;
+      }
+      if (child != nullptr) {
+        __builtin_prefetch(child);
+        current.current = child;
+        ++slot;
+        continue;
+      }
+      node* found = current.bound;
+      if (found != nullptr && tree_comparator(key, key_of(found->data_))) {
+        found = nullptr;
+      }
+      visit(current.next, found);
+      if (++current.next == current.stop) {
+        // Retired; the last search moves into this slot, path and all.
+        --active;
+        if (slot != active) {
+          current = searches[active];
+          if (sorted) {
+            std::copy_n(paths.begin() + active * path_length,
+                        searches[active].depth,
+                        paths.begin() + slot * path_length);
+          }
+        }
+        continue;
+      }
+      if (!sorted) {
+        current.current = top;
+        current.bound = nullptr;
+      } else {
+        const Key& upcoming = keys[current.next];
+        const step* path = paths.data() + slot * path_length;
+        size_type depth = current.depth;
+        while (depth > 1 && path[depth - 1].bound != nullptr &&
+               !tree_comparator(upcoming,
+                                key_of(path[depth - 1].bound->data_))) {
+          --depth;
+        }
+        current.depth = depth - 1;
+        current.current = path[depth - 1].at;
+        current.bound = path[depth - 1].bound;
+      }
+      ++slot;
+    }
   }
-  if (tree_comparator(root->data_.first, key)) {
-    result = recursive_find(root->right, key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::tree_root() const {
+  node* result = root->left;
+  return result == static_cast<node*>(root) ? nullptr : result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+const Key& AVLtree<Key, Value, Comparator, Allocator, Augment>::key_of(
+    const value_type& data) {
+  if constexpr (std::is_void_v<Value>) {
+    return data;
   } else {
-    result = recursive_find(root->left, key);
+    return data.first;
   }
-  if (result.second == nullptr) {
-    result.first = root;
-    result.second = nullptr;
+}
+
+// Top-down search for the first node whose key is not less than key. bound
+// is returned when every key in the subtree is less than key.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::lower_bound_node(
+    node* node_ptr, node* bound, const K& key) const {
+  while (node_ptr != nullptr) {
+    if (!tree_comparator(key_of(node_ptr->data_), key)) {
+      bound = node_ptr;
+      node_ptr = node_ptr->left;
+    } else {
+      node_ptr = node_ptr->right;
+    }
   }
-  return result;
+  return bound;
+}
+
+// Top-down search for the first node whose key is greater than key.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::upper_bound_node(
+    node* node_ptr, node* bound, const K& key) const {
+  while (node_ptr != nullptr) {
+    if (tree_comparator(key, key_of(node_ptr->data_))) {
+      bound = node_ptr;
+      node_ptr = node_ptr->left;
+    } else {
+      node_ptr = node_ptr->right;
+    }
+  }
+  return bound;
+}
+
+// Descends until the first node equal to key, then finishes the lower bound
+// search in its left subtree and the upper bound search in its right one.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*,
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::equal_range_nodes(
+    const K& key) const {
+  node* node_ptr = tree_root();
+  node* bound = static_cast<node*>(root);
+  while (node_ptr != nullptr) {
+    if (tree_comparator(key_of(node_ptr->data_), key)) {
+      node_ptr = node_ptr->right;
+    } else if (tree_comparator(key, key_of(node_ptr->data_))) {
+      bound = node_ptr;
+      node_ptr = node_ptr->left;
+    } else {
+      return {lower_bound_node(node_ptr->left, node_ptr, key),
+              upper_bound_node(node_ptr->right, bound, key)};
+    }
+  }
+  return {bound, bound};
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::node*
-AVLtree<Key, Value, Comparator>::find_min(node* node_ptr) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::find_min(node* node_ptr) {
   if (!node_ptr) {
     return nullptr;
   }
   return node_ptr->left ? find_min(node_ptr->left) : node_ptr;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::node*
-AVLtree<Key, Value, Comparator>::find_max(node* node_ptr) {
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::find_max(node* node_ptr) {
   return node_ptr->right ? find_max(node_ptr->right) : node_ptr;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::node*
-AVLtree<Key, Value, Comparator>::remove_min(node* node_ptr) {
-  if (!node_ptr->left) {
-    return node_ptr->right;
-  }
-  node_ptr->left = remove_min(node_ptr->left);
-  balance(node_ptr);
-  return node_ptr;
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+inline void AVLtree<Key, Value, Comparator, Allocator, Augment>::link_adjacent(
+    node* lhs, node* rhs) {
+  lhs->next = rhs;
+  rhs->prev = lhs;
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename AVLtree<Key, Value, Comparator>::node*
-AVLtree<Key, Value, Comparator>::copy_tree(node* node_ptr, node* parent) {
+// Copies the subtree in order; last is the node copied just before it and is
+// threaded to each new node in turn.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::copy_tree(node* node_ptr,
+                                                               node* parent,
+                                                               node*& last) {
   if (!node_ptr) {
     return nullptr;
   }
-  node* new_node = new node(node_ptr->data_, parent);
-  new_node->left = copy_tree(node_ptr->left, new_node);
-  new_node->right = copy_tree(node_ptr->right, new_node);
+  node* new_node = create_node(parent, node_ptr->data_);
+  new_node->left = copy_tree(node_ptr->left, new_node, last);
+  link_adjacent(last, new_node);
+  last = new_node;
+  new_node->right = copy_tree(node_ptr->right, new_node, last);
+  set_height(new_node);
   return new_node;
 }
 
+// Links count sorted nodes into a perfectly balanced subtree: the middle node
+// becomes the root, so sibling subtree sizes differ by at most one.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::build_balanced(
+    node** nodes, size_type count, node* parent) {
+  if (count == 0) {
+    return nullptr;
+  }
+  size_type middle = count / 2;
+  node* subtree_root = nodes[middle];
+  subtree_root->parent_ = parent;
+  subtree_root->left = build_balanced(nodes, middle, subtree_root);
+  subtree_root->right =
+      build_balanced(nodes + middle + 1, count - middle - 1, subtree_root);
+  set_height(subtree_root);
+  return subtree_root;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::link_sorted(
+    node** nodes, size_type count) {
+  node* sentinel = static_cast<node*>(root);
+  node* last = sentinel;
+  for (size_type i = 0; i < count; ++i) {
+    link_adjacent(last, nodes[i]);
+    last = nodes[i];
+  }
+  link_adjacent(last, sentinel);
+  root->left =
+      count == 0 ? sentinel : build_balanced(nodes, count, sentinel);
+  size_ = count;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::vector<typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::flatten() {
+  std::vector<node*> nodes;
+  nodes.reserve(size_);
+  iterator pos = tree_begin();
+  for (size_type i = 0; i < size_; ++i, ++pos) {
+    nodes.push_back(pos.current_node);
+  }
+  return nodes;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::size_type
+AVLtree<Key, Value, Comparator, Allocator, Augment>::subtree_size(
+    const node* node_ptr) {
+  return node_ptr != nullptr ? node_ptr->subtree_size : 0;
+}
+
+// Descends by subtree sizes to the node at position index, or returns the
+// end sentinel when index is out of range.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::nth_node(
+    size_type index) const {
+  static_assert(counts_subtrees, "nth() needs the order_statistics augment");
+  if (index >= size_) {
+    return static_cast<node*>(root);
+  }
+  node* node_ptr = tree_root();
+  while (true) {
+    size_type left_size = subtree_size(node_ptr->left);
+    if (index < left_size) {
+      node_ptr = node_ptr->left;
+    } else if (index > left_size) {
+      index -= left_size + 1;
+      node_ptr = node_ptr->right;
+    } else {
+      return node_ptr;
+    }
+  }
+}
+
+// Counts keys less than key, or not greater than key when inclusive is set,
+// by adding up left subtree sizes along one root-to-leaf path.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::size_type
+AVLtree<Key, Value, Comparator, Allocator, Augment>::count_before(
+    const K& key, bool inclusive) const {
+  static_assert(counts_subtrees, "rank() needs the order_statistics augment");
+  size_type result = 0;
+  node* node_ptr = tree_root();
+  while (node_ptr != nullptr) {
+    bool before = inclusive ? !tree_comparator(key, key_of(node_ptr->data_))
+                            : tree_comparator(key_of(node_ptr->data_), key);
+    if (before) {
+      result += subtree_size(node_ptr->left) + 1;
+      node_ptr = node_ptr->right;
+    } else {
+      node_ptr = node_ptr->left;
+    }
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void AVLtree<Key, Value, Comparator, Allocator, Augment>::set_root(
+    node* new_root, size_type count) {
+  node* sentinel = static_cast<node*>(root);
+  if (new_root == nullptr) {
+    root->left = sentinel;
+    link_adjacent(sentinel, sentinel);
+  } else {
+    root->left = new_root;
+    new_root->parent_ = sentinel;
+    link_adjacent(sentinel, find_min(new_root));
+    link_adjacent(find_max(new_root), sentinel);
+  }
+  size_ = count;
+}
+
+// In-order successor inside a detached subtree whose root has no parent.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::next_in_subtree(
+    node* node_ptr) {
+  if (node_ptr->right != nullptr) {
+    return find_min(node_ptr->right);
+  }
+  while (node_ptr->parent_ != nullptr && node_ptr == node_ptr->parent_->right) {
+    node_ptr = node_ptr->parent_;
+  }
+  return node_ptr->parent_;
+}
+
+// Counts the nodes of lhs, where lhs and rhs hold total nodes together.
+// Both subtrees are walked in step, so the cost is bounded by the smaller.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::size_type
+AVLtree<Key, Value, Comparator, Allocator, Augment>::count_first(
+    node* lhs, node* rhs, size_type total) {
+  if constexpr (counts_subtrees) {
+    return subtree_size(lhs);
+  }
+  if (lhs != nullptr) {
+    lhs->parent_ = nullptr;
+  }
+  if (rhs != nullptr) {
+    rhs->parent_ = nullptr;
+  }
+  node* lhs_pos = find_min(lhs);
+  node* rhs_pos = find_min(rhs);
+  size_type steps = 0;
+  while (lhs_pos != nullptr && rhs_pos != nullptr) {
+    lhs_pos = next_in_subtree(lhs_pos);
+    rhs_pos = next_in_subtree(rhs_pos);
+    ++steps;
+  }
+  return lhs_pos == nullptr ? steps : total - steps;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::size_type
+AVLtree<Key, Value, Comparator, Allocator, Augment>::destroy_counted(
+    node* node_ptr) {
+  if (node_ptr == nullptr) {
+    return 0;
+  }
+  size_type count = destroy_counted(node_ptr->left) +
+                    destroy_counted(node_ptr->right) + 1;
+  destroy_node(node_ptr);
+  return count;
+}
+
+// Links less < middle < greater into one AVL tree. The taller side is
+// descended along its inner spine until the heights are within one, middle
+// joins there and the spine is rebalanced on the way back up, so the cost
+// is O(|height difference| + 1). Parent links of the result are left to the
+// caller.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::join_nodes(node* less,
+                                                                node* middle,
+                                                                node* greater) {
+  int less_height = get_height(less);
+  int greater_height = get_height(greater);
+  if (less_height > greater_height + 1) {
+    node* joined = join_nodes(less->right, middle, greater);
+    less->right = joined;
+    joined->parent_ = less;
+    set_height(less);
+    balance(less);
+    return less;
+  }
+  if (greater_height > less_height + 1) {
+    node* joined = join_nodes(less, middle, greater->left);
+    greater->left = joined;
+    joined->parent_ = greater;
+    set_height(greater);
+    balance(greater);
+    return greater;
+  }
+  middle->left = less;
+  middle->right = greater;
+  if (less != nullptr) {
+    less->parent_ = middle;
+  }
+  if (greater != nullptr) {
+    greater->parent_ = middle;
+  }
+  set_height(middle);
+  return middle;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::join_pair(node* less,
+                                                               node* greater) {
+  if (less == nullptr) {
+    return greater;
+  }
+  std::pair<node*, node*> lower = split_last(less);
+  return join_nodes(lower.first, lower.second, greater);
+}
+
+// Splitting never reorders a piece, so the threads inside each piece stay
+// valid and only the seams between pieces joined out of order, like the
+// two sides of an erased range or the results of set algebra, need
+// relinking. The extremes are found by descent, which adds O(log n) to a
+// join of the same order.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::join_threaded(
+    node* less, node* middle, node* greater) {
+  if (less != nullptr) {
+    link_adjacent(find_max(less), middle);
+  }
+  if (greater != nullptr) {
+    link_adjacent(middle, find_min(greater));
+  }
+  return join_nodes(less, middle, greater);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::join_pair_threaded(
+    node* less, node* greater) {
+  if (less != nullptr && greater != nullptr) {
+    link_adjacent(find_max(less), find_min(greater));
+  }
+  return join_pair(less, greater);
+}
+
+// Detaches the maximum of a subtree: returns the rest and the lone node.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*,
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::split_last(
+    node* node_ptr) {
+  node* less = node_ptr->left;
+  if (node_ptr->right == nullptr) {
+    return {less, reset_node(node_ptr, nullptr)};
+  }
+  std::pair<node*, node*> lower = split_last(node_ptr->right);
+  reset_node(node_ptr, nullptr);
+  return {join_nodes(less, node_ptr, lower.first), lower.second};
+}
+
+// Splits a subtree into the keys less than key, the node equal to key (or
+// nullptr) and the keys greater than key in O(log n).
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::split_parts
+AVLtree<Key, Value, Comparator, Allocator, Augment>::split_nodes(
+    node* node_ptr, const Key& key) {
+  if (node_ptr == nullptr) {
+    return {nullptr, nullptr, nullptr};
+  }
+  node* less = node_ptr->left;
+  node* greater = node_ptr->right;
+  if (tree_comparator(key, key_of(node_ptr->data_))) {
+    split_parts parts = split_nodes(less, key);
+    parts.greater = join_nodes(parts.greater, node_ptr, greater);
+    return parts;
+  }
+  if (tree_comparator(key_of(node_ptr->data_), key)) {
+    split_parts parts = split_nodes(greater, key);
+    parts.less = join_nodes(less, node_ptr, parts.less);
+    return parts;
+  }
+  return {less, reset_node(node_ptr, nullptr), greater};
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool AVLtree<Key, Value, Comparator, Allocator, Augment>::worth_forking(
+    const node* lhs, const node* rhs, unsigned forks) {
+  return forks > 1 && lhs != nullptr && rhs != nullptr &&
+         std::min(lhs->height, rhs->height) >= parallel_height;
+}
+
+// Runs less() here and greater() on another thread when parallel is set.
+// If no thread can be started both run here.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename Less, typename Greater>
+std::pair<
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*,
+    typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*>
+AVLtree<Key, Value, Comparator, Allocator, Augment>::fork(bool parallel,
+                                                          Less less,
+                                                          Greater greater) {
+  std::future<node*> pending;
+  if (parallel) {
+    try {
+      pending = std::async(std::launch::async, greater);
+    } catch (const std::system_error&) {
+    }
+  }
+  node* less_result = less();
+  node* greater_result = pending.valid() ? pending.get() : greater();
+  return {less_result, greater_result};
+}
+
+// Keys of rhs equal to a key of lhs are pushed to discarded.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::union_nodes(
+    node* lhs, node* rhs, std::vector<node*>& discarded, unsigned forks) {
+  if (lhs == nullptr) {
+    return rhs;
+  }
+  if (rhs == nullptr) {
+    return lhs;
+  }
+  node* lhs_less = lhs->left;
+  node* lhs_greater = lhs->right;
+  bool parallel = worth_forking(lhs, rhs, forks);
+  split_parts parts = split_nodes(rhs, key_of(lhs->data_));
+  if (parts.equal != nullptr) {
+    discarded.push_back(parts.equal);
+  }
+  unsigned child_forks = parallel ? forks / 2 : forks;
+  std::vector<node*> greater_discarded;
+  std::pair<node*, node*> halves = fork(
+      parallel,
+      [&] {
+        return union_nodes(lhs_less, parts.less, discarded, child_forks);
+      },
+      [&] {
+        return union_nodes(lhs_greater, parts.greater, greater_discarded,
+                           child_forks);
+      });
+  discarded.insert(discarded.end(), greater_discarded.begin(),
+                   greater_discarded.end());
+  return join_threaded(halves.first, lhs, halves.second);
+}
+
+// Roots of lhs subtrees that have no match in rhs are pushed to discarded.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::intersection_nodes(
+    node* lhs, const node* rhs, std::vector<node*>& discarded, unsigned forks) {
+  if (lhs == nullptr) {
+    return nullptr;
+  }
+  if (rhs == nullptr) {
+    discarded.push_back(lhs);
+    return nullptr;
+  }
+  bool parallel = worth_forking(lhs, rhs, forks);
+  split_parts parts = split_nodes(lhs, key_of(rhs->data_));
+  unsigned child_forks = parallel ? forks / 2 : forks;
+  std::vector<node*> greater_discarded;
+  std::pair<node*, node*> halves = fork(
+      parallel,
+      [&] {
+        return intersection_nodes(parts.less, rhs->left, discarded,
+                                  child_forks);
+      },
+      [&] {
+        return intersection_nodes(parts.greater, rhs->right,
+                                  greater_discarded, child_forks);
+      });
+  discarded.insert(discarded.end(), greater_discarded.begin(),
+                   greater_discarded.end());
+  if (parts.equal != nullptr) {
+    return join_threaded(halves.first, parts.equal, halves.second);
+  }
+  return join_pair_threaded(halves.first, halves.second);
+}
+
+// Nodes of lhs whose key is in rhs are pushed to discarded.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename AVLtree<Key, Value, Comparator, Allocator, Augment>::node*
+AVLtree<Key, Value, Comparator, Allocator, Augment>::difference_nodes(
+    node* lhs, const node* rhs, std::vector<node*>& discarded, unsigned forks) {
+  if (lhs == nullptr || rhs == nullptr) {
+    return lhs;
+  }
+  bool parallel = worth_forking(lhs, rhs, forks);
+  split_parts parts = split_nodes(lhs, key_of(rhs->data_));
+  if (parts.equal != nullptr) {
+    discarded.push_back(parts.equal);
+  }
+  unsigned child_forks = parallel ? forks / 2 : forks;
+  std::vector<node*> greater_discarded;
+  std::pair<node*, node*> halves = fork(
+      parallel,
+      [&] {
+        return difference_nodes(parts.less, rhs->left, discarded, child_forks);
+      },
+      [&] {
+        return difference_nodes(parts.greater, rhs->right, greater_discarded,
+                                child_forks);
+      });
+  discarded.insert(discarded.end(), greater_discarded.begin(),
+                   greater_discarded.end());
+  return join_pair_threaded(halves.first, halves.second);
+}
+
 }  // namespace s21
 
 #endif
\ No newline at end of file
@@ -0,0 +1,1495 @@
+#ifndef S21_SRC_BTREE_H
+#define S21_SRC_BTREE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "AVLtree.h"
+
+namespace s21 {
+
+// B-tree backend for btree_map, btree_set and btree_multiset. Every node is
+// one allocation holding up to capacity elements inline, sized and aligned
+// to whole cache lines, so a lookup touches one or two lines per level
+// instead of one node per comparison. Elements live in the nodes themselves:
+// any insert or erase may move other elements and invalidates iterators.
+template <typename Key, typename Value, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, Value>>>
+class Btree {
+ protected:
+  struct node;
+  struct internal_node;
+  using leaf_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<node>;
+  using internal_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<internal_node>;
+  using leaf_traits = std::allocator_traits<leaf_allocator>;
+  using internal_traits = std::allocator_traits<internal_allocator>;
+  // Elements are staged in this form while sorting and rebuilding, because
+  // value_type cannot be assigned to.
+  using mutable_value = std::pair<Key, Value>;
+
+ public:
+  using value_type = std::pair<const Key, Value>;
+  using value_reference = value_type&;
+  using const_reference = const value_type&;
+  using value_pointer = value_type*;
+  using const_pointer = const value_type*;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  class iterator {
+   public:
+    friend Btree;
+    iterator();
+    iterator(node* node_ptr, size_type index);
+
+    iterator& operator++();
+    iterator operator++(int);
+    iterator& operator--();
+    iterator operator--(int);
+
+    bool operator!=(const iterator& other) const;
+    bool operator==(const iterator& other) const;
+
+    value_reference operator*();
+    value_pointer operator->();
+
+   protected:
+    node* current_node;
+    size_type position;
+  };
+
+  class const_iterator {
+   public:
+    friend Btree;
+    const_iterator();
+    const_iterator(node* node_ptr, size_type index);
+
+    const_iterator& operator++();
+    const_iterator operator++(int);
+    const_iterator& operator--();
+    const_iterator operator--(int);
+
+    bool operator!=(const const_iterator& other) const;
+    bool operator==(const const_iterator& other) const;
+
+    const_reference operator*();
+    const_pointer operator->();
+
+   protected:
+    node* current_node;
+    size_type position;
+  };
+
+  Btree();
+  Btree(const Btree& other);
+  Btree(Btree&& other) noexcept;
+  ~Btree();
+  Btree& operator=(const Btree& other);
+  Btree& operator=(Btree&& other) noexcept;
+
+  iterator tree_insert(const_reference value);
+  iterator tree_insert(value_type&& value);
+  template <typename... Args>
+  iterator tree_emplace(Args&&... args);
+  std::pair<iterator, bool> tree_unique_insert(const_reference value);
+  std::pair<iterator, bool> tree_unique_insert(value_type&& value);
+  std::pair<iterator, bool> tree_unique_insert(const Key& key,
+                                               const Value& obj);
+  template <typename... Args>
+  std::pair<iterator, bool> tree_unique_emplace(Args&&... args);
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> tree_try_emplace(K&& key, Args&&... args);
+  std::pair<iterator, bool> tree_insert_or_assign(const Key& key,
+                                                  const Value& obj);
+  Value& at(const Key& key);
+  Value& operator[](const Key& key);
+  Value& operator[](Key&& key);
+  void tree_erase(iterator pos);
+  void tree_clear();
+  template <typename InputIt, typename Maker>
+  void tree_assign(InputIt first, InputIt last, bool unique, Maker make_value);
+  void tree_merge(Btree& other);
+  void tree_merge_unique(Btree& other);
+  void tree_swap(Btree& other) noexcept;
+  iterator tree_find(const Key& key);
+  bool tree_contains(const Key& key) const;
+  size_type tree_count(const Key& key) const;
+  const_iterator tree_lower_bound(const Key& key) const;
+  const_iterator tree_upper_bound(const Key& key) const;
+  iterator tree_lower_bound(const Key& key);
+  iterator tree_upper_bound(const Key& key);
+  std::pair<iterator, iterator> tree_equal_range(const Key& key);
+  size_type tree_size() const;
+  size_type tree_max_size() const;
+  bool tree_empty() const;
+  iterator tree_begin();
+  const_iterator const_tree_begin() const;
+  iterator tree_end();
+  const_iterator const_tree_end() const;
+  allocator_type get_allocator() const;
+
+ protected:
+  // Node size the capacity is derived from: four cache lines for leaves.
+  static constexpr size_type node_bytes = 256;
+  static constexpr size_type cache_line = 64;
+  static constexpr size_type header_bytes =
+      (sizeof(void*) + 3 + alignof(value_type) - 1) / alignof(value_type) *
+      alignof(value_type);
+  static constexpr size_type capacity = std::clamp<size_type>(
+      node_bytes > header_bytes ? (node_bytes - header_bytes) /
+                                      sizeof(value_type)
+                                : 0,
+      3, std::numeric_limits<std::uint8_t>::max() - 1);
+  // Erase refills nodes that drop below this by merging or borrowing.
+  static constexpr size_type min_count = (capacity - 1) / 2;
+
+  struct alignas(cache_line) node {
+    node* parent;
+    std::uint8_t position;
+    std::uint8_t count;
+    bool leaf;
+    std::aligned_storage_t<sizeof(value_type), alignof(value_type)>
+        slots[capacity];
+
+    value_type* value(size_type index);
+    node*& child(size_type index);
+  };
+
+  struct internal_node : node {
+    node* children[capacity + 1];
+  };
+
+  node* create_node(bool leaf, node* parent, size_type position);
+  void destroy_node(node* node_ptr);
+  template <typename... Args>
+  void construct_value(value_type* slot, Args&&... args);
+  void destroy_value(value_type* slot);
+  void move_values(node* dst, size_type dst_index, node* src,
+                   size_type src_index, size_type count);
+  static void move_children(node* dst, size_type dst_index, node* src,
+                            size_type src_index, size_type count);
+  static void next_position(node*& node_ptr, size_type& index);
+  static void prev_position(node*& node_ptr, size_type& index);
+
+  size_type lower_index(node* node_ptr, const Key& key) const;
+  size_type upper_index(node* node_ptr, const Key& key) const;
+  std::pair<node*, size_type> find_position(const Key& key) const;
+  std::pair<node*, size_type> lower_bound_position(const Key& key) const;
+  std::pair<node*, size_type> upper_bound_position(const Key& key) const;
+  std::pair<node*, size_type> end_position() const;
+
+  template <typename... Args>
+  std::pair<iterator, bool> unique_emplace_key(const Key& key,
+                                               Args&&... args);
+  template <typename... Args>
+  iterator multi_emplace_key(const Key& key, Args&&... args);
+  template <typename... Args>
+  iterator insert_value(node* node_ptr, size_type index, Args&&... args);
+  void split_node(node*& node_ptr, size_type& index);
+  void erase_at(node* node_ptr, size_type index);
+  void rebalance(node* node_ptr);
+  void merge_children(node* parent, size_type index);
+  void shift_right(node* left, node* right, size_type count);
+  void shift_left(node* left, node* right, size_type count);
+
+  node* copy_node(node* other, node* parent, size_type position);
+  void destroy(node* node_ptr);
+  void destroy_all();
+  void drain(node* node_ptr, std::vector<mutable_value>& out);
+  void drain_all(std::vector<mutable_value>& out);
+  void build_sorted(mutable_value* items, size_type count);
+  node* build_level(mutable_value*& items, size_type count, size_type level,
+                    const std::vector<size_type>& level_sizes, node* parent,
+                    size_type position);
+  void reset_edges();
+  void merge_values(Btree& other, bool unique);
+
+  node* root_;
+  node* leftmost_;
+  node* rightmost_;
+  size_type size_;
+  Comparator tree_comparator;
+  leaf_allocator leaf_allocator_;
+  internal_allocator internal_allocator_;
+};
+
+//----Btree-logic-----//
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Btree<Key, Value, Comparator, Allocator>::Btree()
+    : root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), size_(0) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Btree<Key, Value, Comparator, Allocator>::Btree(const Btree& other)
+    : Btree() {
+  leaf_allocator_ =
+      leaf_traits::select_on_container_copy_construction(other.leaf_allocator_);
+  internal_allocator_ = internal_traits::select_on_container_copy_construction(
+      other.internal_allocator_);
+  tree_comparator = other.tree_comparator;
+  if (other.root_ != nullptr) {
+    root_ = copy_node(other.root_, nullptr, 0);
+    size_ = other.size_;
+    reset_edges();
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Btree<Key, Value, Comparator, Allocator>::Btree(Btree&& other) noexcept
+    : Btree() {
+  tree_swap(other);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Btree<Key, Value, Comparator, Allocator>::~Btree() {
+  destroy_all();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Btree<Key, Value, Comparator, Allocator>&
+Btree<Key, Value, Comparator, Allocator>::operator=(const Btree& other) {
+  if (this != &other) {
+    Btree copy(other);
+    tree_swap(copy);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Btree<Key, Value, Comparator, Allocator>&
+Btree<Key, Value, Comparator, Allocator>::operator=(Btree&& other) noexcept {
+  if (this != &other) {
+    tree_clear();
+    tree_swap(other);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::tree_swap(
+    Btree& other) noexcept {
+  std::swap(root_, other.root_);
+  std::swap(leftmost_, other.leftmost_);
+  std::swap(rightmost_, other.rightmost_);
+  std::swap(size_, other.size_);
+  std::swap(tree_comparator, other.tree_comparator);
+  std::swap(leaf_allocator_, other.leaf_allocator_);
+  std::swap(internal_allocator_, other.internal_allocator_);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::tree_insert(const_reference value) {
+  return multi_emplace_key(value.first, value);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::tree_insert(value_type&& value) {
+  return multi_emplace_key(value.first, std::move(value));
+}
+
+// The key is only known once the element exists, so it is built on the
+// stack first and moved into its slot.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename... Args>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::tree_emplace(Args&&... args) {
+  mutable_value staged(std::forward<Args>(args)...);
+  return multi_emplace_key(staged.first, std::move(staged.first),
+                           std::move(staged.second));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::iterator, bool>
+Btree<Key, Value, Comparator, Allocator>::tree_unique_insert(
+    const_reference value) {
+  return unique_emplace_key(value.first, value);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::iterator, bool>
+Btree<Key, Value, Comparator, Allocator>::tree_unique_insert(
+    value_type&& value) {
+  return unique_emplace_key(value.first, std::move(value));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::iterator, bool>
+Btree<Key, Value, Comparator, Allocator>::tree_unique_insert(
+    const Key& key, const Value& obj) {
+  return unique_emplace_key(key, key, obj);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename... Args>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::iterator, bool>
+Btree<Key, Value, Comparator, Allocator>::tree_unique_emplace(
+    Args&&... args) {
+  mutable_value staged(std::forward<Args>(args)...);
+  return unique_emplace_key(staged.first, std::move(staged.first),
+                            std::move(staged.second));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename K, typename... Args>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::iterator, bool>
+Btree<Key, Value, Comparator, Allocator>::tree_try_emplace(K&& key,
+                                                           Args&&... args) {
+  return unique_emplace_key(
+      key, std::piecewise_construct,
+      std::forward_as_tuple(std::forward<K>(key)),
+      std::forward_as_tuple(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::iterator, bool>
+Btree<Key, Value, Comparator, Allocator>::tree_insert_or_assign(
+    const Key& key, const Value& obj) {
+  std::pair<iterator, bool> result = tree_try_emplace(key, obj);
+  if (result.second == false) {
+    result.first->second = obj;
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Value& Btree<Key, Value, Comparator, Allocator>::at(const Key& key) {
+  std::pair<node*, size_type> found = find_position(key);
+  if (found.first == nullptr) {
+    throw std::out_of_range("There is no element with this key");
+  }
+  return found.first->value(found.second)->second;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Value& Btree<Key, Value, Comparator, Allocator>::operator[](const Key& key) {
+  return tree_try_emplace(key).first->second;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Value& Btree<Key, Value, Comparator, Allocator>::operator[](Key&& key) {
+  return tree_try_emplace(std::move(key)).first->second;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::tree_erase(iterator pos) {
+  erase_at(pos.current_node, pos.position);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::tree_clear() {
+  destroy_all();
+  root_ = nullptr;
+  leftmost_ = nullptr;
+  rightmost_ = nullptr;
+  size_ = 0;
+}
+
+// Replaces the contents with [first, last). make_value(emplace, item) calls
+// emplace with the constructor arguments of value_type for one element. The
+// elements are staged and stable-sorted unless already in order, so the
+// first of several equal keys wins when unique is set, and the tree is then
+// packed bottom-up in O(n).
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename InputIt, typename Maker>
+void Btree<Key, Value, Comparator, Allocator>::tree_assign(InputIt first,
+                                                          InputIt last,
+                                                          bool unique,
+                                                          Maker make_value) {
+  std::vector<mutable_value> items;
+  auto emplace = [&items](auto&&... args) {
+    items.emplace_back(std::forward<decltype(args)>(args)...);
+  };
+  for (; first != last; ++first) {
+    make_value(emplace, *first);
+  }
+
+  auto less = [this](const mutable_value& lhs, const mutable_value& rhs) {
+    return tree_comparator(lhs.first, rhs.first);
+  };
+  if (!std::is_sorted(items.begin(), items.end(), less)) {
+    std::stable_sort(items.begin(), items.end(), less);
+  }
+  if (unique) {
+    items.erase(std::unique(items.begin(), items.end(),
+                            [&less](const mutable_value& lhs,
+                                    const mutable_value& rhs) {
+                              return !less(lhs, rhs);
+                            }),
+                items.end());
+  }
+
+  Btree built;
+  built.tree_comparator = tree_comparator;
+  built.leaf_allocator_ =
+      leaf_traits::select_on_container_copy_construction(leaf_allocator_);
+  built.internal_allocator_ =
+      internal_traits::select_on_container_copy_construction(
+          internal_allocator_);
+  built.build_sorted(items.data(), items.size());
+  tree_swap(built);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::tree_merge(Btree& other) {
+  merge_values(other, false);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::tree_merge_unique(
+    Btree& other) {
+  merge_values(other, true);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::tree_find(const Key& key) {
+  std::pair<node*, size_type> found = find_position(key);
+  return found.first != nullptr ? iterator(found.first, found.second)
+                                : tree_end();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+bool Btree<Key, Value, Comparator, Allocator>::tree_contains(
+    const Key& key) const {
+  return find_position(key).first != nullptr;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::size_type
+Btree<Key, Value, Comparator, Allocator>::tree_count(const Key& key) const {
+  std::pair<node*, size_type> first = lower_bound_position(key);
+  std::pair<node*, size_type> last = upper_bound_position(key);
+  size_type result = 0;
+  while (first != last) {
+    next_position(first.first, first.second);
+    ++result;
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::const_iterator
+Btree<Key, Value, Comparator, Allocator>::tree_lower_bound(
+    const Key& key) const {
+  std::pair<node*, size_type> found = lower_bound_position(key);
+  return const_iterator(found.first, found.second);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::const_iterator
+Btree<Key, Value, Comparator, Allocator>::tree_upper_bound(
+    const Key& key) const {
+  std::pair<node*, size_type> found = upper_bound_position(key);
+  return const_iterator(found.first, found.second);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::tree_lower_bound(const Key& key) {
+  std::pair<node*, size_type> found = lower_bound_position(key);
+  return iterator(found.first, found.second);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::tree_upper_bound(const Key& key) {
+  std::pair<node*, size_type> found = upper_bound_position(key);
+  return iterator(found.first, found.second);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::iterator,
+          typename Btree<Key, Value, Comparator, Allocator>::iterator>
+Btree<Key, Value, Comparator, Allocator>::tree_equal_range(const Key& key) {
+  return {tree_lower_bound(key), tree_upper_bound(key)};
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::size_type
+Btree<Key, Value, Comparator, Allocator>::tree_size() const {
+  return size_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::size_type
+Btree<Key, Value, Comparator, Allocator>::tree_max_size() const {
+  return (std::numeric_limits<size_type>::max() - sizeof(Btree)) /
+         sizeof(value_type);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+bool Btree<Key, Value, Comparator, Allocator>::tree_empty() const {
+  return size_ == 0;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::tree_begin() {
+  return iterator(leftmost_, 0);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::const_iterator
+Btree<Key, Value, Comparator, Allocator>::const_tree_begin() const {
+  return const_iterator(leftmost_, 0);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::tree_end() {
+  std::pair<node*, size_type> last = end_position();
+  return iterator(last.first, last.second);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::const_iterator
+Btree<Key, Value, Comparator, Allocator>::const_tree_end() const {
+  std::pair<node*, size_type> last = end_position();
+  return const_iterator(last.first, last.second);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::allocator_type
+Btree<Key, Value, Comparator, Allocator>::get_allocator() const {
+  return allocator_type(leaf_allocator_);
+}
+
+//----node-logic-----//
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::value_type*
+Btree<Key, Value, Comparator, Allocator>::node::value(size_type index) {
+  return std::launder(reinterpret_cast<value_type*>(&slots[index]));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::node*&
+Btree<Key, Value, Comparator, Allocator>::node::child(size_type index) {
+  return static_cast<internal_node*>(this)->children[index];
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::node*
+Btree<Key, Value, Comparator, Allocator>::create_node(bool leaf, node* parent,
+                                                      size_type position) {
+  node* result;
+  if (leaf) {
+    result = ::new (static_cast<void*>(leaf_traits::allocate(
+        leaf_allocator_, 1))) node;
+  } else {
+    result = ::new (static_cast<void*>(internal_traits::allocate(
+        internal_allocator_, 1))) internal_node;
+  }
+  result->parent = parent;
+  result->position = static_cast<std::uint8_t>(position);
+  result->count = 0;
+  result->leaf = leaf;
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::destroy_node(node* node_ptr) {
+  if (node_ptr->leaf) {
+    leaf_traits::deallocate(leaf_allocator_, node_ptr, 1);
+  } else {
+    internal_traits::deallocate(internal_allocator_,
+                                static_cast<internal_node*>(node_ptr), 1);
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename... Args>
+void Btree<Key, Value, Comparator, Allocator>::construct_value(
+    value_type* slot, Args&&... args) {
+  leaf_traits::construct(leaf_allocator_, slot, std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::destroy_value(
+    value_type* slot) {
+  leaf_traits::destroy(leaf_allocator_, slot);
+}
+
+// Relocates count elements between slots; the ranges may overlap inside one
+// node. Trivially copyable elements are moved as raw bytes. The key is moved
+// out through const_cast because its source slot is destroyed right after.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::move_values(
+    node* dst, size_type dst_index, node* src, size_type src_index,
+    size_type count) {
+  if (count == 0) {
+    return;
+  }
+  if constexpr (std::is_trivially_copyable_v<Key> &&
+                std::is_trivially_copyable_v<Value>) {
+    std::memmove(static_cast<void*>(&dst->slots[dst_index]),
+                 &src->slots[src_index], count * sizeof(value_type));
+  } else {
+    auto relocate = [this, dst, dst_index, src, src_index](size_type offset) {
+      value_type* from = src->value(src_index + offset);
+      construct_value(dst->value(dst_index + offset),
+                      std::move(const_cast<Key&>(from->first)),
+                      std::move(from->second));
+      destroy_value(from);
+    };
+    if (dst == src && dst_index > src_index) {
+      for (size_type offset = count; offset > 0; --offset) {
+        relocate(offset - 1);
+      }
+    } else {
+      for (size_type offset = 0; offset < count; ++offset) {
+        relocate(offset);
+      }
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::move_children(
+    node* dst, size_type dst_index, node* src, size_type src_index,
+    size_type count) {
+  if (count == 0) {
+    return;
+  }
+  std::memmove(&dst->child(dst_index), &src->child(src_index),
+               count * sizeof(node*));
+  for (size_type index = dst_index; index < dst_index + count; ++index) {
+    dst->child(index)->parent = dst;
+    dst->child(index)->position = static_cast<std::uint8_t>(index);
+  }
+}
+
+// In-order successor: the leftmost leaf of the next subtree, or the first
+// ancestor that still has an element to the right. Past the last element
+// the position stays at the end of the rightmost leaf, which is end().
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::next_position(
+    node*& node_ptr, size_type& index) {
+  if (!node_ptr->leaf) {
+    node_ptr = node_ptr->child(index + 1);
+    while (!node_ptr->leaf) {
+      node_ptr = node_ptr->child(0);
+    }
+    index = 0;
+    return;
+  }
+  if (++index < node_ptr->count) {
+    return;
+  }
+  node* last_leaf = node_ptr;
+  size_type last_index = index;
+  while (node_ptr->parent != nullptr && index == node_ptr->count) {
+    index = node_ptr->position;
+    node_ptr = node_ptr->parent;
+  }
+  if (index == node_ptr->count) {
+    node_ptr = last_leaf;
+    index = last_index;
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::prev_position(
+    node*& node_ptr, size_type& index) {
+  if (!node_ptr->leaf) {
+    node_ptr = node_ptr->child(index);
+    while (!node_ptr->leaf) {
+      node_ptr = node_ptr->child(node_ptr->count);
+    }
+    index = node_ptr->count - 1;
+    return;
+  }
+  while (node_ptr->parent != nullptr && index == 0) {
+    index = node_ptr->position;
+    node_ptr = node_ptr->parent;
+  }
+  --index;
+}
+
+// Branch-free binary search over one node: the loop always runs
+// log2(count) steps and the comparison only selects the next base, which
+// compiles to a conditional move instead of a mispredicted jump.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::size_type
+Btree<Key, Value, Comparator, Allocator>::lower_index(node* node_ptr,
+                                                      const Key& key) const {
+  size_type length = node_ptr->count;
+  if (length == 0) {
+    return 0;
+  }
+  value_type* first = node_ptr->value(0);
+  value_type* base = first;
+  while (length > 1) {
+    size_type half = length / 2;
+    base = tree_comparator(base[half].first, key) ? base + half : base;
+    length -= half;
+  }
+  return static_cast<size_type>(base - first) +
+         tree_comparator(base->first, key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::size_type
+Btree<Key, Value, Comparator, Allocator>::upper_index(node* node_ptr,
+                                                      const Key& key) const {
+  size_type length = node_ptr->count;
+  if (length == 0) {
+    return 0;
+  }
+  value_type* first = node_ptr->value(0);
+  value_type* base = first;
+  while (length > 1) {
+    size_type half = length / 2;
+    base = !tree_comparator(key, base[half].first) ? base + half : base;
+    length -= half;
+  }
+  return static_cast<size_type>(base - first) +
+         !tree_comparator(key, base->first);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::node*,
+          typename Btree<Key, Value, Comparator, Allocator>::size_type>
+Btree<Key, Value, Comparator, Allocator>::find_position(
+    const Key& key) const {
+  node* node_ptr = root_;
+  while (node_ptr != nullptr) {
+    size_type index = lower_index(node_ptr, key);
+    if (index < node_ptr->count &&
+        !tree_comparator(key, node_ptr->value(index)->first)) {
+      return {node_ptr, index};
+    }
+    node_ptr = node_ptr->leaf ? nullptr : node_ptr->child(index);
+  }
+  return {nullptr, 0};
+}
+
+// Descends to a leaf remembering the last position that is not less than
+// key; deeper candidates always precede the ones above them.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::node*,
+          typename Btree<Key, Value, Comparator, Allocator>::size_type>
+Btree<Key, Value, Comparator, Allocator>::lower_bound_position(
+    const Key& key) const {
+  std::pair<node*, size_type> result = end_position();
+  node* node_ptr = root_;
+  while (node_ptr != nullptr) {
+    size_type index = lower_index(node_ptr, key);
+    if (index < node_ptr->count) {
+      result = {node_ptr, index};
+    }
+    node_ptr = node_ptr->leaf ? nullptr : node_ptr->child(index);
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::node*,
+          typename Btree<Key, Value, Comparator, Allocator>::size_type>
+Btree<Key, Value, Comparator, Allocator>::upper_bound_position(
+    const Key& key) const {
+  std::pair<node*, size_type> result = end_position();
+  node* node_ptr = root_;
+  while (node_ptr != nullptr) {
+    size_type index = upper_index(node_ptr, key);
+    if (index < node_ptr->count) {
+      result = {node_ptr, index};
+    }
+    node_ptr = node_ptr->leaf ? nullptr : node_ptr->child(index);
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::node*,
+          typename Btree<Key, Value, Comparator, Allocator>::size_type>
+Btree<Key, Value, Comparator, Allocator>::end_position() const {
+  return {rightmost_, rightmost_ != nullptr ? rightmost_->count : 0};
+}
+
+// Nothing is constructed unless the key is absent: the element is built in
+// its leaf slot from args once the search has failed.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename... Args>
+std::pair<typename Btree<Key, Value, Comparator, Allocator>::iterator, bool>
+Btree<Key, Value, Comparator, Allocator>::unique_emplace_key(
+    const Key& key, Args&&... args) {
+  if (root_ == nullptr) {
+    root_ = leftmost_ = rightmost_ = create_node(true, nullptr, 0);
+  }
+  node* node_ptr = root_;
+  while (true) {
+    size_type index = lower_index(node_ptr, key);
+    if (index < node_ptr->count &&
+        !tree_comparator(key, node_ptr->value(index)->first)) {
+      return {iterator(node_ptr, index), false};
+    }
+    if (node_ptr->leaf) {
+      return {insert_value(node_ptr, index, std::forward<Args>(args)...),
+              true};
+    }
+    node_ptr = node_ptr->child(index);
+  }
+}
+
+// Equal keys keep their insertion order: the new element goes after them.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename... Args>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::multi_emplace_key(const Key& key,
+                                                           Args&&... args) {
+  if (root_ == nullptr) {
+    root_ = leftmost_ = rightmost_ = create_node(true, nullptr, 0);
+  }
+  node* node_ptr = root_;
+  while (true) {
+    size_type index = upper_index(node_ptr, key);
+    if (node_ptr->leaf) {
+      return insert_value(node_ptr, index, std::forward<Args>(args)...);
+    }
+    node_ptr = node_ptr->child(index);
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename... Args>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::insert_value(node* node_ptr,
+                                                      size_type index,
+                                                      Args&&... args) {
+  if (node_ptr->count == capacity) {
+    split_node(node_ptr, index);
+  }
+  move_values(node_ptr, index + 1, node_ptr, index, node_ptr->count - index);
+  try {
+    construct_value(node_ptr->value(index), std::forward<Args>(args)...);
+  } catch (...) {
+    move_values(node_ptr, index, node_ptr, index + 1,
+                node_ptr->count - index);
+    throw;
+  }
+  ++node_ptr->count;
+  ++size_;
+  return iterator(node_ptr, index);
+}
+
+// Makes room for one element at index in the full node_ptr by moving its
+// upper part into a new right sibling and its median into the parent,
+// splitting the parent first when that is full too. node_ptr and index are
+// updated to where the new element belongs. Appends at either end leave the
+// old node nearly full, so sorted input packs the leaves densely.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::split_node(node*& node_ptr,
+                                                          size_type& index) {
+  if (node_ptr->parent == nullptr) {
+    root_ = create_node(false, nullptr, 0);
+    root_->child(0) = node_ptr;
+    node_ptr->parent = root_;
+    node_ptr->position = 0;
+  } else if (node_ptr->parent->count == capacity) {
+    node* parent = node_ptr->parent;
+    size_type parent_index = node_ptr->position;
+    split_node(parent, parent_index);
+  }
+
+  size_type count = node_ptr->count;
+  size_type median = index == count ? count - 1 : index == 0 ? 1 : count / 2;
+  node* parent = node_ptr->parent;
+  size_type position = node_ptr->position;
+  node* sibling = create_node(node_ptr->leaf, parent, position + 1);
+  move_values(sibling, 0, node_ptr, median + 1, count - median - 1);
+  if (!node_ptr->leaf) {
+    move_children(sibling, 0, node_ptr, median + 1, count - median);
+  }
+  sibling->count = static_cast<std::uint8_t>(count - median - 1);
+  node_ptr->count = static_cast<std::uint8_t>(median);
+
+  move_values(parent, position + 1, parent, position,
+              parent->count - position);
+  move_values(parent, position, node_ptr, median, 1);
+  move_children(parent, position + 2, parent, position + 1,
+                parent->count - position);
+  parent->child(position + 1) = sibling;
+  ++parent->count;
+  if (rightmost_ == node_ptr) {
+    rightmost_ = sibling;
+  }
+
+  if (index > median) {
+    node_ptr = sibling;
+    index -= median + 1;
+  }
+}
+
+// An element of an internal node is replaced by its in-order predecessor,
+// so the slot is always freed in a leaf.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::erase_at(node* node_ptr,
+                                                        size_type index) {
+  destroy_value(node_ptr->value(index));
+  if (node_ptr->leaf) {
+    move_values(node_ptr, index, node_ptr, index + 1,
+                node_ptr->count - index - 1);
+  } else {
+    node* leaf = node_ptr->child(index);
+    while (!leaf->leaf) {
+      leaf = leaf->child(leaf->count);
+    }
+    move_values(node_ptr, index, leaf, leaf->count - 1, 1);
+    node_ptr = leaf;
+  }
+  --node_ptr->count;
+  --size_;
+  rebalance(node_ptr);
+}
+
+// Walks up from a node that lost an element: an underfull node is merged
+// with a sibling when both fit into one node, which takes an element from
+// the parent, and otherwise borrows half the difference from the fuller
+// neighbour. An emptied root hands over to its only child.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::rebalance(node* node_ptr) {
+  while (node_ptr->parent != nullptr && node_ptr->count < min_count) {
+    node* parent = node_ptr->parent;
+    size_type position = node_ptr->position;
+    node* left = position > 0 ? parent->child(position - 1) : nullptr;
+    node* right =
+        position < parent->count ? parent->child(position + 1) : nullptr;
+    if (left != nullptr && left->count + node_ptr->count < capacity) {
+      merge_children(parent, position - 1);
+    } else if (right != nullptr &&
+               node_ptr->count + right->count < capacity) {
+      merge_children(parent, position);
+    } else if (left != nullptr) {
+      shift_right(left, node_ptr, (left->count - node_ptr->count + 1) / 2);
+      return;
+    } else {
+      shift_left(node_ptr, right, (right->count - node_ptr->count + 1) / 2);
+      return;
+    }
+    node_ptr = parent;
+  }
+  if (root_->count == 0) {
+    node* old_root = root_;
+    if (root_->leaf) {
+      root_ = leftmost_ = rightmost_ = nullptr;
+    } else {
+      root_ = root_->child(0);
+      root_->parent = nullptr;
+      root_->position = 0;
+    }
+    destroy_node(old_root);
+  }
+}
+
+// Pulls the separator at index down into the left child and appends the
+// right child to it.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::merge_children(
+    node* parent, size_type index) {
+  node* left = parent->child(index);
+  node* right = parent->child(index + 1);
+  size_type left_count = left->count;
+  move_values(left, left_count, parent, index, 1);
+  move_values(left, left_count + 1, right, 0, right->count);
+  if (!left->leaf) {
+    move_children(left, left_count + 1, right, 0, right->count + 1);
+  }
+  left->count = static_cast<std::uint8_t>(left_count + 1 + right->count);
+
+  move_values(parent, index, parent, index + 1, parent->count - index - 1);
+  move_children(parent, index + 1, parent, index + 2,
+                parent->count - index - 1);
+  --parent->count;
+  if (rightmost_ == right) {
+    rightmost_ = left;
+  }
+  destroy_node(right);
+}
+
+// Moves count elements from the end of left through the parent separator
+// to the front of right.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::shift_right(node* left,
+                                                           node* right,
+                                                           size_type count) {
+  node* parent = left->parent;
+  size_type separator = left->position;
+  size_type left_count = left->count;
+  move_values(right, count, right, 0, right->count);
+  move_values(right, count - 1, parent, separator, 1);
+  move_values(right, 0, left, left_count - count + 1, count - 1);
+  move_values(parent, separator, left, left_count - count, 1);
+  if (!left->leaf) {
+    move_children(right, count, right, 0, right->count + 1);
+    move_children(right, 0, left, left_count - count + 1, count);
+  }
+  left->count = static_cast<std::uint8_t>(left_count - count);
+  right->count = static_cast<std::uint8_t>(right->count + count);
+}
+
+// Moves count elements from the front of right through the parent
+// separator to the end of left.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::shift_left(node* left,
+                                                          node* right,
+                                                          size_type count) {
+  node* parent = left->parent;
+  size_type separator = left->position;
+  size_type left_count = left->count;
+  move_values(left, left_count, parent, separator, 1);
+  move_values(left, left_count + 1, right, 0, count - 1);
+  move_values(parent, separator, right, count - 1, 1);
+  move_values(right, 0, right, count, right->count - count);
+  if (!left->leaf) {
+    move_children(left, left_count + 1, right, 0, count);
+    move_children(right, 0, right, count, right->count - count + 1);
+  }
+  left->count = static_cast<std::uint8_t>(left_count + count);
+  right->count = static_cast<std::uint8_t>(right->count - count);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::node*
+Btree<Key, Value, Comparator, Allocator>::copy_node(node* other, node* parent,
+                                                    size_type position) {
+  node* result = create_node(other->leaf, parent, position);
+  if (!other->leaf) {
+    std::fill_n(&result->child(0), other->count + 1, nullptr);
+  }
+  try {
+    for (; result->count < other->count; ++result->count) {
+      construct_value(result->value(result->count),
+                      *other->value(result->count));
+    }
+    if (!other->leaf) {
+      for (size_type index = 0; index <= other->count; ++index) {
+        result->child(index) = copy_node(other->child(index), result, index);
+      }
+    }
+  } catch (...) {
+    destroy(result);
+    throw;
+  }
+  return result;
+}
+
+// Also copes with the partly built nodes of a failed copy, whose missing
+// children are nullptr.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::destroy(node* node_ptr) {
+  if (node_ptr == nullptr) {
+    return;
+  }
+  if (!node_ptr->leaf) {
+    for (size_type index = 0; index <= node_ptr->count; ++index) {
+      destroy(node_ptr->child(index));
+    }
+  }
+  for (size_type index = 0; index < node_ptr->count; ++index) {
+    destroy_value(node_ptr->value(index));
+  }
+  destroy_node(node_ptr);
+}
+
+// With a bulk-releasing allocator and trivially destructible elements the
+// nodes go back in O(number of slabs) without being visited.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::destroy_all() {
+  if constexpr (has_bulk_release<leaf_allocator>::value &&
+                std::is_trivially_destructible_v<value_type>) {
+    leaf_allocator_.release();
+    internal_allocator_.release();
+  } else {
+    destroy(root_);
+  }
+}
+
+// Moves the elements of the subtree out in order and frees its nodes.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::drain(
+    node* node_ptr, std::vector<mutable_value>& out) {
+  for (size_type index = 0; index < node_ptr->count; ++index) {
+    if (!node_ptr->leaf) {
+      drain(node_ptr->child(index), out);
+    }
+    value_type* item = node_ptr->value(index);
+    out.emplace_back(std::move(const_cast<Key&>(item->first)),
+                     std::move(item->second));
+    destroy_value(item);
+  }
+  if (!node_ptr->leaf) {
+    drain(node_ptr->child(node_ptr->count), out);
+  }
+  destroy_node(node_ptr);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::drain_all(
+    std::vector<mutable_value>& out) {
+  out.reserve(out.size() + size_);
+  if (root_ != nullptr) {
+    drain(root_, out);
+  }
+  root_ = leftmost_ = rightmost_ = nullptr;
+  size_ = 0;
+}
+
+// Packs sorted elements into an empty tree of the smallest height that
+// holds them, spreading them evenly over as few children per node as
+// possible, so all nodes come out at least about half full.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::build_sorted(
+    mutable_value* items, size_type count) {
+  if (count == 0) {
+    return;
+  }
+  std::vector<size_type> level_sizes{capacity};
+  while (level_sizes.back() < count) {
+    level_sizes.push_back(level_sizes.back() * (capacity + 1) + capacity);
+  }
+  root_ = build_level(items, count, level_sizes.size() - 1, level_sizes,
+                      nullptr, 0);
+  size_ = count;
+  reset_edges();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::node*
+Btree<Key, Value, Comparator, Allocator>::build_level(
+    mutable_value*& items, size_type count, size_type level,
+    const std::vector<size_type>& level_sizes, node* parent,
+    size_type position) {
+  node* result = create_node(level == 0, parent, position);
+  if (level == 0) {
+    for (; result->count < count; ++result->count, ++items) {
+      construct_value(result->value(result->count), std::move(items->first),
+                      std::move(items->second));
+    }
+    return result;
+  }
+  size_type child_size = level_sizes[level - 1];
+  size_type children = (count + child_size + 1) / (child_size + 1);
+  size_type spread = count - (children - 1);
+  for (size_type index = 0; index < children; ++index) {
+    size_type share = spread / children + (index < spread % children);
+    result->child(index) =
+        build_level(items, share, level - 1, level_sizes, result, index);
+    if (index + 1 < children) {
+      construct_value(result->value(index), std::move(items->first),
+                      std::move(items->second));
+      ++items;
+      ++result->count;
+    }
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::reset_edges() {
+  leftmost_ = rightmost_ = root_;
+  if (root_ == nullptr) {
+    return;
+  }
+  while (!leftmost_->leaf) {
+    leftmost_ = leftmost_->child(0);
+  }
+  while (!rightmost_->leaf) {
+    rightmost_ = rightmost_->child(rightmost_->count);
+  }
+}
+
+// Elements move rather than nodes, since they live inside the nodes. A
+// large other is merged with our own elements in one sorted pass and both
+// trees are rebuilt in O(n + m); a small one is inserted element by element.
+// With unique keys the rejected elements are put back into other.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void Btree<Key, Value, Comparator, Allocator>::merge_values(Btree& other,
+                                                            bool unique) {
+  if (this == &other || other.size_ == 0) {
+    return;
+  }
+  std::vector<mutable_value> incoming;
+  other.drain_all(incoming);
+  std::vector<mutable_value> rejected;
+
+  size_type depth = 1;
+  for (size_type count = size_; count > 1; count /= 2) {
+    ++depth;
+  }
+  if (incoming.size() * depth >= size_) {
+    std::vector<mutable_value> merged;
+    merged.reserve(size_ + incoming.size());
+    std::vector<mutable_value> own;
+    drain_all(own);
+    auto own_it = own.begin();
+    for (mutable_value& item : incoming) {
+      while (own_it != own.end() &&
+             (unique ? tree_comparator(own_it->first, item.first)
+                     : !tree_comparator(item.first, own_it->first))) {
+        merged.push_back(std::move(*own_it++));
+      }
+      if (unique && own_it != own.end() &&
+          !tree_comparator(item.first, own_it->first)) {
+        rejected.push_back(std::move(item));
+      } else {
+        merged.push_back(std::move(item));
+      }
+    }
+    std::move(own_it, own.end(), std::back_inserter(merged));
+    build_sorted(merged.data(), merged.size());
+  } else {
+    for (mutable_value& item : incoming) {
+      if (!unique) {
+        multi_emplace_key(item.first, std::move(item.first),
+                          std::move(item.second));
+      } else if (!unique_emplace_key(item.first, std::move(item.first),
+                                     std::move(item.second))
+                      .second) {
+        rejected.push_back(std::move(item));
+      }
+    }
+  }
+  other.build_sorted(rejected.data(), rejected.size());
+}
+
+//---iterator-logic---/
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Btree<Key, Value, Comparator, Allocator>::iterator::iterator()
+    : current_node(nullptr), position(0) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Btree<Key, Value, Comparator, Allocator>::iterator::iterator(node* node_ptr,
+                                                             size_type index)
+    : current_node(node_ptr), position(index) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::iterator&
+Btree<Key, Value, Comparator, Allocator>::iterator::operator++() {
+  next_position(current_node, position);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::iterator::operator++(int) {
+  iterator result(*this);
+  next_position(current_node, position);
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::iterator&
+Btree<Key, Value, Comparator, Allocator>::iterator::operator--() {
+  prev_position(current_node, position);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::iterator
+Btree<Key, Value, Comparator, Allocator>::iterator::operator--(int) {
+  iterator result(*this);
+  prev_position(current_node, position);
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+bool Btree<Key, Value, Comparator, Allocator>::iterator::operator!=(
+    const iterator& other) const {
+  return !(*this == other);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+bool Btree<Key, Value, Comparator, Allocator>::iterator::operator==(
+    const iterator& other) const {
+  return current_node == other.current_node && position == other.position;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::value_reference
+Btree<Key, Value, Comparator, Allocator>::iterator::operator*() {
+  return *current_node->value(position);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::value_pointer
+Btree<Key, Value, Comparator, Allocator>::iterator::operator->() {
+  return current_node->value(position);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Btree<Key, Value, Comparator, Allocator>::const_iterator::const_iterator()
+    : current_node(nullptr), position(0) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Btree<Key, Value, Comparator, Allocator>::const_iterator::const_iterator(
+    node* node_ptr, size_type index)
+    : current_node(node_ptr), position(index) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::const_iterator&
+Btree<Key, Value, Comparator, Allocator>::const_iterator::operator++() {
+  next_position(current_node, position);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::const_iterator
+Btree<Key, Value, Comparator, Allocator>::const_iterator::operator++(int) {
+  const_iterator result(*this);
+  next_position(current_node, position);
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::const_iterator&
+Btree<Key, Value, Comparator, Allocator>::const_iterator::operator--() {
+  prev_position(current_node, position);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::const_iterator
+Btree<Key, Value, Comparator, Allocator>::const_iterator::operator--(int) {
+  const_iterator result(*this);
+  prev_position(current_node, position);
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+bool Btree<Key, Value, Comparator, Allocator>::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return !(*this == other);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+bool Btree<Key, Value, Comparator, Allocator>::const_iterator::operator==(
+    const const_iterator& other) const {
+  return current_node == other.current_node && position == other.position;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::const_reference
+Btree<Key, Value, Comparator, Allocator>::const_iterator::operator*() {
+  return *current_node->value(position);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename Btree<Key, Value, Comparator, Allocator>::const_pointer
+Btree<Key, Value, Comparator, Allocator>::const_iterator::operator->() {
+  return current_node->value(position);
+}
+
+}  // namespace s21
+
+#endif
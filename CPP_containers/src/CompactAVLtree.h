@@ -0,0 +1,1188 @@
+#ifndef S21_SRC_COMPACT_AVL_TREE_H
+#define S21_SRC_COMPACT_AVL_TREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace s21 {
+
+// AVL backend for compact_set and compact_map that keeps every node in one
+// array and links nodes by Index instead of by pointer. A node is the
+// element plus three links, so with the default 32-bit Index a set<int>
+// node takes 16 bytes where AVLtree spends 48. The balance factor lives in
+// the top two bits of the parent link, which leaves 2^30 - 1 nodes for a
+// 32-bit Index; pass uint64_t as the policy for more. Erased nodes are
+// chained into a free list through their left link and reused before the
+// array grows. With Value = void the nodes hold bare keys.
+//
+// Iterators hold the tree and an index, so they stay valid while the array
+// grows, but references to elements do not.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+class CompactAVLtree {
+  static_assert(std::is_unsigned_v<Index>,
+                "the index policy must be an unsigned integer type");
+
+ public:
+  using slot_type = std::conditional_t<std::is_void_v<Value>, Key,
+                                       std::pair<const Key, Value>>;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+ protected:
+  static constexpr int kBalanceShift = std::numeric_limits<Index>::digits - 2;
+  static constexpr Index kNil = (Index(1) << kBalanceShift) - 1;
+  // A parent link with balance bits 11 never occurs in the tree.
+  static constexpr Index kFree = std::numeric_limits<Index>::max();
+
+  struct node {
+    Index left;
+    Index right;
+    // Parent index in the low bits, balance factor + 1 in the top two.
+    Index parent_;
+    slot_type value;
+  };
+
+  using node_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+  using slot_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<slot_type>;
+  using slot_traits = std::allocator_traits<slot_allocator>;
+
+ public:
+  class iterator {
+   public:
+    friend CompactAVLtree;
+    iterator() = default;
+
+    iterator& operator++();
+    iterator operator++(int);
+    iterator& operator--();
+    iterator operator--(int);
+
+    bool operator!=(const iterator& other) const;
+    bool operator==(const iterator& other) const;
+
+    slot_type& operator*() const;
+    slot_type* operator->() const;
+
+   protected:
+    iterator(CompactAVLtree* tree, Index index);
+
+    CompactAVLtree* tree_ = nullptr;
+    Index index_ = kNil;
+  };
+
+  class const_iterator {
+   public:
+    friend CompactAVLtree;
+    const_iterator() = default;
+    const_iterator(const iterator& other);
+
+    const_iterator& operator++();
+    const_iterator operator++(int);
+    const_iterator& operator--();
+    const_iterator operator--(int);
+
+    bool operator!=(const const_iterator& other) const;
+    bool operator==(const const_iterator& other) const;
+
+    const slot_type& operator*() const;
+    const slot_type* operator->() const;
+
+   protected:
+    const_iterator(const CompactAVLtree* tree, Index index);
+
+    const CompactAVLtree* tree_ = nullptr;
+    Index index_ = kNil;
+  };
+
+ protected:
+  CompactAVLtree();
+  CompactAVLtree(const CompactAVLtree& other);
+  CompactAVLtree(CompactAVLtree&& other) noexcept;
+  ~CompactAVLtree();
+  CompactAVLtree& operator=(const CompactAVLtree& other);
+  CompactAVLtree& operator=(CompactAVLtree&& other) noexcept;
+
+  iterator tree_begin();
+  const_iterator tree_begin() const;
+  iterator tree_end();
+  const_iterator tree_end() const;
+  size_type tree_size() const;
+  bool tree_empty() const;
+  size_type tree_max_size() const;
+  size_type tree_capacity() const;
+  allocator_type tree_get_allocator() const;
+  void tree_reserve(size_type count);
+
+  iterator tree_find(const Key& key);
+  const_iterator tree_find(const Key& key) const;
+  bool tree_contains(const Key& key) const;
+  iterator tree_lower_bound(const Key& key);
+  const_iterator tree_lower_bound(const Key& key) const;
+  iterator tree_upper_bound(const Key& key);
+  const_iterator tree_upper_bound(const Key& key) const;
+
+  template <typename S>
+  std::pair<iterator, bool> tree_insert(S&& value);
+  template <typename... Args>
+  std::pair<iterator, bool> tree_emplace(Args&&... args);
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> tree_try_emplace(K&& key, Args&&... args);
+  iterator tree_erase(const_iterator pos);
+  size_type tree_erase_key(const Key& key);
+  void tree_clear();
+  void tree_swap(CompactAVLtree& other) noexcept;
+
+ private:
+  static const Key& key_of(const slot_type& slot);
+
+  Index parent_of(Index index) const;
+  int balance_of(Index index) const;
+  void set_parent(Index index, Index parent);
+  void set_balance(Index index, int balance);
+  Index next_index(Index index) const;
+  Index prev_index(Index index) const;
+  Index lower_bound_index(const Key& key) const;
+  Index upper_bound_index(const Key& key) const;
+  Index find_index(const Key& key) const;
+
+  // Descends to key. Returns the node holding it, or kNil with parent and
+  // side set to where a new node for key belongs.
+  struct insert_position {
+    Index found;
+    Index parent;
+    bool left;
+    bool leftmost;
+  };
+  insert_position find_position(const Key& key) const;
+  template <typename... Args>
+  std::pair<iterator, bool> construct_at(const insert_position& position,
+                                         Args&&... args);
+
+  Index claim_slot();
+  void release_slot(Index index);
+  void replace_child(Index parent, Index child, Index replacement);
+  void rotate_left(Index index);
+  void rotate_right(Index index);
+  Index rebalance(Index index, int balance, bool& height_kept);
+  void rebalance_after_insert(Index child);
+  void rebalance_after_erase(Index parent, bool from_left);
+  void unlink(Index target);
+  void resize(size_type capacity);
+  void destroy_slots();
+  void release();
+
+  node* nodes_ = nullptr;
+  size_type capacity_ = 0;
+  // Slots [0, used_) have been handed out; the free ones among them are
+  // chained from free_.
+  size_type used_ = 0;
+  size_type size_ = 0;
+  Index free_ = kNil;
+  Index root_ = kNil;
+  Index first_ = kNil;
+  Comparator comparator_;
+  allocator_type allocator_;
+};
+
+//----iterator-logic----//
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator::iterator(
+    CompactAVLtree* tree, Index index)
+    : tree_(tree), index_(index) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator&
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::iterator::operator++() {
+  index_ = tree_->next_index(index_);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator::operator++(
+    int) {
+  iterator copy = *this;
+  ++*this;
+  return copy;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator&
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::iterator::operator--() {
+  index_ = tree_->prev_index(index_);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator::operator--(
+    int) {
+  iterator copy = *this;
+  --*this;
+  return copy;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+bool CompactAVLtree<Key, Value, Comparator, Allocator,
+                    Index>::iterator::operator!=(const iterator& other) const {
+  return index_ != other.index_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+bool CompactAVLtree<Key, Value, Comparator, Allocator,
+                    Index>::iterator::operator==(const iterator& other) const {
+  return index_ == other.index_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::slot_type&
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::iterator::operator*() const {
+  return tree_->nodes_[index_].value;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::slot_type*
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::iterator::operator->() const {
+  return &tree_->nodes_[index_].value;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::const_iterator::const_iterator(const iterator& other)
+    : tree_(other.tree_), index_(other.index_) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::const_iterator::const_iterator(
+    const CompactAVLtree* tree, Index index)
+    : tree_(tree), index_(index) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                        Index>::const_iterator&
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::const_iterator::operator++() {
+  index_ = tree_->next_index(index_);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                        Index>::const_iterator
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::const_iterator::operator++(int) {
+  const_iterator copy = *this;
+  ++*this;
+  return copy;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                        Index>::const_iterator&
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::const_iterator::operator--() {
+  index_ = tree_->prev_index(index_);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                        Index>::const_iterator
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::const_iterator::operator--(int) {
+  const_iterator copy = *this;
+  --*this;
+  return copy;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+bool CompactAVLtree<Key, Value, Comparator, Allocator,
+                    Index>::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return index_ != other.index_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+bool CompactAVLtree<Key, Value, Comparator, Allocator,
+                    Index>::const_iterator::operator==(
+    const const_iterator& other) const {
+  return index_ == other.index_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+const typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                              Index>::slot_type&
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::const_iterator::operator*() const {
+  return tree_->nodes_[index_].value;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+const typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                              Index>::slot_type*
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::const_iterator::operator->() const {
+  return &tree_->nodes_[index_].value;
+}
+
+//----tree-logic----//
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::CompactAVLtree() =
+    default;
+
+// Slots are copied one for one, free ones included, so every link stays
+// valid without walking the tree.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::CompactAVLtree(
+    const CompactAVLtree& other)
+    : free_(other.free_),
+      root_(other.root_),
+      first_(other.first_),
+      comparator_(other.comparator_),
+      allocator_(std::allocator_traits<Allocator>::
+                     select_on_container_copy_construction(
+                         other.allocator_)) {
+  if (other.used_ == 0) {
+    free_ = root_ = first_ = kNil;
+    return;
+  }
+  node_allocator allocator(allocator_);
+  slot_allocator slots(allocator_);
+  nodes_ = node_traits::allocate(allocator, other.used_);
+  capacity_ = other.used_;
+  try {
+    for (; used_ < other.used_; ++used_) {
+      const node& source = other.nodes_[used_];
+      node& target = nodes_[used_];
+      target.left = source.left;
+      target.right = source.right;
+      target.parent_ = source.parent_;
+      if (source.parent_ != kFree) {
+        slot_traits::construct(slots, &target.value, source.value);
+      }
+    }
+  } catch (...) {
+    release();
+    throw;
+  }
+  size_ = other.size_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::CompactAVLtree(
+    CompactAVLtree&& other) noexcept
+    : nodes_(std::exchange(other.nodes_, nullptr)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      used_(std::exchange(other.used_, 0)),
+      size_(std::exchange(other.size_, 0)),
+      free_(std::exchange(other.free_, kNil)),
+      root_(std::exchange(other.root_, kNil)),
+      first_(std::exchange(other.first_, kNil)),
+      comparator_(other.comparator_),
+      allocator_(other.allocator_) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::~CompactAVLtree() {
+  release();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>&
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::operator=(
+    const CompactAVLtree& other) {
+  if (this != &other) {
+    CompactAVLtree copy(other);
+    tree_swap(copy);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>&
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::operator=(
+    CompactAVLtree&& other) noexcept {
+  if (this != &other) {
+    release();
+    capacity_ = used_ = size_ = 0;
+    free_ = root_ = first_ = kNil;
+    tree_swap(other);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_begin() {
+  return iterator(this, first_);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                        Index>::const_iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_begin() const {
+  return const_iterator(this, first_);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_end() {
+  return iterator(this, kNil);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                        Index>::const_iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_end() const {
+  return const_iterator(this, kNil);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::size_type
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_size() const {
+  return size_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+bool CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_empty()
+    const {
+  return size_ == 0;
+}
+
+// kNil itself is not a usable index, so indices [0, kNil) are all there is.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::size_type
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_max_size()
+    const {
+  size_type by_memory = std::numeric_limits<size_type>::max() / sizeof(node);
+  return std::min<size_type>(by_memory, kNil);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::size_type
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_capacity()
+    const {
+  return capacity_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                        Index>::allocator_type
+CompactAVLtree<Key, Value, Comparator, Allocator,
+               Index>::tree_get_allocator() const {
+  return allocator_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_reserve(
+    size_type count) {
+  if (count > tree_max_size()) {
+    throw std::length_error("Too many elements for the index type");
+  }
+  if (count > capacity_) {
+    resize(count);
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_find(
+    const Key& key) {
+  return iterator(this, find_index(key));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                        Index>::const_iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_find(
+    const Key& key) const {
+  return const_iterator(this, find_index(key));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+bool CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_contains(
+    const Key& key) const {
+  return find_index(key) != kNil;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_lower_bound(
+    const Key& key) {
+  return iterator(this, lower_bound_index(key));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                        Index>::const_iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_lower_bound(
+    const Key& key) const {
+  return const_iterator(this, lower_bound_index(key));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_upper_bound(
+    const Key& key) {
+  return iterator(this, upper_bound_index(key));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                        Index>::const_iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_upper_bound(
+    const Key& key) const {
+  return const_iterator(this, upper_bound_index(key));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+template <typename S>
+std::pair<
+    typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_insert(
+    S&& value) {
+  insert_position position = find_position(key_of(value));
+  if (position.found != kNil) {
+    return {iterator(this, position.found), false};
+  }
+  return construct_at(position, std::forward<S>(value));
+}
+
+// The key is only known once the value exists, so it is built up front and
+// moved into the node.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+template <typename... Args>
+std::pair<
+    typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_emplace(
+    Args&&... args) {
+  return tree_insert(slot_type(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+template <typename K, typename... Args>
+std::pair<
+    typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_try_emplace(
+    K&& key, Args&&... args) {
+  insert_position position = find_position(key);
+  if (position.found != kNil) {
+    return {iterator(this, position.found), false};
+  }
+  return construct_at(position, std::piecewise_construct,
+                      std::forward_as_tuple(std::forward<K>(key)),
+                      std::forward_as_tuple(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_erase(
+    const_iterator pos) {
+  Index target = pos.index_;
+  Index next = next_index(target);
+  unlink(target);
+  if (first_ == target) {
+    first_ = next;
+  }
+  slot_allocator slots(allocator_);
+  slot_traits::destroy(slots, &nodes_[target].value);
+  release_slot(target);
+  --size_;
+  return iterator(this, next);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::size_type
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_erase_key(
+    const Key& key) {
+  Index found = find_index(key);
+  if (found == kNil) {
+    return 0;
+  }
+  tree_erase(const_iterator(this, found));
+  return 1;
+}
+
+// Keeps the array, so refilling the tree does not allocate again.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_clear() {
+  destroy_slots();
+  used_ = size_ = 0;
+  free_ = root_ = first_ = kNil;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator, Index>::tree_swap(
+    CompactAVLtree& other) noexcept {
+  std::swap(nodes_, other.nodes_);
+  std::swap(capacity_, other.capacity_);
+  std::swap(used_, other.used_);
+  std::swap(size_, other.size_);
+  std::swap(free_, other.free_);
+  std::swap(root_, other.root_);
+  std::swap(first_, other.first_);
+  std::swap(comparator_, other.comparator_);
+  std::swap(allocator_, other.allocator_);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+const Key& CompactAVLtree<Key, Value, Comparator, Allocator, Index>::key_of(
+    const slot_type& slot) {
+  if constexpr (std::is_void_v<Value>) {
+    return slot;
+  } else {
+    return slot.first;
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+inline Index CompactAVLtree<Key, Value, Comparator, Allocator,
+                            Index>::parent_of(Index index) const {
+  return nodes_[index].parent_ & kNil;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+inline int CompactAVLtree<Key, Value, Comparator, Allocator,
+                          Index>::balance_of(Index index) const {
+  return static_cast<int>(nodes_[index].parent_ >> kBalanceShift) - 1;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+inline void CompactAVLtree<Key, Value, Comparator, Allocator,
+                           Index>::set_parent(Index index, Index parent) {
+  Index& link = nodes_[index].parent_;
+  link = static_cast<Index>((link & ~kNil) | parent);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+inline void CompactAVLtree<Key, Value, Comparator, Allocator,
+                           Index>::set_balance(Index index, int balance) {
+  Index& link = nodes_[index].parent_;
+  link = static_cast<Index>((link & kNil) |
+                            (static_cast<Index>(balance + 1) << kBalanceShift));
+}
+
+// kNil stands for end(), so --end() lands on the last node.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+Index CompactAVLtree<Key, Value, Comparator, Allocator, Index>::next_index(
+    Index index) const {
+  if (index == kNil) {
+    return first_;
+  }
+  Index child = nodes_[index].right;
+  if (child != kNil) {
+    while (nodes_[child].left != kNil) {
+      child = nodes_[child].left;
+    }
+    return child;
+  }
+  Index parent = parent_of(index);
+  while (parent != kNil && nodes_[parent].right == index) {
+    index = parent;
+    parent = parent_of(parent);
+  }
+  return parent;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+Index CompactAVLtree<Key, Value, Comparator, Allocator, Index>::prev_index(
+    Index index) const {
+  Index child = index == kNil ? root_ : nodes_[index].left;
+  if (child != kNil) {
+    while (nodes_[child].right != kNil) {
+      child = nodes_[child].right;
+    }
+    return child;
+  }
+  if (index == kNil) {
+    return kNil;
+  }
+  Index parent = parent_of(index);
+  while (parent != kNil && nodes_[parent].left == index) {
+    index = parent;
+    parent = parent_of(parent);
+  }
+  return parent;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+Index CompactAVLtree<Key, Value, Comparator, Allocator,
+                     Index>::lower_bound_index(const Key& key) const {
+  Index bound = kNil;
+  Index index = root_;
+  while (index != kNil) {
+    if (!comparator_(key_of(nodes_[index].value), key)) {
+      bound = index;
+      index = nodes_[index].left;
+    } else {
+      index = nodes_[index].right;
+    }
+  }
+  return bound;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+Index CompactAVLtree<Key, Value, Comparator, Allocator,
+                     Index>::upper_bound_index(const Key& key) const {
+  Index bound = kNil;
+  Index index = root_;
+  while (index != kNil) {
+    if (comparator_(key, key_of(nodes_[index].value))) {
+      bound = index;
+      index = nodes_[index].left;
+    } else {
+      index = nodes_[index].right;
+    }
+  }
+  return bound;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+Index CompactAVLtree<Key, Value, Comparator, Allocator, Index>::find_index(
+    const Key& key) const {
+  Index bound = lower_bound_index(key);
+  if (bound == kNil || comparator_(key, key_of(nodes_[bound].value))) {
+    return kNil;
+  }
+  return bound;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename CompactAVLtree<Key, Value, Comparator, Allocator,
+                        Index>::insert_position
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::find_position(
+    const Key& key) const {
+  insert_position position{kNil, kNil, false, true};
+  Index index = root_;
+  while (index != kNil) {
+    const Key& current = key_of(nodes_[index].value);
+    position.parent = index;
+    if (comparator_(key, current)) {
+      position.left = true;
+      index = nodes_[index].left;
+    } else if (comparator_(current, key)) {
+      position.left = false;
+      position.leftmost = false;
+      index = nodes_[index].right;
+    } else {
+      position.found = index;
+      return position;
+    }
+  }
+  return position;
+}
+
+// Positions are indices, so claiming a slot may move the array without
+// invalidating them.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+template <typename... Args>
+std::pair<
+    typename CompactAVLtree<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>
+CompactAVLtree<Key, Value, Comparator, Allocator, Index>::construct_at(
+    const insert_position& position, Args&&... args) {
+  Index index = claim_slot();
+  slot_allocator slots(allocator_);
+  try {
+    slot_traits::construct(slots, &nodes_[index].value,
+                           std::forward<Args>(args)...);
+  } catch (...) {
+    release_slot(index);
+    throw;
+  }
+  node& created = nodes_[index];
+  created.left = kNil;
+  created.right = kNil;
+  created.parent_ = 0;
+  set_parent(index, position.parent);
+  set_balance(index, 0);
+  if (position.parent == kNil) {
+    root_ = index;
+  } else if (position.left) {
+    nodes_[position.parent].left = index;
+  } else {
+    nodes_[position.parent].right = index;
+  }
+  if (position.leftmost) {
+    first_ = index;
+  }
+  ++size_;
+  rebalance_after_insert(index);
+  return {iterator(this, index), true};
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+Index CompactAVLtree<Key, Value, Comparator, Allocator,
+                     Index>::claim_slot() {
+  if (free_ != kNil) {
+    Index index = free_;
+    free_ = nodes_[index].left;
+    return index;
+  }
+  if (used_ == capacity_) {
+    size_type limit = tree_max_size();
+    if (capacity_ == limit) {
+      throw std::length_error("Too many elements for the index type");
+    }
+    resize(capacity_ < limit / 2 ? std::max<size_type>(capacity_ * 2, 8)
+                                 : limit);
+  }
+  return static_cast<Index>(used_++);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator, Index>::release_slot(
+    Index index) {
+  nodes_[index].parent_ = kFree;
+  nodes_[index].left = free_;
+  free_ = index;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator, Index>::replace_child(
+    Index parent, Index child, Index replacement) {
+  if (parent == kNil) {
+    root_ = replacement;
+  } else if (nodes_[parent].left == child) {
+    nodes_[parent].left = replacement;
+  } else {
+    nodes_[parent].right = replacement;
+  }
+}
+
+// Rotations only relink; balance factors are set by rebalance().
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator, Index>::rotate_left(
+    Index index) {
+  Index pivot = nodes_[index].right;
+  Index parent = parent_of(index);
+  Index inner = nodes_[pivot].left;
+  nodes_[index].right = inner;
+  if (inner != kNil) {
+    set_parent(inner, index);
+  }
+  nodes_[pivot].left = index;
+  set_parent(index, pivot);
+  set_parent(pivot, parent);
+  replace_child(parent, index, pivot);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator, Index>::rotate_right(
+    Index index) {
+  Index pivot = nodes_[index].left;
+  Index parent = parent_of(index);
+  Index inner = nodes_[pivot].right;
+  nodes_[index].left = inner;
+  if (inner != kNil) {
+    set_parent(inner, index);
+  }
+  nodes_[pivot].right = index;
+  set_parent(index, pivot);
+  set_parent(pivot, parent);
+  replace_child(parent, index, pivot);
+}
+
+// Restores the subtree at index, whose balance factor has reached +2 or -2
+// and is passed in because two bits cannot hold it. Returns the new subtree
+// root; height_kept is set when the subtree is as high as before the
+// rotation, which only an erase can cause.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+Index CompactAVLtree<Key, Value, Comparator, Allocator, Index>::rebalance(
+    Index index, int balance, bool& height_kept) {
+  height_kept = false;
+  if (balance > 0) {
+    Index child = nodes_[index].right;
+    int child_balance = balance_of(child);
+    if (child_balance >= 0) {
+      rotate_left(index);
+      height_kept = child_balance == 0;
+      set_balance(index, height_kept ? 1 : 0);
+      set_balance(child, height_kept ? -1 : 0);
+      return child;
+    }
+    Index grandchild = nodes_[child].left;
+    int grandchild_balance = balance_of(grandchild);
+    rotate_right(child);
+    rotate_left(index);
+    set_balance(index, grandchild_balance > 0 ? -1 : 0);
+    set_balance(child, grandchild_balance < 0 ? 1 : 0);
+    set_balance(grandchild, 0);
+    return grandchild;
+  }
+  Index child = nodes_[index].left;
+  int child_balance = balance_of(child);
+  if (child_balance <= 0) {
+    rotate_right(index);
+    height_kept = child_balance == 0;
+    set_balance(index, height_kept ? -1 : 0);
+    set_balance(child, height_kept ? 1 : 0);
+    return child;
+  }
+  Index grandchild = nodes_[child].right;
+  int grandchild_balance = balance_of(grandchild);
+  rotate_left(child);
+  rotate_right(index);
+  set_balance(index, grandchild_balance < 0 ? 1 : 0);
+  set_balance(child, grandchild_balance > 0 ? -1 : 0);
+  set_balance(grandchild, 0);
+  return grandchild;
+}
+
+// Walks up from a new leaf until a subtree absorbs the extra height.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator,
+                    Index>::rebalance_after_insert(Index child) {
+  Index parent = parent_of(child);
+  while (parent != kNil) {
+    int balance =
+        balance_of(parent) + (nodes_[parent].left == child ? -1 : 1);
+    if (balance == 0) {
+      set_balance(parent, 0);
+      return;
+    }
+    if (balance == 1 || balance == -1) {
+      set_balance(parent, balance);
+      child = parent;
+      parent = parent_of(parent);
+      continue;
+    }
+    bool height_kept;
+    rebalance(parent, balance, height_kept);
+    return;
+  }
+}
+
+// Walks up from the parent of a subtree that lost one level, on the left
+// when from_left is set, until some subtree keeps its height.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator,
+                    Index>::rebalance_after_erase(Index parent,
+                                                  bool from_left) {
+  while (parent != kNil) {
+    int balance = balance_of(parent) + (from_left ? 1 : -1);
+    Index grandparent = parent_of(parent);
+    bool parent_is_left =
+        grandparent != kNil && nodes_[grandparent].left == parent;
+    if (balance == 1 || balance == -1) {
+      set_balance(parent, balance);
+      return;
+    }
+    if (balance == 0) {
+      set_balance(parent, 0);
+    } else {
+      bool height_kept;
+      rebalance(parent, balance, height_kept);
+      if (height_kept) {
+        return;
+      }
+    }
+    from_left = parent_is_left;
+    parent = grandparent;
+  }
+}
+
+// Detaches target without moving any element: a node with two children is
+// replaced by its successor node, so iterators to other elements stay
+// valid.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator, Index>::unlink(
+    Index target) {
+  Index parent = parent_of(target);
+  Index left = nodes_[target].left;
+  Index right = nodes_[target].right;
+  Index rebalance_from;
+  bool from_left;
+  if (left == kNil || right == kNil) {
+    Index child = left != kNil ? left : right;
+    from_left = parent != kNil && nodes_[parent].left == target;
+    if (child != kNil) {
+      set_parent(child, parent);
+    }
+    replace_child(parent, target, child);
+    rebalance_from = parent;
+  } else {
+    Index successor = right;
+    while (nodes_[successor].left != kNil) {
+      successor = nodes_[successor].left;
+    }
+    if (successor == right) {
+      rebalance_from = successor;
+      from_left = false;
+    } else {
+      rebalance_from = parent_of(successor);
+      from_left = true;
+      Index successor_right = nodes_[successor].right;
+      nodes_[rebalance_from].left = successor_right;
+      if (successor_right != kNil) {
+        set_parent(successor_right, rebalance_from);
+      }
+      nodes_[successor].right = right;
+      set_parent(right, successor);
+    }
+    nodes_[successor].left = left;
+    set_parent(left, successor);
+    replace_child(parent, target, successor);
+    set_parent(successor, parent);
+    set_balance(successor, balance_of(target));
+  }
+  rebalance_after_erase(rebalance_from, from_left);
+}
+
+// Only called with every slot below used_ accounted for, live or free.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator, Index>::resize(
+    size_type capacity) {
+  node_allocator allocator(allocator_);
+  slot_allocator slots(allocator_);
+  node* moved = node_traits::allocate(allocator, capacity);
+  size_type index = 0;
+  try {
+    for (; index < used_; ++index) {
+      node& source = nodes_[index];
+      node& target = moved[index];
+      target.left = source.left;
+      target.right = source.right;
+      target.parent_ = source.parent_;
+      if (source.parent_ != kFree) {
+        slot_traits::construct(slots, &target.value,
+                               std::move_if_noexcept(source.value));
+      }
+    }
+  } catch (...) {
+    while (index-- > 0) {
+      if (moved[index].parent_ != kFree) {
+        slot_traits::destroy(slots, &moved[index].value);
+      }
+    }
+    node_traits::deallocate(allocator, moved, capacity);
+    throw;
+  }
+  size_type used = used_;
+  release();
+  nodes_ = moved;
+  capacity_ = capacity;
+  used_ = used;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator,
+                    Index>::destroy_slots() {
+  if constexpr (!std::is_trivially_destructible_v<slot_type>) {
+    slot_allocator slots(allocator_);
+    for (size_type index = 0; index < used_; ++index) {
+      if (nodes_[index].parent_ != kFree) {
+        slot_traits::destroy(slots, &nodes_[index].value);
+      }
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void CompactAVLtree<Key, Value, Comparator, Allocator, Index>::release() {
+  if (nodes_ == nullptr) {
+    return;
+  }
+  destroy_slots();
+  node_allocator allocator(allocator_);
+  node_traits::deallocate(allocator, nodes_, capacity_);
+  nodes_ = nullptr;
+  capacity_ = used_ = 0;
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,342 @@
+#ifndef S21_SRC_EYTZINGER_ARRAY_H
+#define S21_SRC_EYTZINGER_ARRAY_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "s21_vector.h"
+
+namespace s21 {
+
+// Read-only backend for frozen_set and the key column of frozen_map. The
+// keys are stored in Eytzinger order, the breadth-first order of a
+// complete search tree: counting slots from 1, the children of slot k are
+// 2k and 2k + 1. A lookup is a descent that only moves to higher slots and
+// picks the child with the comparison result instead of a branch. The top
+// levels share a few hot cache lines, and the 2^d descendants d levels
+// below a slot sit next to each other, so one prefetch per step fetches
+// the line the search reaches a few steps later. Slot 0 stands for "past
+// the end".
+template <typename Key, typename Comparator = std::less<Key>>
+class EytzingerArray {
+ public:
+  using size_type = size_t;
+
+  // Walks the slots in key order; keys are never modified in place.
+  class const_iterator {
+   public:
+    const_iterator() = default;
+    const_iterator(const EytzingerArray* owner, size_type slot);
+
+    const Key& operator*() const;
+    const Key* operator->() const;
+    const_iterator& operator++();
+    const_iterator operator++(int);
+    const_iterator& operator--();
+    const_iterator operator--(int);
+
+    bool operator==(const const_iterator& other) const;
+    bool operator!=(const const_iterator& other) const;
+
+    size_type slot() const;
+
+   private:
+    const EytzingerArray* owner_ = nullptr;
+    size_type slot_ = 0;
+  };
+
+ protected:
+  EytzingerArray() = default;
+  EytzingerArray(const EytzingerArray& other) = default;
+  EytzingerArray(EytzingerArray&& other) noexcept;
+  ~EytzingerArray() = default;
+  EytzingerArray& operator=(const EytzingerArray& other);
+  EytzingerArray& operator=(EytzingerArray&& other) noexcept;
+
+  const_iterator tree_begin() const;
+  const_iterator tree_end() const;
+  size_type tree_size() const;
+  size_type tree_max_size() const;
+  bool tree_empty() const;
+  void tree_swap(EytzingerArray& other) noexcept;
+
+  size_type lower_slot(const Key& key) const;
+  size_type upper_slot(const Key& key) const;
+  bool holds(size_type slot, const Key& key) const;
+
+  template <typename Emit>
+  static void for_each_rank(size_type count, Emit emit);
+  static size_type first_slot(size_type count);
+  static size_type last_slot(size_type count);
+  static size_type next_slot(size_type slot, size_type count);
+  static size_type prev_slot(size_type slot, size_type count);
+
+  // Keys per cache line, rounded down to a power of two: the descendants
+  // that many levels below slot k start at slot k * prefetch_stride.
+  static constexpr size_type prefetch_stride() {
+    size_type stride = 1;
+    while (stride * 2 * sizeof(Key) <= 64) {
+      stride *= 2;
+    }
+    return stride;
+  }
+
+  // keys_[k - 1] holds slot k.
+  vector<Key> keys_;
+  Comparator tree_comparator;
+};
+
+template <typename Key, typename Comparator>
+EytzingerArray<Key, Comparator>::const_iterator::const_iterator(
+    const EytzingerArray* owner, size_type slot)
+    : owner_(owner), slot_(slot) {}
+
+template <typename Key, typename Comparator>
+const Key& EytzingerArray<Key, Comparator>::const_iterator::operator*()
+    const {
+  return owner_->keys_.data()[slot_ - 1];
+}
+
+template <typename Key, typename Comparator>
+const Key* EytzingerArray<Key, Comparator>::const_iterator::operator->()
+    const {
+  return &**this;
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::const_iterator&
+EytzingerArray<Key, Comparator>::const_iterator::operator++() {
+  slot_ = next_slot(slot_, owner_->keys_.size());
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::const_iterator
+EytzingerArray<Key, Comparator>::const_iterator::operator++(int) {
+  const_iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::const_iterator&
+EytzingerArray<Key, Comparator>::const_iterator::operator--() {
+  slot_ = prev_slot(slot_, owner_->keys_.size());
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::const_iterator
+EytzingerArray<Key, Comparator>::const_iterator::operator--(int) {
+  const_iterator previous = *this;
+  --*this;
+  return previous;
+}
+
+template <typename Key, typename Comparator>
+bool EytzingerArray<Key, Comparator>::const_iterator::operator==(
+    const const_iterator& other) const {
+  return slot_ == other.slot_;
+}
+
+template <typename Key, typename Comparator>
+bool EytzingerArray<Key, Comparator>::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return slot_ != other.slot_;
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::size_type
+EytzingerArray<Key, Comparator>::const_iterator::slot() const {
+  return slot_;
+}
+
+template <typename Key, typename Comparator>
+EytzingerArray<Key, Comparator>::EytzingerArray(
+    EytzingerArray&& other) noexcept
+    : keys_(std::move(other.keys_)),
+      tree_comparator(other.tree_comparator) {}
+
+template <typename Key, typename Comparator>
+EytzingerArray<Key, Comparator>& EytzingerArray<Key, Comparator>::operator=(
+    const EytzingerArray& other) {
+  if (this != &other) {
+    EytzingerArray copy(other);
+    tree_swap(copy);
+  }
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+EytzingerArray<Key, Comparator>& EytzingerArray<Key, Comparator>::operator=(
+    EytzingerArray&& other) noexcept {
+  if (this != &other) {
+    keys_.clear();
+    tree_swap(other);
+  }
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::const_iterator
+EytzingerArray<Key, Comparator>::tree_begin() const {
+  return const_iterator(this, first_slot(keys_.size()));
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::const_iterator
+EytzingerArray<Key, Comparator>::tree_end() const {
+  return const_iterator(this, 0);
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::size_type
+EytzingerArray<Key, Comparator>::tree_size() const {
+  return keys_.size();
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::size_type
+EytzingerArray<Key, Comparator>::tree_max_size() const {
+  return keys_.max_size();
+}
+
+template <typename Key, typename Comparator>
+bool EytzingerArray<Key, Comparator>::tree_empty() const {
+  return keys_.empty();
+}
+
+template <typename Key, typename Comparator>
+void EytzingerArray<Key, Comparator>::tree_swap(
+    EytzingerArray& other) noexcept {
+  keys_.swap(other.keys_);
+  std::swap(tree_comparator, other.tree_comparator);
+}
+
+// The descent appends one bit per level: 1 for going right past a smaller
+// key. The answer is the last slot where it went left, so the trailing run
+// of right turns and that left turn are shifted back out; a search that
+// never went left shifts down to 0, the end.
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::size_type
+EytzingerArray<Key, Comparator>::lower_slot(const Key& key) const {
+  const Key* keys = keys_.data();
+  size_type count = keys_.size();
+  size_type slot = 1;
+  while (slot <= count) {
+    __builtin_prefetch(keys + prefetch_stride() * slot - 1);
+    slot = 2 * slot + tree_comparator(keys[slot - 1], key);
+  }
+  return slot >> __builtin_ffsll(static_cast<long long>(~slot));
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::size_type
+EytzingerArray<Key, Comparator>::upper_slot(const Key& key) const {
+  const Key* keys = keys_.data();
+  size_type count = keys_.size();
+  size_type slot = 1;
+  while (slot <= count) {
+    __builtin_prefetch(keys + prefetch_stride() * slot - 1);
+    slot = 2 * slot + !tree_comparator(key, keys[slot - 1]);
+  }
+  return slot >> __builtin_ffsll(static_cast<long long>(~slot));
+}
+
+// Whether slot, typically a lower bound, holds a key equivalent to key.
+template <typename Key, typename Comparator>
+bool EytzingerArray<Key, Comparator>::holds(size_type slot,
+                                            const Key& key) const {
+  return slot != 0 && !tree_comparator(key, keys_.data()[slot - 1]);
+}
+
+// Calls emit(rank) once per slot, in slot order, with the position in
+// sorted order of the key that belongs there. Building an array is then a
+// push_back of the rank-th element of the sorted input for each call. The
+// input should be staged in a contiguous buffer first: the deep levels,
+// which hold most slots, read it nearly in order, while gathering straight
+// from tree nodes would miss the cache on almost every element.
+template <typename Key, typename Comparator>
+template <typename Emit>
+void EytzingerArray<Key, Comparator>::for_each_rank(size_type count,
+                                                    Emit emit) {
+  std::vector<size_type> ranks(count);
+  size_type slot = first_slot(count);
+  for (size_type rank = 0; rank < count; ++rank) {
+    ranks[slot - 1] = rank;
+    slot = next_slot(slot, count);
+  }
+  for (size_type rank : ranks) {
+    emit(rank);
+  }
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::size_type
+EytzingerArray<Key, Comparator>::first_slot(size_type count) {
+  if (count == 0) {
+    return 0;
+  }
+  size_type slot = 1;
+  while (2 * slot <= count) {
+    slot *= 2;
+  }
+  return slot;
+}
+
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::size_type
+EytzingerArray<Key, Comparator>::last_slot(size_type count) {
+  if (count == 0) {
+    return 0;
+  }
+  size_type slot = 1;
+  while (2 * slot + 1 <= count) {
+    slot = 2 * slot + 1;
+  }
+  return slot;
+}
+
+// In-order successor: the leftmost slot of the right subtree if there is
+// one, otherwise the parent of the nearest ancestor reached from the left.
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::size_type
+EytzingerArray<Key, Comparator>::next_slot(size_type slot, size_type count) {
+  if (2 * slot + 1 <= count) {
+    slot = 2 * slot + 1;
+    while (2 * slot <= count) {
+      slot *= 2;
+    }
+    return slot;
+  }
+  while (slot & 1) {
+    slot >>= 1;
+  }
+  return slot >> 1;
+}
+
+// Mirror of next_slot; stepping back from the end gives the last slot.
+template <typename Key, typename Comparator>
+typename EytzingerArray<Key, Comparator>::size_type
+EytzingerArray<Key, Comparator>::prev_slot(size_type slot, size_type count) {
+  if (slot == 0) {
+    return last_slot(count);
+  }
+  if (2 * slot <= count) {
+    slot *= 2;
+    while (2 * slot + 1 <= count) {
+      slot = 2 * slot + 1;
+    }
+    return slot;
+  }
+  while (!(slot & 1)) {
+    slot >>= 1;
+  }
+  return slot >> 1;
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,998 @@
+#ifndef S21_SRC_HASH_TABLE_H
+#define S21_SRC_HASH_TABLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace s21 {
+
+// Enables the heterogeneous lookup overloads for a lookup type K when both
+// the hasher and the key equality declare is_transparent.
+template <typename Hash, typename KeyEqual, typename K, typename = void>
+struct transparent_hash_key {};
+
+template <typename Hash, typename KeyEqual, typename K>
+struct transparent_hash_key<Hash, KeyEqual, K,
+                            std::void_t<typename Hash::is_transparent,
+                                        typename KeyEqual::is_transparent>> {
+  using type = K;
+};
+
+template <typename Hash, typename KeyEqual, typename K>
+using transparent_hash_key_t =
+    typename transparent_hash_key<Hash, KeyEqual, K>::type;
+
+// Open-addressing backend for unordered_map and unordered_set, laid out as
+// a Swiss table. Every slot has a control byte: empty, deleted or, for a
+// full slot, the low 7 bits of its hash. A probe loads 16 control bytes at
+// once and compares them against those 7 bits in one SSE2 instruction, so
+// keys are only compared on a near-certain hit and a miss usually stops at
+// the first group. With Value = void the slots hold bare keys.
+//
+// The capacity is always 2^k - 1. Control byte [capacity] is a sentinel
+// that stops iteration, and the 15 bytes after it mirror the first 15 so a
+// group can be loaded at any slot without wrapping around.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+class HashTable {
+ public:
+  using slot_type = std::conditional_t<std::is_void_v<Value>, Key,
+                                       std::pair<const Key, Value>>;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+ protected:
+  using ctrl_t = signed char;
+  using slot_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<slot_type>;
+  using ctrl_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<ctrl_t>;
+  using slot_traits = std::allocator_traits<slot_allocator>;
+  using ctrl_traits = std::allocator_traits<ctrl_allocator>;
+
+  static constexpr ctrl_t kEmpty = -128;
+  static constexpr ctrl_t kDeleted = -2;
+  static constexpr ctrl_t kSentinel = -1;
+  static constexpr size_type kGroupWidth = 16;
+  static constexpr size_type kClonedBytes = kGroupWidth - 1;
+  // At most 7/8 of the slots hold elements. growth_of() and
+  // table_max_load_factor() both derive from this ratio.
+  static constexpr size_type kMaxLoadNumerator = 7;
+  static constexpr size_type kMaxLoadDenominator = 8;
+
+  // Bitmask over one group of control bytes, bit i for the byte at i.
+  class group {
+   public:
+    explicit group(const ctrl_t* position);
+    uint32_t match(ctrl_t h2) const;
+    uint32_t match_empty() const;
+    uint32_t match_empty_or_deleted() const;
+
+   private:
+#if defined(__SSE2__)
+    __m128i bytes_;
+#else
+    const ctrl_t* bytes_;
+#endif
+  };
+
+ public:
+  class iterator {
+   public:
+    friend HashTable;
+    iterator() = default;
+    iterator(ctrl_t* ctrl, slot_type* slot);
+
+    iterator& operator++();
+    iterator operator++(int);
+
+    bool operator!=(const iterator& other) const;
+    bool operator==(const iterator& other) const;
+
+    slot_type& operator*() const;
+    slot_type* operator->() const;
+
+   protected:
+    // Moves forward to the next full slot or the sentinel.
+    void skip_free();
+
+    ctrl_t* ctrl_ = nullptr;
+    slot_type* slot_ = nullptr;
+  };
+
+  class const_iterator {
+   public:
+    friend HashTable;
+    const_iterator() = default;
+    const_iterator(const ctrl_t* ctrl, const slot_type* slot);
+    const_iterator(const iterator& other);
+
+    const_iterator& operator++();
+    const_iterator operator++(int);
+
+    bool operator!=(const const_iterator& other) const;
+    bool operator==(const const_iterator& other) const;
+
+    const slot_type& operator*() const;
+    const slot_type* operator->() const;
+
+   protected:
+    void skip_free();
+
+    const ctrl_t* ctrl_ = nullptr;
+    const slot_type* slot_ = nullptr;
+  };
+
+ protected:
+  HashTable();
+  HashTable(const HashTable& other);
+  HashTable(HashTable&& other) noexcept;
+  ~HashTable();
+  HashTable& operator=(const HashTable& other);
+  HashTable& operator=(HashTable&& other) noexcept;
+
+  iterator table_begin();
+  const_iterator table_begin() const;
+  iterator table_end();
+  const_iterator table_end() const;
+  size_type table_size() const;
+  bool table_empty() const;
+  size_type table_max_size() const;
+  size_type table_capacity() const;
+  static constexpr float table_max_load_factor() {
+    return static_cast<float>(kMaxLoadNumerator) / kMaxLoadDenominator;
+  }
+  allocator_type table_get_allocator() const;
+
+  template <typename K>
+  iterator table_find(const K& key);
+  template <typename K>
+  const_iterator table_find(const K& key) const;
+  template <typename K>
+  bool table_contains(const K& key) const;
+
+  template <typename S>
+  std::pair<iterator, bool> table_insert(S&& value);
+  template <typename... Args>
+  std::pair<iterator, bool> table_emplace(Args&&... args);
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> table_try_emplace(K&& key, Args&&... args);
+  void table_erase(const_iterator pos);
+  template <typename K>
+  size_type table_erase_key(const K& key);
+  void table_clear();
+  void table_merge(HashTable& other);
+  void table_swap(HashTable& other) noexcept;
+  void table_reserve(size_type count);
+  void table_rehash(size_type count);
+
+ private:
+  static ctrl_t* empty_group();
+  static size_type mix(size_t hash);
+  static ctrl_t h2_of(size_type hash);
+  static const Key& key_of(const slot_type& slot);
+  static size_type capacity_for(size_type count);
+  static size_type growth_of(size_type capacity);
+
+  template <typename K>
+  size_type hash_of(const K& key) const;
+  template <typename K>
+  size_type find_index(const K& key, size_type hash) const;
+  size_type find_free(size_type hash) const;
+  // Finds key, or claims a free slot for it and returns false; the caller
+  // then constructs the slot or calls abandon_slot().
+  template <typename K>
+  std::pair<size_type, bool> find_or_prepare(const K& key);
+  template <typename... Args>
+  std::pair<iterator, bool> construct_at(size_type index, Args&&... args);
+  void abandon_slot(size_type index);
+  void set_ctrl(size_type index, ctrl_t value);
+  void resize(size_type capacity);
+  void destroy_slots();
+  void release();
+  iterator iterator_at(size_type index);
+
+  ctrl_t* ctrl_;
+  slot_type* slots_ = nullptr;
+  size_type capacity_ = 0;
+  size_type size_ = 0;
+  // Free slots left before the 7/8 load limit; tombstones are not refunded.
+  size_type growth_left_ = 0;
+  Hash hasher_;
+  KeyEqual key_equal_;
+  allocator_type allocator_;
+};
+
+#if defined(__SSE2__)
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::group::group(
+    const ctrl_t* position)
+    : bytes_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(position))) {}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint32_t HashTable<Key, Value, Hash, KeyEqual, Allocator>::group::match(
+    ctrl_t h2) const {
+  return static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), bytes_)));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint32_t
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::group::match_empty() const {
+  return match(kEmpty);
+}
+
+// Empty and deleted are the only bytes below the sentinel.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint32_t HashTable<Key, Value, Hash, KeyEqual,
+                   Allocator>::group::match_empty_or_deleted() const {
+  return static_cast<uint32_t>(_mm_movemask_epi8(
+      _mm_cmpgt_epi8(_mm_set1_epi8(kSentinel), bytes_)));
+}
+
+#else
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::group::group(
+    const ctrl_t* position)
+    : bytes_(position) {}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint32_t HashTable<Key, Value, Hash, KeyEqual, Allocator>::group::match(
+    ctrl_t h2) const {
+  uint32_t result = 0;
+  for (size_type index = 0; index < kGroupWidth; ++index) {
+    result |= static_cast<uint32_t>(bytes_[index] == h2) << index;
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint32_t
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::group::match_empty() const {
+  return match(kEmpty);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint32_t HashTable<Key, Value, Hash, KeyEqual,
+                   Allocator>::group::match_empty_or_deleted() const {
+  uint32_t result = 0;
+  for (size_type index = 0; index < kGroupWidth; ++index) {
+    result |= static_cast<uint32_t>(bytes_[index] < kSentinel) << index;
+  }
+  return result;
+}
+
+#endif
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator::iterator(
+    ctrl_t* ctrl, slot_type* slot)
+    : ctrl_(ctrl), slot_(slot) {}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator&
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator::operator++() {
+  ++ctrl_;
+  ++slot_;
+  skip_free();
+  return *this;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator::operator++(int) {
+  iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+bool HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator::operator!=(
+    const iterator& other) const {
+  return ctrl_ != other.ctrl_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+bool HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator::operator==(
+    const iterator& other) const {
+  return ctrl_ == other.ctrl_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::slot_type&
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator::operator*()
+    const {
+  return *slot_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::slot_type*
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator::operator->()
+    const {
+  return slot_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator::skip_free() {
+  while (*ctrl_ < kSentinel) {
+    ++ctrl_;
+    ++slot_;
+  }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::const_iterator::
+    const_iterator(const ctrl_t* ctrl, const slot_type* slot)
+    : ctrl_(ctrl), slot_(slot) {}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::const_iterator::
+    const_iterator(const iterator& other)
+    : ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::const_iterator&
+HashTable<Key, Value, Hash, KeyEqual,
+          Allocator>::const_iterator::operator++() {
+  ++ctrl_;
+  ++slot_;
+  skip_free();
+  return *this;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::const_iterator
+HashTable<Key, Value, Hash, KeyEqual,
+          Allocator>::const_iterator::operator++(int) {
+  const_iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+bool HashTable<Key, Value, Hash, KeyEqual,
+               Allocator>::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return ctrl_ != other.ctrl_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+bool HashTable<Key, Value, Hash, KeyEqual,
+               Allocator>::const_iterator::operator==(
+    const const_iterator& other) const {
+  return ctrl_ == other.ctrl_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+const typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::slot_type&
+HashTable<Key, Value, Hash, KeyEqual,
+          Allocator>::const_iterator::operator*() const {
+  return *slot_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+const typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::slot_type*
+HashTable<Key, Value, Hash, KeyEqual,
+          Allocator>::const_iterator::operator->() const {
+  return slot_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual,
+               Allocator>::const_iterator::skip_free() {
+  while (*ctrl_ < kSentinel) {
+    ++ctrl_;
+    ++slot_;
+  }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::HashTable()
+    : ctrl_(empty_group()) {}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::HashTable(
+    const HashTable& other)
+    : ctrl_(empty_group()),
+      hasher_(other.hasher_),
+      key_equal_(other.key_equal_),
+      allocator_(std::allocator_traits<Allocator>::
+                     select_on_container_copy_construction(
+                         other.allocator_)) {
+  try {
+    table_reserve(other.size_);
+    for (const_iterator it = other.table_begin(); it != other.table_end();
+         ++it) {
+      size_type hash = hash_of(key_of(*it));
+      size_type index = find_free(hash);
+      set_ctrl(index, h2_of(hash));
+      ++size_;
+      --growth_left_;
+      construct_at(index, *it);
+    }
+  } catch (...) {
+    release();
+    throw;
+  }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::HashTable(
+    HashTable&& other) noexcept
+    : ctrl_(std::exchange(other.ctrl_, empty_group())),
+      slots_(std::exchange(other.slots_, nullptr)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      size_(std::exchange(other.size_, 0)),
+      growth_left_(std::exchange(other.growth_left_, 0)),
+      hasher_(other.hasher_),
+      key_equal_(other.key_equal_),
+      allocator_(other.allocator_) {}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::~HashTable() {
+  release();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>&
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::operator=(
+    const HashTable& other) {
+  if (this != &other) {
+    HashTable copy(other);
+    table_swap(copy);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>&
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::operator=(
+    HashTable&& other) noexcept {
+  if (this != &other) {
+    release();
+    ctrl_ = empty_group();
+    slots_ = nullptr;
+    capacity_ = size_ = growth_left_ = 0;
+    table_swap(other);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_begin() {
+  iterator result(ctrl_, slots_);
+  result.skip_free();
+  return result;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::const_iterator
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_begin() const {
+  const_iterator result(ctrl_, slots_);
+  result.skip_free();
+  return result;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_end() {
+  return iterator_at(capacity_);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::const_iterator
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_end() const {
+  return const_iterator(ctrl_ + capacity_, slots_ + capacity_);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::size_type
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_size() const {
+  return size_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+bool HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_empty() const {
+  return size_ == 0;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::size_type
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_max_size() const {
+  return growth_of(std::numeric_limits<size_type>::max() /
+                   (sizeof(slot_type) + 1));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::size_type
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_capacity() const {
+  return capacity_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::allocator_type
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_get_allocator()
+    const {
+  return allocator_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_find(const K& key) {
+  return iterator_at(find_index(key, hash_of(key)));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::const_iterator
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_find(
+    const K& key) const {
+  size_type index = find_index(key, hash_of(key));
+  return const_iterator(ctrl_ + index, slots_ + index);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K>
+bool HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_contains(
+    const K& key) const {
+  return find_index(key, hash_of(key)) != capacity_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename S>
+std::pair<typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+          bool>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_insert(S&& value) {
+  auto [index, found] = find_or_prepare(key_of(value));
+  if (found) {
+    return {iterator_at(index), false};
+  }
+  return construct_at(index, std::forward<S>(value));
+}
+
+// The key is only known once the value exists, so it is built up front and
+// moved into the slot.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename... Args>
+std::pair<typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+          bool>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_emplace(
+    Args&&... args) {
+  return table_insert(slot_type(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K, typename... Args>
+std::pair<typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+          bool>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_try_emplace(
+    K&& key, Args&&... args) {
+  auto [index, found] = find_or_prepare(key);
+  if (found) {
+    return {iterator_at(index), false};
+  }
+  return construct_at(index, std::piecewise_construct,
+                      std::forward_as_tuple(std::forward<K>(key)),
+                      std::forward_as_tuple(std::forward<Args>(args)...));
+}
+
+// Leaves a tombstone so that probe sequences passing through the slot
+// still reach the keys behind it; the next rehash clears them out.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_erase(
+    const_iterator pos) {
+  size_type index = static_cast<size_type>(pos.ctrl_ - ctrl_);
+  slot_allocator allocator(allocator_);
+  slot_traits::destroy(allocator, slots_ + index);
+  set_ctrl(index, kDeleted);
+  --size_;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::size_type
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_erase_key(
+    const K& key) {
+  size_type index = find_index(key, hash_of(key));
+  if (index == capacity_) {
+    return 0;
+  }
+  table_erase(const_iterator(ctrl_ + index, slots_ + index));
+  return 1;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_clear() {
+  if (capacity_ == 0) {
+    return;
+  }
+  destroy_slots();
+  for (size_type index = 0; index < capacity_ + 1 + kClonedBytes; ++index) {
+    ctrl_[index] = kEmpty;
+  }
+  ctrl_[capacity_] = kSentinel;
+  size_ = 0;
+  growth_left_ = growth_of(capacity_);
+}
+
+// Keys this table already holds stay in other, as in map::merge.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_merge(
+    HashTable& other) {
+  if (this == &other) {
+    return;
+  }
+  for (iterator it = other.table_begin(); it != other.table_end(); ++it) {
+    auto [index, found] = find_or_prepare(key_of(*it));
+    if (!found) {
+      construct_at(index, std::move(*it));
+      other.table_erase(it);
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_swap(
+    HashTable& other) noexcept {
+  std::swap(ctrl_, other.ctrl_);
+  std::swap(slots_, other.slots_);
+  std::swap(capacity_, other.capacity_);
+  std::swap(size_, other.size_);
+  std::swap(growth_left_, other.growth_left_);
+  std::swap(hasher_, other.hasher_);
+  std::swap(key_equal_, other.key_equal_);
+  std::swap(allocator_, other.allocator_);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_reserve(
+    size_type count) {
+  if (count > size_ + growth_left_) {
+    resize(capacity_for(count));
+  }
+}
+
+// Rebuilds at the smallest capacity that holds both count and the current
+// elements under the load limit, which also drops every tombstone.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::table_rehash(
+    size_type count) {
+  size_type capacity = capacity_for(std::max(count, size_));
+  if (count == 0 && size_ == 0) {
+    release();
+    ctrl_ = empty_group();
+    slots_ = nullptr;
+    capacity_ = growth_left_ = 0;
+  } else {
+    resize(capacity);
+  }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::ctrl_t*
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::empty_group() {
+  alignas(16) static ctrl_t group[kGroupWidth] = {
+      kSentinel, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty,
+      kEmpty,    kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty};
+  return group;
+}
+
+// std::hash is the identity for integers, which would put consecutive keys
+// in one group and leave the 7 tag bits all alike. The multiply spreads
+// every input bit upwards and the shift folds the high half back down.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::size_type
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::mix(size_t hash) {
+  uint64_t mixed = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<size_type>(mixed ^ (mixed >> 32));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::ctrl_t
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::h2_of(size_type hash) {
+  return static_cast<ctrl_t>(hash & 0x7F);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+const Key& HashTable<Key, Value, Hash, KeyEqual, Allocator>::key_of(
+    const slot_type& slot) {
+  if constexpr (std::is_void_v<Value>) {
+    return slot;
+  } else {
+    return slot.first;
+  }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::size_type
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::capacity_for(
+    size_type count) {
+  size_type capacity = kClonedBytes;
+  while (growth_of(capacity) < count) {
+    capacity = capacity * 2 + 1;
+  }
+  return capacity;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::size_type
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::growth_of(
+    size_type capacity) {
+  return capacity / kMaxLoadDenominator * kMaxLoadNumerator +
+         capacity % kMaxLoadDenominator * kMaxLoadNumerator /
+             kMaxLoadDenominator;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::size_type
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::hash_of(
+    const K& key) const {
+  return mix(hasher_(key));
+}
+
+// Probes whole groups in triangular steps, which visits every group of a
+// power-of-two table once. Returns capacity_ when the key is absent.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::size_type
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::find_index(
+    const K& key, size_type hash) const {
+  ctrl_t h2 = h2_of(hash);
+  size_type position = (hash >> 7) & capacity_;
+  for (size_type step = kGroupWidth;; step += kGroupWidth) {
+    group probe(ctrl_ + position);
+    for (uint32_t match = probe.match(h2); match != 0; match &= match - 1) {
+      size_type index = (position + __builtin_ctz(match)) & capacity_;
+      if (key_equal_(key_of(slots_[index]), key)) {
+        return index;
+      }
+    }
+    if (probe.match_empty() != 0) {
+      return capacity_;
+    }
+    position = (position + step) & capacity_;
+  }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::size_type
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::find_free(
+    size_type hash) const {
+  size_type position = (hash >> 7) & capacity_;
+  for (size_type step = kGroupWidth;; step += kGroupWidth) {
+    uint32_t free = group(ctrl_ + position).match_empty_or_deleted();
+    if (free != 0) {
+      return (position + __builtin_ctz(free)) & capacity_;
+    }
+    position = (position + step) & capacity_;
+  }
+}
+
+// A tombstone can be reused without touching the load limit; an empty slot
+// cannot once growth runs out, so the table is rebuilt first.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K>
+std::pair<typename HashTable<Key, Value, Hash, KeyEqual,
+                             Allocator>::size_type,
+          bool>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::find_or_prepare(
+    const K& key) {
+  size_type hash = hash_of(key);
+  size_type index = find_index(key, hash);
+  if (index != capacity_) {
+    return {index, true};
+  }
+  index = find_free(hash);
+  if (growth_left_ == 0 && ctrl_[index] != kDeleted) {
+    if (capacity_ == 0) {
+      resize(kClonedBytes);
+    } else if (size_ * 32 <= capacity_ * 25) {
+      // Mostly tombstones: rebuilding at the same size is enough.
+      resize(capacity_);
+    } else {
+      resize(capacity_ * 2 + 1);
+    }
+    index = find_free(hash);
+  }
+  growth_left_ -= ctrl_[index] == kEmpty;
+  set_ctrl(index, h2_of(hash));
+  ++size_;
+  return {index, false};
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename... Args>
+std::pair<typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+          bool>
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::construct_at(
+    size_type index, Args&&... args) {
+  slot_allocator allocator(allocator_);
+  try {
+    slot_traits::construct(allocator, slots_ + index,
+                           std::forward<Args>(args)...);
+  } catch (...) {
+    abandon_slot(index);
+    throw;
+  }
+  return {iterator_at(index), true};
+}
+
+// A claimed slot whose value failed to construct becomes a tombstone, which
+// is safe whether or not other keys probed past it meanwhile.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::abandon_slot(
+    size_type index) {
+  set_ctrl(index, kDeleted);
+  --size_;
+}
+
+// Writes the byte and, for the first kClonedBytes slots, its mirror past
+// the sentinel; for later slots both writes land on the same byte.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::set_ctrl(
+    size_type index, ctrl_t value) {
+  ctrl_[index] = value;
+  ctrl_[((index - kClonedBytes) & capacity_) + kClonedBytes] = value;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::resize(
+    size_type capacity) {
+  ctrl_allocator ctrl_alloc(allocator_);
+  slot_allocator slot_alloc(allocator_);
+  size_type ctrl_size = capacity + 1 + kClonedBytes;
+  ctrl_t* ctrl = ctrl_traits::allocate(ctrl_alloc, ctrl_size);
+  slot_type* slots;
+  try {
+    slots = slot_traits::allocate(slot_alloc, capacity);
+  } catch (...) {
+    ctrl_traits::deallocate(ctrl_alloc, ctrl, ctrl_size);
+    throw;
+  }
+  for (size_type index = 0; index < ctrl_size; ++index) {
+    ctrl[index] = kEmpty;
+  }
+  ctrl[capacity] = kSentinel;
+
+  ctrl_t* old_ctrl = std::exchange(ctrl_, ctrl);
+  slot_type* old_slots = std::exchange(slots_, slots);
+  size_type old_capacity = std::exchange(capacity_, capacity);
+  growth_left_ = growth_of(capacity) - size_;
+  for (size_type index = 0; index < old_capacity; ++index) {
+    if (old_ctrl[index] >= 0) {
+      size_type hash = hash_of(key_of(old_slots[index]));
+      size_type target = find_free(hash);
+      set_ctrl(target, h2_of(hash));
+      slot_traits::construct(slot_alloc, slots_ + target,
+                             std::move(old_slots[index]));
+      slot_traits::destroy(slot_alloc, old_slots + index);
+    }
+  }
+  if (old_capacity != 0) {
+    ctrl_traits::deallocate(ctrl_alloc, old_ctrl,
+                            old_capacity + 1 + kClonedBytes);
+    slot_traits::deallocate(slot_alloc, old_slots, old_capacity);
+  }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::destroy_slots() {
+  if constexpr (!std::is_trivially_destructible_v<slot_type>) {
+    slot_allocator allocator(allocator_);
+    for (size_type index = 0; index < capacity_; ++index) {
+      if (ctrl_[index] >= 0) {
+        slot_traits::destroy(allocator, slots_ + index);
+      }
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashTable<Key, Value, Hash, KeyEqual, Allocator>::release() {
+  if (capacity_ == 0) {
+    return;
+  }
+  destroy_slots();
+  ctrl_allocator ctrl_alloc(allocator_);
+  slot_allocator slot_alloc(allocator_);
+  ctrl_traits::deallocate(ctrl_alloc, ctrl_, capacity_ + 1 + kClonedBytes);
+  slot_traits::deallocate(slot_alloc, slots_, capacity_);
+  size_ = 0;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator
+HashTable<Key, Value, Hash, KeyEqual, Allocator>::iterator_at(
+    size_type index) {
+  return iterator(ctrl_ + index, slots_ + index);
+}
+
+}  // namespace s21
+
+#endif
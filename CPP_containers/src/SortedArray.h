@@ -0,0 +1,477 @@
+#ifndef S21_SRC_SORTED_ARRAY_H
+#define S21_SRC_SORTED_ARRAY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "s21_vector.h"
+
+namespace s21 {
+
+// Lower bound over count sorted keys. The range halves every step whatever
+// the comparison says, so the loop has a fixed trip count and the choice
+// compiles to a conditional move instead of a branch the CPU mispredicts
+// half the time.
+template <typename Key, typename K, typename Comparator>
+size_t sorted_lower_bound(const Key* first, size_t count, const K& key,
+                          const Comparator& comparator) {
+  if (count == 0) {
+    return 0;
+  }
+  const Key* base = first;
+  while (count > 1) {
+    size_t half = count / 2;
+    base = comparator(base[half], key) ? base + half : base;
+    count -= half;
+  }
+  return static_cast<size_t>(base - first) + comparator(*base, key);
+}
+
+template <typename Key, typename K, typename Comparator>
+size_t sorted_upper_bound(const Key* first, size_t count, const K& key,
+                          const Comparator& comparator) {
+  if (count == 0) {
+    return 0;
+  }
+  const Key* base = first;
+  while (count > 1) {
+    size_t half = count / 2;
+    base = !comparator(key, base[half]) ? base + half : base;
+    count -= half;
+  }
+  return static_cast<size_t>(base - first) + !comparator(key, *base);
+}
+
+// Sorted-array backend for flat_set, flat_multiset and the key column of
+// flat_map. Keys sit contiguously in one s21::vector, so a lookup touches
+// log n cache lines without chasing a pointer, and a full scan is a linear
+// walk. Inserting and erasing shift the tail and invalidate iterators;
+// batches go through one sort and one merge instead.
+template <typename Key, typename Comparator = std::less<Key>>
+class SortedArray {
+ public:
+  using size_type = size_t;
+
+  // Keys are never modified in place, so one iterator type serves both.
+  class const_iterator {
+   public:
+    using difference_type = std::ptrdiff_t;
+
+    const_iterator() = default;
+    explicit const_iterator(const Key* position);
+
+    const Key& operator*() const;
+    const Key* operator->() const;
+    const_iterator& operator++();
+    const_iterator operator++(int);
+    const_iterator& operator--();
+    const_iterator operator--(int);
+    const_iterator operator+(difference_type offset) const;
+    const_iterator operator-(difference_type offset) const;
+    difference_type operator-(const const_iterator& other) const;
+
+    bool operator==(const const_iterator& other) const;
+    bool operator!=(const const_iterator& other) const;
+    bool operator<(const const_iterator& other) const;
+
+   private:
+    const Key* current_ = nullptr;
+  };
+
+ protected:
+  SortedArray() = default;
+  SortedArray(const SortedArray& other);
+  SortedArray(SortedArray&& other) noexcept;
+  ~SortedArray() = default;
+  SortedArray& operator=(const SortedArray& other);
+  SortedArray& operator=(SortedArray&& other) noexcept;
+
+  const_iterator tree_begin() const;
+  const_iterator tree_end() const;
+  const_iterator iterator_at(size_type index) const;
+  size_type index_of(const_iterator pos) const;
+  size_type tree_size() const;
+  size_type tree_max_size() const;
+  bool tree_empty() const;
+  void tree_reserve(size_type count);
+  void tree_swap(SortedArray& other) noexcept;
+
+  size_type lower_index(const Key& key) const;
+  size_type upper_index(const Key& key) const;
+  bool holds(size_type index, const Key& key) const;
+  const_iterator tree_find(const Key& key) const;
+  size_type tree_count(const Key& key) const;
+
+  std::pair<const_iterator, bool> tree_insert(const Key& key, bool unique);
+  void tree_erase(size_type first, size_type last);
+  size_type tree_erase_key(const Key& key);
+  template <typename InputIt>
+  void tree_insert_range(InputIt first, InputIt last, bool unique);
+  void tree_merge(SortedArray& other, bool unique);
+
+  // Column helpers shared with flat_map's value column.
+  template <typename T>
+  static void insert_at(vector<T>& column, size_type index, const T& item);
+  template <typename T>
+  static void erase_at(vector<T>& column, size_type first, size_type last);
+  template <typename T, typename KeyOf>
+  void sort_batch(std::vector<T>& batch, bool unique, KeyOf key_of) const;
+  template <typename T, typename KeyOf, typename Take>
+  void merge_batch(const std::vector<T>& batch, bool unique, KeyOf key_of,
+                   Take take) const;
+
+  vector<Key> keys_;
+  Comparator tree_comparator;
+};
+
+template <typename Key, typename Comparator>
+SortedArray<Key, Comparator>::const_iterator::const_iterator(
+    const Key* position)
+    : current_(position) {}
+
+template <typename Key, typename Comparator>
+const Key& SortedArray<Key, Comparator>::const_iterator::operator*() const {
+  return *current_;
+}
+
+template <typename Key, typename Comparator>
+const Key* SortedArray<Key, Comparator>::const_iterator::operator->() const {
+  return current_;
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::const_iterator&
+SortedArray<Key, Comparator>::const_iterator::operator++() {
+  ++current_;
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::const_iterator
+SortedArray<Key, Comparator>::const_iterator::operator++(int) {
+  const_iterator previous = *this;
+  ++current_;
+  return previous;
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::const_iterator&
+SortedArray<Key, Comparator>::const_iterator::operator--() {
+  --current_;
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::const_iterator
+SortedArray<Key, Comparator>::const_iterator::operator--(int) {
+  const_iterator previous = *this;
+  --current_;
+  return previous;
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::const_iterator
+SortedArray<Key, Comparator>::const_iterator::operator+(
+    difference_type offset) const {
+  return const_iterator(current_ + offset);
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::const_iterator
+SortedArray<Key, Comparator>::const_iterator::operator-(
+    difference_type offset) const {
+  return const_iterator(current_ - offset);
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::const_iterator::difference_type
+SortedArray<Key, Comparator>::const_iterator::operator-(
+    const const_iterator& other) const {
+  return current_ - other.current_;
+}
+
+template <typename Key, typename Comparator>
+bool SortedArray<Key, Comparator>::const_iterator::operator==(
+    const const_iterator& other) const {
+  return current_ == other.current_;
+}
+
+template <typename Key, typename Comparator>
+bool SortedArray<Key, Comparator>::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return current_ != other.current_;
+}
+
+template <typename Key, typename Comparator>
+bool SortedArray<Key, Comparator>::const_iterator::operator<(
+    const const_iterator& other) const {
+  return current_ < other.current_;
+}
+
+template <typename Key, typename Comparator>
+SortedArray<Key, Comparator>::SortedArray(const SortedArray& other)
+    : keys_(other.keys_), tree_comparator(other.tree_comparator) {}
+
+template <typename Key, typename Comparator>
+SortedArray<Key, Comparator>::SortedArray(SortedArray&& other) noexcept
+    : keys_(std::move(other.keys_)),
+      tree_comparator(other.tree_comparator) {}
+
+template <typename Key, typename Comparator>
+SortedArray<Key, Comparator>& SortedArray<Key, Comparator>::operator=(
+    const SortedArray& other) {
+  if (this != &other) {
+    SortedArray copy(other);
+    tree_swap(copy);
+  }
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+SortedArray<Key, Comparator>& SortedArray<Key, Comparator>::operator=(
+    SortedArray&& other) noexcept {
+  if (this != &other) {
+    keys_.clear();
+    tree_swap(other);
+  }
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::const_iterator
+SortedArray<Key, Comparator>::tree_begin() const {
+  return const_iterator(keys_.data());
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::const_iterator
+SortedArray<Key, Comparator>::tree_end() const {
+  return const_iterator(keys_.data() + keys_.size());
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::const_iterator
+SortedArray<Key, Comparator>::iterator_at(size_type index) const {
+  return const_iterator(keys_.data() + index);
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::size_type
+SortedArray<Key, Comparator>::index_of(const_iterator pos) const {
+  return static_cast<size_type>(pos - tree_begin());
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::size_type
+SortedArray<Key, Comparator>::tree_size() const {
+  return keys_.size();
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::size_type
+SortedArray<Key, Comparator>::tree_max_size() const {
+  return keys_.max_size();
+}
+
+template <typename Key, typename Comparator>
+bool SortedArray<Key, Comparator>::tree_empty() const {
+  return keys_.empty();
+}
+
+template <typename Key, typename Comparator>
+void SortedArray<Key, Comparator>::tree_reserve(size_type count) {
+  keys_.reserve(count);
+}
+
+template <typename Key, typename Comparator>
+void SortedArray<Key, Comparator>::tree_swap(SortedArray& other) noexcept {
+  keys_.swap(other.keys_);
+  std::swap(tree_comparator, other.tree_comparator);
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::size_type
+SortedArray<Key, Comparator>::lower_index(const Key& key) const {
+  return sorted_lower_bound(keys_.data(), keys_.size(), key, tree_comparator);
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::size_type
+SortedArray<Key, Comparator>::upper_index(const Key& key) const {
+  return sorted_upper_bound(keys_.data(), keys_.size(), key, tree_comparator);
+}
+
+// Whether the key at index, typically a lower bound, is equivalent to key.
+template <typename Key, typename Comparator>
+bool SortedArray<Key, Comparator>::holds(size_type index,
+                                         const Key& key) const {
+  return index < keys_.size() && !tree_comparator(key, keys_[index]);
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::const_iterator
+SortedArray<Key, Comparator>::tree_find(const Key& key) const {
+  size_type index = lower_index(key);
+  return holds(index, key) ? iterator_at(index) : tree_end();
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::size_type
+SortedArray<Key, Comparator>::tree_count(const Key& key) const {
+  return upper_index(key) - lower_index(key);
+}
+
+// Equal keys keep their insertion order: a new duplicate goes after them.
+template <typename Key, typename Comparator>
+std::pair<typename SortedArray<Key, Comparator>::const_iterator, bool>
+SortedArray<Key, Comparator>::tree_insert(const Key& key, bool unique) {
+  size_type index = unique ? lower_index(key) : upper_index(key);
+  if (unique && holds(index, key)) {
+    return {iterator_at(index), false};
+  }
+  insert_at(keys_, index, key);
+  return {iterator_at(index), true};
+}
+
+template <typename Key, typename Comparator>
+void SortedArray<Key, Comparator>::tree_erase(size_type first,
+                                              size_type last) {
+  erase_at(keys_, first, last);
+}
+
+template <typename Key, typename Comparator>
+typename SortedArray<Key, Comparator>::size_type
+SortedArray<Key, Comparator>::tree_erase_key(const Key& key) {
+  size_type first = lower_index(key);
+  size_type last = upper_index(key);
+  erase_at(keys_, first, last);
+  return last - first;
+}
+
+// Sorts the batch once and merges it in a single pass, O(n + m log m)
+// rather than the O(n * m) of shifting the tail for every key.
+template <typename Key, typename Comparator>
+template <typename InputIt>
+void SortedArray<Key, Comparator>::tree_insert_range(InputIt first,
+                                                     InputIt last,
+                                                     bool unique) {
+  std::vector<Key> batch;
+  for (; first != last; ++first) {
+    batch.push_back(*first);
+  }
+  auto key_of = [](const Key& key) -> const Key& { return key; };
+  sort_batch(batch, unique, key_of);
+  vector<Key> merged;
+  merged.reserve(keys_.size() + batch.size());
+  merge_batch(batch, unique, key_of, [&](bool existing, size_type index) {
+    merged.push_back(existing ? keys_[index] : batch[index]);
+  });
+  keys_.swap(merged);
+}
+
+// Keys other already holds stay there when unique is set, as in set.
+template <typename Key, typename Comparator>
+void SortedArray<Key, Comparator>::tree_merge(SortedArray& other,
+                                              bool unique) {
+  if (this == &other || other.keys_.empty()) {
+    return;
+  }
+  std::vector<Key> moved;
+  vector<Key> kept;
+  for (size_type index = 0; index < other.keys_.size(); ++index) {
+    const Key& key = other.keys_[index];
+    if (unique && holds(lower_index(key), key)) {
+      kept.push_back(key);
+    } else {
+      moved.push_back(key);
+    }
+  }
+  vector<Key> merged;
+  merged.reserve(keys_.size() + moved.size());
+  merge_batch(moved, false, [](const Key& key) -> const Key& { return key; },
+              [&](bool existing, size_type index) {
+                merged.push_back(existing ? keys_[index] : moved[index]);
+              });
+  keys_.swap(merged);
+  other.keys_.swap(kept);
+}
+
+// s21::vector::insert copies every element it shifts; appending and
+// rotating moves them instead. item may live in column itself, as in
+// s.insert(*s.begin()), and push_back frees the old buffer before copying
+// from it, so a full column gets a copy of item instead.
+template <typename Key, typename Comparator>
+template <typename T>
+void SortedArray<Key, Comparator>::insert_at(vector<T>& column,
+                                             size_type index, const T& item) {
+  if (column.size() < column.capacity()) {
+    column.push_back(item);
+  } else {
+    T copy(item);
+    column.push_back(copy);
+  }
+  T* data = column.data();
+  std::rotate(data + index, data + column.size() - 1, data + column.size());
+}
+
+template <typename Key, typename Comparator>
+template <typename T>
+void SortedArray<Key, Comparator>::erase_at(vector<T>& column,
+                                            size_type first, size_type last) {
+  T* data = column.data();
+  std::move(data + last, data + column.size(), data + first);
+  for (size_type count = last - first; count > 0; --count) {
+    column.pop_back();
+  }
+}
+
+// Stable, so of equal keys the first one in the batch wins when unique.
+template <typename Key, typename Comparator>
+template <typename T, typename KeyOf>
+void SortedArray<Key, Comparator>::sort_batch(std::vector<T>& batch,
+                                              bool unique,
+                                              KeyOf key_of) const {
+  auto less = [this, &key_of](const T& lhs, const T& rhs) {
+    return tree_comparator(key_of(lhs), key_of(rhs));
+  };
+  std::stable_sort(batch.begin(), batch.end(), less);
+  if (unique) {
+    auto equal = [&less](const T& lhs, const T& rhs) {
+      return !less(lhs, rhs) && !less(rhs, lhs);
+    };
+    batch.erase(std::unique(batch.begin(), batch.end(), equal), batch.end());
+  }
+}
+
+// Walks the stored keys and a sorted batch in step and reports each
+// element of the result in order as take(from_stored, index). Stored keys
+// go first among equals; with unique set, batch keys already stored are
+// skipped.
+template <typename Key, typename Comparator>
+template <typename T, typename KeyOf, typename Take>
+void SortedArray<Key, Comparator>::merge_batch(const std::vector<T>& batch,
+                                               bool unique, KeyOf key_of,
+                                               Take take) const {
+  size_type stored = 0;
+  size_type added = 0;
+  while (stored < keys_.size() || added < batch.size()) {
+    if (added == batch.size() ||
+        (stored < keys_.size() &&
+         !tree_comparator(key_of(batch[added]), keys_[stored]))) {
+      take(true, stored++);
+    } else if (unique && stored > 0 &&
+               !tree_comparator(keys_[stored - 1], key_of(batch[added]))) {
+      ++added;
+    } else {
+      take(false, added++);
+    }
+  }
+}
+
+}  // namespace s21
+
+#endif
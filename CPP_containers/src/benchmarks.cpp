@@ -0,0 +1,1300 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <map>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "s21_containers.h"
+#include "s21_containersplus.h"
+#include "s21_snapshot.h"
+
+namespace {
+
+// Atomic because several cases allocate from more than one thread.
+std::atomic<size_t> allocation_count{0};
+
+// Payload that owns heap memory and records every copy and move made of it.
+struct tracked {
+  static size_t copies;
+  static size_t moves;
+
+  std::vector<int> data;
+
+  explicit tracked(size_t length = 16) : data(length, 1) {}
+  tracked(const tracked& other) : data(other.data) { ++copies; }
+  tracked(tracked&& other) noexcept : data(std::move(other.data)) { ++moves; }
+  tracked& operator=(const tracked& other) {
+    data = other.data;
+    ++copies;
+    return *this;
+  }
+  tracked& operator=(tracked&& other) noexcept {
+    data = std::move(other.data);
+    ++moves;
+    return *this;
+  }
+};
+
+size_t tracked::copies = 0;
+size_t tracked::moves = 0;
+
+class stopwatch {
+ public:
+  stopwatch() : start_(std::chrono::steady_clock::now()) {}
+  double ms() const {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start_)
+        .count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+struct counters {
+  size_t allocations;
+  size_t copies;
+  size_t moves;
+
+  static counters now() {
+    return {allocation_count, tracked::copies, tracked::moves};
+  }
+};
+
+void report_insert(const char* name, size_t n, const counters& before,
+                   double ms) {
+  counters after = counters::now();
+  double count = static_cast<double>(n);
+  std::printf("  %-34s %8.2f allocs %8.2f copies %8.2f moves %9.2f ms\n", name,
+              (after.allocations - before.allocations) / count,
+              (after.copies - before.copies) / count,
+              (after.moves - before.moves) / count, ms);
+}
+
+template <typename Insert>
+void run_insert(const char* name, size_t n, Insert insert) {
+  counters before = counters::now();
+  stopwatch timer;
+  insert(n);
+  report_insert(name, n, before, timer.ms());
+}
+
+// Per-insert allocations, copies and moves of a heap-owning mapped value.
+// Every s21 path must construct the element exactly once: one allocation for
+// the node and one for the vector, with no copies on the move-aware paths.
+void bench_insert_copies(size_t n) {
+  std::printf("insert_copies: %zu keys, per-insert counts\n", n);
+  run_insert("s21::map insert(const value_type&)", n, [](size_t count) {
+    s21::map<int, tracked> m;
+    for (size_t i = 0; i < count; ++i) {
+      const std::pair<const int, tracked> value(static_cast<int>(i), tracked());
+      m.insert(value);
+    }
+  });
+  run_insert("s21::map insert(value_type&&)", n, [](size_t count) {
+    s21::map<int, tracked> m;
+    for (size_t i = 0; i < count; ++i) {
+      m.insert(std::pair<const int, tracked>(static_cast<int>(i), tracked()));
+    }
+  });
+  run_insert("s21::map emplace", n, [](size_t count) {
+    s21::map<int, tracked> m;
+    for (size_t i = 0; i < count; ++i) {
+      m.emplace(std::piecewise_construct,
+                std::forward_as_tuple(static_cast<int>(i)),
+                std::forward_as_tuple());
+    }
+  });
+  run_insert("s21::map try_emplace", n, [](size_t count) {
+    s21::map<int, tracked> m;
+    for (size_t i = 0; i < count; ++i) {
+      m.try_emplace(static_cast<int>(i));
+    }
+  });
+  run_insert("s21::map try_emplace (duplicates)", n, [](size_t count) {
+    s21::map<int, tracked> m;
+    for (size_t i = 0; i < count; ++i) {
+      m.try_emplace(static_cast<int>(i % 64));
+    }
+  });
+  run_insert("std::map try_emplace", n, [](size_t count) {
+    std::map<int, tracked> m;
+    for (size_t i = 0; i < count; ++i) {
+      m.try_emplace(static_cast<int>(i));
+    }
+  });
+}
+
+template <typename Map>
+void run_fill_and_clear(const char* name, size_t n) {
+  Map m;
+  stopwatch insert_timer;
+  for (size_t i = 0; i < n; ++i) {
+    m.insert({static_cast<int>((i * 2654435761U) % n), static_cast<int>(i)});
+  }
+  double insert_ms = insert_timer.ms();
+  stopwatch clear_timer;
+  m.clear();
+  std::printf("  %-34s insert %9.2f ms   clear %9.2f ms\n", name, insert_ms,
+              clear_timer.ms());
+}
+
+// Node allocation through the heap versus the slab arena; clear() with the
+// arena and trivially destructible payloads skips the tree walk entirely.
+void bench_allocator_clear(size_t n) {
+  std::printf("allocator_clear: %zu keys\n", n);
+  run_fill_and_clear<s21::map<int, int>>("s21::map std::allocator", n);
+  run_fill_and_clear<s21::map<int, int, std::less<int>,
+                              s21::slab_allocator<std::pair<const int, int>>>>(
+      "s21::map slab_allocator", n);
+}
+
+// Range construction links a balanced tree in O(n) from sorted input; the
+// unsorted variant pays for a sort first.
+void bench_bulk_build(size_t n) {
+  std::printf("bulk_build: %zu keys\n", n);
+  std::vector<std::pair<int, int>> sorted(n);
+  for (size_t i = 0; i < n; ++i) {
+    sorted[i] = {static_cast<int>(i), static_cast<int>(i)};
+  }
+  std::vector<std::pair<int, int>> shuffled(sorted);
+  for (size_t i = 0; i < n; ++i) {
+    std::swap(shuffled[i], shuffled[(i * 2654435761U) % n]);
+  }
+
+  stopwatch one_by_one_timer;
+  {
+    s21::map<int, int> m;
+    for (const auto& item : sorted) {
+      m.insert(item);
+    }
+  }
+  std::printf("  %-34s %9.2f ms\n", "insert one by one (sorted)",
+              one_by_one_timer.ms());
+
+  stopwatch sorted_timer;
+  { s21::map<int, int> m(sorted.begin(), sorted.end()); }
+  std::printf("  %-34s %9.2f ms\n", "range constructor (sorted)",
+              sorted_timer.ms());
+
+  stopwatch unsorted_timer;
+  { s21::map<int, int> m(shuffled.begin(), shuffled.end()); }
+  std::printf("  %-34s %9.2f ms\n", "range constructor (unsorted)",
+              unsorted_timer.ms());
+}
+
+s21::map<int, int> make_map(size_t n, int stride, int offset) {
+  std::vector<std::pair<int, int>> items;
+  items.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    int key = static_cast<int>(i) * stride + offset;
+    items.push_back({key, key});
+  }
+  return s21::map<int, int>(items.begin(), items.end());
+}
+
+// merge() relinks the other tree's nodes, so it must not allocate per
+// element; similar sizes go through the O(n + m) flatten-and-rebuild path.
+void bench_merge(size_t n) {
+  std::printf("merge: %zu keys into %zu keys\n", n, n);
+  for (size_t other_size : {n, n / 1000}) {
+    s21::map<int, int> target = make_map(n, 2, 0);
+    s21::map<int, int> source = make_map(other_size, 2, 1);
+    size_t allocations = allocation_count;
+    stopwatch merge_timer;
+    target.merge(source);
+    double merge_ms = merge_timer.ms();
+    allocations = allocation_count - allocations;
+
+    s21::map<int, int> copy_target = make_map(n, 2, 0);
+    s21::map<int, int> copy_source = make_map(other_size, 2, 1);
+    stopwatch copy_timer;
+    while (!copy_source.empty()) {
+      copy_target.insert(*copy_source.begin());
+      copy_source.erase(copy_source.begin());
+    }
+    std::printf("  %8zu incoming: merge %9.2f ms (%zu allocs)   "
+                "insert+erase %9.2f ms\n",
+                other_size, merge_ms, allocations, copy_timer.ms());
+  }
+}
+
+// Join-based set operations against the element-wise contains/insert loop.
+// Operand copies are made before the timers start.
+void bench_set_algebra(size_t n) {
+  std::printf("set_algebra: %zu keys, %u hardware threads\n", n,
+              std::thread::hardware_concurrency());
+  auto make_set = [](size_t count, int stride) {
+    std::vector<int> keys(count);
+    for (size_t i = 0; i < count; ++i) {
+      keys[i] = static_cast<int>(i) * stride;
+    }
+    return s21::set<int>(keys.begin(), keys.end());
+  };
+  for (size_t rhs_size : {n, n / 1000}) {
+    s21::set<int> lhs = make_set(n, 2);
+    s21::set<int> rhs = make_set(rhs_size, 3);
+
+    // The smaller operand goes first: it is the one consumed and rebuilt.
+    s21::set<int> rhs_copy(rhs);
+    stopwatch intersection_timer;
+    s21::set<int> joined = s21::set_intersection(std::move(rhs_copy), lhs);
+    double intersection_ms = intersection_timer.ms();
+
+    stopwatch naive_intersection_timer;
+    s21::set<int> naive;
+    for (int key : rhs) {
+      if (lhs.contains(key)) {
+        naive.insert(key);
+      }
+    }
+    double naive_intersection_ms = naive_intersection_timer.ms();
+
+    s21::set<int> lhs_copy(lhs);
+    rhs_copy = rhs;
+    stopwatch union_timer;
+    joined = s21::set_union(std::move(lhs_copy), std::move(rhs_copy));
+    double union_ms = union_timer.ms();
+
+    lhs_copy = lhs;
+    stopwatch naive_union_timer;
+    for (int key : rhs) {
+      lhs_copy.insert(key);
+    }
+    double naive_union_ms = naive_union_timer.ms();
+
+    std::printf("  %8zu rhs keys: intersection %8.2f ms (element-wise %8.2f)"
+                "   union %8.2f ms (element-wise %8.2f)\n",
+                rhs_size, intersection_ms, naive_intersection_ms, union_ms,
+                naive_union_ms);
+  }
+}
+
+// count() and percentile lookups with subtree sizes against the plain tree,
+// where count walks the equal range and nth() has to walk from begin().
+void bench_order_statistics(size_t n) {
+  std::printf("order_statistics: %zu keys, 16 distinct\n", n);
+  s21::multiset<int> plain;
+  s21::multiset<int, std::less<int>, std::allocator<int>,
+                s21::order_statistics>
+      ranked;
+  for (size_t i = 0; i < n; ++i) {
+    plain.insert(static_cast<int>(i % 16));
+    ranked.insert(static_cast<int>(i % 16));
+  }
+
+  size_t total = 0;
+  stopwatch plain_count_timer;
+  for (int key = 0; key < 16; ++key) {
+    total += plain.count(key);
+  }
+  double plain_count_ms = plain_count_timer.ms();
+  stopwatch ranked_count_timer;
+  for (int key = 0; key < 16; ++key) {
+    total += ranked.count(key);
+  }
+  double ranked_count_ms = ranked_count_timer.ms();
+
+  stopwatch walk_timer;
+  for (size_t percentile = 1; percentile < 100; percentile += 10) {
+    auto it = plain.begin();
+    for (size_t step = n * percentile / 100; step > 0; --step) {
+      ++it;
+    }
+    total += static_cast<size_t>(*it);
+  }
+  double walk_ms = walk_timer.ms();
+  stopwatch nth_timer;
+  for (size_t percentile = 1; percentile < 100; percentile += 10) {
+    total += static_cast<size_t>(*ranked.nth(n * percentile / 100));
+  }
+  double nth_ms = nth_timer.ms();
+
+  std::printf("  count x16: plain %9.3f ms   order_statistics %9.3f ms\n",
+              plain_count_ms, ranked_count_ms);
+  std::printf("  percentile x10: walk %9.3f ms   nth %9.3f ms   (%zu)\n",
+              walk_ms, nth_ms, total);
+}
+
+struct benchmark_case {
+  const char* name;
+  void (*run)(size_t n);
+  size_t default_size;
+};
+
+// Evicts the oldest tenth of a session map keyed by expiry time, once by
+// erasing each entry through its iterator and once with a single range
+// erase that splits the tree instead of rebalancing after every node.
+void bench_erase_range(size_t n) {
+  std::printf("erase_range: %zu keys, evicting the oldest 10%%\n", n);
+  s21::map<int, int> one_by_one;
+  for (size_t i = 0; i < n; ++i) {
+    one_by_one.insert(static_cast<int>(i), static_cast<int>(i));
+  }
+  s21::map<int, int> ranged(one_by_one);
+  int expiry = static_cast<int>(n / 10);
+
+  stopwatch iterator_timer;
+  for (auto it = one_by_one.begin(); it != one_by_one.end() &&
+                                     it->first < expiry;) {
+    it = one_by_one.erase(it);
+  }
+  double iterator_ms = iterator_timer.ms();
+  stopwatch range_timer;
+  ranged.erase(ranged.begin(), ranged.lower_bound(expiry));
+  double range_ms = range_timer.ms();
+
+  std::printf("  erase(it) loop %9.2f ms   erase(first, last) %9.2f ms   "
+              "(%zu %zu)\n",
+              iterator_ms, range_ms, one_by_one.size(), ranged.size());
+
+  // A sliding window: sum the next 1% of keys, then drop them.
+  int window = std::max(1, static_cast<int>(n / 100));
+  long long stepped_sum = 0;
+  stopwatch stepped_timer;
+  for (int lo = expiry; lo < expiry + 10 * window; lo += window) {
+    for (auto it = one_by_one.lower_bound(lo);
+         it != one_by_one.end() && it->first < lo + window;) {
+      stepped_sum += it->second;
+      it = one_by_one.erase(it);
+    }
+  }
+  double stepped_ms = stepped_timer.ms();
+  long long ranged_sum = 0;
+  stopwatch window_timer;
+  for (int lo = expiry; lo < expiry + 10 * window; lo += window) {
+    ranged.for_each_in_range(lo, lo + window, [&ranged_sum](auto& item) {
+      ranged_sum += item.second;
+    });
+    ranged.erase_range(lo, lo + window);
+  }
+  double window_ms = window_timer.ms();
+  std::printf("  windows: lower_bound + erase(it) %9.2f ms   "
+              "for_each_in_range + erase_range %9.2f ms   (%lld %lld)\n",
+              stepped_ms, window_ms, stepped_sum, ranged_sum);
+}
+
+// Looks up keys that arrive as std::string_view, as a request parser hands
+// them over. Without a transparent comparator every probe builds a Key;
+// keys are long enough to defeat the small string buffer.
+template <bool Transparent, typename Map>
+void run_string_lookup(const char* name, const Map& tree,
+                       const std::vector<std::string>& probes) {
+  size_t hits = 0;
+  size_t allocations = allocation_count;
+  stopwatch timer;
+  for (const std::string& probe : probes) {
+    std::string_view view = probe;
+    if constexpr (Transparent) {
+      hits += tree.contains(view);
+    } else {
+      hits += tree.contains(std::string(view));
+    }
+  }
+  double ms = timer.ms();
+  std::printf("  %-22s %8.2f allocs/lookup %9.2f ms   (%zu hits)\n", name,
+              static_cast<double>(allocation_count - allocations) /
+                  probes.size(),
+              ms, hits);
+}
+
+void bench_transparent_lookup(size_t n) {
+  std::printf("transparent_lookup: %zu string_view lookups\n", n);
+  s21::map<std::string, int> plain;
+  s21::map<std::string, int, std::less<>> transparent;
+  std::vector<std::string> probes;
+  for (size_t i = 0; i < 10000; ++i) {
+    std::string key = "/api/v1/resource/" + std::to_string(i * 2);
+    plain.insert(key, static_cast<int>(i));
+    transparent.insert(key, static_cast<int>(i));
+  }
+  for (size_t i = 0; i < n; ++i) {
+    probes.push_back("/api/v1/resource/" + std::to_string(i % 20000));
+  }
+  run_string_lookup<false>("map<string>", plain, probes);
+  run_string_lookup<true>("map<string, less<>>", transparent, probes);
+}
+
+// Random keys so that lookups miss the cache the way they do on a large
+// production map; the same probe sequence is replayed against both trees.
+template <typename Map>
+void run_btree_size(const char* name, size_t n) {
+  std::vector<int> keys(n);
+  unsigned state = 12345U;
+  for (size_t i = 0; i < n; ++i) {
+    state = state * 1664525U + 1013904223U;
+    keys[i] = static_cast<int>(state >> 1);
+  }
+
+  Map tree;
+  stopwatch insert_timer;
+  for (size_t i = 0; i < n; ++i) {
+    tree.insert({keys[i], static_cast<int>(i)});
+  }
+  double insert_ms = insert_timer.ms();
+
+  size_t hits = 0;
+  stopwatch find_timer;
+  for (size_t i = 0; i < n; ++i) {
+    hits += tree.contains(keys[(i * 7919) % n]);
+  }
+  double find_ms = find_timer.ms();
+
+  long long sum = 0;
+  stopwatch scan_timer;
+  for (auto item : tree) {
+    sum += item.second;
+  }
+  double scan_ms = scan_timer.ms();
+
+  std::printf("  %-10s insert %6.1f ns  find %6.1f ns  scan %5.2f ns  "
+              "(%zu %lld)\n",
+              name, insert_ms * 1e6 / n, find_ms * 1e6 / n,
+              scan_ms * 1e6 / n, hits, sum);
+}
+
+void bench_btree(size_t n) {
+  std::printf("btree: per-element cost, random int keys\n");
+  for (size_t size = 1000; size <= n; size *= 10) {
+    std::printf(" %zu keys\n", size);
+    run_btree_size<s21::map<int, int>>("map", size);
+    run_btree_size<s21::btree_map<int, int>>("btree_map", size);
+  }
+}
+
+// s21::map behind a lock, the usual way to share an ordered map.
+template <typename Mutex>
+class locked_map {
+ public:
+  bool contains(int key) const {
+    if constexpr (std::is_same_v<Mutex, std::shared_mutex>) {
+      std::shared_lock<Mutex> lock(mutex_);
+      return map_.contains(key);
+    } else {
+      std::lock_guard<Mutex> lock(mutex_);
+      return map_.contains(key);
+    }
+  }
+  void insert(int key, int value) {
+    std::lock_guard<Mutex> lock(mutex_);
+    map_.insert(key, value);
+  }
+  void insert_or_assign(int key, int value) {
+    std::lock_guard<Mutex> lock(mutex_);
+    map_.insert_or_assign(key, value);
+  }
+  void erase(int key) {
+    std::lock_guard<Mutex> lock(mutex_);
+    map_.erase(key);
+  }
+
+ private:
+  mutable Mutex mutex_;
+  s21::map<int, int> map_;
+};
+
+// Each thread runs the same share of a 90% lookup, 5% upsert, 5% erase mix
+// over keys drawn uniformly from twice the initial size.
+template <typename Map>
+void run_read_write_mix(const char* name, Map& tree, size_t n,
+                        unsigned threads, size_t operations) {
+  std::atomic<size_t> hits{0};
+  std::vector<std::thread> workers;
+  stopwatch timer;
+  for (unsigned id = 0; id < threads; ++id) {
+    workers.emplace_back([&tree, &hits, n, id, operations, threads] {
+      unsigned state = 2654435761U * (id + 1);
+      size_t found = 0;
+      for (size_t i = 0; i < operations / threads; ++i) {
+        state = state * 1664525U + 1013904223U;
+        int key = static_cast<int>((state >> 8) % (2 * n));
+        unsigned choice = state % 100;
+        if (choice < 90) {
+          found += tree.contains(key);
+        } else if (choice < 95) {
+          tree.insert_or_assign(key, key);
+        } else {
+          tree.erase(key);
+        }
+      }
+      hits += found;
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  double ms = timer.ms();
+  std::printf("  %-22s %2u threads %8.2f Mops/s   (%zu hits)\n", name,
+              threads, operations / ms / 1e3, hits.load());
+}
+
+void bench_concurrent_map(size_t n) {
+  std::printf("concurrent_map: %zu keys, 90/5/5 read/upsert/erase, "
+              "%u hardware threads\n",
+              n, std::thread::hardware_concurrency());
+  const size_t operations = 2000000;
+  for (unsigned threads = 1; threads <= 8; threads *= 2) {
+    s21::concurrent_map<int, int> concurrent;
+    locked_map<std::shared_mutex> shared_locked;
+    locked_map<std::mutex> locked;
+    for (size_t i = 0; i < n; ++i) {
+      int key = static_cast<int>(2 * i);
+      concurrent.insert(key, key);
+      shared_locked.insert_or_assign(key, key);
+      locked.insert_or_assign(key, key);
+    }
+    run_read_write_mix("concurrent_map", concurrent, n, threads, operations);
+    run_read_write_mix("map + shared_mutex", shared_locked, n, threads,
+                       operations);
+    run_read_write_mix("map + mutex", locked, n, threads, operations);
+  }
+}
+
+// Write-heavy counterpart of run_read_write_mix: 50% lookups, 25% inserts
+// and 25% erases, so the key set keeps churning around its initial size.
+template <typename Map>
+void run_write_heavy_mix(const char* name, Map& tree, size_t n,
+                         unsigned threads, size_t operations) {
+  std::atomic<size_t> hits{0};
+  std::vector<std::thread> workers;
+  stopwatch timer;
+  for (unsigned id = 0; id < threads; ++id) {
+    workers.emplace_back([&tree, &hits, n, id, operations, threads] {
+      unsigned state = 2654435761U * (id + 1);
+      size_t found = 0;
+      for (size_t i = 0; i < operations / threads; ++i) {
+        state = state * 1664525U + 1013904223U;
+        int key = static_cast<int>((state >> 8) % (2 * n));
+        unsigned choice = state % 100;
+        if (choice < 50) {
+          found += tree.contains(key);
+        } else if (choice < 75) {
+          tree.insert(key, key);
+        } else {
+          tree.erase(key);
+        }
+      }
+      hits += found;
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  double ms = timer.ms();
+  std::printf("  %-22s %2u threads %8.2f Mops/s   (%zu hits)\n", name,
+              threads, operations / ms / 1e3, hits.load());
+}
+
+// Scales from one thread to twice the hardware threads, at least 8.
+void bench_skiplist_map(size_t n) {
+  std::printf("skiplist_map: %zu keys, 50/25/25 read/insert/erase, "
+              "%u hardware threads\n",
+              n, std::thread::hardware_concurrency());
+  const size_t operations = 2000000;
+  const unsigned most = std::max(8U, 2 * std::thread::hardware_concurrency());
+  for (unsigned threads = 1; threads <= most; threads *= 2) {
+    s21::skiplist_map<int, int> skiplist;
+    s21::concurrent_map<int, int> concurrent;
+    locked_map<std::mutex> locked;
+    for (size_t i = 0; i < n; ++i) {
+      int key = static_cast<int>(2 * i);
+      skiplist.insert(key, key);
+      concurrent.insert(key, key);
+      locked.insert(key, key);
+    }
+    run_write_heavy_mix("skiplist_map", skiplist, n, threads, operations);
+    run_write_heavy_mix("concurrent_map", concurrent, n, threads,
+                        operations);
+    run_write_heavy_mix("map + mutex", locked, n, threads, operations);
+  }
+}
+
+// Publishes a config map to readers after every update: a full copy of an
+// s21::map against a path-copying update plus an O(1) snapshot.
+void bench_persistent_snapshot(size_t n) {
+  std::printf("persistent_snapshot: %zu keys, update then publish\n", n);
+  const size_t publishes = 1000;
+  s21::map<int, int> plain;
+  s21::persistent_map<int, int> persistent;
+  for (size_t i = 0; i < n; ++i) {
+    plain.insert(static_cast<int>(i), static_cast<int>(i));
+    persistent.insert(static_cast<int>(i), static_cast<int>(i));
+  }
+
+  size_t sum = 0;
+  size_t allocations = allocation_count;
+  stopwatch copy_timer;
+  for (size_t i = 0; i < publishes; ++i) {
+    plain.insert_or_assign(static_cast<int>(i * 7919 % n), 0);
+    s21::map<int, int> published(plain);
+    sum += published.size();
+  }
+  double copy_ms = copy_timer.ms();
+  double copy_allocations =
+      static_cast<double>(allocation_count - allocations) / publishes;
+
+  allocations = allocation_count;
+  stopwatch snapshot_timer;
+  for (size_t i = 0; i < publishes; ++i) {
+    persistent.insert_or_assign(static_cast<int>(i * 7919 % n), 0);
+    s21::persistent_map<int, int> published = persistent.snapshot();
+    sum += published.size();
+  }
+  double snapshot_ms = snapshot_timer.ms();
+  double snapshot_allocations =
+      static_cast<double>(allocation_count - allocations) / publishes;
+
+  std::printf("  map copy        %9.4f ms/publish %10.1f allocs/publish\n",
+              copy_ms / publishes, copy_allocations);
+  std::printf("  persistent_map  %9.4f ms/publish %10.1f allocs/publish"
+              "   (%zu)\n",
+              snapshot_ms / publishes, snapshot_allocations, sum);
+}
+
+// Passes a large map by value to a function that only reads it, the
+// common case copy-on-write is meant for, then once to one that writes.
+template <typename Map>
+size_t read_by_value(Map copy, int key) {
+  const Map& view = copy;
+  return view.size() + view.contains(key);
+}
+
+template <typename Map>
+size_t write_by_value(Map copy, int key) {
+  copy.erase(key);
+  return copy.size();
+}
+
+template <typename Map>
+void run_pass_by_value(const char* name, const Map& tree, size_t n) {
+  const size_t calls = 100;
+  size_t sum = 0;
+  stopwatch read_timer;
+  for (size_t i = 0; i < calls; ++i) {
+    sum += read_by_value(tree, static_cast<int>(i));
+  }
+  double read_ms = read_timer.ms();
+  stopwatch write_timer;
+  sum += write_by_value(tree, static_cast<int>(n / 2));
+  double write_ms = write_timer.ms();
+  std::printf("  %-8s read-only call %9.4f ms   writing call %8.2f ms"
+              "   (%zu)\n",
+              name, read_ms / calls, write_ms, sum);
+}
+
+void bench_cow_copy(size_t n) {
+  std::printf("cow_copy: %zu keys passed by value\n", n);
+  s21::map<int, int> plain;
+  for (size_t i = 0; i < n; ++i) {
+    plain.insert(static_cast<int>(i), static_cast<int>(i));
+  }
+  s21::cow_map<int, int> shared(plain);
+  run_pass_by_value("map", plain, n);
+  run_pass_by_value("cow_map", shared, n);
+}
+
+// Builds each map from the same random pairs, the flat one in a single
+// bulk pass, then replays one random probe sequence against all three.
+template <typename Map>
+void run_flat_lookup(const char* name,
+                     const std::vector<std::pair<int, int>>& items) {
+  size_t n = items.size();
+  stopwatch build_timer;
+  Map tree(items.begin(), items.end());
+  double build_ms = build_timer.ms();
+
+  size_t hits = 0;
+  stopwatch find_timer;
+  for (size_t i = 0; i < n; ++i) {
+    hits += tree.contains(items[(i * 7919) % n].first + (i & 1));
+  }
+  double find_ms = find_timer.ms();
+
+  long long sum = 0;
+  stopwatch scan_timer;
+  for (auto item : tree) {
+    sum += item.second;
+  }
+  double scan_ms = scan_timer.ms();
+
+  std::printf("  %-10s build %6.1f ns  find %6.1f ns  scan %5.2f ns  "
+              "(%zu %lld)\n",
+              name, build_ms * 1e6 / n, find_ms * 1e6 / n,
+              scan_ms * 1e6 / n, hits, sum);
+}
+
+void bench_flat_lookup(size_t n) {
+  std::printf("flat_lookup: per-element cost, random int keys\n");
+  for (size_t size = 1000; size <= n; size *= 10) {
+    std::vector<std::pair<int, int>> items(size);
+    unsigned state = 54321U;
+    for (size_t i = 0; i < size; ++i) {
+      state = state * 1664525U + 1013904223U;
+      items[i] = {static_cast<int>(state >> 1), static_cast<int>(i)};
+    }
+    std::printf(" %zu keys\n", size);
+    run_flat_lookup<s21::map<int, int>>("map", items);
+    run_flat_lookup<s21::btree_map<int, int>>("btree_map", items);
+    run_flat_lookup<s21::flat_map<int, int>>("flat_map", items);
+  }
+
+  // A 1% batch into the largest table: one merge versus a shift per key.
+  std::vector<std::pair<int, int>> items(n);
+  std::vector<std::pair<int, int>> batch(n / 100);
+  for (size_t i = 0; i < n; ++i) {
+    items[i] = {static_cast<int>(i * 2), 0};
+  }
+  for (size_t i = 0; i < batch.size(); ++i) {
+    batch[i] = {static_cast<int>((i * 7919 % n) * 2 + 1), 0};
+  }
+  s21::flat_map<int, int> merged(items.begin(), items.end());
+  s21::flat_map<int, int> shifted(merged);
+  stopwatch merge_timer;
+  merged.insert(batch.begin(), batch.end());
+  double merge_ms = merge_timer.ms();
+  stopwatch shift_timer;
+  for (const auto& item : batch) {
+    shifted.insert(item);
+  }
+  double shift_ms = shift_timer.ms();
+  std::printf(" batch of %zu into %zu keys: merge %.2f ms  one by one "
+              "%.2f ms\n",
+              batch.size(), n, merge_ms, shift_ms);
+}
+
+// The same random keys and probe order against each map: half of the
+// probes hit, half miss, then a quarter of the keys are erased and
+// reinserted so that unordered_map works through its tombstones.
+template <typename Map>
+void run_hash_lookup(const char* name, const std::vector<int>& keys) {
+  size_t n = keys.size();
+  Map table;
+  stopwatch insert_timer;
+  for (size_t i = 0; i < n; ++i) {
+    table.insert({keys[i], static_cast<int>(i)});
+  }
+  double insert_ms = insert_timer.ms();
+
+  size_t hits = 0;
+  stopwatch find_timer;
+  for (size_t i = 0; i < n; ++i) {
+    hits += table.contains(keys[(i * 7919) % n] ^ static_cast<int>(i & 1));
+  }
+  double find_ms = find_timer.ms();
+
+  stopwatch churn_timer;
+  for (size_t i = 0; i < n / 4; ++i) {
+    table.erase(keys[i]);
+  }
+  for (size_t i = 0; i < n / 4; ++i) {
+    table.insert({keys[i], 0});
+  }
+  double churn_ms = churn_timer.ms();
+
+  std::printf("  %-14s insert %6.1f ns  find %6.1f ns  churn %6.1f ns  "
+              "(%zu)\n",
+              name, insert_ms * 1e6 / n, find_ms * 1e6 / n,
+              churn_ms * 1e6 / (n / 2), hits);
+}
+
+// std::unordered_map before C++20 has no contains.
+template <typename Key, typename Value>
+struct std_hash_map : std::unordered_map<Key, Value> {
+  bool contains(const Key& key) const { return this->count(key) != 0; }
+};
+
+void bench_hash_lookup(size_t n) {
+  std::printf("hash_lookup: per-element cost, random int keys\n");
+  for (size_t size = 1000; size <= n; size *= 10) {
+    std::vector<int> keys(size);
+    unsigned state = 777U;
+    for (size_t i = 0; i < size; ++i) {
+      state = state * 1664525U + 1013904223U;
+      keys[i] = static_cast<int>(state & ~1U);
+    }
+    std::printf(" %zu keys\n", size);
+    run_hash_lookup<s21::map<int, int>>("map", keys);
+    run_hash_lookup<std_hash_map<int, int>>("std::unordered", keys);
+    run_hash_lookup<s21::unordered_map<int, int>>("unordered_map", keys);
+  }
+}
+
+// Forward and backward walks over a map filled either in key order, so that
+// neighbours were allocated next to each other, or in random order, so that
+// they sit in unrelated nodes as they do after long use. Each walk is
+// repeated until it has visited at least 10M elements.
+void run_scan(const char* name, const std::vector<int>& keys) {
+  s21::map<int, int> tree;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    tree.insert(keys[i], static_cast<int>(i));
+  }
+  size_t rounds = std::max<size_t>(1, 10000000 / tree.size());
+
+  long long sum = 0;
+  stopwatch forward_timer;
+  for (size_t round = 0; round < rounds; ++round) {
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+      sum += (*it).second;
+    }
+  }
+  double forward_ms = forward_timer.ms();
+
+  stopwatch backward_timer;
+  for (size_t round = 0; round < rounds; ++round) {
+    auto it = tree.end();
+    while (it != tree.begin()) {
+      --it;
+      sum += (*it).second;
+    }
+  }
+  double backward_ms = backward_timer.ms();
+
+  double visited = static_cast<double>(rounds * tree.size());
+  std::printf("  %-8s forward %6.2f ns  backward %6.2f ns  (%lld)\n", name,
+              forward_ms * 1e6 / visited, backward_ms * 1e6 / visited, sum);
+}
+
+void bench_scan(size_t n) {
+  std::printf("scan: map iteration cost per element\n");
+  for (size_t size = 1000; size <= n; size *= 10) {
+    std::vector<int> keys(size);
+    unsigned state = 2024U;
+    for (size_t i = 0; i < size; ++i) {
+      keys[i] = static_cast<int>(i);
+    }
+    std::printf(" %zu keys\n", size);
+    run_scan("in order", keys);
+    for (size_t i = size - 1; i > 0; --i) {
+      state = state * 1664525U + 1013904223U;
+      std::swap(keys[i], keys[(state >> 8) % (i + 1)]);
+    }
+    run_scan("random", keys);
+  }
+}
+
+void run_batch_lookup(const char* name, const s21::map<int, int>& tree,
+                      const std::vector<int>& keys, size_t batch) {
+  size_t hits = 0;
+  stopwatch timer;
+  for (size_t first = 0; first < keys.size(); first += batch) {
+    for (size_t i = first; i < first + batch; ++i) {
+      hits += tree.contains(keys[i]);
+    }
+  }
+  double one_by_one = timer.ms();
+  timer = stopwatch();
+  for (size_t first = 0; first < keys.size(); first += batch) {
+    std::vector<bool> found = tree.contains_many(keys.data() + first, batch);
+    for (bool hit : found) {
+      hits -= hit;
+    }
+  }
+  double batched = timer.ms();
+  double per_key = 1e6 / static_cast<double>(keys.size());
+  std::printf("  %-8s contains %6.1f ns/key, contains_many %6.1f ns/key%s\n",
+              name, one_by_one * per_key, batched * per_key,
+              hits == 0 ? "" : " (mismatch)");
+}
+
+void bench_batch_lookup(size_t n) {
+  const size_t batch = 4096;
+  std::printf("batch_lookup: batches of %zu keys against a map\n", batch);
+  for (size_t size = 10000; size <= n; size *= 10) {
+    s21::map<int, int> tree;
+    unsigned state = 99U;
+    for (size_t i = 0; i < size; ++i) {
+      state = state * 1664525U + 1013904223U;
+      tree.insert(static_cast<int>(state >> 1), static_cast<int>(i));
+    }
+    std::vector<int> keys(std::max<size_t>(size, 1 << 20) / batch * batch);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      state = state * 1664525U + 1013904223U;
+      keys[i] = static_cast<int>(state >> 1);
+    }
+    std::printf(" %zu keys\n", size);
+    run_batch_lookup("random", tree, keys, batch);
+    for (size_t first = 0; first < keys.size(); first += batch) {
+      std::sort(keys.begin() + first, keys.begin() + first + batch);
+    }
+    run_batch_lookup("sorted", tree, keys, batch);
+  }
+}
+
+// Overlap queries over random [start, start + length) ranges. The scan
+// walks a multiset of the same intervals and tests each one.
+void bench_interval_overlap(size_t n) {
+  std::printf("interval_overlap: %zu intervals\n", n);
+  s21::interval_map<int, int> intervals;
+  s21::multiset<std::pair<int, int>> scanned;
+  unsigned state = 404U;
+  const int span = 1 << 30;
+  for (size_t i = 0; i < n; ++i) {
+    state = state * 1664525U + 1013904223U;
+    int start = static_cast<int>(state >> 2) % span;
+    state = state * 1664525U + 1013904223U;
+    int end = start + 1 + static_cast<int>(state >> 8) % (span / 100000);
+    intervals.insert(start, end, static_cast<int>(i));
+    scanned.insert({start, end});
+  }
+  for (int width : {1, span / 10000}) {
+    const size_t tree_queries = 100000;
+    const size_t scan_queries = std::max<size_t>(1, 10000000 / (n + 1));
+    std::vector<int> los(tree_queries);
+    for (int& lo : los) {
+      state = state * 1664525U + 1013904223U;
+      lo = static_cast<int>(state >> 2) % span;
+    }
+    size_t tree_hits = 0;
+    stopwatch tree_timer;
+    for (int lo : los) {
+      intervals.for_each_overlapping(lo, lo + width,
+                                     [&tree_hits](auto&) { ++tree_hits; });
+    }
+    double tree_us = tree_timer.ms() * 1000 / tree_queries;
+    size_t scan_hits = 0;
+    size_t check_hits = 0;
+    stopwatch scan_timer;
+    for (size_t q = 0; q < scan_queries; ++q) {
+      int lo = los[q];
+      int hi = lo + width;
+      for (const auto& item : scanned) {
+        scan_hits += item.first < hi && lo < item.second;
+      }
+    }
+    double scan_us = scan_timer.ms() * 1000 / scan_queries;
+    for (size_t q = 0; q < scan_queries; ++q) {
+      check_hits += intervals.find_overlapping(los[q], los[q] + width).size();
+    }
+    std::printf("  width %-9d interval_map %9.2f us/query   multiset scan "
+                "%11.2f us/query   (%.1f hits/query%s)\n",
+                width, tree_us, scan_us,
+                static_cast<double>(tree_hits) / tree_queries,
+                check_hits == scan_hits ? "" : ", mismatch");
+  }
+}
+
+// Counts what a container holds on the heap: the bytes it asked for and
+// what malloc actually set aside for them, chunk headers included.
+struct heap_usage {
+  size_t requested = 0;
+  size_t reserved = 0;
+};
+
+heap_usage footprint_usage;
+
+template <typename T>
+struct footprint_allocator {
+  using value_type = T;
+
+  footprint_allocator() = default;
+  template <typename U>
+  footprint_allocator(const footprint_allocator<U>&) {}
+
+  T* allocate(size_t count) {
+    void* result = std::malloc(count * sizeof(T));
+    if (result == nullptr) {
+      throw std::bad_alloc();
+    }
+    footprint_usage.requested += count * sizeof(T);
+    footprint_usage.reserved += malloc_usable_size(result) + sizeof(size_t);
+    return static_cast<T*>(result);
+  }
+  void deallocate(T* ptr, size_t count) {
+    footprint_usage.requested -= count * sizeof(T);
+    footprint_usage.reserved -= malloc_usable_size(ptr) + sizeof(size_t);
+    std::free(ptr);
+  }
+
+  bool operator==(const footprint_allocator&) const { return true; }
+  bool operator!=(const footprint_allocator&) const { return false; }
+};
+
+template <typename Set, typename Prepare>
+void run_footprint(const char* name, size_t n, Prepare prepare) {
+  footprint_usage = heap_usage();
+  stopwatch timer;
+  {
+    Set tree;
+    prepare(tree, n);
+    unsigned state = 77U;
+    for (size_t i = 0; i < n; ++i) {
+      state = state * 1664525U + 1013904223U;
+      tree.insert(static_cast<int>(state ^ (state >> 15)));
+    }
+    double per_element = static_cast<double>(footprint_usage.reserved) /
+                         static_cast<double>(tree.size());
+    std::printf(
+        "  %-30s %6.1f B/elem requested, %6.1f B/elem on the heap, "
+        "%6.2f GB at 100M, built in %.0f ms\n",
+        name,
+        static_cast<double>(footprint_usage.requested) /
+            static_cast<double>(tree.size()),
+        per_element, per_element * 1e8 / 1e9, timer.ms());
+  }
+}
+
+// The 100M column is projected from n elements; compact_set can be run at
+// 100M directly, set needs more than 5 GB for it. Without reserve() the
+// compact array carries the slack of its last doubling.
+void bench_footprint(size_t n) {
+  std::printf("footprint: heap bytes per element of a set<int>, %zu keys\n",
+              n);
+  auto grow = [](auto&, size_t) {};
+  auto reserve = [](auto& tree, size_t count) { tree.reserve(count); };
+  using compact32 =
+      s21::compact_set<int, std::less<int>, footprint_allocator<int>>;
+  using compact64 = s21::compact_set<int, std::less<int>,
+                                     footprint_allocator<int>, uint64_t>;
+  run_footprint<s21::set<int, std::less<int>, footprint_allocator<int>>>(
+      "s21::set", n, grow);
+  run_footprint<compact32>("s21::compact_set<uint32_t>", n, grow);
+  run_footprint<compact32>("  reserved", n, reserve);
+  run_footprint<compact64>("s21::compact_set<uint64_t>", n, grow);
+  run_footprint<compact64>("  reserved", n, reserve);
+}
+
+template <typename Multiset>
+void run_run_length(const char* name, size_t n, size_t distinct) {
+  footprint_usage = heap_usage();
+  Multiset tree;
+  stopwatch timer;
+  unsigned state = 91U;
+  for (size_t i = 0; i < n; ++i) {
+    state = state * 1664525U + 1013904223U;
+    tree.insert(static_cast<int>((state >> 8) % distinct));
+  }
+  double build_ms = timer.ms();
+  timer = stopwatch();
+  size_t total = 0;
+  for (size_t i = 0; i < distinct; ++i) {
+    total += tree.count(static_cast<int>(i));
+  }
+  double count_ms = timer.ms();
+  std::printf(
+      "  %-28s %10zu bytes on the heap, build %7.1f ms, "
+      "count of every key %7.2f ms (%zu)\n",
+      name, footprint_usage.reserved, build_ms, count_ms, total);
+}
+
+// multiset keeps a node per copy, and without order_statistics its count()
+// walks every one of them.
+void bench_run_length(size_t n) {
+  const size_t distinct = 4096;
+  std::printf("run_length: %zu ints over %zu distinct keys\n", n, distinct);
+  run_run_length<
+      s21::multiset<int, std::less<int>, footprint_allocator<int>>>(
+      "s21::multiset", n, distinct);
+  run_run_length<
+      s21::run_length_multiset<int, std::less<int>, footprint_allocator<int>>>(
+      "s21::run_length_multiset", n, distinct);
+}
+
+template <typename Set, typename Insert>
+void run_key_only(const char* name, const std::vector<std::string>& keys,
+                  Insert insert) {
+  size_t heap_before = mallinfo2().uordblks;
+  stopwatch timer;
+  Set tree;
+  for (const std::string& key : keys) {
+    insert(tree, key);
+  }
+  double build_ms = timer.ms();
+  double per_element =
+      static_cast<double>(mallinfo2().uordblks - heap_before) /
+      static_cast<double>(tree.size());
+  std::printf("  %-34s %6.1f B/elem on the heap, %6.1f ns per insert\n",
+              name, per_element,
+              build_ms * 1e6 / static_cast<double>(keys.size()));
+}
+
+// map<string, string> holding (key, key) is the node set and multiset used
+// to have, so it stands in for the old layout. The keys are longer than the
+// short-string buffer, so every copy of one is a heap block of its own.
+void bench_key_only(size_t n) {
+  std::printf("key_only: %zu strings of 32 chars\n", n);
+  std::vector<std::string> keys;
+  keys.reserve(n);
+  unsigned state = 5U;
+  for (size_t i = 0; i < n; ++i) {
+    state = state * 1664525U + 1013904223U;
+    char buffer[40];
+    std::snprintf(buffer, sizeof(buffer), "key-%028u", state);
+    keys.push_back(buffer);
+  }
+  auto insert_key = [](auto& tree, const std::string& key) {
+    tree.insert(key);
+  };
+  run_key_only<s21::map<std::string, std::string>>(
+      "pair<const Key, Key> (old layout)", keys,
+      [](auto& tree, const std::string& key) { tree.insert(key, key); });
+  run_key_only<s21::set<std::string>>("s21::set<string>", keys, insert_key);
+  run_key_only<s21::multiset<std::string>>("s21::multiset<string>", keys,
+                                           insert_key);
+}
+
+template <typename Map>
+void run_frozen_lookup(const char* name, const Map& tree,
+                       const std::vector<int>& probes) {
+  size_t hits = 0;
+  stopwatch timer;
+  for (int key : probes) {
+    hits += tree.contains(key);
+  }
+  double find_ms = timer.ms();
+  std::printf("  %-10s lookup %7.1f ns  (%zu hits)\n", name,
+              find_ms * 1e6 / static_cast<double>(probes.size()), hits);
+}
+
+// One random probe order, nine hits to every miss, against the map, a
+// flat_map copy and the frozen copy. At 10M keys none of them fits in the
+// cache, so the lookups are bound by memory latency.
+void bench_frozen_lookup(size_t n) {
+  std::printf("frozen_lookup: %zu random int keys\n", n);
+  std::vector<int> keys(n);
+  unsigned state = 4242U;
+  for (size_t i = 0; i < n; ++i) {
+    state = state * 1664525U + 1013904223U;
+    keys[i] = static_cast<int>(state >> 1);
+  }
+  s21::map<int, int> tree;
+  for (size_t i = 0; i < n; ++i) {
+    tree.insert(keys[i], static_cast<int>(i));
+  }
+  stopwatch freeze_timer;
+  s21::frozen_map<int, int> frozen = tree.freeze();
+  double freeze_ms = freeze_timer.ms();
+  s21::flat_map<int, int> flat(tree.begin(), tree.end());
+
+  std::vector<int> probes(std::min<size_t>(n, 2000000));
+  for (size_t i = 0; i < probes.size(); ++i) {
+    state = state * 1664525U + 1013904223U;
+    probes[i] = keys[state % n] + (i % 10 == 9);
+  }
+  std::printf("  freeze() %.0f ms\n", freeze_ms);
+  run_frozen_lookup("map", tree, probes);
+  run_frozen_lookup("flat_map", flat, probes);
+  run_frozen_lookup("frozen_map", frozen, probes);
+}
+
+// Warm restart of a map<uint64_t, uint64_t>: rebuilding it from a text dump
+// with one insert per line against load() from a binary snapshot. 50M
+// entries do not fit in this machine's memory twice over, so the default is
+// smaller; both paths are linear in n apart from the inserts' log factor.
+void bench_snapshot(size_t n) {
+  std::printf("snapshot: %zu random uint64_t entries\n", n);
+  const std::string text_path = "/tmp/s21_bench_snapshot.txt";
+  const std::string snapshot_path = "/tmp/s21_bench_snapshot.bin";
+  using map_type = s21::map<std::uint64_t, std::uint64_t>;
+  std::uint64_t state = 77;
+  {
+    map_type tree;
+    for (size_t i = 0; i < n; ++i) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      tree.insert(state >> 8, i);
+    }
+    std::FILE* text = std::fopen(text_path.c_str(), "w");
+    for (const auto& item : tree) {
+      std::fprintf(text, "%llu %llu\n",
+                   static_cast<unsigned long long>(item.first),
+                   static_cast<unsigned long long>(item.second));
+    }
+    std::fclose(text);
+    stopwatch save_timer;
+    s21::save(tree, snapshot_path);
+    std::printf("  save()          %7.0f ms\n", save_timer.ms());
+  }
+
+  stopwatch text_timer;
+  {
+    map_type tree;
+    std::FILE* text = std::fopen(text_path.c_str(), "r");
+    unsigned long long key = 0;
+    unsigned long long value = 0;
+    while (std::fscanf(text, "%llu %llu", &key, &value) == 2) {
+      tree.insert(key, value);
+    }
+    std::fclose(text);
+    std::printf("  text + insert   %7.0f ms  (%zu entries)\n", text_timer.ms(),
+                tree.size());
+  }
+
+  stopwatch load_timer;
+  map_type tree;
+  s21::load(tree, snapshot_path);
+  std::printf("  load()          %7.0f ms  (%zu entries)\n", load_timer.ms(),
+              tree.size());
+  std::remove(text_path.c_str());
+  std::remove(snapshot_path.c_str());
+}
+
+const benchmark_case cases[] = {
+    {"insert_copies", bench_insert_copies, 100000},
+    {"allocator_clear", bench_allocator_clear, 1000000},
+    {"bulk_build", bench_bulk_build, 1000000},
+    {"merge", bench_merge, 1000000},
+    {"set_algebra", bench_set_algebra, 1000000},
+    {"order_statistics", bench_order_statistics, 1000000},
+    {"btree", bench_btree, 1000000},
+    {"transparent_lookup", bench_transparent_lookup, 1000000},
+    {"erase_range", bench_erase_range, 1000000},
+    {"concurrent_map", bench_concurrent_map, 100000},
+    {"persistent_snapshot", bench_persistent_snapshot, 100000},
+    {"cow_copy", bench_cow_copy, 1000000},
+    {"flat_lookup", bench_flat_lookup, 1000000},
+    {"hash_lookup", bench_hash_lookup, 1000000},
+    {"scan", bench_scan, 1000000},
+    {"footprint", bench_footprint, 10000000},
+    {"batch_lookup", bench_batch_lookup, 1000000},
+    {"interval_overlap", bench_interval_overlap, 1000000},
+    {"run_length", bench_run_length, 10000000},
+    {"key_only", bench_key_only, 1000000},
+    {"frozen_lookup", bench_frozen_lookup, 10000000},
+    {"snapshot", bench_snapshot, 5000000},
+    {"skiplist_map", bench_skiplist_map, 100000},
+};
+
+}  // namespace
+
+// Kept out of line so the optimizer does not pair the malloc and free inside
+// them with unrelated new and delete expressions.
+__attribute__((noinline)) void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* result = std::malloc(size ? size : 1)) {
+    return result;
+  }
+  throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr,
+                                               std::size_t) noexcept {
+  std::free(ptr);
+}
+
+// Usage: ./benchmarks [case_name [element_count]]
+int main(int argc, char** argv) {
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+  size_t size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+  for (const benchmark_case& item : cases) {
+    if (filter == nullptr || std::strcmp(filter, item.name) == 0) {
+      item.run(size ? size : item.default_size);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,364 @@
+#ifndef S21_SRC_BTREE_MAP_H
+#define S21_SRC_BTREE_MAP_H
+
+#include <type_traits>
+#include <vector>
+
+#include "Btree.h"
+
+namespace s21 {
+
+// Drop-in for map on the cache-friendly B-tree. Unlike map, every insert and
+// erase invalidates all iterators into the container.
+template <typename Key, typename Value, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, Value>>>
+class btree_map : private Btree<Key, Value, Comparator, Allocator> {
+  using tree_type = Btree<Key, Value, Comparator, Allocator>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  btree_map();
+  btree_map(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  btree_map(InputIt first, InputIt last);
+  btree_map(const btree_map& m);
+  btree_map(btree_map&& m);
+  ~btree_map() = default;
+  btree_map& operator=(const btree_map& m);
+  btree_map& operator=(btree_map&& m);
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
+
+  Value& at(const Key& key);
+  Value& operator[](const Key& key);
+  Value& operator[](Key&& key);
+
+  iterator begin();
+  const_iterator begin() const;
+  iterator end();
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  allocator_type get_allocator() const;
+
+  void clear();
+  std::pair<iterator, bool> insert(const Key& key, const Value& obj);
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(value_type&& value);
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args);
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args);
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const Value& obj);
+  void erase(iterator pos);
+  void swap(btree_map& other);
+  void merge(btree_map& other);
+
+  bool contains(const Key& key) const;
+  iterator lower_bound(const Key& key);
+  const_iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key);
+  const_iterator upper_bound(const Key& key) const;
+
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+};
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+btree_map<Key, Value, Comparator, Allocator>::btree_map() : tree_type() {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+btree_map<Key, Value, Comparator, Allocator>::btree_map(
+    std::initializer_list<value_type> const& items)
+    : btree_map() {
+  assign(items.begin(), items.end());
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename InputIt, typename>
+btree_map<Key, Value, Comparator, Allocator>::btree_map(InputIt first,
+                                                        InputIt last)
+    : btree_map() {
+  assign(first, last);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename InputIt>
+void btree_map<Key, Value, Comparator, Allocator>::assign(InputIt first,
+                                                          InputIt last) {
+  tree_type::tree_assign(
+      first, last, true,
+      [](auto& emplace, const auto& item) { return emplace(item); });
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+btree_map<Key, Value, Comparator, Allocator>::btree_map(const btree_map& m)
+    : tree_type(m) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+btree_map<Key, Value, Comparator, Allocator>::btree_map(btree_map&& m)
+    : tree_type(std::move(m)) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+btree_map<Key, Value, Comparator, Allocator>&
+btree_map<Key, Value, Comparator, Allocator>::operator=(const btree_map& m) {
+  tree_type::operator=(m);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+btree_map<Key, Value, Comparator, Allocator>&
+btree_map<Key, Value, Comparator, Allocator>::operator=(btree_map&& m) {
+  tree_type::operator=(std::move(m));
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Value& btree_map<Key, Value, Comparator, Allocator>::at(const Key& key) {
+  return tree_type::at(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Value& btree_map<Key, Value, Comparator, Allocator>::operator[](
+    const Key& key) {
+  return tree_type::operator[](key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+Value& btree_map<Key, Value, Comparator, Allocator>::operator[](Key&& key) {
+  return tree_type::operator[](std::move(key));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename btree_map<Key, Value, Comparator, Allocator>::iterator
+btree_map<Key, Value, Comparator, Allocator>::begin() {
+  return tree_type::tree_begin();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename btree_map<Key, Value, Comparator, Allocator>::const_iterator
+btree_map<Key, Value, Comparator, Allocator>::begin() const {
+  return tree_type::const_tree_begin();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename btree_map<Key, Value, Comparator, Allocator>::iterator
+btree_map<Key, Value, Comparator, Allocator>::end() {
+  return tree_type::tree_end();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename btree_map<Key, Value, Comparator, Allocator>::const_iterator
+btree_map<Key, Value, Comparator, Allocator>::end() const {
+  return tree_type::const_tree_end();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+bool btree_map<Key, Value, Comparator, Allocator>::empty() const {
+  return tree_type::tree_empty();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename btree_map<Key, Value, Comparator, Allocator>::size_type
+btree_map<Key, Value, Comparator, Allocator>::size() const {
+  return tree_type::tree_size();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename btree_map<Key, Value, Comparator, Allocator>::size_type
+btree_map<Key, Value, Comparator, Allocator>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename btree_map<Key, Value, Comparator, Allocator>::allocator_type
+btree_map<Key, Value, Comparator, Allocator>::get_allocator() const {
+  return tree_type::get_allocator();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void btree_map<Key, Value, Comparator, Allocator>::clear() {
+  tree_type::tree_clear();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename btree_map<Key, Value, Comparator, Allocator>::iterator,
+          bool>
+btree_map<Key, Value, Comparator, Allocator>::insert(const Key& key,
+                                                     const Value& obj) {
+  return tree_type::tree_unique_insert(key, obj);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename btree_map<Key, Value, Comparator, Allocator>::iterator,
+          bool>
+btree_map<Key, Value, Comparator, Allocator>::insert(
+    const value_type& value) {
+  return tree_type::tree_unique_insert(value);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename btree_map<Key, Value, Comparator, Allocator>::iterator,
+          bool>
+btree_map<Key, Value, Comparator, Allocator>::insert(value_type&& value) {
+  return tree_type::tree_unique_insert(std::move(value));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <class... Args>
+std::pair<typename btree_map<Key, Value, Comparator, Allocator>::iterator,
+          bool>
+btree_map<Key, Value, Comparator, Allocator>::emplace(Args&&... args) {
+  return tree_type::tree_unique_emplace(std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <class... Args>
+std::pair<typename btree_map<Key, Value, Comparator, Allocator>::iterator,
+          bool>
+btree_map<Key, Value, Comparator, Allocator>::try_emplace(const Key& key,
+                                                          Args&&... args) {
+  return tree_type::tree_try_emplace(key, std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <class... Args>
+std::pair<typename btree_map<Key, Value, Comparator, Allocator>::iterator,
+          bool>
+btree_map<Key, Value, Comparator, Allocator>::try_emplace(Key&& key,
+                                                          Args&&... args) {
+  return tree_type::tree_try_emplace(std::move(key),
+                                     std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::pair<typename btree_map<Key, Value, Comparator, Allocator>::iterator,
+          bool>
+btree_map<Key, Value, Comparator, Allocator>::insert_or_assign(
+    const Key& key, const Value& obj) {
+  return tree_type::tree_insert_or_assign(key, obj);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void btree_map<Key, Value, Comparator, Allocator>::erase(iterator pos) {
+  tree_type::tree_erase(pos);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void btree_map<Key, Value, Comparator, Allocator>::swap(btree_map& other) {
+  tree_type::tree_swap(other);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void btree_map<Key, Value, Comparator, Allocator>::merge(btree_map& other) {
+  tree_type::tree_merge_unique(other);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+bool btree_map<Key, Value, Comparator, Allocator>::contains(
+    const Key& key) const {
+  return tree_type::tree_contains(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename btree_map<Key, Value, Comparator, Allocator>::iterator
+btree_map<Key, Value, Comparator, Allocator>::lower_bound(const Key& key) {
+  return tree_type::tree_lower_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename btree_map<Key, Value, Comparator, Allocator>::const_iterator
+btree_map<Key, Value, Comparator, Allocator>::lower_bound(
+    const Key& key) const {
+  return tree_type::tree_lower_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename btree_map<Key, Value, Comparator, Allocator>::iterator
+btree_map<Key, Value, Comparator, Allocator>::upper_bound(const Key& key) {
+  return tree_type::tree_upper_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename btree_map<Key, Value, Comparator, Allocator>::const_iterator
+btree_map<Key, Value, Comparator, Allocator>::upper_bound(
+    const Key& key) const {
+  return tree_type::tree_upper_bound(key);
+}
+
+// Each insert may move elements between nodes, so the returned iterators
+// are looked up again once every element is in.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <class... Args>
+std::vector<std::pair<
+    typename btree_map<Key, Value, Comparator, Allocator>::iterator, bool>>
+btree_map<Key, Value, Comparator, Allocator>::insert_many(Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  std::vector<Key> keys;
+  result.reserve(sizeof...(args));
+  keys.reserve(sizeof...(args));
+  (
+      [&](auto&& item) {
+        keys.push_back(item.first);
+        result.push_back(insert(std::forward<decltype(item)>(item)));
+      }(std::forward<Args>(args)),
+      ...);
+  for (size_type index = 0; index < keys.size(); ++index) {
+    result[index].first = tree_type::tree_find(keys[index]);
+  }
+  return result;
+}
+
+}  // namespace s21
+
+#endif
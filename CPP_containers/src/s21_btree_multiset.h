@@ -0,0 +1,314 @@
+#ifndef S21_SRC_BTREE_MULTISET_H
+#define S21_SRC_BTREE_MULTISET_H
+
+#include <type_traits>
+#include <vector>
+
+#include "Btree.h"
+
+namespace s21 {
+
+// Drop-in for multiset on the cache-friendly B-tree. Unlike multiset, every
+// insert and erase invalidates all iterators into the container.
+template <typename Key, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<Key>>
+class btree_multiset : private Btree<Key, Key, Comparator, Allocator> {
+  using tree_type = Btree<Key, Key, Comparator, Allocator>;
+
+ public:
+  class btree_multiset_iterator;
+  class const_btree_multiset_iterator;
+  using key_type = Key;
+  using value_type = Key;
+  using reference = value_type&;
+  using pointer = value_type*;
+  using const_reference = const value_type&;
+  using const_pointer = const value_type*;
+  using iterator = btree_multiset_iterator;
+  using const_iterator = const_btree_multiset_iterator;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  class btree_multiset_iterator : public tree_type::iterator {
+   public:
+    btree_multiset_iterator() = default;
+    btree_multiset_iterator(const typename tree_type::iterator& other);
+    reference operator*();
+  };
+
+  class const_btree_multiset_iterator : public tree_type::const_iterator {
+   public:
+    const_btree_multiset_iterator() = default;
+    const_btree_multiset_iterator(
+        const typename tree_type::const_iterator& other);
+    const_reference operator*();
+  };
+
+  btree_multiset();
+  btree_multiset(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  btree_multiset(InputIt first, InputIt last);
+  btree_multiset(const btree_multiset& ms);
+  btree_multiset(btree_multiset&& ms);
+  ~btree_multiset() = default;
+  btree_multiset& operator=(const btree_multiset& ms);
+  btree_multiset& operator=(btree_multiset&& ms);
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
+
+  iterator begin();
+  const_iterator begin() const;
+  iterator end();
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  allocator_type get_allocator() const;
+
+  void clear();
+  iterator insert(const value_type& value);
+  iterator insert(value_type&& value);
+  template <class... Args>
+  iterator emplace(Args&&... args);
+  void erase(iterator pos);
+  void swap(btree_multiset& other);
+  void merge(btree_multiset& other);
+
+  size_type count(const Key& key) const;
+  iterator find(const Key& key);
+  bool contains(const Key& key) const;
+  std::pair<iterator, iterator> equal_range(const Key& key);
+  iterator lower_bound(const Key& key);
+  iterator upper_bound(const Key& key);
+
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+};
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_multiset<Key, Comparator, Allocator>::btree_multiset() : tree_type() {}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_multiset<Key, Comparator, Allocator>::btree_multiset(
+    std::initializer_list<value_type> const& items)
+    : btree_multiset() {
+  assign(items.begin(), items.end());
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+template <typename InputIt, typename>
+btree_multiset<Key, Comparator, Allocator>::btree_multiset(InputIt first,
+                                                           InputIt last)
+    : btree_multiset() {
+  assign(first, last);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+template <typename InputIt>
+void btree_multiset<Key, Comparator, Allocator>::assign(InputIt first,
+                                                        InputIt last) {
+  tree_type::tree_assign(
+      first, last, false,
+      [](auto& emplace, const auto& item) { return emplace(item, item); });
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_multiset<Key, Comparator, Allocator>::btree_multiset(
+    const btree_multiset& ms)
+    : tree_type(ms) {}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_multiset<Key, Comparator, Allocator>::btree_multiset(
+    btree_multiset&& ms)
+    : tree_type(std::move(ms)) {}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_multiset<Key, Comparator, Allocator>&
+btree_multiset<Key, Comparator, Allocator>::operator=(
+    const btree_multiset& ms) {
+  tree_type::operator=(ms);
+  return *this;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_multiset<Key, Comparator, Allocator>&
+btree_multiset<Key, Comparator, Allocator>::operator=(btree_multiset&& ms) {
+  tree_type::operator=(std::move(ms));
+  return *this;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::iterator
+btree_multiset<Key, Comparator, Allocator>::begin() {
+  return tree_type::tree_begin();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::const_iterator
+btree_multiset<Key, Comparator, Allocator>::begin() const {
+  return tree_type::const_tree_begin();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::iterator
+btree_multiset<Key, Comparator, Allocator>::end() {
+  return tree_type::tree_end();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::const_iterator
+btree_multiset<Key, Comparator, Allocator>::end() const {
+  return tree_type::const_tree_end();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+bool btree_multiset<Key, Comparator, Allocator>::empty() const {
+  return tree_type::tree_empty();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::size_type
+btree_multiset<Key, Comparator, Allocator>::size() const {
+  return tree_type::tree_size();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::size_type
+btree_multiset<Key, Comparator, Allocator>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::allocator_type
+btree_multiset<Key, Comparator, Allocator>::get_allocator() const {
+  return tree_type::get_allocator();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+void btree_multiset<Key, Comparator, Allocator>::clear() {
+  tree_type::tree_clear();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::iterator
+btree_multiset<Key, Comparator, Allocator>::insert(const value_type& value) {
+  return tree_type::tree_emplace(value, value);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::iterator
+btree_multiset<Key, Comparator, Allocator>::insert(value_type&& value) {
+  return tree_type::tree_emplace(value, std::move(value));
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+template <class... Args>
+typename btree_multiset<Key, Comparator, Allocator>::iterator
+btree_multiset<Key, Comparator, Allocator>::emplace(Args&&... args) {
+  return insert(value_type(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+void btree_multiset<Key, Comparator, Allocator>::erase(iterator pos) {
+  tree_type::tree_erase(pos);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+void btree_multiset<Key, Comparator, Allocator>::swap(btree_multiset& other) {
+  tree_type::tree_swap(other);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+void btree_multiset<Key, Comparator, Allocator>::merge(
+    btree_multiset& other) {
+  tree_type::tree_merge(other);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::size_type
+btree_multiset<Key, Comparator, Allocator>::count(const Key& key) const {
+  return tree_type::tree_count(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::iterator
+btree_multiset<Key, Comparator, Allocator>::find(const Key& key) {
+  return tree_type::tree_find(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+bool btree_multiset<Key, Comparator, Allocator>::contains(
+    const Key& key) const {
+  return tree_type::tree_contains(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+std::pair<typename btree_multiset<Key, Comparator, Allocator>::iterator,
+          typename btree_multiset<Key, Comparator, Allocator>::iterator>
+btree_multiset<Key, Comparator, Allocator>::equal_range(const Key& key) {
+  auto range = tree_type::tree_equal_range(key);
+  return std::pair<iterator, iterator>(range.first, range.second);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::iterator
+btree_multiset<Key, Comparator, Allocator>::lower_bound(const Key& key) {
+  return tree_type::tree_lower_bound(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::iterator
+btree_multiset<Key, Comparator, Allocator>::upper_bound(const Key& key) {
+  return tree_type::tree_upper_bound(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_multiset<Key, Comparator, Allocator>::btree_multiset_iterator::
+    btree_multiset_iterator(const typename tree_type::iterator& other)
+    : tree_type::iterator::iterator(other) {}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::reference
+btree_multiset<Key, Comparator,
+               Allocator>::btree_multiset_iterator::operator*() {
+  return tree_type::iterator::operator*().second;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_multiset<Key, Comparator, Allocator>::const_btree_multiset_iterator::
+    const_btree_multiset_iterator(
+        const typename tree_type::const_iterator& other)
+    : tree_type::const_iterator::const_iterator(other) {}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_multiset<Key, Comparator, Allocator>::const_reference
+btree_multiset<Key, Comparator,
+               Allocator>::const_btree_multiset_iterator::operator*() {
+  return tree_type::const_iterator::operator*().second;
+}
+
+// Each insert may move elements between nodes, so once every element is in
+// the returned iterators are looked up again; each one refers to the last
+// element with its key.
+template <typename Key, typename Comparator, typename Allocator>
+template <class... Args>
+std::vector<std::pair<
+    typename btree_multiset<Key, Comparator, Allocator>::iterator, bool>>
+btree_multiset<Key, Comparator, Allocator>::insert_many(Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  std::vector<Key> keys;
+  result.reserve(sizeof...(args));
+  keys.reserve(sizeof...(args));
+  (keys.emplace_back(args), ...);
+  (result.push_back({insert(std::forward<Args>(args)), true}), ...);
+  for (size_type index = 0; index < keys.size(); ++index) {
+    result[index].first = --upper_bound(keys[index]);
+  }
+  return result;
+}
+
+}  // namespace s21
+
+#endif
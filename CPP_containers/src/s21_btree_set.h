@@ -0,0 +1,301 @@
+#ifndef S21_SRC_BTREE_SET_H
+#define S21_SRC_BTREE_SET_H
+
+#include <type_traits>
+#include <vector>
+
+#include "Btree.h"
+
+namespace s21 {
+
+// Drop-in for set on the cache-friendly B-tree. Unlike set, every insert and
+// erase invalidates all iterators into the container.
+template <typename Key, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<Key>>
+class btree_set : private Btree<Key, Key, Comparator, Allocator> {
+  using tree_type = Btree<Key, Key, Comparator, Allocator>;
+
+ public:
+  class btree_set_iterator;
+  class const_btree_set_iterator;
+  using key_type = Key;
+  using value_type = Key;
+  using reference = value_type&;
+  using pointer = value_type*;
+  using const_reference = const value_type&;
+  using const_pointer = const value_type*;
+  using iterator = btree_set_iterator;
+  using const_iterator = const_btree_set_iterator;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  class btree_set_iterator : public tree_type::iterator {
+   public:
+    btree_set_iterator() = default;
+    btree_set_iterator(const typename tree_type::iterator& other);
+    reference operator*();
+  };
+
+  class const_btree_set_iterator : public tree_type::const_iterator {
+   public:
+    const_btree_set_iterator() = default;
+    const_btree_set_iterator(const typename tree_type::const_iterator& other);
+    const_reference operator*();
+  };
+
+  btree_set();
+  btree_set(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  btree_set(InputIt first, InputIt last);
+  btree_set(const btree_set& s);
+  btree_set(btree_set&& s);
+  ~btree_set() = default;
+  btree_set& operator=(const btree_set& s);
+  btree_set& operator=(btree_set&& s);
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
+
+  iterator begin();
+  const_iterator begin() const;
+  iterator end();
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  allocator_type get_allocator() const;
+
+  void clear();
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(value_type&& value);
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  void erase(iterator pos);
+  void swap(btree_set& other);
+  void merge(btree_set& other);
+
+  iterator find(const Key& key);
+  bool contains(const Key& key) const;
+  iterator lower_bound(const Key& key);
+  const_iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key);
+  const_iterator upper_bound(const Key& key) const;
+
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+};
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_set<Key, Comparator, Allocator>::btree_set() : tree_type() {}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_set<Key, Comparator, Allocator>::btree_set(
+    std::initializer_list<value_type> const& items)
+    : btree_set() {
+  assign(items.begin(), items.end());
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+template <typename InputIt, typename>
+btree_set<Key, Comparator, Allocator>::btree_set(InputIt first, InputIt last)
+    : btree_set() {
+  assign(first, last);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+template <typename InputIt>
+void btree_set<Key, Comparator, Allocator>::assign(InputIt first,
+                                                   InputIt last) {
+  tree_type::tree_assign(
+      first, last, true,
+      [](auto& emplace, const auto& item) { return emplace(item, item); });
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_set<Key, Comparator, Allocator>::btree_set(const btree_set& s)
+    : tree_type(s) {}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_set<Key, Comparator, Allocator>::btree_set(btree_set&& s)
+    : tree_type(std::move(s)) {}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_set<Key, Comparator, Allocator>&
+btree_set<Key, Comparator, Allocator>::operator=(const btree_set& s) {
+  tree_type::operator=(s);
+  return *this;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_set<Key, Comparator, Allocator>&
+btree_set<Key, Comparator, Allocator>::operator=(btree_set&& s) {
+  tree_type::operator=(std::move(s));
+  return *this;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::iterator
+btree_set<Key, Comparator, Allocator>::begin() {
+  return tree_type::tree_begin();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::const_iterator
+btree_set<Key, Comparator, Allocator>::begin() const {
+  return tree_type::const_tree_begin();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::iterator
+btree_set<Key, Comparator, Allocator>::end() {
+  return tree_type::tree_end();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::const_iterator
+btree_set<Key, Comparator, Allocator>::end() const {
+  return tree_type::const_tree_end();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+bool btree_set<Key, Comparator, Allocator>::empty() const {
+  return tree_type::tree_empty();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::size_type
+btree_set<Key, Comparator, Allocator>::size() const {
+  return tree_type::tree_size();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::size_type
+btree_set<Key, Comparator, Allocator>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::allocator_type
+btree_set<Key, Comparator, Allocator>::get_allocator() const {
+  return tree_type::get_allocator();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+void btree_set<Key, Comparator, Allocator>::clear() {
+  tree_type::tree_clear();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+std::pair<typename btree_set<Key, Comparator, Allocator>::iterator, bool>
+btree_set<Key, Comparator, Allocator>::insert(const value_type& value) {
+  return tree_type::tree_unique_insert(value, value);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+std::pair<typename btree_set<Key, Comparator, Allocator>::iterator, bool>
+btree_set<Key, Comparator, Allocator>::insert(value_type&& value) {
+  return tree_type::tree_try_emplace(value, std::move(value));
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+template <class... Args>
+std::pair<typename btree_set<Key, Comparator, Allocator>::iterator, bool>
+btree_set<Key, Comparator, Allocator>::emplace(Args&&... args) {
+  return insert(value_type(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+void btree_set<Key, Comparator, Allocator>::erase(iterator pos) {
+  tree_type::tree_erase(pos);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+void btree_set<Key, Comparator, Allocator>::swap(btree_set& other) {
+  tree_type::tree_swap(other);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+void btree_set<Key, Comparator, Allocator>::merge(btree_set& other) {
+  tree_type::tree_merge_unique(other);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::iterator
+btree_set<Key, Comparator, Allocator>::find(const Key& key) {
+  return tree_type::tree_find(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+bool btree_set<Key, Comparator, Allocator>::contains(const Key& key) const {
+  return tree_type::tree_contains(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::iterator
+btree_set<Key, Comparator, Allocator>::lower_bound(const Key& key) {
+  return tree_type::tree_lower_bound(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::const_iterator
+btree_set<Key, Comparator, Allocator>::lower_bound(const Key& key) const {
+  return tree_type::tree_lower_bound(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::iterator
+btree_set<Key, Comparator, Allocator>::upper_bound(const Key& key) {
+  return tree_type::tree_upper_bound(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::const_iterator
+btree_set<Key, Comparator, Allocator>::upper_bound(const Key& key) const {
+  return tree_type::tree_upper_bound(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_set<Key, Comparator, Allocator>::btree_set_iterator::btree_set_iterator(
+    const typename tree_type::iterator& other)
+    : tree_type::iterator::iterator(other) {}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::reference
+btree_set<Key, Comparator, Allocator>::btree_set_iterator::operator*() {
+  return tree_type::iterator::operator*().second;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+btree_set<Key, Comparator, Allocator>::const_btree_set_iterator::
+    const_btree_set_iterator(const typename tree_type::const_iterator& other)
+    : tree_type::const_iterator::const_iterator(other) {}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename btree_set<Key, Comparator, Allocator>::const_reference
+btree_set<Key, Comparator, Allocator>::const_btree_set_iterator::operator*() {
+  return tree_type::const_iterator::operator*().second;
+}
+
+// Each insert may move elements between nodes, so the returned iterators
+// are looked up again once every element is in.
+template <typename Key, typename Comparator, typename Allocator>
+template <class... Args>
+std::vector<
+    std::pair<typename btree_set<Key, Comparator, Allocator>::iterator, bool>>
+btree_set<Key, Comparator, Allocator>::insert_many(Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  std::vector<Key> keys;
+  result.reserve(sizeof...(args));
+  keys.reserve(sizeof...(args));
+  (keys.emplace_back(args), ...);
+  (result.push_back(insert(std::forward<Args>(args))), ...);
+  for (size_type index = 0; index < keys.size(); ++index) {
+    result[index].first = find(keys[index]);
+  }
+  return result;
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,495 @@
+#ifndef S21_SRC_COMPACT_MAP_H
+#define S21_SRC_COMPACT_MAP_H
+
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "CompactAVLtree.h"
+
+namespace s21 {
+
+// Ordered map on CompactAVLtree: same interface as map, with nodes packed
+// into one array and linked by Index, which saves the three pointers and
+// per-node heap header of map. The Index policy and the invalidation rules
+// are those of compact_set.
+template <typename Key, typename Value, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, Value>>,
+          typename Index = std::uint32_t>
+class compact_map
+    : private CompactAVLtree<Key, Value, Comparator, Allocator, Index> {
+  using tree_type = CompactAVLtree<Key, Value, Comparator, Allocator, Index>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = size_t;
+  using key_compare = Comparator;
+  using allocator_type = Allocator;
+  using index_type = Index;
+
+  compact_map();
+  compact_map(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  compact_map(InputIt first, InputIt last);
+  compact_map(const compact_map& m);
+  compact_map(compact_map&& m) noexcept;
+  ~compact_map() = default;
+  compact_map& operator=(const compact_map& m);
+  compact_map& operator=(compact_map&& m) noexcept;
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
+
+  Value& at(const Key& key);
+  const Value& at(const Key& key) const;
+  Value& operator[](const Key& key);
+  Value& operator[](Key&& key);
+
+  iterator begin();
+  const_iterator begin() const;
+  iterator end();
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  allocator_type get_allocator() const;
+  size_type capacity() const;
+  void reserve(size_type count);
+
+  void clear();
+  std::pair<iterator, bool> insert(const Key& key, const Value& obj);
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(value_type&& value);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  void insert(InputIt first, InputIt last);
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args);
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args);
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const Value& obj);
+  iterator erase(iterator pos);
+  iterator erase(iterator first, iterator last);
+  size_type erase(const Key& key);
+  void swap(compact_map& other) noexcept;
+  void merge(compact_map& other);
+
+  iterator find(const Key& key);
+  const_iterator find(const Key& key) const;
+  bool contains(const Key& key) const;
+  size_type count(const Key& key) const;
+  iterator lower_bound(const Key& key);
+  const_iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key);
+  const_iterator upper_bound(const Key& key) const;
+
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+};
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+compact_map<Key, Value, Comparator, Allocator, Index>::compact_map()
+    : tree_type() {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+compact_map<Key, Value, Comparator, Allocator, Index>::compact_map(
+    std::initializer_list<value_type> const& items)
+    : compact_map() {
+  assign(items.begin(), items.end());
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+template <typename InputIt, typename>
+compact_map<Key, Value, Comparator, Allocator, Index>::compact_map(
+    InputIt first, InputIt last)
+    : compact_map() {
+  assign(first, last);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+compact_map<Key, Value, Comparator, Allocator, Index>::compact_map(
+    const compact_map& m)
+    : tree_type(m) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+compact_map<Key, Value, Comparator, Allocator, Index>::compact_map(
+    compact_map&& m) noexcept
+    : tree_type(std::move(m)) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+compact_map<Key, Value, Comparator, Allocator, Index>&
+compact_map<Key, Value, Comparator, Allocator, Index>::operator=(
+    const compact_map& m) {
+  tree_type::operator=(m);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+compact_map<Key, Value, Comparator, Allocator, Index>&
+compact_map<Key, Value, Comparator, Allocator, Index>::operator=(
+    compact_map&& m) noexcept {
+  tree_type::operator=(std::move(m));
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+template <typename InputIt>
+void compact_map<Key, Value, Comparator, Allocator, Index>::assign(
+    InputIt first, InputIt last) {
+  clear();
+  insert(first, last);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+Value& compact_map<Key, Value, Comparator, Allocator, Index>::at(
+    const Key& key) {
+  iterator result = find(key);
+  if (result == end()) {
+    throw std::out_of_range("There is no element with this key");
+  }
+  return result->second;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+const Value& compact_map<Key, Value, Comparator, Allocator, Index>::at(
+    const Key& key) const {
+  const_iterator result = find(key);
+  if (result == end()) {
+    throw std::out_of_range("There is no element with this key");
+  }
+  return result->second;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+Value& compact_map<Key, Value, Comparator, Allocator, Index>::operator[](
+    const Key& key) {
+  return try_emplace(key).first->second;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+Value& compact_map<Key, Value, Comparator, Allocator, Index>::operator[](
+    Key&& key) {
+  return try_emplace(std::move(key)).first->second;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::begin() {
+  return tree_type::tree_begin();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::const_iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::begin() const {
+  return tree_type::tree_begin();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::end() {
+  return tree_type::tree_end();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::const_iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::end() const {
+  return tree_type::tree_end();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+bool compact_map<Key, Value, Comparator, Allocator, Index>::empty() const {
+  return tree_type::tree_empty();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::size_type
+compact_map<Key, Value, Comparator, Allocator, Index>::size() const {
+  return tree_type::tree_size();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::size_type
+compact_map<Key, Value, Comparator, Allocator, Index>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::allocator_type
+compact_map<Key, Value, Comparator, Allocator, Index>::get_allocator() const {
+  return tree_type::tree_get_allocator();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::size_type
+compact_map<Key, Value, Comparator, Allocator, Index>::capacity() const {
+  return tree_type::tree_capacity();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void compact_map<Key, Value, Comparator, Allocator, Index>::reserve(
+    size_type count) {
+  tree_type::tree_reserve(count);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void compact_map<Key, Value, Comparator, Allocator, Index>::clear() {
+  tree_type::tree_clear();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+std::pair<
+    typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>
+compact_map<Key, Value, Comparator, Allocator, Index>::insert(
+    const Key& key, const Value& obj) {
+  return tree_type::tree_try_emplace(key, obj);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+std::pair<
+    typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>
+compact_map<Key, Value, Comparator, Allocator, Index>::insert(
+    const value_type& value) {
+  return tree_type::tree_insert(value);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+std::pair<
+    typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>
+compact_map<Key, Value, Comparator, Allocator, Index>::insert(
+    value_type&& value) {
+  return tree_type::tree_insert(std::move(value));
+}
+
+// Sized ranges grow the array once up front.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+template <typename InputIt, typename>
+void compact_map<Key, Value, Comparator, Allocator, Index>::insert(
+    InputIt first, InputIt last) {
+  using category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+    reserve(size() + static_cast<size_type>(std::distance(first, last)));
+  }
+  for (; first != last; ++first) {
+    tree_type::tree_try_emplace(first->first, first->second);
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+template <class... Args>
+std::pair<
+    typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>
+compact_map<Key, Value, Comparator, Allocator, Index>::emplace(
+    Args&&... args) {
+  return tree_type::tree_emplace(std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+template <class... Args>
+std::pair<
+    typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>
+compact_map<Key, Value, Comparator, Allocator, Index>::try_emplace(
+    const Key& key, Args&&... args) {
+  return tree_type::tree_try_emplace(key, std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+template <class... Args>
+std::pair<
+    typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>
+compact_map<Key, Value, Comparator, Allocator, Index>::try_emplace(
+    Key&& key, Args&&... args) {
+  return tree_type::tree_try_emplace(std::move(key),
+                                     std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+std::pair<
+    typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>
+compact_map<Key, Value, Comparator, Allocator, Index>::insert_or_assign(
+    const Key& key, const Value& obj) {
+  auto result = tree_type::tree_try_emplace(key, obj);
+  if (!result.second) {
+    result.first->second = obj;
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::erase(iterator pos) {
+  return tree_type::tree_erase(pos);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::erase(iterator first,
+                                                             iterator last) {
+  while (first != last) {
+    first = erase(first);
+  }
+  return last;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::size_type
+compact_map<Key, Value, Comparator, Allocator, Index>::erase(const Key& key) {
+  return tree_type::tree_erase_key(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void compact_map<Key, Value, Comparator, Allocator, Index>::swap(
+    compact_map& other) noexcept {
+  tree_type::tree_swap(other);
+}
+
+// Mapped values are moved across one element at a time; keys already
+// present stay behind in other, as with map::merge.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+void compact_map<Key, Value, Comparator, Allocator, Index>::merge(
+    compact_map& other) {
+  if (this == &other) {
+    return;
+  }
+  for (iterator it = other.begin(); it != other.end();) {
+    if (try_emplace(it->first, std::move(it->second)).second) {
+      it = other.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::find(const Key& key) {
+  return tree_type::tree_find(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::const_iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::find(
+    const Key& key) const {
+  return tree_type::tree_find(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+bool compact_map<Key, Value, Comparator, Allocator, Index>::contains(
+    const Key& key) const {
+  return tree_type::tree_contains(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::size_type
+compact_map<Key, Value, Comparator, Allocator, Index>::count(
+    const Key& key) const {
+  return tree_type::tree_contains(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::lower_bound(
+    const Key& key) {
+  return tree_type::tree_lower_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::const_iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::lower_bound(
+    const Key& key) const {
+  return tree_type::tree_lower_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::upper_bound(
+    const Key& key) {
+  return tree_type::tree_upper_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+typename compact_map<Key, Value, Comparator, Allocator, Index>::const_iterator
+compact_map<Key, Value, Comparator, Allocator, Index>::upper_bound(
+    const Key& key) const {
+  return tree_type::tree_upper_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Index>
+template <class... Args>
+std::vector<std::pair<
+    typename compact_map<Key, Value, Comparator, Allocator, Index>::iterator,
+    bool>>
+compact_map<Key, Value, Comparator, Allocator, Index>::insert_many(
+    Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  result.reserve(sizeof...(args));
+  reserve(size() + sizeof...(args));
+  (result.push_back(insert(std::forward<Args>(args))), ...);
+  return result;
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,350 @@
+#ifndef S21_SRC_COMPACT_SET_H
+#define S21_SRC_COMPACT_SET_H
+
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "CompactAVLtree.h"
+
+namespace s21 {
+
+// Ordered set on CompactAVLtree: same interface as set, but all nodes live
+// in one array linked by Index, so a set<int> costs 16 bytes per element
+// rather than a 48-byte heap node. Index is the policy: uint32_t holds up
+// to 2^30 - 1 elements, uint64_t lifts that. Iterators survive inserts;
+// references to elements do not.
+template <typename Key, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<Key>,
+          typename Index = std::uint32_t>
+class compact_set
+    : private CompactAVLtree<Key, void, Comparator, Allocator, Index> {
+  using tree_type = CompactAVLtree<Key, void, Comparator, Allocator, Index>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename tree_type::const_iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = size_t;
+  using key_compare = Comparator;
+  using allocator_type = Allocator;
+  using index_type = Index;
+
+  compact_set();
+  compact_set(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  compact_set(InputIt first, InputIt last);
+  compact_set(const compact_set& s);
+  compact_set(compact_set&& s) noexcept;
+  ~compact_set() = default;
+  compact_set& operator=(const compact_set& s);
+  compact_set& operator=(compact_set&& s) noexcept;
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  allocator_type get_allocator() const;
+  size_type capacity() const;
+  void reserve(size_type count);
+
+  void clear();
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(value_type&& value);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  void insert(InputIt first, InputIt last);
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  iterator erase(iterator pos);
+  iterator erase(iterator first, iterator last);
+  size_type erase(const Key& key);
+  void swap(compact_set& other) noexcept;
+  void merge(compact_set& other);
+
+  iterator find(const Key& key) const;
+  bool contains(const Key& key) const;
+  size_type count(const Key& key) const;
+  iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key) const;
+
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+};
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+compact_set<Key, Comparator, Allocator, Index>::compact_set() : tree_type() {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+compact_set<Key, Comparator, Allocator, Index>::compact_set(
+    std::initializer_list<value_type> const& items)
+    : compact_set() {
+  assign(items.begin(), items.end());
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+template <typename InputIt, typename>
+compact_set<Key, Comparator, Allocator, Index>::compact_set(InputIt first,
+                                                            InputIt last)
+    : compact_set() {
+  assign(first, last);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+compact_set<Key, Comparator, Allocator, Index>::compact_set(
+    const compact_set& s)
+    : tree_type(s) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+compact_set<Key, Comparator, Allocator, Index>::compact_set(
+    compact_set&& s) noexcept
+    : tree_type(std::move(s)) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+compact_set<Key, Comparator, Allocator, Index>&
+compact_set<Key, Comparator, Allocator, Index>::operator=(
+    const compact_set& s) {
+  tree_type::operator=(s);
+  return *this;
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+compact_set<Key, Comparator, Allocator, Index>&
+compact_set<Key, Comparator, Allocator, Index>::operator=(
+    compact_set&& s) noexcept {
+  tree_type::operator=(std::move(s));
+  return *this;
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+template <typename InputIt>
+void compact_set<Key, Comparator, Allocator, Index>::assign(InputIt first,
+                                                            InputIt last) {
+  clear();
+  insert(first, last);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::const_iterator
+compact_set<Key, Comparator, Allocator, Index>::begin() const {
+  return tree_type::tree_begin();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::const_iterator
+compact_set<Key, Comparator, Allocator, Index>::end() const {
+  return tree_type::tree_end();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+bool compact_set<Key, Comparator, Allocator, Index>::empty() const {
+  return tree_type::tree_empty();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::size_type
+compact_set<Key, Comparator, Allocator, Index>::size() const {
+  return tree_type::tree_size();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::size_type
+compact_set<Key, Comparator, Allocator, Index>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::allocator_type
+compact_set<Key, Comparator, Allocator, Index>::get_allocator() const {
+  return tree_type::tree_get_allocator();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::size_type
+compact_set<Key, Comparator, Allocator, Index>::capacity() const {
+  return tree_type::tree_capacity();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+void compact_set<Key, Comparator, Allocator, Index>::reserve(
+    size_type count) {
+  tree_type::tree_reserve(count);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+void compact_set<Key, Comparator, Allocator, Index>::clear() {
+  tree_type::tree_clear();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+std::pair<typename compact_set<Key, Comparator, Allocator, Index>::iterator,
+          bool>
+compact_set<Key, Comparator, Allocator, Index>::insert(
+    const value_type& value) {
+  return tree_type::tree_insert(value);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+std::pair<typename compact_set<Key, Comparator, Allocator, Index>::iterator,
+          bool>
+compact_set<Key, Comparator, Allocator, Index>::insert(value_type&& value) {
+  return tree_type::tree_insert(std::move(value));
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+template <typename InputIt, typename>
+void compact_set<Key, Comparator, Allocator, Index>::insert(InputIt first,
+                                                            InputIt last) {
+  using category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+    reserve(size() + static_cast<size_type>(std::distance(first, last)));
+  }
+  for (; first != last; ++first) {
+    tree_type::tree_insert(*first);
+  }
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+template <class... Args>
+std::pair<typename compact_set<Key, Comparator, Allocator, Index>::iterator,
+          bool>
+compact_set<Key, Comparator, Allocator, Index>::emplace(Args&&... args) {
+  return tree_type::tree_emplace(std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::iterator
+compact_set<Key, Comparator, Allocator, Index>::erase(iterator pos) {
+  return tree_type::tree_erase(pos);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::iterator
+compact_set<Key, Comparator, Allocator, Index>::erase(iterator first,
+                                                      iterator last) {
+  while (first != last) {
+    first = erase(first);
+  }
+  return last;
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::size_type
+compact_set<Key, Comparator, Allocator, Index>::erase(const Key& key) {
+  return tree_type::tree_erase_key(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+void compact_set<Key, Comparator, Allocator, Index>::swap(
+    compact_set& other) noexcept {
+  tree_type::tree_swap(other);
+}
+
+// Elements live inside the other array, so they are moved across one at a
+// time; keys already present stay behind in other.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+void compact_set<Key, Comparator, Allocator, Index>::merge(
+    compact_set& other) {
+  if (this == &other) {
+    return;
+  }
+  for (iterator it = other.begin(); it != other.end();) {
+    if (insert(*it).second) {
+      it = other.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::iterator
+compact_set<Key, Comparator, Allocator, Index>::find(const Key& key) const {
+  return tree_type::tree_find(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+bool compact_set<Key, Comparator, Allocator, Index>::contains(
+    const Key& key) const {
+  return tree_type::tree_contains(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::size_type
+compact_set<Key, Comparator, Allocator, Index>::count(const Key& key) const {
+  return tree_type::tree_contains(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::iterator
+compact_set<Key, Comparator, Allocator, Index>::lower_bound(
+    const Key& key) const {
+  return tree_type::tree_lower_bound(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+typename compact_set<Key, Comparator, Allocator, Index>::iterator
+compact_set<Key, Comparator, Allocator, Index>::upper_bound(
+    const Key& key) const {
+  return tree_type::tree_upper_bound(key);
+}
+
+// Iterators hold indices, so the ones returned along the way stay valid
+// even if an insert grows the array.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Index>
+template <class... Args>
+std::vector<
+    std::pair<typename compact_set<Key, Comparator, Allocator, Index>::iterator,
+              bool>>
+compact_set<Key, Comparator, Allocator, Index>::insert_many(Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  result.reserve(sizeof...(args));
+  reserve(size() + sizeof...(args));
+  (result.push_back(insert(std::forward<Args>(args))), ...);
+  return result;
+}
+
+}  // namespace s21
+
+#endif
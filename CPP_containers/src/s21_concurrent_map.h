@@ -0,0 +1,962 @@
+#ifndef S21_SRC_CONCURRENT_MAP_H
+#define S21_SRC_CONCURRENT_MAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "AVLtree.h"
+#include "s21_epoch.h"
+
+namespace s21 {
+
+// Ordered map that many threads may use at once. The tree is a relaxed AVL
+// tree with optimistic concurrency control after Bronson et al., "A
+// Practical Concurrent Binary Search Tree": readers take no locks and
+// instead validate a per-node version while they descend, so lookups
+// scale with the number of readers. Writers lock only the nodes they link,
+// unlink or rotate, always parent before child, and repair heights and
+// balance on the way back up.
+//
+// A rotation bumps the version of each node it moves down. A reader that
+// sees the version of the node it came from change retries from there,
+// because the key range under that node may have shrunk. Removing a node
+// with two children turns it into a routing node without a value; routing
+// nodes are spliced out once they have at most one child. Unlinked nodes
+// and replaced values are retired to the epoch domain, since readers may
+// still be looking at them.
+//
+// The height arithmetic, the balance bounds and the choice between a single
+// and a double rotation are AVLtree's, through avl_rules. The rotations are
+// not shared: here they run under locks on atomic links, bump versions for
+// readers and must cope with routing nodes and heights that are briefly
+// stale, none of which the single-threaded tree has.
+//
+// Values are returned by copy, so no reference into the tree outlives the
+// call. The tree is strictly balanced whenever no writer is in progress.
+template <typename Key, typename Value, typename Comparator = std::less<Key>>
+class concurrent_map {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using size_type = size_t;
+
+  concurrent_map();
+  concurrent_map(std::initializer_list<value_type> const& items);
+  concurrent_map(const concurrent_map&) = delete;
+  concurrent_map& operator=(const concurrent_map&) = delete;
+  ~concurrent_map();
+
+  bool empty() const;
+  size_type size() const;
+
+  std::optional<Value> get(const Key& key) const;
+  bool contains(const Key& key) const;
+  bool insert(const Key& key, const Value& obj);
+  bool insert_or_assign(const Key& key, const Value& obj);
+  size_type erase(const Key& key);
+
+  // Calls function(key, value) for every element in key order. The walk is
+  // weakly consistent: each step looks up the next key from scratch, so
+  // elements present for the whole walk are seen exactly once and
+  // concurrent changes may or may not be.
+  template <typename Function>
+  void for_each(Function function) const;
+
+ private:
+  class spin_lock {
+   public:
+    void lock();
+    void unlock();
+
+   private:
+    std::atomic<bool> locked_{false};
+  };
+
+  struct node;
+
+  // children[0] is the left child and children[1] the right one. The root
+  // holder only uses its right child and is the only node without a
+  // parent.
+  struct node_base {
+    std::atomic<node*> children[2] = {nullptr, nullptr};
+    std::atomic<node_base*> parent{nullptr};
+    std::atomic<int> height{0};
+    std::atomic<std::uint64_t> version{0};
+    spin_lock lock;
+  };
+
+  struct node : node_base {
+    const Key key;
+    std::atomic<Value*> value;
+    node(const Key& node_key, Value* node_value, node_base* node_parent);
+    ~node();
+  };
+
+  enum class update_mode { insert, assign, erase };
+  enum class outcome { retry, absent, present };
+
+  struct search_result {
+    bool retry;
+    node* found;
+  };
+
+  using lock_guard = std::lock_guard<spin_lock>;
+
+  // Version layout: the low bit marks an unlinked node, the next one a
+  // rotation in progress that moves the node down; the rest counts
+  // completed rotations.
+  static constexpr std::uint64_t unlinked = 1;
+  static constexpr std::uint64_t shrinking = 2;
+
+  // node_condition() returns the repaired height, or one of these.
+  static constexpr int unlink_required = -1;
+  static constexpr int rebalance_required = -2;
+  static constexpr int nothing_required = -3;
+
+  static bool is_shrinking_or_unlinked(std::uint64_t version);
+  static std::uint64_t begin_shrink(std::uint64_t version);
+  static std::uint64_t end_shrink(std::uint64_t version);
+  static void wait_until_shrunk(node_base* node_ptr, std::uint64_t version);
+  static int height(const node* node_ptr);
+  static void retire(node* node_ptr);
+  static void retire(Value* value);
+  static void destroy(node* node_ptr);
+
+  int compare(const Key& key, const Key& node_key) const;
+  node* find_node(const Key& key) const;
+  search_result attempt_find(const Key& key, node* parent, int direction,
+                             std::uint64_t parent_version) const;
+  node* higher_node(const Key* after) const;
+  search_result attempt_higher(const Key* after, node* node_ptr,
+                               std::uint64_t node_version, node* best) const;
+
+  bool update(const Key& key, update_mode mode, Value*& fresh);
+  bool attempt_insert_into_empty(const Key& key, Value*& fresh);
+  outcome attempt_update(const Key& key, update_mode mode, Value*& fresh,
+                         node_base* parent, node* node_ptr,
+                         std::uint64_t node_version);
+  outcome attempt_node_update(update_mode mode, Value*& fresh,
+                              node_base* parent, node* node_ptr);
+  bool attempt_unlink_nl(node_base* parent, node* node_ptr);
+
+  int node_condition(node* node_ptr) const;
+  void fix_height_and_rebalance(node_base* damaged);
+  node_base* fix_height_nl(node_base* node_ptr);
+  node_base* rebalance_nl(node_base* parent, node* node_ptr);
+  node_base* rebalance_toward_nl(node_base* parent, node* node_ptr, int side,
+                                 node* heavy, int light_height);
+  node_base* rotate_nl(node_base* parent, node* node_ptr, int side,
+                       node* heavy, int light_height, int outer_height,
+                       node* inner, int inner_height);
+  node_base* double_rotate_nl(node_base* parent, node* node_ptr, int side,
+                              node* heavy, int light_height, int outer_height,
+                              node* inner, int inner_outer_height);
+  static void replace_child(node_base* parent, node* old_child,
+                            node* new_child);
+
+  mutable node_base holder_;
+  std::atomic<std::ptrdiff_t> size_{0};
+  Comparator tree_comparator;
+};
+
+template <typename Key, typename Value, typename Comparator>
+void concurrent_map<Key, Value, Comparator>::spin_lock::lock() {
+  while (locked_.exchange(true, std::memory_order_acquire)) {
+    for (int spins = 0; locked_.load(std::memory_order_relaxed); ++spins) {
+      if (spins >= 64) {
+        std::this_thread::yield();
+      }
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+void concurrent_map<Key, Value, Comparator>::spin_lock::unlock() {
+  locked_.store(false, std::memory_order_release);
+}
+
+template <typename Key, typename Value, typename Comparator>
+concurrent_map<Key, Value, Comparator>::node::node(const Key& node_key,
+                                                   Value* node_value,
+                                                   node_base* node_parent)
+    : key(node_key), value(node_value) {
+  this->parent.store(node_parent);
+  this->height.store(1);
+}
+
+template <typename Key, typename Value, typename Comparator>
+concurrent_map<Key, Value, Comparator>::node::~node() {
+  delete value.load();
+}
+
+template <typename Key, typename Value, typename Comparator>
+concurrent_map<Key, Value, Comparator>::concurrent_map() : holder_() {}
+
+template <typename Key, typename Value, typename Comparator>
+concurrent_map<Key, Value, Comparator>::concurrent_map(
+    std::initializer_list<value_type> const& items)
+    : concurrent_map() {
+  for (const value_type& item : items) {
+    insert(item.first, item.second);
+  }
+}
+
+// Destruction must not overlap with any other call; nodes already retired
+// belong to the epoch domain.
+template <typename Key, typename Value, typename Comparator>
+concurrent_map<Key, Value, Comparator>::~concurrent_map() {
+  destroy(holder_.children[1].load());
+}
+
+template <typename Key, typename Value, typename Comparator>
+void concurrent_map<Key, Value, Comparator>::destroy(node* node_ptr) {
+  if (node_ptr != nullptr) {
+    destroy(node_ptr->children[0].load());
+    destroy(node_ptr->children[1].load());
+    delete node_ptr;
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool concurrent_map<Key, Value, Comparator>::empty() const {
+  return size() == 0;
+}
+
+// Counts are adjusted after the tree changes, so a remove can be counted
+// before the insert it follows; size() never reports that as negative.
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::size_type
+concurrent_map<Key, Value, Comparator>::size() const {
+  std::ptrdiff_t count = size_.load(std::memory_order_relaxed);
+  return count > 0 ? static_cast<size_type>(count) : 0;
+}
+
+template <typename Key, typename Value, typename Comparator>
+std::optional<Value> concurrent_map<Key, Value, Comparator>::get(
+    const Key& key) const {
+  epoch_domain::guard pin;
+  node* found = find_node(key);
+  Value* value = found != nullptr ? found->value.load() : nullptr;
+  if (value == nullptr) {
+    return std::nullopt;
+  }
+  return *value;
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool concurrent_map<Key, Value, Comparator>::contains(const Key& key) const {
+  epoch_domain::guard pin;
+  node* found = find_node(key);
+  return found != nullptr && found->value.load() != nullptr;
+}
+
+// Returns whether the key was inserted; an existing value is left alone.
+template <typename Key, typename Value, typename Comparator>
+bool concurrent_map<Key, Value, Comparator>::insert(const Key& key,
+                                                    const Value& obj) {
+  Value* fresh = new Value(obj);
+  bool present;
+  try {
+    epoch_domain::guard pin;
+    present = update(key, update_mode::insert, fresh);
+  } catch (...) {
+    delete fresh;
+    throw;
+  }
+  delete fresh;
+  return !present;
+}
+
+// Returns whether the key was inserted rather than assigned.
+template <typename Key, typename Value, typename Comparator>
+bool concurrent_map<Key, Value, Comparator>::insert_or_assign(
+    const Key& key, const Value& obj) {
+  Value* fresh = new Value(obj);
+  bool present;
+  try {
+    epoch_domain::guard pin;
+    present = update(key, update_mode::assign, fresh);
+  } catch (...) {
+    delete fresh;
+    throw;
+  }
+  delete fresh;
+  return !present;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::size_type
+concurrent_map<Key, Value, Comparator>::erase(const Key& key) {
+  Value* none = nullptr;
+  epoch_domain::guard pin;
+  return update(key, update_mode::erase, none) ? 1 : 0;
+}
+
+template <typename Key, typename Value, typename Comparator>
+template <typename Function>
+void concurrent_map<Key, Value, Comparator>::for_each(
+    Function function) const {
+  std::optional<Key> last;
+  while (true) {
+    std::optional<Value> value;
+    {
+      epoch_domain::guard pin;
+      node* next = higher_node(last ? &*last : nullptr);
+      if (next == nullptr) {
+        return;
+      }
+      last.emplace(next->key);
+      if (Value* current = next->value.load()) {
+        value.emplace(*current);
+      }
+    }
+    if (value) {
+      function(*last, *value);
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool concurrent_map<Key, Value, Comparator>::is_shrinking_or_unlinked(
+    std::uint64_t version) {
+  return (version & (shrinking | unlinked)) != 0;
+}
+
+template <typename Key, typename Value, typename Comparator>
+std::uint64_t concurrent_map<Key, Value, Comparator>::begin_shrink(
+    std::uint64_t version) {
+  return version | shrinking;
+}
+
+template <typename Key, typename Value, typename Comparator>
+std::uint64_t concurrent_map<Key, Value, Comparator>::end_shrink(
+    std::uint64_t version) {
+  return (version | shrinking) + shrinking;
+}
+
+// A rotation holds the node's lock from before it marks the node until
+// after it bumps the version, so taking the lock waits for it to finish.
+template <typename Key, typename Value, typename Comparator>
+void concurrent_map<Key, Value, Comparator>::wait_until_shrunk(
+    node_base* node_ptr, std::uint64_t version) {
+  if ((version & shrinking) != 0) {
+    lock_guard wait(node_ptr->lock);
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+int concurrent_map<Key, Value, Comparator>::height(const node* node_ptr) {
+  return node_ptr != nullptr ? node_ptr->height.load() : 0;
+}
+
+template <typename Key, typename Value, typename Comparator>
+void concurrent_map<Key, Value, Comparator>::retire(node* node_ptr) {
+  epoch_domain::instance().retire(node_ptr);
+}
+
+template <typename Key, typename Value, typename Comparator>
+void concurrent_map<Key, Value, Comparator>::retire(Value* value) {
+  epoch_domain::instance().retire(value);
+}
+
+template <typename Key, typename Value, typename Comparator>
+int concurrent_map<Key, Value, Comparator>::compare(
+    const Key& key, const Key& node_key) const {
+  if (tree_comparator(key, node_key)) {
+    return -1;
+  }
+  return tree_comparator(node_key, key) ? 1 : 0;
+}
+
+// Returns the node holding key, which may be a routing node or one that
+// was just unlinked; both have no value. Each step to a child is only
+// trusted if the parent's version did not change while the child pointer
+// and the child's version were read.
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::node*
+concurrent_map<Key, Value, Comparator>::find_node(const Key& key) const {
+  while (true) {
+    node* root = holder_.children[1].load();
+    if (root == nullptr) {
+      return nullptr;
+    }
+    int direction = compare(key, root->key);
+    if (direction == 0) {
+      return root;
+    }
+    std::uint64_t version = root->version.load();
+    if (is_shrinking_or_unlinked(version)) {
+      wait_until_shrunk(root, version);
+    } else if (root == holder_.children[1].load()) {
+      search_result result = attempt_find(key, root, direction, version);
+      if (!result.retry) {
+        return result.found;
+      }
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::search_result
+concurrent_map<Key, Value, Comparator>::attempt_find(
+    const Key& key, node* parent, int direction,
+    std::uint64_t parent_version) const {
+  int side = direction > 0 ? 1 : 0;
+  while (true) {
+    node* child = parent->children[side].load();
+    if (child == nullptr) {
+      return {parent->version.load() != parent_version, nullptr};
+    }
+    int child_direction = compare(key, child->key);
+    if (child_direction == 0) {
+      return {false, child};
+    }
+    std::uint64_t child_version = child->version.load();
+    if (is_shrinking_or_unlinked(child_version)) {
+      wait_until_shrunk(child, child_version);
+      if (parent->version.load() != parent_version) {
+        return {true, nullptr};
+      }
+    } else if (child != parent->children[side].load()) {
+      if (parent->version.load() != parent_version) {
+        return {true, nullptr};
+      }
+    } else {
+      if (parent->version.load() != parent_version) {
+        return {true, nullptr};
+      }
+      search_result result =
+          attempt_find(key, child, child_direction, child_version);
+      if (!result.retry) {
+        return result;
+      }
+    }
+  }
+}
+
+// Finds the first node with a value whose key follows *after, or the first
+// node overall when after is nullptr. The search path for *after is
+// validated like a lookup; every node on it with a greater key is a
+// candidate and the smallest candidate is the successor. A candidate that
+// turns out to have no value is skipped by searching again past it.
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::node*
+concurrent_map<Key, Value, Comparator>::higher_node(const Key* after) const {
+  while (true) {
+    node* root = holder_.children[1].load();
+    if (root == nullptr) {
+      return nullptr;
+    }
+    std::uint64_t version = root->version.load();
+    if (is_shrinking_or_unlinked(version)) {
+      wait_until_shrunk(root, version);
+    } else if (root == holder_.children[1].load()) {
+      search_result result = attempt_higher(after, root, version, nullptr);
+      if (!result.retry) {
+        if (result.found == nullptr || result.found->value.load() != nullptr) {
+          return result.found;
+        }
+        after = &result.found->key;
+      }
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::search_result
+concurrent_map<Key, Value, Comparator>::attempt_higher(
+    const Key* after, node* node_ptr, std::uint64_t node_version,
+    node* best) const {
+  int side = after != nullptr && !tree_comparator(*after, node_ptr->key);
+  if (side == 0 &&
+      (best == nullptr || tree_comparator(node_ptr->key, best->key))) {
+    best = node_ptr;
+  }
+  while (true) {
+    node* child = node_ptr->children[side].load();
+    if (child == nullptr) {
+      if (node_ptr->version.load() != node_version) {
+        return {true, nullptr};
+      }
+      return {false, best};
+    }
+    std::uint64_t child_version = child->version.load();
+    if (is_shrinking_or_unlinked(child_version)) {
+      wait_until_shrunk(child, child_version);
+      if (node_ptr->version.load() != node_version) {
+        return {true, nullptr};
+      }
+    } else if (child != node_ptr->children[side].load()) {
+      if (node_ptr->version.load() != node_version) {
+        return {true, nullptr};
+      }
+    } else {
+      if (node_ptr->version.load() != node_version) {
+        return {true, nullptr};
+      }
+      search_result result = attempt_higher(after, child, child_version, best);
+      if (!result.retry) {
+        return result;
+      }
+    }
+  }
+}
+
+// Applies mode to key and returns whether the key had a value before. A
+// value taken over by the tree is cleared from fresh.
+template <typename Key, typename Value, typename Comparator>
+bool concurrent_map<Key, Value, Comparator>::update(const Key& key,
+                                                    update_mode mode,
+                                                    Value*& fresh) {
+  while (true) {
+    node* root = holder_.children[1].load();
+    if (root == nullptr) {
+      if (mode == update_mode::erase ||
+          attempt_insert_into_empty(key, fresh)) {
+        return false;
+      }
+    } else {
+      std::uint64_t version = root->version.load();
+      if (is_shrinking_or_unlinked(version)) {
+        wait_until_shrunk(root, version);
+      } else if (root == holder_.children[1].load()) {
+        outcome result =
+            attempt_update(key, mode, fresh, &holder_, root, version);
+        if (result != outcome::retry) {
+          return result == outcome::present;
+        }
+      }
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool concurrent_map<Key, Value, Comparator>::attempt_insert_into_empty(
+    const Key& key, Value*& fresh) {
+  lock_guard hold(holder_.lock);
+  if (holder_.children[1].load() != nullptr) {
+    return false;
+  }
+  holder_.children[1].store(new node(key, fresh, &holder_));
+  fresh = nullptr;
+  size_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+// As in find_node(), the step from node_ptr to its child is revalidated
+// before descending. A missing key is linked in as a new leaf under the
+// lock of its parent, after checking that the parent neither shrank nor
+// gained that child in the meantime.
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::outcome
+concurrent_map<Key, Value, Comparator>::attempt_update(
+    const Key& key, update_mode mode, Value*& fresh, node_base* parent,
+    node* node_ptr, std::uint64_t node_version) {
+  int direction = compare(key, node_ptr->key);
+  if (direction == 0) {
+    return attempt_node_update(mode, fresh, parent, node_ptr);
+  }
+  int side = direction > 0 ? 1 : 0;
+  while (true) {
+    node* child = node_ptr->children[side].load();
+    if (node_ptr->version.load() != node_version) {
+      return outcome::retry;
+    }
+    if (child == nullptr) {
+      if (mode == update_mode::erase) {
+        return outcome::absent;
+      }
+      node_base* damaged;
+      {
+        lock_guard hold(node_ptr->lock);
+        if (node_ptr->version.load() != node_version) {
+          return outcome::retry;
+        }
+        if (node_ptr->children[side].load() != nullptr) {
+          continue;
+        }
+        node_ptr->children[side].store(new node(key, fresh, node_ptr));
+        fresh = nullptr;
+        damaged = fix_height_nl(node_ptr);
+      }
+      size_.fetch_add(1, std::memory_order_relaxed);
+      fix_height_and_rebalance(damaged);
+      return outcome::absent;
+    }
+    std::uint64_t child_version = child->version.load();
+    if (is_shrinking_or_unlinked(child_version)) {
+      wait_until_shrunk(child, child_version);
+    } else if (child == node_ptr->children[side].load()) {
+      if (node_ptr->version.load() != node_version) {
+        return outcome::retry;
+      }
+      outcome result =
+          attempt_update(key, mode, fresh, node_ptr, child, child_version);
+      if (result != outcome::retry) {
+        return result;
+      }
+    }
+  }
+}
+
+// Erasing a node with at most one child unlinks it, which needs the lock of
+// its parent as well. Any other change, including erasing a node with two
+// children, swaps the value under the node's own lock.
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::outcome
+concurrent_map<Key, Value, Comparator>::attempt_node_update(
+    update_mode mode, Value*& fresh, node_base* parent, node* node_ptr) {
+  bool erasing = mode == update_mode::erase;
+  if (erasing && node_ptr->value.load() == nullptr) {
+    return outcome::absent;
+  }
+  if (erasing && (node_ptr->children[0].load() == nullptr ||
+                  node_ptr->children[1].load() == nullptr)) {
+    node_base* damaged;
+    {
+      lock_guard hold_parent(parent->lock);
+      if (parent->version.load() == unlinked ||
+          node_ptr->parent.load() != parent) {
+        return outcome::retry;
+      }
+      {
+        lock_guard hold(node_ptr->lock);
+        if (node_ptr->value.load() == nullptr) {
+          return outcome::absent;
+        }
+        if (!attempt_unlink_nl(parent, node_ptr)) {
+          return outcome::retry;
+        }
+      }
+      damaged = fix_height_nl(parent);
+    }
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    fix_height_and_rebalance(damaged);
+    return outcome::present;
+  }
+
+  lock_guard hold(node_ptr->lock);
+  if (node_ptr->version.load() == unlinked) {
+    return outcome::retry;
+  }
+  Value* previous = node_ptr->value.load();
+  if (mode == update_mode::insert && previous != nullptr) {
+    return outcome::present;
+  }
+  if (erasing && (node_ptr->children[0].load() == nullptr ||
+                  node_ptr->children[1].load() == nullptr)) {
+    return outcome::retry;
+  }
+  node_ptr->value.store(fresh);
+  fresh = nullptr;
+  retire(previous);
+  if (previous == nullptr && !erasing) {
+    size_.fetch_add(1, std::memory_order_relaxed);
+  } else if (previous != nullptr && erasing) {
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  return previous != nullptr ? outcome::present : outcome::absent;
+}
+
+// Splices out node_ptr, which must have at most one child. Both locks are
+// held. The node and its value go to the epoch domain.
+template <typename Key, typename Value, typename Comparator>
+bool concurrent_map<Key, Value, Comparator>::attempt_unlink_nl(
+    node_base* parent, node* node_ptr) {
+  if (parent->children[0].load() != node_ptr &&
+      parent->children[1].load() != node_ptr) {
+    return false;
+  }
+  node* left = node_ptr->children[0].load();
+  node* right = node_ptr->children[1].load();
+  if (left != nullptr && right != nullptr) {
+    return false;
+  }
+  node* splice = left != nullptr ? left : right;
+  replace_child(parent, node_ptr, splice);
+  if (splice != nullptr) {
+    splice->parent.store(parent);
+  }
+  node_ptr->version.store(unlinked);
+  retire(node_ptr->value.exchange(nullptr));
+  retire(node_ptr);
+  return true;
+}
+
+template <typename Key, typename Value, typename Comparator>
+void concurrent_map<Key, Value, Comparator>::replace_child(node_base* parent,
+                                                           node* old_child,
+                                                           node* new_child) {
+  if (parent->children[0].load() == old_child) {
+    parent->children[0].store(new_child);
+  } else {
+    parent->children[1].store(new_child);
+  }
+}
+
+// Reads the children once and judges the node from that snapshot.
+template <typename Key, typename Value, typename Comparator>
+int concurrent_map<Key, Value, Comparator>::node_condition(
+    node* node_ptr) const {
+  node* left = node_ptr->children[0].load();
+  node* right = node_ptr->children[1].load();
+  if ((left == nullptr || right == nullptr) &&
+      node_ptr->value.load() == nullptr) {
+    return unlink_required;
+  }
+  int current = node_ptr->height.load();
+  int left_height = height(left);
+  int right_height = height(right);
+  int repaired = avl_rules::height_above(left_height, right_height);
+  if (avl_rules::out_of_balance(left_height, right_height)) {
+    return rebalance_required;
+  }
+  return current != repaired ? repaired : nothing_required;
+}
+
+// Repairs damaged nodes bottom-up until one needs no repair. Height fixes
+// lock the node alone; unlinks and rotations lock its parent first. A
+// rotation that leaves one of the nodes it moved damaged returns that node
+// before the parent's height is fixed, so the parent is revisited once the
+// repair below it settles.
+template <typename Key, typename Value, typename Comparator>
+void concurrent_map<Key, Value, Comparator>::fix_height_and_rebalance(
+    node_base* damaged) {
+  std::vector<node_base*> revisit;
+  while (true) {
+    int condition = nothing_required;
+    if (damaged != nullptr && damaged->parent.load() != nullptr &&
+        damaged->version.load() != unlinked) {
+      condition = node_condition(static_cast<node*>(damaged));
+    }
+    if (condition == nothing_required) {
+      if (revisit.empty()) {
+        return;
+      }
+      damaged = revisit.back();
+      revisit.pop_back();
+      continue;
+    }
+    node* node_ptr = static_cast<node*>(damaged);
+    if (condition != unlink_required && condition != rebalance_required) {
+      lock_guard hold(node_ptr->lock);
+      damaged = fix_height_nl(node_ptr);
+    } else {
+      node_base* parent = node_ptr->parent.load();
+      lock_guard hold_parent(parent->lock);
+      if (parent->version.load() != unlinked &&
+          node_ptr->parent.load() == parent) {
+        lock_guard hold(node_ptr->lock);
+        damaged = rebalance_nl(parent, node_ptr);
+        if (damaged != nullptr && damaged != parent &&
+            damaged != parent->parent.load()) {
+          revisit.push_back(parent);
+        }
+      }
+    }
+  }
+}
+
+// Fixes the height of a locked node if that is all it needs. Returns the
+// next node to repair: the node itself when it needs more than a height
+// fix, its parent after a fix, nullptr when nothing changed.
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::node_base*
+concurrent_map<Key, Value, Comparator>::fix_height_nl(node_base* node_ptr) {
+  if (node_ptr == &holder_) {
+    return nullptr;
+  }
+  node* target = static_cast<node*>(node_ptr);
+  int condition = node_condition(target);
+  if (condition == rebalance_required || condition == unlink_required) {
+    return target;
+  }
+  if (condition == nothing_required) {
+    return nullptr;
+  }
+  target->height.store(condition);
+  return target->parent.load();
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::node_base*
+concurrent_map<Key, Value, Comparator>::rebalance_nl(node_base* parent,
+                                                     node* node_ptr) {
+  node* left = node_ptr->children[0].load();
+  node* right = node_ptr->children[1].load();
+  if ((left == nullptr || right == nullptr) &&
+      node_ptr->value.load() == nullptr) {
+    return attempt_unlink_nl(parent, node_ptr) ? fix_height_nl(parent)
+                                               : node_ptr;
+  }
+  int current = node_ptr->height.load();
+  int left_height = height(left);
+  int right_height = height(right);
+  int repaired = avl_rules::height_above(left_height, right_height);
+  int skew = avl_rules::skew(left_height, right_height);
+  if (skew < -1) {
+    return rebalance_toward_nl(parent, node_ptr, 0, left, right_height);
+  }
+  if (skew > 1) {
+    return rebalance_toward_nl(parent, node_ptr, 1, right, left_height);
+  }
+  if (repaired != current) {
+    node_ptr->height.store(repaired);
+    return fix_height_nl(parent);
+  }
+  return nullptr;
+}
+
+// node_ptr is too heavy on side; heavy is its child there and light_height
+// the height seen on the other side. A single rotation lifts heavy; when
+// heavy leans the other way its inner child is lifted by a double rotation,
+// or heavy is rebalanced first if a double rotation would leave it out of
+// balance. A routing node left with one child by a rotation is returned as
+// damaged, so the repair loop unlinks it.
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::node_base*
+concurrent_map<Key, Value, Comparator>::rebalance_toward_nl(
+    node_base* parent, node* node_ptr, int side, node* heavy,
+    int light_height) {
+  int other = 1 - side;
+  lock_guard hold_heavy(heavy->lock);
+  if (heavy->height.load() - light_height <= 1) {
+    return node_ptr;
+  }
+  node* inner = heavy->children[other].load();
+  int outer_height = height(heavy->children[side].load());
+  int inner_height = height(inner);
+  if (!avl_rules::needs_double_rotation(outer_height, inner_height)) {
+    return rotate_nl(parent, node_ptr, side, heavy, light_height, outer_height,
+                     inner, inner_height);
+  }
+  {
+    lock_guard hold_inner(inner->lock);
+    inner_height = inner->height.load();
+    if (!avl_rules::needs_double_rotation(outer_height, inner_height)) {
+      return rotate_nl(parent, node_ptr, side, heavy, light_height,
+                       outer_height, inner, inner_height);
+    }
+    int inner_outer_height = height(inner->children[side].load());
+    if (!avl_rules::out_of_balance(outer_height, inner_outer_height)) {
+      return double_rotate_nl(parent, node_ptr, side, heavy, light_height,
+                              outer_height, inner, inner_outer_height);
+    }
+  }
+  return rebalance_toward_nl(node_ptr, heavy, other, inner, outer_height);
+}
+
+// Lifts heavy into the place of node_ptr, which moves down to the other
+// side and takes inner as its new child on side.
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::node_base*
+concurrent_map<Key, Value, Comparator>::rotate_nl(
+    node_base* parent, node* node_ptr, int side, node* heavy,
+    int light_height, int outer_height, node* inner, int inner_height) {
+  int other = 1 - side;
+  std::uint64_t version = node_ptr->version.load();
+  node_ptr->version.store(begin_shrink(version));
+
+  node_ptr->children[side].store(inner);
+  if (inner != nullptr) {
+    inner->parent.store(node_ptr);
+  }
+  heavy->children[other].store(node_ptr);
+  node_ptr->parent.store(heavy);
+  replace_child(parent, node_ptr, heavy);
+  heavy->parent.store(parent);
+
+  int node_height = avl_rules::height_above(inner_height, light_height);
+  node_ptr->height.store(node_height);
+  heavy->height.store(avl_rules::height_above(outer_height, node_height));
+  node_ptr->version.store(end_shrink(version));
+
+  int node_balance = inner_height - light_height;
+  if (node_balance < -1 || node_balance > 1) {
+    return node_ptr;
+  }
+  if ((inner == nullptr || light_height == 0) &&
+      node_ptr->value.load() == nullptr) {
+    return node_ptr;
+  }
+  int heavy_balance = outer_height - node_height;
+  if (heavy_balance < -1 || heavy_balance > 1) {
+    return heavy;
+  }
+  if (outer_height == 0 && heavy->value.load() == nullptr) {
+    return heavy;
+  }
+  return fix_height_nl(parent);
+}
+
+// Lifts inner above both heavy and node_ptr, which become its children and
+// take over its two subtrees.
+template <typename Key, typename Value, typename Comparator>
+typename concurrent_map<Key, Value, Comparator>::node_base*
+concurrent_map<Key, Value, Comparator>::double_rotate_nl(
+    node_base* parent, node* node_ptr, int side, node* heavy,
+    int light_height, int outer_height, node* inner,
+    int inner_outer_height) {
+  int other = 1 - side;
+  std::uint64_t version = node_ptr->version.load();
+  std::uint64_t heavy_version = heavy->version.load();
+  node* inner_outer = inner->children[side].load();
+  node* inner_inner = inner->children[other].load();
+  int inner_inner_height = height(inner_inner);
+  node_ptr->version.store(begin_shrink(version));
+  heavy->version.store(begin_shrink(heavy_version));
+
+  node_ptr->children[side].store(inner_inner);
+  if (inner_inner != nullptr) {
+    inner_inner->parent.store(node_ptr);
+  }
+  heavy->children[other].store(inner_outer);
+  if (inner_outer != nullptr) {
+    inner_outer->parent.store(heavy);
+  }
+  inner->children[side].store(heavy);
+  heavy->parent.store(inner);
+  inner->children[other].store(node_ptr);
+  node_ptr->parent.store(inner);
+  replace_child(parent, node_ptr, inner);
+  inner->parent.store(parent);
+
+  int node_height = avl_rules::height_above(inner_inner_height, light_height);
+  node_ptr->height.store(node_height);
+  int heavy_height = avl_rules::height_above(outer_height, inner_outer_height);
+  heavy->height.store(heavy_height);
+  inner->height.store(avl_rules::height_above(heavy_height, node_height));
+  node_ptr->version.store(end_shrink(version));
+  heavy->version.store(end_shrink(heavy_version));
+
+  int node_balance = inner_inner_height - light_height;
+  if (node_balance < -1 || node_balance > 1) {
+    return node_ptr;
+  }
+  if ((inner_inner == nullptr || light_height == 0) &&
+      node_ptr->value.load() == nullptr) {
+    return node_ptr;
+  }
+  if ((inner_outer == nullptr || outer_height == 0) &&
+      heavy->value.load() == nullptr) {
+    return heavy;
+  }
+  int inner_balance = heavy_height - node_height;
+  if (inner_balance < -1 || inner_balance > 1) {
+    return inner;
+  }
+  return fix_height_nl(parent);
+}
+
+}  // namespace s21
+
+#endif
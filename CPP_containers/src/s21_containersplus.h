@@ -2,6 +2,26 @@
 #define SRC_S21_CONTAINERSPLUS_H
 
 #include "s21_array.h"
+#include "s21_btree_map.h"
+#include "s21_btree_multiset.h"
+#include "s21_btree_set.h"
+#include "s21_compact_map.h"
+#include "s21_compact_set.h"
+#include "s21_concurrent_map.h"
+#include "s21_cow_map.h"
+#include "s21_cow_set.h"
+#include "s21_flat_map.h"
+#include "s21_flat_multiset.h"
+#include "s21_flat_set.h"
+#include "s21_frozen_map.h"
+#include "s21_frozen_set.h"
+#include "s21_interval_map.h"
 #include "s21_multiset.h"
+#include "s21_persistent_map.h"
+#include "s21_run_length_multiset.h"
+#include "s21_skiplist_map.h"
+#include "s21_slab_allocator.h"
+#include "s21_unordered_map.h"
+#include "s21_unordered_set.h"
 
 #endif
\ No newline at end of file
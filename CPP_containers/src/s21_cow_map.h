@@ -0,0 +1,429 @@
+#ifndef S21_SRC_COW_MAP_H
+#define S21_SRC_COW_MAP_H
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_map.h"
+
+namespace s21 {
+
+// map whose copies share one tree until either side is modified. Copying is
+// O(1); the first non-const call on a shared copy clones the tree and the
+// copy carries on alone, so passing a large map by value only costs a full
+// copy when the callee changes it.
+//
+// Non-const begin(), end(), find-like calls and element access count as
+// modifications, since they hand out mutable references. As with other
+// implicitly shared containers, a mutable iterator or reference taken
+// before a copy is made writes to the tree both copies share; take it
+// after copying, or read through a const cow_map. erase() is the
+// exception: it finds the same positions again in its own clone.
+template <typename Key, typename Value, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, Value>>,
+          typename Augment = no_augment>
+class cow_map {
+  using map_type = map<Key, Value, Comparator, Allocator, Augment>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = typename map_type::value_type;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename map_type::iterator;
+  using const_iterator = typename map_type::const_iterator;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  cow_map() = default;
+  cow_map(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  cow_map(InputIt first, InputIt last);
+  explicit cow_map(map_type items);
+  cow_map(const cow_map& m) = default;
+  cow_map(cow_map&& m) noexcept = default;
+  ~cow_map() = default;
+  cow_map& operator=(const cow_map& m) = default;
+  cow_map& operator=(cow_map&& m) noexcept = default;
+
+  Value& at(const Key& key);
+  const Value& at(const Key& key) const;
+  Value& operator[](const Key& key);
+  Value& operator[](Key&& key);
+
+  iterator begin();
+  const_iterator begin() const;
+  iterator end();
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  allocator_type get_allocator() const;
+  // Whether another cow_map currently shares this tree.
+  bool shared() const;
+
+  void clear();
+  std::pair<iterator, bool> insert(const Key& key, const Value& obj);
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(value_type&& value);
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args);
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const Value& obj);
+  iterator erase(iterator pos);
+  iterator erase(iterator first, iterator last);
+  size_type erase(const Key& key);
+  void swap(cow_map& other) noexcept;
+  void merge(cow_map& other);
+
+  bool contains(const Key& key) const;
+  iterator lower_bound(const Key& key);
+  const_iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key);
+  const_iterator upper_bound(const Key& key) const;
+
+ private:
+  map_type& unshare();
+  const map_type& view() const;
+  std::optional<Key> key_at(iterator pos);
+  iterator find_again(const std::optional<Key>& key);
+
+  // Null until first written to, and again after being moved from.
+  std::shared_ptr<map_type> tree_;
+};
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+cow_map<Key, Value, Comparator, Allocator, Augment>::cow_map(
+    std::initializer_list<value_type> const& items)
+    : tree_(std::make_shared<map_type>(items)) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename InputIt, typename>
+cow_map<Key, Value, Comparator, Allocator, Augment>::cow_map(InputIt first,
+                                                             InputIt last)
+    : tree_(std::make_shared<map_type>(first, last)) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+cow_map<Key, Value, Comparator, Allocator, Augment>::cow_map(map_type items)
+    : tree_(std::make_shared<map_type>(std::move(items))) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+Value& cow_map<Key, Value, Comparator, Allocator, Augment>::at(
+    const Key& key) {
+  return unshare().at(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+const Value& cow_map<Key, Value, Comparator, Allocator, Augment>::at(
+    const Key& key) const {
+  if (!view().contains(key)) {
+    throw std::out_of_range("There is no element with this key");
+  }
+  return view().lower_bound(key)->second;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+Value& cow_map<Key, Value, Comparator, Allocator, Augment>::operator[](
+    const Key& key) {
+  return unshare()[key];
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+Value& cow_map<Key, Value, Comparator, Allocator, Augment>::operator[](
+    Key&& key) {
+  return unshare()[std::move(key)];
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::iterator
+cow_map<Key, Value, Comparator, Allocator, Augment>::begin() {
+  return unshare().begin();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::const_iterator
+cow_map<Key, Value, Comparator, Allocator, Augment>::begin() const {
+  return view().begin();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::iterator
+cow_map<Key, Value, Comparator, Allocator, Augment>::end() {
+  return unshare().end();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::const_iterator
+cow_map<Key, Value, Comparator, Allocator, Augment>::end() const {
+  return view().end();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool cow_map<Key, Value, Comparator, Allocator, Augment>::empty() const {
+  return view().empty();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::size_type
+cow_map<Key, Value, Comparator, Allocator, Augment>::size() const {
+  return view().size();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::size_type
+cow_map<Key, Value, Comparator, Allocator, Augment>::max_size() const {
+  return view().max_size();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::allocator_type
+cow_map<Key, Value, Comparator, Allocator, Augment>::get_allocator() const {
+  return view().get_allocator();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool cow_map<Key, Value, Comparator, Allocator, Augment>::shared() const {
+  return tree_ != nullptr && tree_.use_count() > 1;
+}
+
+// A shared tree is left to its other owners rather than cloned and cleared.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void cow_map<Key, Value, Comparator, Allocator, Augment>::clear() {
+  if (shared()) {
+    tree_.reset();
+  } else if (tree_ != nullptr) {
+    tree_->clear();
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<typename cow_map<Key, Value, Comparator, Allocator,
+                           Augment>::iterator,
+          bool>
+cow_map<Key, Value, Comparator, Allocator, Augment>::insert(
+    const Key& key, const Value& obj) {
+  return unshare().insert(key, obj);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<typename cow_map<Key, Value, Comparator, Allocator,
+                           Augment>::iterator,
+          bool>
+cow_map<Key, Value, Comparator, Allocator, Augment>::insert(
+    const value_type& value) {
+  return unshare().insert(value);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<typename cow_map<Key, Value, Comparator, Allocator,
+                           Augment>::iterator,
+          bool>
+cow_map<Key, Value, Comparator, Allocator, Augment>::insert(
+    value_type&& value) {
+  return unshare().insert(std::move(value));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <class... Args>
+std::pair<typename cow_map<Key, Value, Comparator, Allocator,
+                           Augment>::iterator,
+          bool>
+cow_map<Key, Value, Comparator, Allocator, Augment>::emplace(
+    Args&&... args) {
+  return unshare().emplace(std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <class... Args>
+std::pair<typename cow_map<Key, Value, Comparator, Allocator,
+                           Augment>::iterator,
+          bool>
+cow_map<Key, Value, Comparator, Allocator, Augment>::try_emplace(
+    const Key& key, Args&&... args) {
+  return unshare().try_emplace(key, std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<typename cow_map<Key, Value, Comparator, Allocator,
+                           Augment>::iterator,
+          bool>
+cow_map<Key, Value, Comparator, Allocator, Augment>::insert_or_assign(
+    const Key& key, const Value& obj) {
+  return unshare().insert_or_assign(key, obj);
+}
+
+// pos may still point into a tree shared with another copy, in which case
+// it is found again by key in the clone.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::iterator
+cow_map<Key, Value, Comparator, Allocator, Augment>::erase(iterator pos) {
+  if (!shared()) {
+    return unshare().erase(pos);
+  }
+  std::optional<Key> key = key_at(pos);
+  unshare();
+  return tree_->erase(find_again(key));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::iterator
+cow_map<Key, Value, Comparator, Allocator, Augment>::erase(iterator first,
+                                                           iterator last) {
+  if (!shared()) {
+    return unshare().erase(first, last);
+  }
+  std::optional<Key> first_key = key_at(first);
+  std::optional<Key> last_key = key_at(last);
+  unshare();
+  return tree_->erase(find_again(first_key), find_again(last_key));
+}
+
+// A key that is not there leaves a shared tree shared.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::size_type
+cow_map<Key, Value, Comparator, Allocator, Augment>::erase(const Key& key) {
+  if (!view().contains(key)) {
+    return 0;
+  }
+  return unshare().erase(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void cow_map<Key, Value, Comparator, Allocator, Augment>::swap(
+    cow_map& other) noexcept {
+  tree_.swap(other.tree_);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void cow_map<Key, Value, Comparator, Allocator, Augment>::merge(
+    cow_map& other) {
+  if (other.empty() || this == &other) {
+    return;
+  }
+  unshare().merge(other.unshare());
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool cow_map<Key, Value, Comparator, Allocator, Augment>::contains(
+    const Key& key) const {
+  return view().contains(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::iterator
+cow_map<Key, Value, Comparator, Allocator, Augment>::lower_bound(
+    const Key& key) {
+  return unshare().lower_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::const_iterator
+cow_map<Key, Value, Comparator, Allocator, Augment>::lower_bound(
+    const Key& key) const {
+  return view().lower_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::iterator
+cow_map<Key, Value, Comparator, Allocator, Augment>::upper_bound(
+    const Key& key) {
+  return unshare().upper_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::const_iterator
+cow_map<Key, Value, Comparator, Allocator, Augment>::upper_bound(
+    const Key& key) const {
+  return view().upper_bound(key);
+}
+
+// Clones the tree if another cow_map still shares it. Seeing a count of one
+// also has to order this thread's writes after whatever the last other
+// owner did before letting go; its release of the count is paired with the
+// acquire fence here.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::map_type&
+cow_map<Key, Value, Comparator, Allocator, Augment>::unshare() {
+  if (tree_ == nullptr) {
+    tree_ = std::make_shared<map_type>();
+  } else if (tree_.use_count() > 1) {
+    tree_ = std::make_shared<map_type>(*tree_);
+  } else {
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+  return *tree_;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+const typename cow_map<Key, Value, Comparator, Allocator, Augment>::map_type&
+cow_map<Key, Value, Comparator, Allocator, Augment>::view() const {
+  static const map_type empty_tree;
+  return tree_ != nullptr ? *tree_ : empty_tree;
+}
+
+// Copies the key at pos, or nothing for end(), while pos is still valid.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::optional<Key> cow_map<Key, Value, Comparator, Allocator,
+                           Augment>::key_at(iterator pos) {
+  if (pos == tree_->end()) {
+    return std::nullopt;
+  }
+  return pos->first;
+}
+
+// The position of key, saved by key_at(), in this map's own tree.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename cow_map<Key, Value, Comparator, Allocator, Augment>::iterator
+cow_map<Key, Value, Comparator, Allocator, Augment>::find_again(
+    const std::optional<Key>& key) {
+  return key ? tree_->lower_bound(*key) : tree_->end();
+}
+
+}  // namespace s21
+
+#endif
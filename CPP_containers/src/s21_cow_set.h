@@ -0,0 +1,367 @@
+#ifndef S21_SRC_COW_SET_H
+#define S21_SRC_COW_SET_H
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "s21_set.h"
+
+namespace s21 {
+
+// set whose copies share one tree until either side is modified; see
+// cow_map for what counts as a modification.
+template <typename Key, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<Key>,
+          typename Augment = no_augment>
+class cow_set {
+  using set_type = set<Key, Comparator, Allocator, Augment>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename set_type::iterator;
+  using const_iterator = typename set_type::const_iterator;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  cow_set() = default;
+  cow_set(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  cow_set(InputIt first, InputIt last);
+  explicit cow_set(set_type items);
+  cow_set(const cow_set& s) = default;
+  cow_set(cow_set&& s) noexcept = default;
+  ~cow_set() = default;
+  cow_set& operator=(const cow_set& s) = default;
+  cow_set& operator=(cow_set&& s) noexcept = default;
+
+  iterator begin();
+  const_iterator begin() const;
+  iterator end();
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  allocator_type get_allocator() const;
+  // Whether another cow_set currently shares this tree.
+  bool shared() const;
+
+  void clear();
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(value_type&& value);
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  iterator erase(iterator pos);
+  iterator erase(iterator first, iterator last);
+  size_type erase(const Key& key);
+  void swap(cow_set& other) noexcept;
+  void merge(cow_set& other);
+
+  iterator find(const Key& key);
+  const_iterator find(const Key& key) const;
+  bool contains(const Key& key) const;
+  iterator lower_bound(const Key& key);
+  const_iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key);
+  const_iterator upper_bound(const Key& key) const;
+
+ private:
+  set_type& unshare();
+  const set_type& view() const;
+  std::optional<Key> key_at(iterator pos);
+  iterator find_again(const std::optional<Key>& key);
+
+  // Null until first written to, and again after being moved from.
+  std::shared_ptr<set_type> tree_;
+};
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+cow_set<Key, Comparator, Allocator, Augment>::cow_set(
+    std::initializer_list<value_type> const& items)
+    : tree_(std::make_shared<set_type>(items)) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename InputIt, typename>
+cow_set<Key, Comparator, Allocator, Augment>::cow_set(InputIt first,
+                                                      InputIt last)
+    : tree_(std::make_shared<set_type>(first, last)) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+cow_set<Key, Comparator, Allocator, Augment>::cow_set(set_type items)
+    : tree_(std::make_shared<set_type>(std::move(items))) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::iterator
+cow_set<Key, Comparator, Allocator, Augment>::begin() {
+  return unshare().begin();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::const_iterator
+cow_set<Key, Comparator, Allocator, Augment>::begin() const {
+  return view().begin();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::iterator
+cow_set<Key, Comparator, Allocator, Augment>::end() {
+  return unshare().end();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::const_iterator
+cow_set<Key, Comparator, Allocator, Augment>::end() const {
+  return view().end();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+bool cow_set<Key, Comparator, Allocator, Augment>::empty() const {
+  return view().empty();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::size_type
+cow_set<Key, Comparator, Allocator, Augment>::size() const {
+  return view().size();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::size_type
+cow_set<Key, Comparator, Allocator, Augment>::max_size() const {
+  return view().max_size();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::allocator_type
+cow_set<Key, Comparator, Allocator, Augment>::get_allocator() const {
+  return view().get_allocator();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+bool cow_set<Key, Comparator, Allocator, Augment>::shared() const {
+  return tree_ != nullptr && tree_.use_count() > 1;
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void cow_set<Key, Comparator, Allocator, Augment>::clear() {
+  if (shared()) {
+    tree_.reset();
+  } else if (tree_ != nullptr) {
+    tree_->clear();
+  }
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+std::pair<typename cow_set<Key, Comparator, Allocator, Augment>::iterator,
+          bool>
+cow_set<Key, Comparator, Allocator, Augment>::insert(
+    const value_type& value) {
+  return unshare().insert(value);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+std::pair<typename cow_set<Key, Comparator, Allocator, Augment>::iterator,
+          bool>
+cow_set<Key, Comparator, Allocator, Augment>::insert(value_type&& value) {
+  return unshare().insert(std::move(value));
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <class... Args>
+std::pair<typename cow_set<Key, Comparator, Allocator, Augment>::iterator,
+          bool>
+cow_set<Key, Comparator, Allocator, Augment>::emplace(Args&&... args) {
+  return unshare().emplace(std::forward<Args>(args)...);
+}
+
+// Same as cow_map::erase(): positions in a shared tree are found again by
+// key in the clone.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::iterator
+cow_set<Key, Comparator, Allocator, Augment>::erase(iterator pos) {
+  if (!shared()) {
+    return unshare().erase(pos);
+  }
+  std::optional<Key> key = key_at(pos);
+  unshare();
+  return tree_->erase(find_again(key));
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::iterator
+cow_set<Key, Comparator, Allocator, Augment>::erase(iterator first,
+                                                    iterator last) {
+  if (!shared()) {
+    return unshare().erase(first, last);
+  }
+  std::optional<Key> first_key = key_at(first);
+  std::optional<Key> last_key = key_at(last);
+  unshare();
+  return tree_->erase(find_again(first_key), find_again(last_key));
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::size_type
+cow_set<Key, Comparator, Allocator, Augment>::erase(const Key& key) {
+  if (!view().contains(key)) {
+    return 0;
+  }
+  return unshare().erase(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void cow_set<Key, Comparator, Allocator, Augment>::swap(
+    cow_set& other) noexcept {
+  tree_.swap(other.tree_);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void cow_set<Key, Comparator, Allocator, Augment>::merge(cow_set& other) {
+  if (other.empty() || this == &other) {
+    return;
+  }
+  unshare().merge(other.unshare());
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::iterator
+cow_set<Key, Comparator, Allocator, Augment>::find(const Key& key) {
+  return unshare().find(key);
+}
+
+// set has no const find; lower_bound lands on the key when it is there.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::const_iterator
+cow_set<Key, Comparator, Allocator, Augment>::find(const Key& key) const {
+  return view().contains(key) ? view().lower_bound(key) : view().end();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+bool cow_set<Key, Comparator, Allocator, Augment>::contains(
+    const Key& key) const {
+  return view().contains(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::iterator
+cow_set<Key, Comparator, Allocator, Augment>::lower_bound(const Key& key) {
+  return unshare().lower_bound(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::const_iterator
+cow_set<Key, Comparator, Allocator, Augment>::lower_bound(
+    const Key& key) const {
+  return view().lower_bound(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::iterator
+cow_set<Key, Comparator, Allocator, Augment>::upper_bound(const Key& key) {
+  return unshare().upper_bound(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::const_iterator
+cow_set<Key, Comparator, Allocator, Augment>::upper_bound(
+    const Key& key) const {
+  return view().upper_bound(key);
+}
+
+// Same ownership check as cow_map::unshare().
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::set_type&
+cow_set<Key, Comparator, Allocator, Augment>::unshare() {
+  if (tree_ == nullptr) {
+    tree_ = std::make_shared<set_type>();
+  } else if (tree_.use_count() > 1) {
+    tree_ = std::make_shared<set_type>(*tree_);
+  } else {
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+  return *tree_;
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+const typename cow_set<Key, Comparator, Allocator, Augment>::set_type&
+cow_set<Key, Comparator, Allocator, Augment>::view() const {
+  static const set_type empty_tree;
+  return tree_ != nullptr ? *tree_ : empty_tree;
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+std::optional<Key> cow_set<Key, Comparator, Allocator, Augment>::key_at(
+    iterator pos) {
+  if (pos == tree_->end()) {
+    return std::nullopt;
+  }
+  return *pos;
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+cow_set<Key, Comparator, Allocator, Augment>::iterator
+cow_set<Key, Comparator, Allocator, Augment>::find_again(
+    const std::optional<Key>& key) {
+  return key ? tree_->lower_bound(*key) : tree_->end();
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef S21_SRC_EPOCH_H
+#define S21_SRC_EPOCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace s21 {
+
+// Epoch-based reclamation for structures that readers walk without taking
+// locks. Every operation runs inside a guard, which pins the global epoch
+// it started in. Memory unlinked by a writer is retired instead of freed
+// and is only deleted once the epoch has advanced twice past the one it was
+// retired in: by then no pinned thread can still hold a pointer to it.
+//
+// The domain is process-wide. Each thread keeps its own record, reused by
+// later threads once it exits; whatever it retired and could not free yet
+// is handed to the domain and freed when that becomes safe.
+class epoch_domain {
+ public:
+  class guard {
+   public:
+    guard();
+    guard(const guard&) = delete;
+    guard& operator=(const guard&) = delete;
+    ~guard();
+  };
+
+  static epoch_domain& instance();
+
+  // Schedules object for deletion by deleter once no pinned thread can
+  // reach it.
+  void retire(void* object, void (*deleter)(void*));
+  template <typename T>
+  void retire(T* object);
+
+  epoch_domain(const epoch_domain&) = delete;
+  epoch_domain& operator=(const epoch_domain&) = delete;
+  ~epoch_domain();
+
+ private:
+  struct retired {
+    void* object;
+    void (*deleter)(void*);
+  };
+
+  struct bin {
+    std::uint64_t epoch = 0;
+    std::vector<retired> items;
+  };
+
+  // state holds the pinned epoch shifted left by one, with the low bit set
+  // while the owner is inside a guard.
+  struct alignas(64) record {
+    std::atomic<std::uint64_t> state{0};
+    std::atomic<bool> in_use{true};
+    record* next = nullptr;
+    unsigned depth = 0;
+    unsigned retired_since_advance = 0;
+    bin bins[3];
+  };
+
+  // Releases the thread's record when the thread exits.
+  struct thread_record {
+    record* owned = nullptr;
+    ~thread_record();
+  };
+
+  // Retiring this many objects makes a thread try to advance the epoch.
+  static constexpr unsigned advance_interval = 64;
+
+  epoch_domain() = default;
+
+  record& local();
+  record* acquire_record();
+  void pin(record& owner);
+  void unpin(record& owner);
+  bool try_advance();
+  void release(record& owner);
+  static void free_all(std::vector<retired>& items);
+
+  std::atomic<std::uint64_t> epoch_{1};
+  std::atomic<record*> records_{nullptr};
+  std::mutex orphans_mutex_;
+  std::vector<bin> orphans_;
+};
+
+inline epoch_domain& epoch_domain::instance() {
+  static epoch_domain domain;
+  return domain;
+}
+
+inline epoch_domain::guard::guard() {
+  epoch_domain& domain = instance();
+  domain.pin(domain.local());
+}
+
+inline epoch_domain::guard::~guard() {
+  epoch_domain& domain = instance();
+  domain.unpin(domain.local());
+}
+
+inline epoch_domain::~epoch_domain() {
+  for (bin& orphan : orphans_) {
+    free_all(orphan.items);
+  }
+  record* current = records_.load();
+  while (current != nullptr) {
+    record* next = current->next;
+    for (bin& owned : current->bins) {
+      free_all(owned.items);
+    }
+    delete current;
+    current = next;
+  }
+}
+
+inline epoch_domain::thread_record::~thread_record() {
+  if (owned != nullptr) {
+    instance().release(*owned);
+  }
+}
+
+inline epoch_domain::record& epoch_domain::local() {
+  thread_local thread_record current;
+  if (current.owned == nullptr) {
+    current.owned = acquire_record();
+  }
+  return *current.owned;
+}
+
+// Reuses the record of an exited thread when there is one, otherwise
+// pushes a new record onto the list. Records are never unlinked while the
+// domain lives, so the list can be walked without locks.
+inline epoch_domain::record* epoch_domain::acquire_record() {
+  for (record* current = records_.load(); current != nullptr;
+       current = current->next) {
+    bool expected = false;
+    if (current->in_use.compare_exchange_strong(expected, true)) {
+      return current;
+    }
+  }
+  record* created = new record;
+  record* head = records_.load();
+  do {
+    created->next = head;
+  } while (!records_.compare_exchange_weak(head, created));
+  return created;
+}
+
+// The epoch is read again after the state is published: a reclaimer that
+// advanced in between may not have seen this thread, so the pin only holds
+// once both agree. Both accesses are sequentially consistent, which keeps
+// the load from moving ahead of the store.
+inline void epoch_domain::pin(record& owner) {
+  if (owner.depth++ != 0) {
+    return;
+  }
+  std::uint64_t current = epoch_.load();
+  while (true) {
+    owner.state.store(current << 1 | 1);
+    std::uint64_t confirmed = epoch_.load();
+    if (confirmed == current) {
+      return;
+    }
+    current = confirmed;
+  }
+}
+
+inline void epoch_domain::unpin(record& owner) {
+  if (--owner.depth == 0) {
+    owner.state.store(owner.state.load(std::memory_order_relaxed) & ~1ULL,
+                      std::memory_order_release);
+  }
+}
+
+// Moves the epoch forward when every pinned thread has observed the current
+// one. Orphaned objects retired two epochs ago are freed on the way.
+inline bool epoch_domain::try_advance() {
+  std::uint64_t current = epoch_.load();
+  for (record* owner = records_.load(); owner != nullptr;
+       owner = owner->next) {
+    std::uint64_t state = owner->state.load();
+    if ((state & 1) != 0 && (state >> 1) != current) {
+      return false;
+    }
+  }
+  if (!epoch_.compare_exchange_strong(current, current + 1)) {
+    return false;
+  }
+  std::unique_lock<std::mutex> lock(orphans_mutex_, std::try_to_lock);
+  if (lock.owns_lock()) {
+    for (auto orphan = orphans_.begin(); orphan != orphans_.end();) {
+      if (orphan->epoch + 2 <= current + 1) {
+        free_all(orphan->items);
+        orphan = orphans_.erase(orphan);
+      } else {
+        ++orphan;
+      }
+    }
+  }
+  return true;
+}
+
+// Objects go to the bin of the epoch they are retired in. A bin still
+// holding objects from an older epoch with the same residue is at least
+// three epochs behind, so those are freed before it is reused.
+inline void epoch_domain::retire(void* object, void (*deleter)(void*)) {
+  if (object == nullptr) {
+    return;
+  }
+  record& owner = local();
+  std::uint64_t current = epoch_.load();
+  bin& target = owner.bins[current % 3];
+  if (target.epoch != current) {
+    free_all(target.items);
+    target.epoch = current;
+  }
+  target.items.push_back({object, deleter});
+  if (++owner.retired_since_advance >= advance_interval) {
+    owner.retired_since_advance = 0;
+    try_advance();
+  }
+}
+
+template <typename T>
+void epoch_domain::retire(T* object) {
+  retire(object, [](void* pointer) { delete static_cast<T*>(pointer); });
+}
+
+inline void epoch_domain::release(record& owner) {
+  {
+    std::lock_guard<std::mutex> lock(orphans_mutex_);
+    for (bin& owned : owner.bins) {
+      if (!owned.items.empty()) {
+        orphans_.push_back(std::move(owned));
+        owned = bin();
+      }
+    }
+  }
+  owner.state.store(0);
+  owner.depth = 0;
+  owner.in_use.store(false);
+}
+
+inline void epoch_domain::free_all(std::vector<retired>& items) {
+  for (const retired& item : items) {
+    item.deleter(item.object);
+  }
+  items.clear();
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,700 @@
+#ifndef S21_SRC_FLAT_MAP_H
+#define S21_SRC_FLAT_MAP_H
+
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "SortedArray.h"
+
+namespace s21 {
+
+// Drop-in for map on two parallel s21::vectors, one of keys and one of
+// values. The binary search only walks the key column, so several keys
+// share each cache line it touches no matter how large Value is. Iterators
+// dereference to a pair of references into the two columns rather than to
+// a stored std::pair, and like flat_set's they are invalidated by any
+// insert or erase.
+template <typename Key, typename Value, typename Comparator = std::less<Key>>
+class flat_map : private SortedArray<Key, Comparator> {
+  using tree_type = SortedArray<Key, Comparator>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = std::pair<const Key&, Value&>;
+  using const_reference = std::pair<const Key&, const Value&>;
+  using size_type = size_t;
+
+  class iterator {
+   public:
+    friend flat_map;
+    using difference_type = std::ptrdiff_t;
+
+    // operator-> has no stored pair to point at, so it hands out one.
+    struct pointer {
+      reference* operator->() { return &item; }
+      reference item;
+    };
+
+    iterator() = default;
+    iterator(const Key* key, Value* value);
+
+    reference operator*() const;
+    pointer operator->() const;
+    iterator& operator++();
+    iterator operator++(int);
+    iterator& operator--();
+    iterator operator--(int);
+    difference_type operator-(const iterator& other) const;
+
+    bool operator==(const iterator& other) const;
+    bool operator!=(const iterator& other) const;
+
+   protected:
+    const Key* key_ = nullptr;
+    Value* value_ = nullptr;
+  };
+
+  class const_iterator {
+   public:
+    friend flat_map;
+    using difference_type = std::ptrdiff_t;
+
+    struct pointer {
+      const_reference* operator->() { return &item; }
+      const_reference item;
+    };
+
+    const_iterator() = default;
+    const_iterator(const Key* key, const Value* value);
+    const_iterator(const iterator& other);
+
+    const_reference operator*() const;
+    pointer operator->() const;
+    const_iterator& operator++();
+    const_iterator operator++(int);
+    const_iterator& operator--();
+    const_iterator operator--(int);
+    difference_type operator-(const const_iterator& other) const;
+
+    bool operator==(const const_iterator& other) const;
+    bool operator!=(const const_iterator& other) const;
+
+   protected:
+    const Key* key_ = nullptr;
+    const Value* value_ = nullptr;
+  };
+
+  flat_map();
+  flat_map(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  flat_map(InputIt first, InputIt last);
+  flat_map(const flat_map& m);
+  flat_map(flat_map&& m) noexcept;
+  ~flat_map() = default;
+  flat_map& operator=(const flat_map& m);
+  flat_map& operator=(flat_map&& m) noexcept;
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
+
+  Value& at(const Key& key);
+  const Value& at(const Key& key) const;
+  Value& operator[](const Key& key);
+
+  iterator begin();
+  const_iterator begin() const;
+  iterator end();
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  void reserve(size_type count);
+
+  void clear();
+  std::pair<iterator, bool> insert(const Key& key, const Value& obj);
+  std::pair<iterator, bool> insert(const value_type& value);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  void insert(InputIt first, InputIt last);
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args);
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const Value& obj);
+  iterator erase(iterator pos);
+  iterator erase(iterator first, iterator last);
+  size_type erase(const Key& key);
+  void swap(flat_map& other) noexcept;
+  void merge(flat_map& other);
+
+  iterator find(const Key& key);
+  const_iterator find(const Key& key) const;
+  bool contains(const Key& key) const;
+  iterator nth(size_type index);
+  const_iterator nth(size_type index) const;
+  size_type rank(const Key& key) const;
+  iterator lower_bound(const Key& key);
+  const_iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key);
+  const_iterator upper_bound(const Key& key) const;
+
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+
+ private:
+  using staged_type = std::pair<Key, Value>;
+
+  iterator iterator_at(size_type index);
+  const_iterator iterator_at(size_type index) const;
+  size_type index_of(const_iterator pos) const;
+  std::pair<iterator, bool> insert_at(size_type index, const Key& key,
+                                      const Value& obj);
+  void erase_at(size_type first, size_type last);
+  void insert_staged(std::vector<staged_type>& batch, bool sorted);
+
+  // values_[i] belongs to keys_[i]; every modifier updates both columns.
+  vector<Value> values_;
+};
+
+template <typename Key, typename Value, typename Comparator>
+flat_map<Key, Value, Comparator>::iterator::iterator(const Key* key,
+                                                     Value* value)
+    : key_(key), value_(value) {}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::reference
+flat_map<Key, Value, Comparator>::iterator::operator*() const {
+  return {*key_, *value_};
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator::pointer
+flat_map<Key, Value, Comparator>::iterator::operator->() const {
+  return {**this};
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator&
+flat_map<Key, Value, Comparator>::iterator::operator++() {
+  ++key_;
+  ++value_;
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator
+flat_map<Key, Value, Comparator>::iterator::operator++(int) {
+  iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator&
+flat_map<Key, Value, Comparator>::iterator::operator--() {
+  --key_;
+  --value_;
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator
+flat_map<Key, Value, Comparator>::iterator::operator--(int) {
+  iterator previous = *this;
+  --*this;
+  return previous;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator::difference_type
+flat_map<Key, Value, Comparator>::iterator::operator-(
+    const iterator& other) const {
+  return key_ - other.key_;
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool flat_map<Key, Value, Comparator>::iterator::operator==(
+    const iterator& other) const {
+  return key_ == other.key_;
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool flat_map<Key, Value, Comparator>::iterator::operator!=(
+    const iterator& other) const {
+  return key_ != other.key_;
+}
+
+template <typename Key, typename Value, typename Comparator>
+flat_map<Key, Value, Comparator>::const_iterator::const_iterator(
+    const Key* key, const Value* value)
+    : key_(key), value_(value) {}
+
+template <typename Key, typename Value, typename Comparator>
+flat_map<Key, Value, Comparator>::const_iterator::const_iterator(
+    const iterator& other)
+    : key_(other.key_), value_(other.value_) {}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_reference
+flat_map<Key, Value, Comparator>::const_iterator::operator*() const {
+  return {*key_, *value_};
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator::pointer
+flat_map<Key, Value, Comparator>::const_iterator::operator->() const {
+  return {**this};
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator&
+flat_map<Key, Value, Comparator>::const_iterator::operator++() {
+  ++key_;
+  ++value_;
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator
+flat_map<Key, Value, Comparator>::const_iterator::operator++(int) {
+  const_iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator&
+flat_map<Key, Value, Comparator>::const_iterator::operator--() {
+  --key_;
+  --value_;
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator
+flat_map<Key, Value, Comparator>::const_iterator::operator--(int) {
+  const_iterator previous = *this;
+  --*this;
+  return previous;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator::difference_type
+flat_map<Key, Value, Comparator>::const_iterator::operator-(
+    const const_iterator& other) const {
+  return key_ - other.key_;
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool flat_map<Key, Value, Comparator>::const_iterator::operator==(
+    const const_iterator& other) const {
+  return key_ == other.key_;
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool flat_map<Key, Value, Comparator>::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return key_ != other.key_;
+}
+
+template <typename Key, typename Value, typename Comparator>
+flat_map<Key, Value, Comparator>::flat_map() : tree_type() {}
+
+template <typename Key, typename Value, typename Comparator>
+flat_map<Key, Value, Comparator>::flat_map(
+    std::initializer_list<value_type> const& items)
+    : flat_map() {
+  assign(items.begin(), items.end());
+}
+
+template <typename Key, typename Value, typename Comparator>
+template <typename InputIt, typename>
+flat_map<Key, Value, Comparator>::flat_map(InputIt first, InputIt last)
+    : flat_map() {
+  assign(first, last);
+}
+
+template <typename Key, typename Value, typename Comparator>
+flat_map<Key, Value, Comparator>::flat_map(const flat_map& m)
+    : tree_type(m), values_(m.values_) {}
+
+template <typename Key, typename Value, typename Comparator>
+flat_map<Key, Value, Comparator>::flat_map(flat_map&& m) noexcept
+    : tree_type(std::move(m)), values_(std::move(m.values_)) {}
+
+template <typename Key, typename Value, typename Comparator>
+flat_map<Key, Value, Comparator>& flat_map<Key, Value, Comparator>::operator=(
+    const flat_map& m) {
+  if (this != &m) {
+    flat_map copy(m);
+    swap(copy);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+flat_map<Key, Value, Comparator>& flat_map<Key, Value, Comparator>::operator=(
+    flat_map&& m) noexcept {
+  if (this != &m) {
+    clear();
+    swap(m);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+template <typename InputIt>
+void flat_map<Key, Value, Comparator>::assign(InputIt first, InputIt last) {
+  clear();
+  insert(first, last);
+}
+
+template <typename Key, typename Value, typename Comparator>
+Value& flat_map<Key, Value, Comparator>::at(const Key& key) {
+  size_type index = tree_type::lower_index(key);
+  if (!tree_type::holds(index, key)) {
+    throw std::out_of_range("There is no element with this key");
+  }
+  return values_[index];
+}
+
+template <typename Key, typename Value, typename Comparator>
+const Value& flat_map<Key, Value, Comparator>::at(const Key& key) const {
+  size_type index = tree_type::lower_index(key);
+  if (!tree_type::holds(index, key)) {
+    throw std::out_of_range("There is no element with this key");
+  }
+  return values_[index];
+}
+
+template <typename Key, typename Value, typename Comparator>
+Value& flat_map<Key, Value, Comparator>::operator[](const Key& key) {
+  return try_emplace(key).first.value_[0];
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator
+flat_map<Key, Value, Comparator>::begin() {
+  return iterator_at(0);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator
+flat_map<Key, Value, Comparator>::begin() const {
+  return iterator_at(0);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator
+flat_map<Key, Value, Comparator>::end() {
+  return iterator_at(size());
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator
+flat_map<Key, Value, Comparator>::end() const {
+  return iterator_at(size());
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool flat_map<Key, Value, Comparator>::empty() const {
+  return tree_type::tree_empty();
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::size_type
+flat_map<Key, Value, Comparator>::size() const {
+  return tree_type::tree_size();
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::size_type
+flat_map<Key, Value, Comparator>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Value, typename Comparator>
+void flat_map<Key, Value, Comparator>::reserve(size_type count) {
+  tree_type::tree_reserve(count);
+  values_.reserve(count);
+}
+
+template <typename Key, typename Value, typename Comparator>
+void flat_map<Key, Value, Comparator>::clear() {
+  tree_type::keys_.clear();
+  values_.clear();
+}
+
+template <typename Key, typename Value, typename Comparator>
+std::pair<typename flat_map<Key, Value, Comparator>::iterator, bool>
+flat_map<Key, Value, Comparator>::insert(const Key& key, const Value& obj) {
+  size_type index = tree_type::lower_index(key);
+  if (tree_type::holds(index, key)) {
+    return {iterator_at(index), false};
+  }
+  return insert_at(index, key, obj);
+}
+
+template <typename Key, typename Value, typename Comparator>
+std::pair<typename flat_map<Key, Value, Comparator>::iterator, bool>
+flat_map<Key, Value, Comparator>::insert(const value_type& value) {
+  return insert(value.first, value.second);
+}
+
+template <typename Key, typename Value, typename Comparator>
+template <typename InputIt, typename>
+void flat_map<Key, Value, Comparator>::insert(InputIt first, InputIt last) {
+  std::vector<staged_type> batch;
+  for (; first != last; ++first) {
+    batch.emplace_back(first->first, first->second);
+  }
+  insert_staged(batch, false);
+}
+
+template <typename Key, typename Value, typename Comparator>
+template <class... Args>
+std::pair<typename flat_map<Key, Value, Comparator>::iterator, bool>
+flat_map<Key, Value, Comparator>::emplace(Args&&... args) {
+  value_type value(std::forward<Args>(args)...);
+  return insert(value.first, value.second);
+}
+
+template <typename Key, typename Value, typename Comparator>
+template <class... Args>
+std::pair<typename flat_map<Key, Value, Comparator>::iterator, bool>
+flat_map<Key, Value, Comparator>::try_emplace(const Key& key,
+                                              Args&&... args) {
+  size_type index = tree_type::lower_index(key);
+  if (tree_type::holds(index, key)) {
+    return {iterator_at(index), false};
+  }
+  return insert_at(index, key, Value(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Value, typename Comparator>
+std::pair<typename flat_map<Key, Value, Comparator>::iterator, bool>
+flat_map<Key, Value, Comparator>::insert_or_assign(const Key& key,
+                                                   const Value& obj) {
+  size_type index = tree_type::lower_index(key);
+  if (tree_type::holds(index, key)) {
+    values_[index] = obj;
+    return {iterator_at(index), false};
+  }
+  return insert_at(index, key, obj);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator
+flat_map<Key, Value, Comparator>::erase(iterator pos) {
+  size_type index = index_of(pos);
+  erase_at(index, index + 1);
+  return iterator_at(index);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator
+flat_map<Key, Value, Comparator>::erase(iterator first, iterator last) {
+  size_type index = index_of(first);
+  erase_at(index, index_of(last));
+  return iterator_at(index);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::size_type
+flat_map<Key, Value, Comparator>::erase(const Key& key) {
+  size_type index = tree_type::lower_index(key);
+  if (!tree_type::holds(index, key)) {
+    return 0;
+  }
+  erase_at(index, index + 1);
+  return 1;
+}
+
+template <typename Key, typename Value, typename Comparator>
+void flat_map<Key, Value, Comparator>::swap(flat_map& other) noexcept {
+  tree_type::tree_swap(other);
+  values_.swap(other.values_);
+}
+
+// Pairs whose key is already here stay in other, as in map::merge.
+template <typename Key, typename Value, typename Comparator>
+void flat_map<Key, Value, Comparator>::merge(flat_map& other) {
+  if (this == &other || other.empty()) {
+    return;
+  }
+  std::vector<staged_type> moved;
+  flat_map kept;
+  for (size_type index = 0; index < other.size(); ++index) {
+    const Key& key = other.tree_type::keys_[index];
+    if (contains(key)) {
+      kept.tree_type::keys_.push_back(key);
+      kept.values_.push_back(other.values_[index]);
+    } else {
+      moved.emplace_back(key, other.values_[index]);
+    }
+  }
+  insert_staged(moved, true);
+  other.swap(kept);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator
+flat_map<Key, Value, Comparator>::find(const Key& key) {
+  size_type index = tree_type::lower_index(key);
+  return tree_type::holds(index, key) ? iterator_at(index) : end();
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator
+flat_map<Key, Value, Comparator>::find(const Key& key) const {
+  size_type index = tree_type::lower_index(key);
+  return tree_type::holds(index, key) ? iterator_at(index) : end();
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool flat_map<Key, Value, Comparator>::contains(const Key& key) const {
+  return tree_type::holds(tree_type::lower_index(key), key);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator
+flat_map<Key, Value, Comparator>::nth(size_type index) {
+  return iterator_at(index);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator
+flat_map<Key, Value, Comparator>::nth(size_type index) const {
+  return iterator_at(index);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::size_type
+flat_map<Key, Value, Comparator>::rank(const Key& key) const {
+  return tree_type::lower_index(key);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator
+flat_map<Key, Value, Comparator>::lower_bound(const Key& key) {
+  return iterator_at(tree_type::lower_index(key));
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator
+flat_map<Key, Value, Comparator>::lower_bound(const Key& key) const {
+  return iterator_at(tree_type::lower_index(key));
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator
+flat_map<Key, Value, Comparator>::upper_bound(const Key& key) {
+  return iterator_at(tree_type::upper_index(key));
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator
+flat_map<Key, Value, Comparator>::upper_bound(const Key& key) const {
+  return iterator_at(tree_type::upper_index(key));
+}
+
+// Every insert may move the columns, so iterators are looked up again once
+// all values are in.
+template <typename Key, typename Value, typename Comparator>
+template <class... Args>
+std::vector<std::pair<typename flat_map<Key, Value, Comparator>::iterator,
+                      bool>>
+flat_map<Key, Value, Comparator>::insert_many(Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  std::vector<Key> keys;
+  result.reserve(sizeof...(args));
+  keys.reserve(sizeof...(args));
+  (keys.emplace_back(value_type(args).first), ...);
+  (result.push_back(emplace(std::forward<Args>(args))), ...);
+  for (size_type index = 0; index < keys.size(); ++index) {
+    result[index].first = find(keys[index]);
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::iterator
+flat_map<Key, Value, Comparator>::iterator_at(size_type index) {
+  return iterator(tree_type::keys_.data() + index, values_.data() + index);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::const_iterator
+flat_map<Key, Value, Comparator>::iterator_at(size_type index) const {
+  return const_iterator(tree_type::keys_.data() + index,
+                        values_.data() + index);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename flat_map<Key, Value, Comparator>::size_type
+flat_map<Key, Value, Comparator>::index_of(const_iterator pos) const {
+  return static_cast<size_type>(pos.key_ - tree_type::keys_.data());
+}
+
+// Takes the key back out if the value column cannot grow, so the two
+// columns never differ in length.
+template <typename Key, typename Value, typename Comparator>
+std::pair<typename flat_map<Key, Value, Comparator>::iterator, bool>
+flat_map<Key, Value, Comparator>::insert_at(size_type index, const Key& key,
+                                            const Value& obj) {
+  tree_type::insert_at(tree_type::keys_, index, key);
+  try {
+    tree_type::insert_at(values_, index, obj);
+  } catch (...) {
+    tree_type::erase_at(tree_type::keys_, index, index + 1);
+    throw;
+  }
+  return {iterator_at(index), true};
+}
+
+template <typename Key, typename Value, typename Comparator>
+void flat_map<Key, Value, Comparator>::erase_at(size_type first,
+                                                size_type last) {
+  tree_type::erase_at(tree_type::keys_, first, last);
+  tree_type::erase_at(values_, first, last);
+}
+
+// Builds both columns in one merge pass, then swaps them in together.
+// A batch already sorted and free of stored keys skips the sort.
+template <typename Key, typename Value, typename Comparator>
+void flat_map<Key, Value, Comparator>::insert_staged(
+    std::vector<staged_type>& batch, bool sorted) {
+  if (batch.empty()) {
+    return;
+  }
+  auto key_of = [](const staged_type& item) -> const Key& {
+    return item.first;
+  };
+  if (!sorted) {
+    tree_type::sort_batch(batch, true, key_of);
+  }
+  vector<Key> keys;
+  vector<Value> values;
+  keys.reserve(size() + batch.size());
+  values.reserve(size() + batch.size());
+  tree_type::merge_batch(batch, !sorted, key_of,
+                         [&](bool existing, size_type index) {
+                           if (existing) {
+                             keys.push_back(tree_type::keys_[index]);
+                             values.push_back(values_[index]);
+                           } else {
+                             keys.push_back(batch[index].first);
+                             values.push_back(batch[index].second);
+                           }
+                         });
+  tree_type::keys_.swap(keys);
+  values_.swap(values);
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,278 @@
+#ifndef S21_SRC_FLAT_MULTISET_H
+#define S21_SRC_FLAT_MULTISET_H
+
+#include <type_traits>
+#include <vector>
+
+#include "SortedArray.h"
+
+namespace s21 {
+
+// multiset counterpart of flat_set. Equal keys are stored next to each
+// other in insertion order, so count and equal_range are two binary
+// searches.
+template <typename Key, typename Comparator = std::less<Key>>
+class flat_multiset : private SortedArray<Key, Comparator> {
+  using tree_type = SortedArray<Key, Comparator>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename tree_type::const_iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = size_t;
+
+  flat_multiset();
+  flat_multiset(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  flat_multiset(InputIt first, InputIt last);
+  flat_multiset(const flat_multiset& s);
+  flat_multiset(flat_multiset&& s) noexcept;
+  ~flat_multiset() = default;
+  flat_multiset& operator=(const flat_multiset& s);
+  flat_multiset& operator=(flat_multiset&& s) noexcept;
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  void reserve(size_type count);
+
+  void clear();
+  iterator insert(const value_type& value);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  void insert(InputIt first, InputIt last);
+  template <class... Args>
+  iterator emplace(Args&&... args);
+  iterator erase(iterator pos);
+  iterator erase(iterator first, iterator last);
+  size_type erase(const Key& key);
+  void swap(flat_multiset& other) noexcept;
+  void merge(flat_multiset& other);
+
+  size_type count(const Key& key) const;
+  iterator find(const Key& key) const;
+  bool contains(const Key& key) const;
+  iterator nth(size_type index) const;
+  size_type rank(const Key& key) const;
+  iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key) const;
+  std::pair<iterator, iterator> equal_range(const Key& key) const;
+
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+};
+
+template <typename Key, typename Comparator>
+flat_multiset<Key, Comparator>::flat_multiset() : tree_type() {}
+
+template <typename Key, typename Comparator>
+flat_multiset<Key, Comparator>::flat_multiset(
+    std::initializer_list<value_type> const& items)
+    : flat_multiset() {
+  assign(items.begin(), items.end());
+}
+
+template <typename Key, typename Comparator>
+template <typename InputIt, typename>
+flat_multiset<Key, Comparator>::flat_multiset(InputIt first, InputIt last)
+    : flat_multiset() {
+  assign(first, last);
+}
+
+template <typename Key, typename Comparator>
+flat_multiset<Key, Comparator>::flat_multiset(const flat_multiset& s)
+    : tree_type(s) {}
+
+template <typename Key, typename Comparator>
+flat_multiset<Key, Comparator>::flat_multiset(flat_multiset&& s) noexcept
+    : tree_type(std::move(s)) {}
+
+template <typename Key, typename Comparator>
+flat_multiset<Key, Comparator>& flat_multiset<Key, Comparator>::operator=(
+    const flat_multiset& s) {
+  tree_type::operator=(s);
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+flat_multiset<Key, Comparator>& flat_multiset<Key, Comparator>::operator=(
+    flat_multiset&& s) noexcept {
+  tree_type::operator=(std::move(s));
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+template <typename InputIt>
+void flat_multiset<Key, Comparator>::assign(InputIt first, InputIt last) {
+  clear();
+  tree_type::tree_insert_range(first, last, false);
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::const_iterator
+flat_multiset<Key, Comparator>::begin() const {
+  return tree_type::tree_begin();
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::const_iterator
+flat_multiset<Key, Comparator>::end() const {
+  return tree_type::tree_end();
+}
+
+template <typename Key, typename Comparator>
+bool flat_multiset<Key, Comparator>::empty() const {
+  return tree_type::tree_empty();
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::size_type
+flat_multiset<Key, Comparator>::size() const {
+  return tree_type::tree_size();
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::size_type
+flat_multiset<Key, Comparator>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Comparator>
+void flat_multiset<Key, Comparator>::reserve(size_type count) {
+  tree_type::tree_reserve(count);
+}
+
+template <typename Key, typename Comparator>
+void flat_multiset<Key, Comparator>::clear() {
+  tree_type::keys_.clear();
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::iterator
+flat_multiset<Key, Comparator>::insert(const value_type& value) {
+  return tree_type::tree_insert(value, false).first;
+}
+
+template <typename Key, typename Comparator>
+template <typename InputIt, typename>
+void flat_multiset<Key, Comparator>::insert(InputIt first, InputIt last) {
+  tree_type::tree_insert_range(first, last, false);
+}
+
+template <typename Key, typename Comparator>
+template <class... Args>
+typename flat_multiset<Key, Comparator>::iterator
+flat_multiset<Key, Comparator>::emplace(Args&&... args) {
+  return insert(value_type(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::iterator
+flat_multiset<Key, Comparator>::erase(iterator pos) {
+  size_type index = tree_type::index_of(pos);
+  tree_type::tree_erase(index, index + 1);
+  return tree_type::iterator_at(index);
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::iterator
+flat_multiset<Key, Comparator>::erase(iterator first, iterator last) {
+  size_type index = tree_type::index_of(first);
+  tree_type::tree_erase(index, tree_type::index_of(last));
+  return tree_type::iterator_at(index);
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::size_type
+flat_multiset<Key, Comparator>::erase(const Key& key) {
+  return tree_type::tree_erase_key(key);
+}
+
+template <typename Key, typename Comparator>
+void flat_multiset<Key, Comparator>::swap(flat_multiset& other) noexcept {
+  tree_type::tree_swap(other);
+}
+
+template <typename Key, typename Comparator>
+void flat_multiset<Key, Comparator>::merge(flat_multiset& other) {
+  tree_type::tree_merge(other, false);
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::size_type
+flat_multiset<Key, Comparator>::count(const Key& key) const {
+  return tree_type::tree_count(key);
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::iterator
+flat_multiset<Key, Comparator>::find(const Key& key) const {
+  return tree_type::tree_find(key);
+}
+
+template <typename Key, typename Comparator>
+bool flat_multiset<Key, Comparator>::contains(const Key& key) const {
+  return tree_type::holds(tree_type::lower_index(key), key);
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::iterator
+flat_multiset<Key, Comparator>::nth(size_type index) const {
+  return tree_type::iterator_at(index);
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::size_type
+flat_multiset<Key, Comparator>::rank(const Key& key) const {
+  return tree_type::lower_index(key);
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::iterator
+flat_multiset<Key, Comparator>::lower_bound(const Key& key) const {
+  return tree_type::iterator_at(tree_type::lower_index(key));
+}
+
+template <typename Key, typename Comparator>
+typename flat_multiset<Key, Comparator>::iterator
+flat_multiset<Key, Comparator>::upper_bound(const Key& key) const {
+  return tree_type::iterator_at(tree_type::upper_index(key));
+}
+
+template <typename Key, typename Comparator>
+std::pair<typename flat_multiset<Key, Comparator>::iterator,
+          typename flat_multiset<Key, Comparator>::iterator>
+flat_multiset<Key, Comparator>::equal_range(const Key& key) const {
+  return {lower_bound(key), upper_bound(key)};
+}
+
+// Every insert may move the array, so iterators are looked up again once
+// all values are in; repeated keys all report the first of their run.
+template <typename Key, typename Comparator>
+template <class... Args>
+std::vector<std::pair<typename flat_multiset<Key, Comparator>::iterator, bool>>
+flat_multiset<Key, Comparator>::insert_many(Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  std::vector<Key> keys;
+  result.reserve(sizeof...(args));
+  keys.reserve(sizeof...(args));
+  (keys.emplace_back(args), ...);
+  (result.push_back({insert(std::forward<Args>(args)), true}), ...);
+  for (size_type index = 0; index < keys.size(); ++index) {
+    result[index].first = find(keys[index]);
+  }
+  return result;
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,279 @@
+#ifndef S21_SRC_FROZEN_MAP_H
+#define S21_SRC_FROZEN_MAP_H
+
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "EytzingerArray.h"
+
+namespace s21 {
+
+// Immutable map for data built once and then only read, usually made with
+// map::freeze(). Keys and values are two parallel arrays in Eytzinger
+// order: a lookup descends the key column alone, branch-free and with
+// prefetching, and touches the value column once at the end. Iteration is
+// in key order, and like flat_map's the iterators dereference to a pair of
+// references into the two columns.
+template <typename Key, typename Value, typename Comparator = std::less<Key>>
+class frozen_map : private EytzingerArray<Key, Comparator> {
+  using tree_type = EytzingerArray<Key, Comparator>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = std::pair<const Key&, const Value&>;
+  using const_reference = std::pair<const Key&, const Value&>;
+  using size_type = size_t;
+
+  class const_iterator {
+   public:
+    friend frozen_map;
+
+    // operator-> has no stored pair to point at, so it hands out one.
+    struct pointer {
+      const_reference* operator->() { return &item; }
+      const_reference item;
+    };
+
+    const_iterator() = default;
+    const_iterator(const frozen_map* owner, size_type slot);
+
+    const_reference operator*() const;
+    pointer operator->() const;
+    const_iterator& operator++();
+    const_iterator operator++(int);
+    const_iterator& operator--();
+    const_iterator operator--(int);
+
+    bool operator==(const const_iterator& other) const;
+    bool operator!=(const const_iterator& other) const;
+
+   private:
+    const frozen_map* owner_ = nullptr;
+    size_type slot_ = 0;
+  };
+  using iterator = const_iterator;
+
+  frozen_map();
+  // [first, last) must already be sorted by Comparator without duplicate
+  // keys, as the contents of a map are.
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  frozen_map(InputIt first, InputIt last);
+  frozen_map(const frozen_map& m);
+  frozen_map(frozen_map&& m) noexcept;
+  ~frozen_map() = default;
+  frozen_map& operator=(const frozen_map& m);
+  frozen_map& operator=(frozen_map&& m) noexcept;
+
+  const Value& at(const Key& key) const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  void swap(frozen_map& other) noexcept;
+
+  const_iterator find(const Key& key) const;
+  bool contains(const Key& key) const;
+  size_type count(const Key& key) const;
+  const_iterator lower_bound(const Key& key) const;
+  const_iterator upper_bound(const Key& key) const;
+
+ private:
+  // values_[k - 1] belongs to the key in slot k.
+  vector<Value> values_;
+};
+
+template <typename Key, typename Value, typename Comparator>
+frozen_map<Key, Value, Comparator>::const_iterator::const_iterator(
+    const frozen_map* owner, size_type slot)
+    : owner_(owner), slot_(slot) {}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::const_reference
+frozen_map<Key, Value, Comparator>::const_iterator::operator*() const {
+  return {owner_->keys_.data()[slot_ - 1], owner_->values_.data()[slot_ - 1]};
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::const_iterator::pointer
+frozen_map<Key, Value, Comparator>::const_iterator::operator->() const {
+  return {**this};
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::const_iterator&
+frozen_map<Key, Value, Comparator>::const_iterator::operator++() {
+  slot_ = tree_type::next_slot(slot_, owner_->size());
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::const_iterator
+frozen_map<Key, Value, Comparator>::const_iterator::operator++(int) {
+  const_iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::const_iterator&
+frozen_map<Key, Value, Comparator>::const_iterator::operator--() {
+  slot_ = tree_type::prev_slot(slot_, owner_->size());
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::const_iterator
+frozen_map<Key, Value, Comparator>::const_iterator::operator--(int) {
+  const_iterator previous = *this;
+  --*this;
+  return previous;
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool frozen_map<Key, Value, Comparator>::const_iterator::operator==(
+    const const_iterator& other) const {
+  return slot_ == other.slot_;
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool frozen_map<Key, Value, Comparator>::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return slot_ != other.slot_;
+}
+
+template <typename Key, typename Value, typename Comparator>
+frozen_map<Key, Value, Comparator>::frozen_map() : tree_type() {}
+
+template <typename Key, typename Value, typename Comparator>
+template <typename InputIt, typename>
+frozen_map<Key, Value, Comparator>::frozen_map(InputIt first,
+                                               InputIt last)
+    : frozen_map() {
+  std::vector<Key> sorted_keys;
+  std::vector<Value> sorted_values;
+  for (; first != last; ++first) {
+    const auto& element = *first;
+    sorted_keys.push_back(element.first);
+    sorted_values.push_back(element.second);
+  }
+  tree_type::keys_.reserve(sorted_keys.size());
+  values_.reserve(sorted_keys.size());
+  tree_type::for_each_rank(sorted_keys.size(), [&](size_type rank) {
+    tree_type::keys_.push_back(sorted_keys[rank]);
+    values_.push_back(sorted_values[rank]);
+  });
+}
+
+template <typename Key, typename Value, typename Comparator>
+frozen_map<Key, Value, Comparator>::frozen_map(const frozen_map& m)
+    : tree_type(m), values_(m.values_) {}
+
+template <typename Key, typename Value, typename Comparator>
+frozen_map<Key, Value, Comparator>::frozen_map(frozen_map&& m) noexcept
+    : tree_type(std::move(m)), values_(std::move(m.values_)) {}
+
+template <typename Key, typename Value, typename Comparator>
+frozen_map<Key, Value, Comparator>&
+frozen_map<Key, Value, Comparator>::operator=(const frozen_map& m) {
+  if (this != &m) {
+    frozen_map copy(m);
+    swap(copy);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+frozen_map<Key, Value, Comparator>&
+frozen_map<Key, Value, Comparator>::operator=(frozen_map&& m) noexcept {
+  if (this != &m) {
+    tree_type::operator=(std::move(m));
+    values_.clear();
+    values_.swap(m.values_);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+const Value& frozen_map<Key, Value, Comparator>::at(const Key& key) const {
+  size_type slot = tree_type::lower_slot(key);
+  if (!tree_type::holds(slot, key)) {
+    throw std::out_of_range("There is no element with this key");
+  }
+  return values_[slot - 1];
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::const_iterator
+frozen_map<Key, Value, Comparator>::begin() const {
+  return const_iterator(this, tree_type::first_slot(size()));
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::const_iterator
+frozen_map<Key, Value, Comparator>::end() const {
+  return const_iterator(this, 0);
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool frozen_map<Key, Value, Comparator>::empty() const {
+  return tree_type::tree_empty();
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::size_type
+frozen_map<Key, Value, Comparator>::size() const {
+  return tree_type::tree_size();
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::size_type
+frozen_map<Key, Value, Comparator>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Value, typename Comparator>
+void frozen_map<Key, Value, Comparator>::swap(frozen_map& other) noexcept {
+  tree_type::tree_swap(other);
+  values_.swap(other.values_);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::const_iterator
+frozen_map<Key, Value, Comparator>::find(const Key& key) const {
+  size_type slot = tree_type::lower_slot(key);
+  return const_iterator(this, tree_type::holds(slot, key) ? slot : 0);
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool frozen_map<Key, Value, Comparator>::contains(const Key& key) const {
+  return tree_type::holds(tree_type::lower_slot(key), key);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::size_type
+frozen_map<Key, Value, Comparator>::count(const Key& key) const {
+  return contains(key);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::const_iterator
+frozen_map<Key, Value, Comparator>::lower_bound(const Key& key) const {
+  return const_iterator(this, tree_type::lower_slot(key));
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename frozen_map<Key, Value, Comparator>::const_iterator
+frozen_map<Key, Value, Comparator>::upper_bound(const Key& key) const {
+  return const_iterator(this, tree_type::upper_slot(key));
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef S21_SRC_FROZEN_SET_H
+#define S21_SRC_FROZEN_SET_H
+
+#include <type_traits>
+#include <vector>
+
+#include "EytzingerArray.h"
+
+namespace s21 {
+
+// Immutable set for data built once and then only read, usually made with
+// set::freeze(). The keys sit in one array in Eytzinger order, so a lookup
+// is a branch-free descent with prefetching instead of a walk over heap
+// nodes. Iteration is still in key order.
+template <typename Key, typename Comparator = std::less<Key>>
+class frozen_set : private EytzingerArray<Key, Comparator> {
+  using tree_type = EytzingerArray<Key, Comparator>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename tree_type::const_iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = size_t;
+
+  frozen_set();
+  // [first, last) must already be sorted by Comparator without duplicates,
+  // as the contents of a set are.
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  frozen_set(InputIt first, InputIt last);
+  frozen_set(const frozen_set& s);
+  frozen_set(frozen_set&& s) noexcept;
+  ~frozen_set() = default;
+  frozen_set& operator=(const frozen_set& s);
+  frozen_set& operator=(frozen_set&& s) noexcept;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  void swap(frozen_set& other) noexcept;
+
+  const_iterator find(const Key& key) const;
+  bool contains(const Key& key) const;
+  size_type count(const Key& key) const;
+  const_iterator lower_bound(const Key& key) const;
+  const_iterator upper_bound(const Key& key) const;
+};
+
+template <typename Key, typename Comparator>
+frozen_set<Key, Comparator>::frozen_set() : tree_type() {}
+
+template <typename Key, typename Comparator>
+template <typename InputIt, typename>
+frozen_set<Key, Comparator>::frozen_set(InputIt first, InputIt last)
+    : frozen_set() {
+  std::vector<Key> sorted;
+  for (; first != last; ++first) {
+    sorted.push_back(*first);
+  }
+  tree_type::keys_.reserve(sorted.size());
+  tree_type::for_each_rank(sorted.size(), [this, &sorted](size_type rank) {
+    tree_type::keys_.push_back(sorted[rank]);
+  });
+}
+
+template <typename Key, typename Comparator>
+frozen_set<Key, Comparator>::frozen_set(const frozen_set& s) : tree_type(s) {}
+
+template <typename Key, typename Comparator>
+frozen_set<Key, Comparator>::frozen_set(frozen_set&& s) noexcept
+    : tree_type(std::move(s)) {}
+
+template <typename Key, typename Comparator>
+frozen_set<Key, Comparator>& frozen_set<Key, Comparator>::operator=(
+    const frozen_set& s) {
+  tree_type::operator=(s);
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+frozen_set<Key, Comparator>& frozen_set<Key, Comparator>::operator=(
+    frozen_set&& s) noexcept {
+  tree_type::operator=(std::move(s));
+  return *this;
+}
+
+template <typename Key, typename Comparator>
+typename frozen_set<Key, Comparator>::const_iterator
+frozen_set<Key, Comparator>::begin() const {
+  return tree_type::tree_begin();
+}
+
+template <typename Key, typename Comparator>
+typename frozen_set<Key, Comparator>::const_iterator
+frozen_set<Key, Comparator>::end() const {
+  return tree_type::tree_end();
+}
+
+template <typename Key, typename Comparator>
+bool frozen_set<Key, Comparator>::empty() const {
+  return tree_type::tree_empty();
+}
+
+template <typename Key, typename Comparator>
+typename frozen_set<Key, Comparator>::size_type
+frozen_set<Key, Comparator>::size() const {
+  return tree_type::tree_size();
+}
+
+template <typename Key, typename Comparator>
+typename frozen_set<Key, Comparator>::size_type
+frozen_set<Key, Comparator>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Comparator>
+void frozen_set<Key, Comparator>::swap(frozen_set& other) noexcept {
+  tree_type::tree_swap(other);
+}
+
+template <typename Key, typename Comparator>
+typename frozen_set<Key, Comparator>::const_iterator
+frozen_set<Key, Comparator>::find(const Key& key) const {
+  size_type slot = tree_type::lower_slot(key);
+  return const_iterator(this, tree_type::holds(slot, key) ? slot : 0);
+}
+
+template <typename Key, typename Comparator>
+bool frozen_set<Key, Comparator>::contains(const Key& key) const {
+  return tree_type::holds(tree_type::lower_slot(key), key);
+}
+
+template <typename Key, typename Comparator>
+typename frozen_set<Key, Comparator>::size_type
+frozen_set<Key, Comparator>::count(const Key& key) const {
+  return contains(key);
+}
+
+template <typename Key, typename Comparator>
+typename frozen_set<Key, Comparator>::const_iterator
+frozen_set<Key, Comparator>::lower_bound(const Key& key) const {
+  return const_iterator(this, tree_type::lower_slot(key));
+}
+
+template <typename Key, typename Comparator>
+typename frozen_set<Key, Comparator>::const_iterator
+frozen_set<Key, Comparator>::upper_bound(const Key& key) const {
+  return const_iterator(this, tree_type::upper_slot(key));
+}
+
+}  // namespace s21
+
+#endif
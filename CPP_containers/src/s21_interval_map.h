@@ -0,0 +1,350 @@
+#ifndef S21_SRC_INTERVAL_MAP_H
+#define S21_SRC_INTERVAL_MAP_H
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "AVLtree.h"
+
+namespace s21 {
+
+// Orders intervals by start, then by end.
+template <typename Key, typename Comparator>
+struct interval_less {
+  bool operator()(const std::pair<Key, Key>& lhs,
+                  const std::pair<Key, Key>& rhs) const {
+    Comparator less;
+    if (less(lhs.first, rhs.first)) {
+      return true;
+    }
+    if (less(rhs.first, lhs.first)) {
+      return false;
+    }
+    return less(lhs.second, rhs.second);
+  }
+};
+
+// Largest interval end in the subtree, so a query can skip every subtree
+// that ends before the range it asks about.
+template <typename Key, typename Comparator>
+struct interval_max_end {
+  Key max_end{};
+
+  template <typename Node>
+  void update(const Node* left, const Node* right) {
+    Comparator less;
+    max_end = static_cast<const Node*>(this)->data_.first.second;
+    if (left != nullptr && less(max_end, left->max_end)) {
+      max_end = left->max_end;
+    }
+    if (right != nullptr && less(max_end, right->max_end)) {
+      max_end = right->max_end;
+    }
+  }
+};
+
+// Multimap from half-open intervals [start, end) to values, on an AVLtree
+// ordered by interval and augmented with the largest end in each subtree.
+// Stabbing and overlap queries prune every subtree whose intervals all end
+// too early or start too late, so they cost O(log n + k) for k results.
+// The same interval may be stored any number of times.
+template <typename Key, typename Value, typename Comparator = std::less<Key>,
+          typename Allocator =
+              std::allocator<std::pair<const std::pair<Key, Key>, Value>>>
+class interval_map
+    : private AVLtree<std::pair<Key, Key>, Value,
+                      interval_less<Key, Comparator>, Allocator,
+                      interval_max_end<Key, Comparator>> {
+  using tree_type =
+      AVLtree<std::pair<Key, Key>, Value, interval_less<Key, Comparator>,
+              Allocator, interval_max_end<Key, Comparator>>;
+  using node = typename tree_type::node;
+
+ public:
+  using key_type = Key;
+  using interval_type = std::pair<Key, Key>;
+  using mapped_type = Value;
+  using value_type = std::pair<const interval_type, mapped_type>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  interval_map();
+  interval_map(std::initializer_list<value_type> const& items);
+  interval_map(const interval_map& m);
+  interval_map(interval_map&& m);
+  ~interval_map() = default;
+  interval_map& operator=(const interval_map& m);
+  interval_map& operator=(interval_map&& m);
+
+  iterator begin();
+  const_iterator begin() const;
+  iterator end();
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+
+  void clear();
+  iterator insert(const Key& start, const Key& end, const Value& obj);
+  iterator insert(const value_type& value);
+  iterator erase(iterator pos);
+  size_type erase(const Key& start, const Key& end);
+  void swap(interval_map& other);
+
+  template <typename Function>
+  void for_each_containing(const Key& point, Function fn);
+  template <typename Function>
+  void for_each_overlapping(const Key& lo, const Key& hi, Function fn);
+  std::vector<iterator> find_containing(const Key& point);
+  std::vector<iterator> find_overlapping(const Key& lo, const Key& hi);
+  bool overlaps(const Key& lo, const Key& hi) const;
+
+ private:
+  template <typename Function>
+  void visit(node* node_ptr, const Key& lo, const Key& hi, bool point,
+             Function& fn) const;
+
+  Comparator less_;
+};
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+interval_map<Key, Value, Comparator, Allocator>::interval_map()
+    : tree_type() {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+interval_map<Key, Value, Comparator, Allocator>::interval_map(
+    std::initializer_list<value_type> const& items)
+    : interval_map() {
+  for (const value_type& item : items) {
+    insert(item);
+  }
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+interval_map<Key, Value, Comparator, Allocator>::interval_map(
+    const interval_map& m)
+    : tree_type(m) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+interval_map<Key, Value, Comparator, Allocator>::interval_map(
+    interval_map&& m)
+    : tree_type(std::move(m)) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+interval_map<Key, Value, Comparator, Allocator>&
+interval_map<Key, Value, Comparator, Allocator>::operator=(
+    const interval_map& m) {
+  tree_type::operator=(m);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+interval_map<Key, Value, Comparator, Allocator>&
+interval_map<Key, Value, Comparator, Allocator>::operator=(
+    interval_map&& m) {
+  tree_type::operator=(std::move(m));
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename interval_map<Key, Value, Comparator, Allocator>::iterator
+interval_map<Key, Value, Comparator, Allocator>::begin() {
+  return tree_type::tree_begin();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename interval_map<Key, Value, Comparator, Allocator>::const_iterator
+interval_map<Key, Value, Comparator, Allocator>::begin() const {
+  return tree_type::const_tree_begin();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename interval_map<Key, Value, Comparator, Allocator>::iterator
+interval_map<Key, Value, Comparator, Allocator>::end() {
+  return tree_type::tree_end();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename interval_map<Key, Value, Comparator, Allocator>::const_iterator
+interval_map<Key, Value, Comparator, Allocator>::end() const {
+  return tree_type::const_tree_end();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+bool interval_map<Key, Value, Comparator, Allocator>::empty() const {
+  return tree_type::tree_empty();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename interval_map<Key, Value, Comparator, Allocator>::size_type
+interval_map<Key, Value, Comparator, Allocator>::size() const {
+  return tree_type::tree_size();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename interval_map<Key, Value, Comparator, Allocator>::size_type
+interval_map<Key, Value, Comparator, Allocator>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void interval_map<Key, Value, Comparator, Allocator>::clear() {
+  tree_type::tree_clear();
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename interval_map<Key, Value, Comparator, Allocator>::iterator
+interval_map<Key, Value, Comparator, Allocator>::insert(const Key& start,
+                                                        const Key& end,
+                                                        const Value& obj) {
+  return insert(value_type(interval_type(start, end), obj));
+}
+
+// An empty interval [s, s) is stored like any other. Point queries never
+// return it, while range queries treat it as the point s and return it for
+// any [lo, hi) with lo < s < hi.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename interval_map<Key, Value, Comparator, Allocator>::iterator
+interval_map<Key, Value, Comparator, Allocator>::insert(
+    const value_type& value) {
+  if (less_(value.first.second, value.first.first)) {
+    throw std::invalid_argument("Interval ends before it starts");
+  }
+  return tree_type::tree_insert(value);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename interval_map<Key, Value, Comparator, Allocator>::iterator
+interval_map<Key, Value, Comparator, Allocator>::erase(iterator pos) {
+  return tree_type::tree_erase(pos);
+}
+
+// Removes every entry for exactly [start, end).
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+typename interval_map<Key, Value, Comparator, Allocator>::size_type
+interval_map<Key, Value, Comparator, Allocator>::erase(const Key& start,
+                                                       const Key& end) {
+  return tree_type::tree_erase(interval_type(start, end));
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+void interval_map<Key, Value, Comparator, Allocator>::swap(
+    interval_map& other) {
+  tree_type::tree_swap(other);
+}
+
+// Visits every entry whose interval holds point, in interval order.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename Function>
+void interval_map<Key, Value, Comparator, Allocator>::for_each_containing(
+    const Key& point, Function fn) {
+  auto apply = [&fn](node* found) { fn(found->data_); };
+  visit(tree_type::tree_root(), point, point, true, apply);
+}
+
+// Visits every entry whose interval shares a point with [lo, hi), in
+// interval order.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename Function>
+void interval_map<Key, Value, Comparator, Allocator>::for_each_overlapping(
+    const Key& lo, const Key& hi, Function fn) {
+  auto apply = [&fn](node* found) { fn(found->data_); };
+  visit(tree_type::tree_root(), lo, hi, false, apply);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::vector<typename interval_map<Key, Value, Comparator, Allocator>::iterator>
+interval_map<Key, Value, Comparator, Allocator>::find_containing(
+    const Key& point) {
+  std::vector<iterator> result;
+  auto collect = [&result](node* found) { result.push_back(iterator(found)); };
+  visit(tree_type::tree_root(), point, point, true, collect);
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+std::vector<typename interval_map<Key, Value, Comparator, Allocator>::iterator>
+interval_map<Key, Value, Comparator, Allocator>::find_overlapping(
+    const Key& lo, const Key& hi) {
+  std::vector<iterator> result;
+  auto collect = [&result](node* found) { result.push_back(iterator(found)); };
+  visit(tree_type::tree_root(), lo, hi, false, collect);
+  return result;
+}
+
+// Stops at the first hit. Going left whenever the left subtree reaches past
+// lo is safe: if nothing there overlaps, nothing to the right can either,
+// because everything to the right starts later still.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+bool interval_map<Key, Value, Comparator, Allocator>::overlaps(
+    const Key& lo, const Key& hi) const {
+  node* node_ptr = tree_type::tree_root();
+  while (node_ptr != nullptr && less_(lo, node_ptr->max_end)) {
+    const interval_type& interval = node_ptr->data_.first;
+    if (less_(interval.first, hi) && less_(lo, interval.second)) {
+      return true;
+    }
+    node* left = node_ptr->left;
+    node_ptr = left != nullptr && less_(lo, left->max_end) ? left
+                                                           : node_ptr->right;
+  }
+  return false;
+}
+
+// In-order walk that skips a subtree when its largest end is not past lo,
+// and stops going right once starts reach hi. With point set, the query is
+// [lo, lo] and an interval starting at lo still counts.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator>
+template <typename Function>
+void interval_map<Key, Value, Comparator, Allocator>::visit(
+    node* node_ptr, const Key& lo, const Key& hi, bool point,
+    Function& fn) const {
+  while (node_ptr != nullptr && less_(lo, node_ptr->max_end)) {
+    visit(node_ptr->left, lo, hi, point, fn);
+    const interval_type& interval = node_ptr->data_.first;
+    bool starts_in_time =
+        point ? !less_(hi, interval.first) : less_(interval.first, hi);
+    if (!starts_in_time) {
+      return;
+    }
+    if (less_(lo, interval.second)) {
+      fn(node_ptr);
+    }
+    node_ptr = node_ptr->right;
+  }
+}
+
+}  // namespace s21
+
+#endif
@@ -1,36 +1,54 @@
 #ifndef S21_SRC_MAP_H
 #define S21_SRC_MAP_H
 
+#include <string>
+#include <type_traits>
 #include <vector>
 
 #include "AVLtree.h"
+#include "s21_frozen_map.h"
 #include "exception"
 
 namespace s21 {
 
-template <typename Key, typename Value, typename Comparator = std::less<Key>>
-class map : private AVLtree<Key, Value, Comparator> {
+template <typename Key, typename Value, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, Value>>,
+          typename Augment = no_augment>
+class map : private AVLtree<Key, Value, Comparator, Allocator, Augment> {
+  using tree_type = AVLtree<Key, Value, Comparator, Allocator, Augment>;
+
  public:
   using key_type = Key;
   using mapped_type = Value;
   using value_type = std::pair<const key_type, mapped_type>;
   using reference = value_type&;
   using const_reference = const value_type&;
-  using iterator = typename AVLtree<Key, Value, Comparator>::iterator;
-  using const_iterator =
-      typename AVLtree<Key, Value, Comparator>::const_iterator;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
   using size_type = size_t;
+  using allocator_type = Allocator;
+  using node_type = typename tree_type::node_handle;
+  using insert_return_type =
+      typename tree_type::template node_insert_result<iterator>;
 
   map();
   map(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  map(InputIt first, InputIt last);
   map(const map& m);
   map(map&& m);
   ~map() = default;
   map& operator=(const map& m);
   map& operator=(map&& m);
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
 
   Value& at(const Key& key);
+  template <typename K, typename = transparent_key_t<Comparator, K>>
+  Value& at(const K& key);
   Value& operator[](const Key& key);
+  Value& operator[](Key&& key);
 
   iterator begin();
   const_iterator begin() const;
@@ -40,160 +58,523 @@ class map : private AVLtree<Key, Value, Comparator> {
   bool empty() const;
   size_type size() const;
   size_type max_size() const;
+  allocator_type get_allocator() const;
 
   void clear();
   std::pair<iterator, bool> insert(const Key& key, const Value& obj);
   std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(value_type&& value);
+  insert_return_type insert(node_type&& handle);
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args);
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args);
   std::pair<iterator, bool> insert_or_assign(const Key& key, const Value& obj);
-  void erase(iterator pos);
+  iterator erase(iterator pos);
+  iterator erase(iterator first, iterator last);
+  size_type erase(const Key& key);
   void swap(map& other);
   void merge(map& other);
+  node_type extract(iterator pos);
+  node_type extract(const Key& key);
+  map split(const Key& key);
+  void join(map& greater);
+  frozen_map<Key, Value, Comparator> freeze() const;
 
   bool contains(const Key& key) const;
+  template <typename K, typename = transparent_key_t<Comparator, K>>
+  bool contains(const K& key) const;
+  std::vector<iterator> find_many(const Key* keys, size_type count);
+  std::vector<bool> contains_many(const Key* keys, size_type count) const;
+  iterator nth(size_type index);
+  const_iterator nth(size_type index) const;
+  size_type rank(const Key& key) const;
+  iterator lower_bound(const Key& key);
+  const_iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key);
+  const_iterator upper_bound(const Key& key) const;
+  template <typename Function>
+  void for_each_in_range(const Key& lo, const Key& hi, Function fn);
+  template <typename Function>
+  void for_each_in_range(const Key& lo, const Key& hi, Function fn) const;
+  size_type erase_range(const Key& lo, const Key& hi);
 
   template <class... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+
+  template <typename K, typename V, typename C, typename A, typename G>
+  friend map<K, V, C, A, G> set_union(map<K, V, C, A, G> lhs,
+                                      map<K, V, C, A, G> rhs);
+  template <typename K, typename V, typename C, typename A, typename G>
+  friend map<K, V, C, A, G> set_intersection(map<K, V, C, A, G> lhs,
+                                          const map<K, V, C, A, G>& rhs);
+  template <typename K, typename V, typename C, typename A, typename G>
+  friend map<K, V, C, A, G> set_difference(map<K, V, C, A, G> lhs,
+                                        const map<K, V, C, A, G>& rhs);
+  // Defined in s21_snapshot.h, so only code that loads snapshots pulls in
+  // the POSIX headers they need.
+  template <typename K, typename V, typename C, typename A, typename G>
+  friend void load(map<K, V, C, A, G>& m, const std::string& path);
 };
 
-template <typename Key, typename Value, typename Comparator>
-map<Key, Value, Comparator>::map() : AVLtree<Key, Value, Comparator>() {}
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+map<Key, Value, Comparator, Allocator, Augment>::map() : tree_type() {}
 
-template <typename Key, typename Value, typename Comparator>
-map<Key, Value, Comparator>::map(std::initializer_list<value_type> const& items)
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+map<Key, Value, Comparator, Allocator, Augment>::map(
+    std::initializer_list<value_type> const& items)
     : map() {
-  for (auto item : items) {
-    AVLtree<Key, Value, Comparator>::tree_unique_insert(item);
-  }
+  assign(items.begin(), items.end());
 }
 
-template <typename Key, typename Value, typename Comparator>
-map<Key, Value, Comparator>::map(const map& m)
-    : AVLtree<Key, Value, Comparator>(m) {}
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename InputIt, typename>
+map<Key, Value, Comparator, Allocator, Augment>::map(InputIt first,
+                                                     InputIt last)
+    : map() {
+  assign(first, last);
+}
 
-template <typename Key, typename Value, typename Comparator>
-map<Key, Value, Comparator>::map(map&& m)
-    : AVLtree<Key, Value, Comparator>(std::move(m)) {}
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename InputIt>
+void map<Key, Value, Comparator, Allocator, Augment>::assign(InputIt first,
+                                                             InputIt last) {
+  tree_type::tree_assign(
+      first, last, true,
+      [](auto& emplace, const auto& item) { return emplace(item); });
+}
 
-template <typename Key, typename Value, typename Comparator>
-map<Key, Value, Comparator>& map<Key, Value, Comparator>::operator=(
-    const map& m) {
-  AVLtree<Key, Value, Comparator>::operator=(m);
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+map<Key, Value, Comparator, Allocator, Augment>::map(const map& m)
+    : tree_type(m) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+map<Key, Value, Comparator, Allocator, Augment>::map(map&& m)
+    : tree_type(std::move(m)) {}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+map<Key, Value, Comparator, Allocator, Augment>&
+map<Key, Value, Comparator, Allocator, Augment>::operator=(const map& m) {
+  tree_type::operator=(m);
   return *this;
 }
 
-template <typename Key, typename Value, typename Comparator>
-map<Key, Value, Comparator>& map<Key, Value, Comparator>::operator=(map&& m) {
-  AVLtree<Key, Value, Comparator>::operator=(std::move(m));
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+map<Key, Value, Comparator, Allocator, Augment>&
+map<Key, Value, Comparator, Allocator, Augment>::operator=(map&& m) {
+  tree_type::operator=(std::move(m));
   return *this;
 }
 
-template <typename Key, typename Value, typename Comparator>
-Value& map<Key, Value, Comparator>::at(const Key& key) {
-  return AVLtree<Key, Value, Comparator>::at(key);
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+Value& map<Key, Value, Comparator, Allocator, Augment>::at(const Key& key) {
+  return tree_type::at(key);
 }
 
-template <typename Key, typename Value, typename Comparator>
-Value& map<Key, Value, Comparator>::operator[](const Key& key) {
-  return AVLtree<Key, Value, Comparator>::operator[](key);
+// Heterogeneous lookups compare K against the stored keys directly, so a
+// std::string_view probe into a map keyed by std::string allocates nothing.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K, typename>
+Value& map<Key, Value, Comparator, Allocator, Augment>::at(const K& key) {
+  return tree_type::at(key);
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename map<Key, Value, Comparator>::iterator
-map<Key, Value, Comparator>::begin() {
-  return AVLtree<Key, Value, Comparator>::tree_begin();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+Value& map<Key, Value, Comparator, Allocator, Augment>::operator[](
+    const Key& key) {
+  return tree_type::operator[](key);
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename map<Key, Value, Comparator>::const_iterator
-map<Key, Value, Comparator>::begin() const {
-  return AVLtree<Key, Value, Comparator>::const_tree_begin();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+Value& map<Key, Value, Comparator, Allocator, Augment>::operator[](Key&& key) {
+  return tree_type::operator[](std::move(key));
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename map<Key, Value, Comparator>::iterator
-map<Key, Value, Comparator>::end() {
-  return AVLtree<Key, Value, Comparator>::tree_end();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::iterator
+map<Key, Value, Comparator, Allocator, Augment>::begin() {
+  return tree_type::tree_begin();
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename map<Key, Value, Comparator>::const_iterator
-map<Key, Value, Comparator>::end() const {
-  return AVLtree<Key, Value, Comparator>::const_tree_end();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::const_iterator
+map<Key, Value, Comparator, Allocator, Augment>::begin() const {
+  return tree_type::const_tree_begin();
 }
 
-template <typename Key, typename Value, typename Comparator>
-bool map<Key, Value, Comparator>::empty() const {
-  return AVLtree<Key, Value, Comparator>::tree_empty();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::iterator
+map<Key, Value, Comparator, Allocator, Augment>::end() {
+  return tree_type::tree_end();
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename map<Key, Value, Comparator>::size_type
-map<Key, Value, Comparator>::size() const {
-  return AVLtree<Key, Value, Comparator>::tree_size();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::const_iterator
+map<Key, Value, Comparator, Allocator, Augment>::end() const {
+  return tree_type::const_tree_end();
 }
 
-template <typename Key, typename Value, typename Comparator>
-typename map<Key, Value, Comparator>::size_type
-map<Key, Value, Comparator>::max_size() const {
-  return AVLtree<Key, Value, Comparator>::tree_max_size();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool map<Key, Value, Comparator, Allocator, Augment>::empty() const {
+  return tree_type::tree_empty();
 }
 
-template <typename Key, typename Value, typename Comparator>
-void map<Key, Value, Comparator>::clear() {
-  AVLtree<Key, Value, Comparator>::tree_clear();
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::size_type
+map<Key, Value, Comparator, Allocator, Augment>::size() const {
+  return tree_type::tree_size();
 }
 
-template <typename Key, typename Value, typename Comparator>
-std::pair<typename map<Key, Value, Comparator>::iterator, bool>
-map<Key, Value, Comparator>::insert(const Key& key, const Value& obj) {
-  return AVLtree<Key, Value, Comparator>::tree_unique_insert(key, obj);
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::size_type
+map<Key, Value, Comparator, Allocator, Augment>::max_size() const {
+  return tree_type::tree_max_size();
 }
 
-template <typename Key, typename Value, typename Comparator>
-std::pair<typename map<Key, Value, Comparator>::iterator, bool>
-map<Key, Value, Comparator>::insert(const value_type& value) {
-  return AVLtree<Key, Value, Comparator>::tree_unique_insert(value);
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::allocator_type
+map<Key, Value, Comparator, Allocator, Augment>::get_allocator() const {
+  return tree_type::get_allocator();
 }
 
-template <typename Key, typename Value, typename Comparator>
-std::pair<typename map<Key, Value, Comparator>::iterator, bool>
-map<Key, Value, Comparator>::insert_or_assign(const Key& key,
-                                              const Value& obj) {
-  return AVLtree<Key, Value, Comparator>::tree_insert_or_assign(key, obj);
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void map<Key, Value, Comparator, Allocator, Augment>::clear() {
+  tree_type::tree_clear();
 }
 
-template <typename Key, typename Value, typename Comparator>
-void map<Key, Value, Comparator>::erase(iterator pos) {
-  AVLtree<Key, Value, Comparator>::tree_erase(pos);
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<
+    typename map<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+map<Key, Value, Comparator, Allocator, Augment>::insert(const Key& key,
+                                                        const Value& obj) {
+  return tree_type::tree_unique_insert(key, obj);
 }
 
-template <typename Key, typename Value, typename Comparator>
-void map<Key, Value, Comparator>::swap(map& other) {
-  AVLtree<Key, Value, Comparator>::tree_swap(other);
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<
+    typename map<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+map<Key, Value, Comparator, Allocator, Augment>::insert(
+    const value_type& value) {
+  return tree_type::tree_unique_insert(value);
 }
 
-template <typename Key, typename Value, typename Comparator>
-void map<Key, Value, Comparator>::merge(map& other) {
-  AVLtree<Key, Value, Comparator>::tree_merge_unique(other);
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<
+    typename map<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+map<Key, Value, Comparator, Allocator, Augment>::insert(value_type&& value) {
+  return tree_type::tree_unique_insert(std::move(value));
 }
 
-template <typename Key, typename Value, typename Comparator>
-bool map<Key, Value, Comparator>::contains(const Key& key) const {
-  return AVLtree<Key, Value, Comparator>::tree_contains(key);
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::insert_return_type
+map<Key, Value, Comparator, Allocator, Augment>::insert(node_type&& handle) {
+  std::pair<iterator, bool> result = tree_type::tree_unique_insert(handle);
+  return {result.first, result.second, std::move(handle)};
 }
 
-template <typename Key, typename Value, typename Comparator>
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
 template <class... Args>
-std::vector<std::pair<typename map<Key, Value, Comparator>::iterator, bool>>
-map<Key, Value, Comparator>::insert_many(Args&&... args) {
-  std::vector<std::pair<typename map<Key, Value, Comparator>::iterator, bool>>
-      result;
-  for (const auto& item : {args...}) {
-    result.push_back(insert(item));
-  }
+std::pair<
+    typename map<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+map<Key, Value, Comparator, Allocator, Augment>::emplace(Args&&... args) {
+  return tree_type::tree_unique_emplace(std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <class... Args>
+std::pair<
+    typename map<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+map<Key, Value, Comparator, Allocator, Augment>::try_emplace(const Key& key,
+                                                             Args&&... args) {
+  return tree_type::tree_try_emplace(key, std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <class... Args>
+std::pair<
+    typename map<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+map<Key, Value, Comparator, Allocator, Augment>::try_emplace(Key&& key,
+                                                             Args&&... args) {
+  return tree_type::tree_try_emplace(
+      std::move(key), std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::pair<
+    typename map<Key, Value, Comparator, Allocator, Augment>::iterator,
+    bool>
+map<Key, Value, Comparator, Allocator, Augment>::insert_or_assign(
+    const Key& key, const Value& obj) {
+  return tree_type::tree_insert_or_assign(key, obj);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::iterator
+map<Key, Value, Comparator, Allocator, Augment>::erase(iterator pos) {
+  return tree_type::tree_erase(pos);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::iterator
+map<Key, Value, Comparator, Allocator, Augment>::erase(iterator first,
+                                                       iterator last) {
+  return tree_type::tree_erase(first, last);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::size_type
+map<Key, Value, Comparator, Allocator, Augment>::erase(const Key& key) {
+  return tree_type::tree_erase(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void map<Key, Value, Comparator, Allocator, Augment>::swap(map& other) {
+  tree_type::tree_swap(other);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void map<Key, Value, Comparator, Allocator, Augment>::merge(map& other) {
+  tree_type::tree_merge_unique(other);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::node_type
+map<Key, Value, Comparator, Allocator, Augment>::extract(iterator pos) {
+  return tree_type::tree_extract(pos);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::node_type
+map<Key, Value, Comparator, Allocator, Augment>::extract(const Key& key) {
+  return tree_type::tree_extract(key);
+}
+
+// Moves every key not less than key into the returned map in O(log n).
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+map<Key, Value, Comparator, Allocator, Augment>
+map<Key, Value, Comparator, Allocator, Augment>::split(const Key& key) {
+  map greater;
+  tree_type::tree_split(key, greater);
+  return greater;
+}
+
+// Appends greater, whose keys must all follow ours, in O(log n); otherwise
+// it behaves like merge().
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void map<Key, Value, Comparator, Allocator, Augment>::join(map& greater) {
+  tree_type::tree_join(greater, true);
+}
+
+// Copies the contents into a read-only frozen_map with faster lookups; the
+// map itself is left as it was.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+frozen_map<Key, Value, Comparator>
+map<Key, Value, Comparator, Allocator, Augment>::freeze() const {
+  return frozen_map<Key, Value, Comparator>(begin(), end());
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+bool map<Key, Value, Comparator, Allocator, Augment>::contains(
+    const Key& key) const {
+  return tree_type::tree_contains(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename K, typename>
+bool map<Key, Value, Comparator, Allocator, Augment>::contains(
+    const K& key) const {
+  return tree_type::tree_contains(key);
+}
+
+// Looks up a batch of keys with interleaved, prefetched searches (see
+// AVLtree::find_batch). Misses come back as end().
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::vector<typename map<Key, Value, Comparator, Allocator, Augment>::iterator>
+map<Key, Value, Comparator, Allocator, Augment>::find_many(
+    const Key* keys, size_type count) {
+  return tree_type::tree_find_many(keys, count);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+std::vector<bool>
+map<Key, Value, Comparator, Allocator, Augment>::contains_many(
+    const Key* keys, size_type count) const {
+  return tree_type::tree_contains_many(keys, count);
+}
+
+// nth() and rank() need the order_statistics augment.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::iterator
+map<Key, Value, Comparator, Allocator, Augment>::nth(size_type index) {
+  return tree_type::tree_nth(index);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::const_iterator
+map<Key, Value, Comparator, Allocator, Augment>::nth(size_type index) const {
+  return tree_type::tree_nth(index);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::size_type
+map<Key, Value, Comparator, Allocator, Augment>::rank(const Key& key) const {
+  return tree_type::tree_rank(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::iterator
+map<Key, Value, Comparator, Allocator, Augment>::lower_bound(const Key& key) {
+  return tree_type::tree_lower_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::const_iterator
+map<Key, Value, Comparator, Allocator, Augment>::lower_bound(
+    const Key& key) const {
+  return tree_type::tree_lower_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::iterator
+map<Key, Value, Comparator, Allocator, Augment>::upper_bound(const Key& key) {
+  return tree_type::tree_upper_bound(key);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::const_iterator
+map<Key, Value, Comparator, Allocator, Augment>::upper_bound(
+    const Key& key) const {
+  return tree_type::tree_upper_bound(key);
+}
+
+// Visits every element with a key in [lo, hi) in O(log n + k); fn may
+// change mapped values but must not insert or erase.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename Function>
+void map<Key, Value, Comparator, Allocator, Augment>::for_each_in_range(
+    const Key& lo, const Key& hi, Function fn) {
+  tree_type::tree_for_each_in_range(lo, hi, fn);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <typename Function>
+void map<Key, Value, Comparator, Allocator, Augment>::for_each_in_range(
+    const Key& lo, const Key& hi, Function fn) const {
+  tree_type::tree_for_each_in_range(
+      lo, hi, [&fn](const value_type& item) { fn(item); });
+}
+
+// Drops every key in [lo, hi) in O(log n + k) and returns how many went.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+typename map<Key, Value, Comparator, Allocator, Augment>::size_type
+map<Key, Value, Comparator, Allocator, Augment>::erase_range(
+    const Key& lo, const Key& hi) {
+  return tree_type::tree_erase_range(lo, hi);
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+template <class... Args>
+std::vector<std::pair<
+    typename map<Key, Value, Comparator, Allocator, Augment>::iterator, bool>>
+map<Key, Value, Comparator, Allocator, Augment>::insert_many(Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  result.reserve(sizeof...(args));
+  (result.push_back(insert(std::forward<Args>(args))), ...);
   return result;
 }
 
+// Set operations on keys. The result is lhs, so pass it with std::move to
+// avoid a copy; on equal keys the element of lhs is kept. set_union also
+// consumes rhs, intersection and difference only read it.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+map<Key, Value, Comparator, Allocator, Augment> set_union(
+    map<Key, Value, Comparator, Allocator, Augment> lhs,
+    map<Key, Value, Comparator, Allocator, Augment> rhs) {
+  lhs.tree_set_union(rhs);
+  return lhs;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+map<Key, Value, Comparator, Allocator, Augment> set_intersection(
+    map<Key, Value, Comparator, Allocator, Augment> lhs,
+    const map<Key, Value, Comparator, Allocator, Augment>& rhs) {
+  lhs.tree_set_intersection(rhs);
+  return lhs;
+}
+
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+map<Key, Value, Comparator, Allocator, Augment> set_difference(
+    map<Key, Value, Comparator, Allocator, Augment> lhs,
+    const map<Key, Value, Comparator, Allocator, Augment>& rhs) {
+  lhs.tree_set_difference(rhs);
+  return lhs;
+}
+
 }  // namespace s21
 
 #endif
\ No newline at end of file
@@ -1,13 +1,18 @@
 #ifndef S21_SRC_MULTISET_H
 #define S21_SRC_MULTISET_H
 
+#include <type_traits>
 #include <vector>
 
 #include "AVLtree.h"
 
 namespace s21 {
-template <typename Key, typename Comparator = std::less<Key>>
-class multiset : private AVLtree<Key, Key, Comparator> {
+template <typename Key, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<Key>,
+          typename Augment = no_augment>
+class multiset : private AVLtree<Key, void, Comparator, Allocator, Augment> {
+  using tree_type = AVLtree<Key, void, Comparator, Allocator, Augment>;
+
  public:
   class multiset_iterator;
   class const_multiset_iterator;
@@ -20,33 +25,40 @@ class multiset : private AVLtree<Key, Key, Comparator> {
   using iterator = multiset_iterator;
   using const_iterator = const_multiset_iterator;
   using size_type = size_t;
+  using allocator_type = Allocator;
+  using node_type = typename tree_type::node_handle;
 
-  class multiset_iterator : public AVLtree<Key, Key, Comparator>::iterator {
+  class multiset_iterator : public tree_type::iterator {
    public:
     multiset_iterator() = default;
-    multiset_iterator(
-        const typename AVLtree<Key, Key, Comparator>::iterator& other);
-    multiset_iterator(typename AVLtree<Key, Key, Comparator>::node* node);
-    reference operator*();
+    multiset_iterator(const typename tree_type::iterator& other);
+    multiset_iterator(typename tree_type::node* node);
+    // The element is the key the node is ordered by, so like std::multiset's
+    // iterators this one only reads it.
+    const_reference operator*();
+    const_pointer operator->();
   };
 
-  class const_multiset_iterator
-      : public AVLtree<Key, Key, Comparator>::const_iterator {
+  class const_multiset_iterator : public tree_type::const_iterator {
    public:
     const_multiset_iterator() = default;
-    const_multiset_iterator(
-        const typename AVLtree<Key, Key, Comparator>::const_iterator& other);
-    const_multiset_iterator(typename AVLtree<Key, Key, Comparator>::node* node);
+    const_multiset_iterator(const typename tree_type::const_iterator& other);
+    const_multiset_iterator(typename tree_type::node* node);
     const_reference operator*();
   };
 
   multiset();
   multiset(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  multiset(InputIt first, InputIt last);
   multiset(const multiset& ms);
   multiset(multiset&& ms);
   ~multiset() = default;
   multiset& operator=(const multiset& ms);
   multiset& operator=(multiset&& ms);
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
 
   iterator begin();
   const_iterator begin() const;
@@ -56,206 +68,435 @@ class multiset : private AVLtree<Key, Key, Comparator> {
   bool empty() const;
   size_type size() const;
   size_type max_size() const;
+  allocator_type get_allocator() const;
 
   void clear();
   iterator insert(const value_type& value);
-  void erase(iterator pos);
+  iterator insert(value_type&& value);
+  iterator insert(node_type&& handle);
+  template <class... Args>
+  iterator emplace(Args&&... args);
+  iterator erase(iterator pos);
+  iterator erase(iterator first, iterator last);
+  size_type erase(const Key& key);
   void swap(multiset& other);
   void merge(multiset& other);
+  node_type extract(iterator pos);
+  node_type extract(const Key& key);
 
   size_type count(const Key& key) const;
+  template <typename K, typename = transparent_key_t<Comparator, K>>
+  size_type count(const K& key) const;
   iterator find(const Key& key);
+  template <typename K, typename = transparent_key_t<Comparator, K>>
+  iterator find(const K& key);
   bool contains(const Key& key) const;
+  template <typename K, typename = transparent_key_t<Comparator, K>>
+  bool contains(const K& key) const;
+  std::vector<iterator> find_many(const Key* keys, size_type count);
+  std::vector<bool> contains_many(const Key* keys, size_type count) const;
+  iterator nth(size_type index);
+  size_type rank(const Key& key) const;
   std::pair<iterator, iterator> equal_range(const Key& key);
   iterator lower_bound(const Key& key);
   iterator upper_bound(const Key& key);
+  template <typename Function>
+  void for_each_in_range(const Key& lo, const Key& hi, Function fn) const;
+  size_type erase_range(const Key& lo, const Key& hi);
 
   template <class... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
 };
 
-template <typename Key, typename Comparator>
-multiset<Key, Comparator>::multiset() : AVLtree<Key, Key, Comparator>() {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+multiset<Key, Comparator, Allocator, Augment>::multiset() : tree_type() {}
 
-template <typename Key, typename Comparator>
-multiset<Key, Comparator>::multiset(
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+multiset<Key, Comparator, Allocator, Augment>::multiset(
     std::initializer_list<value_type> const& items)
     : multiset() {
-  for (auto item : items) {
-    AVLtree<Key, Key, Comparator>::tree_insert({item, item});
-  }
+  assign(items.begin(), items.end());
 }
 
-template <typename Key, typename Comparator>
-multiset<Key, Comparator>::multiset(const multiset& ms)
-    : AVLtree<Key, Key, Comparator>(ms) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename InputIt, typename>
+multiset<Key, Comparator, Allocator, Augment>::multiset(InputIt first,
+                                                        InputIt last)
+    : multiset() {
+  assign(first, last);
+}
 
-template <typename Key, typename Comparator>
-multiset<Key, Comparator>::multiset(multiset&& ms)
-    : AVLtree<Key, Key, Comparator>(std::move(ms)) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename InputIt>
+void multiset<Key, Comparator, Allocator, Augment>::assign(InputIt first,
+                                                           InputIt last) {
+  tree_type::tree_assign(
+      first, last, false,
+      [](auto& emplace, const auto& item) { return emplace(item); });
+}
 
-template <typename Key, typename Comparator>
-multiset<Key, Comparator>& multiset<Key, Comparator>::operator=(
-    const multiset& ms) {
-  AVLtree<Key, Key, Comparator>::operator=(ms);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+multiset<Key, Comparator, Allocator, Augment>::multiset(const multiset& ms)
+    : tree_type(ms) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+multiset<Key, Comparator, Allocator, Augment>::multiset(multiset&& ms)
+    : tree_type(std::move(ms)) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+multiset<Key, Comparator, Allocator, Augment>&
+multiset<Key, Comparator, Allocator, Augment>::operator=(const multiset& ms) {
+  tree_type::operator=(ms);
   return *this;
 }
 
-template <typename Key, typename Comparator>
-multiset<Key, Comparator>& multiset<Key, Comparator>::operator=(multiset&& ms) {
-  AVLtree<Key, Key, Comparator>::operator=(std::move(ms));
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+multiset<Key, Comparator, Allocator, Augment>&
+multiset<Key, Comparator, Allocator, Augment>::operator=(multiset&& ms) {
+  tree_type::operator=(std::move(ms));
   return *this;
 }
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::iterator
-multiset<Key, Comparator>::begin() {
-  return multiset_iterator(AVLtree<Key, Key, Comparator>::root->parent_);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::begin() {
+  return multiset_iterator(tree_type::root->next);
 }
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::const_iterator
-multiset<Key, Comparator>::begin() const {
-  return const_multiset_iterator(AVLtree<Key, Key, Comparator>::root->parent_);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::const_iterator
+multiset<Key, Comparator, Allocator, Augment>::begin() const {
+  return const_multiset_iterator(tree_type::root->next);
 }
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::iterator multiset<Key, Comparator>::end() {
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::end() {
   return multiset_iterator(
-      static_cast<typename AVLtree<Key, Key, Comparator>::node*>(
-          AVLtree<Key, Key, Comparator>::root));
+      static_cast<typename tree_type::node*>(tree_type::root));
 }
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::const_iterator
-multiset<Key, Comparator>::end() const {
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::const_iterator
+multiset<Key, Comparator, Allocator, Augment>::end() const {
   return const_multiset_iterator(
-      static_cast<typename AVLtree<Key, Key, Comparator>::node*>(
-          AVLtree<Key, Key, Comparator>::root));
+      static_cast<typename tree_type::node*>(tree_type::root));
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+bool multiset<Key, Comparator, Allocator, Augment>::empty() const {
+  return tree_type::tree_empty();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+multiset<Key, Comparator, Allocator, Augment>::size_type
+multiset<Key, Comparator, Allocator, Augment>::size() const {
+  return tree_type::tree_size();
 }
 
-template <typename Key, typename Comparator>
-bool multiset<Key, Comparator>::empty() const {
-  return AVLtree<Key, Key, Comparator>::tree_empty();
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::size_type
+multiset<Key, Comparator, Allocator, Augment>::max_size() const {
+  return tree_type::tree_max_size();
 }
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::size_type multiset<Key, Comparator>::size()
-    const {
-  return AVLtree<Key, Key, Comparator>::tree_size();
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::allocator_type
+multiset<Key, Comparator, Allocator, Augment>::get_allocator() const {
+  return tree_type::get_allocator();
 }
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::size_type
-multiset<Key, Comparator>::max_size() const {
-  return AVLtree<Key, Key, Comparator>::tree_max_size();
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void multiset<Key, Comparator, Allocator, Augment>::clear() {
+  tree_type::tree_clear();
 }
 
-template <typename Key, typename Comparator>
-void multiset<Key, Comparator>::clear() {
-  AVLtree<Key, Key, Comparator>::tree_clear();
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::insert(const value_type& value) {
+  iterator result = tree_type::tree_insert(value);
+  return result;
 }
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::iterator multiset<Key, Comparator>::insert(
-    const value_type& value) {
-  iterator result = AVLtree<Key, Key, Comparator>::tree_insert({value, value});
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::insert(value_type&& value) {
+  iterator result = tree_type::tree_insert(std::move(value));
   return result;
 }
 
-template <typename Key, typename Comparator>
-void multiset<Key, Comparator>::erase(iterator pos) {
-  AVLtree<Key, Key, Comparator>::tree_erase(pos);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::insert(node_type&& handle) {
+  return tree_type::tree_insert(std::move(handle));
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <class... Args>
+typename multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::emplace(Args&&... args) {
+  return insert(value_type(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::erase(iterator pos) {
+  return tree_type::tree_erase(pos);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::erase(iterator first,
+                                                     iterator last) {
+  return tree_type::tree_erase(first, last);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+multiset<Key, Comparator, Allocator, Augment>::size_type
+multiset<Key, Comparator, Allocator, Augment>::erase(const Key& key) {
+  return tree_type::tree_erase(key);
 }
 
-template <typename Key, typename Comparator>
-void multiset<Key, Comparator>::swap(multiset& other) {
-  AVLtree<Key, Key, Comparator>::tree_swap(other);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void multiset<Key, Comparator, Allocator, Augment>::swap(multiset& other) {
+  tree_type::tree_swap(other);
 }
 
-template <typename Key, typename Comparator>
-void multiset<Key, Comparator>::merge(multiset& other) {
-  AVLtree<Key, Key, Comparator>::tree_merge(other);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void multiset<Key, Comparator, Allocator, Augment>::merge(multiset& other) {
+  tree_type::tree_merge(other);
 }
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::size_type multiset<Key, Comparator>::count(
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::node_type
+multiset<Key, Comparator, Allocator, Augment>::extract(iterator pos) {
+  return tree_type::tree_extract(pos);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::node_type
+multiset<Key, Comparator, Allocator, Augment>::extract(const Key& key) {
+  return tree_type::tree_extract(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+multiset<Key, Comparator, Allocator, Augment>::size_type
+multiset<Key, Comparator, Allocator, Augment>::count(const Key& key) const {
+  return tree_type::tree_count(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::find(const Key& key) {
+  return tree_type::tree_find(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+bool multiset<Key, Comparator, Allocator, Augment>::contains(
     const Key& key) const {
-  return AVLtree<Key, Key, Comparator>::tree_count(key);
+  return tree_type::tree_contains(key);
+}
+
+// The heterogeneous overloads compare K against the stored keys directly
+// instead of building a Key for the lookup.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename K, typename>
+typename
+multiset<Key, Comparator, Allocator, Augment>::size_type
+multiset<Key, Comparator, Allocator, Augment>::count(const K& key) const {
+  return tree_type::tree_count(key);
 }
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::iterator multiset<Key, Comparator>::find(
-    const Key& key) {
-  return AVLtree<Key, Key, Comparator>::tree_find(key);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename K, typename>
+typename
+multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::find(const K& key) {
+  return tree_type::tree_find(key);
 }
 
-template <typename Key, typename Comparator>
-bool multiset<Key, Comparator>::contains(const Key& key) const {
-  return AVLtree<Key, Key, Comparator>::tree_contains(key);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename K, typename>
+bool multiset<Key, Comparator, Allocator, Augment>::contains(
+    const K& key) const {
+  return tree_type::tree_contains(key);
 }
 
-template <typename Key, typename Comparator>
-inline std::pair<typename multiset<Key, Comparator>::iterator,
-                 typename multiset<Key, Comparator>::iterator>
-multiset<Key, Comparator>::equal_range(const Key& key) {
-  return std::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+std::vector<typename multiset<Key, Comparator, Allocator, Augment>::iterator>
+multiset<Key, Comparator, Allocator, Augment>::find_many(
+    const Key* keys, size_type count) {
+  return tree_type::template tree_find_many<iterator>(keys, count);
 }
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::iterator
-multiset<Key, Comparator>::lower_bound(const Key& key) {
-  return iterator(AVLtree<Key, Key, Comparator>::tree_lower_bound(key));
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+std::vector<bool> multiset<Key, Comparator, Allocator, Augment>::contains_many(
+    const Key* keys, size_type count) const {
+  return tree_type::tree_contains_many(keys, count);
 }
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::iterator
-multiset<Key, Comparator>::upper_bound(const Key& key) {
-  return iterator(AVLtree<Key, Key, Comparator>::tree_upper_bound(key));
+// nth() and rank() need the order_statistics augment.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::nth(size_type index) {
+  return iterator(tree_type::tree_nth(index));
 }
 
-template <typename Key, typename Comparator>
-inline multiset<Key, Comparator>::multiset_iterator::multiset_iterator(
-    const typename AVLtree<Key, Key, Comparator>::iterator& other)
-    : AVLtree<Key, Key, Comparator>::iterator::iterator(other) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+multiset<Key, Comparator, Allocator, Augment>::size_type
+multiset<Key, Comparator, Allocator, Augment>::rank(const Key& key) const {
+  return tree_type::tree_rank(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+std::pair<
+    typename multiset<Key, Comparator, Allocator, Augment>::iterator,
+    typename multiset<Key, Comparator, Allocator, Augment>::iterator>
+multiset<Key, Comparator, Allocator, Augment>::equal_range(const Key& key) {
+  auto range = tree_type::tree_equal_range(key);
+  return std::pair<iterator, iterator>(range.first, range.second);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::lower_bound(const Key& key) {
+  return iterator(tree_type::tree_lower_bound(key));
+}
 
-template <typename Key, typename Comparator>
-multiset<Key, Comparator>::multiset_iterator::multiset_iterator(
-    typename AVLtree<Key, Key, Comparator>::node* node)
-    : AVLtree<Key, Key, Comparator>::iterator::iterator(node) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::iterator
+multiset<Key, Comparator, Allocator, Augment>::upper_bound(const Key& key) {
+  return iterator(tree_type::tree_upper_bound(key));
+}
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::reference
-multiset<Key, Comparator>::multiset_iterator::operator*() {
-  return AVLtree<Key, Key, Comparator>::iterator::current_node->data_.second;
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename Function>
+void multiset<Key, Comparator, Allocator, Augment>::for_each_in_range(
+    const Key& lo, const Key& hi, Function fn) const {
+  tree_type::tree_for_each_in_range(lo, hi,
+                                    [&fn](const Key& key) { fn(key); });
 }
 
-template <typename Key, typename Comparator>
-multiset<Key, Comparator>::const_multiset_iterator::const_multiset_iterator(
-    const typename AVLtree<Key, Key, Comparator>::const_iterator& other)
-    : AVLtree<Key, Key, Comparator>::const_iterator::const_iterator(other) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::size_type
+multiset<Key, Comparator, Allocator, Augment>::erase_range(
+    const Key& lo, const Key& hi) {
+  return tree_type::tree_erase_range(lo, hi);
+}
 
-template <typename Key, typename Comparator>
-multiset<Key, Comparator>::const_multiset_iterator::const_multiset_iterator(
-    typename AVLtree<Key, Key, Comparator>::node* node)
-    : AVLtree<Key, Key, Comparator>::const_iterator::const_iterator(node) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+multiset<Key, Comparator, Allocator,
+         Augment>::multiset_iterator::multiset_iterator(
+    const typename tree_type::iterator& other)
+    : tree_type::iterator::iterator(other) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+multiset<Key, Comparator, Allocator,
+         Augment>::multiset_iterator::multiset_iterator(
+    typename tree_type::node* node)
+    : tree_type::iterator::iterator(node) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::const_reference
+multiset<Key, Comparator, Allocator, Augment>::multiset_iterator::operator*() {
+  return tree_type::iterator::current_node->data_;
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::const_pointer
+multiset<Key, Comparator, Allocator, Augment>::multiset_iterator::operator->() {
+  return &tree_type::iterator::current_node->data_;
+}
 
-template <typename Key, typename Comparator>
-typename multiset<Key, Comparator>::const_reference
-multiset<Key, Comparator>::const_multiset_iterator::operator*() {
-  return AVLtree<Key, Key, Comparator>::const_iterator::current_node->data_
-      .second;
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+multiset<Key, Comparator, Allocator,
+         Augment>::const_multiset_iterator::const_multiset_iterator(
+    const typename tree_type::const_iterator& other)
+    : tree_type::const_iterator::const_iterator(other) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+multiset<Key, Comparator, Allocator,
+         Augment>::const_multiset_iterator::const_multiset_iterator(
+    typename tree_type::node* node)
+    : tree_type::const_iterator::const_iterator(node) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename multiset<Key, Comparator, Allocator, Augment>::const_reference
+multiset<Key, Comparator, Allocator,
+         Augment>::const_multiset_iterator::operator*() {
+  return tree_type::const_iterator::current_node->data_;
 }
 
-template <typename Key, typename Comparator>
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
 template <class... Args>
-std::vector<std::pair<typename multiset<Key, Comparator>::iterator, bool>>
-multiset<Key, Comparator>::insert_many(Args&&... args) {
-  std::vector<std::pair<typename multiset<Key, Comparator>::iterator, bool>>
-      result;
-  for (const auto& item : {args...}) {
-    result.push_back({insert(item), true});
-  }
+std::vector<std::pair<
+    typename multiset<Key, Comparator, Allocator, Augment>::iterator, bool>>
+multiset<Key, Comparator, Allocator, Augment>::insert_many(Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  result.reserve(sizeof...(args));
+  (result.push_back({insert(std::forward<Args>(args)), true}), ...);
   return result;
 }
 
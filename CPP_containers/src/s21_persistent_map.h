@@ -0,0 +1,619 @@
+#ifndef S21_SRC_PERSISTENT_MAP_H
+#define S21_SRC_PERSISTENT_MAP_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_epoch.h"
+
+namespace s21 {
+
+// Ordered map whose versions share structure. Nodes are immutable once
+// built and reference counted: insert and erase copy only the nodes on the
+// path from the root to the change, plus the few a rebalancing rotation
+// touches, and link the copies to the untouched subtrees. Copying a map is
+// therefore O(1) and yields a snapshot that later changes to either map do
+// not affect. Counts are atomic, so snapshots may be handed to other
+// threads, read there without locks and dropped in any order; a node is
+// freed by whichever version releases it last.
+//
+// Nodes have no parent links, since a node can sit in many trees at once;
+// iterators keep the path they came down instead and only move forward.
+template <typename Key, typename Value, typename Comparator = std::less<Key>>
+class persistent_map {
+  struct node;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using size_type = size_t;
+
+  class const_iterator {
+   public:
+    const_iterator() = default;
+    const value_type& operator*() const;
+    const value_type* operator->() const;
+    const_iterator& operator++();
+    const_iterator operator++(int);
+    bool operator==(const const_iterator& other) const;
+    bool operator!=(const const_iterator& other) const;
+
+   private:
+    friend class persistent_map;
+    // An AVL tree this deep would need more than 10^13 nodes.
+    static constexpr int max_depth = 64;
+
+    void push_left_spine(const node* from);
+
+    const node* path_[max_depth] = {};
+    int depth_ = 0;
+  };
+  using iterator = const_iterator;
+
+  persistent_map();
+  persistent_map(std::initializer_list<value_type> const& items);
+  persistent_map(const persistent_map& other);
+  persistent_map(persistent_map&& other) noexcept;
+  ~persistent_map();
+  persistent_map& operator=(const persistent_map& other);
+  persistent_map& operator=(persistent_map&& other) noexcept;
+
+  // Same as copying; spelled out where the intent is a frozen view.
+  persistent_map snapshot() const;
+
+  const Value& at(const Key& key) const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+
+  void clear();
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(const Key& key, const Value& obj);
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const Value& obj);
+  size_type erase(const Key& key);
+  void swap(persistent_map& other) noexcept;
+
+  const_iterator find(const Key& key) const;
+  bool contains(const Key& key) const;
+  const_iterator lower_bound(const Key& key) const;
+
+ private:
+  struct node {
+    value_type item;
+    const node* left;
+    const node* right;
+    std::int8_t height;
+    mutable std::atomic<size_t> references{1};
+
+    node(const value_type& node_item, const node* node_left,
+         const node* node_right);
+  };
+
+  // Functions taking or returning const node* hand over one reference.
+  static const node* retain(const node* target);
+  static void release(const node* target);
+  static int height(const node* target);
+  static const node* make(const value_type& item, const node* left,
+                          const node* right);
+  static const node* balance(const value_type& item, const node* left,
+                             const node* right);
+
+  const node* insert_path(const node* target, const value_type& value,
+                          bool assign, bool& inserted) const;
+  const node* erase_path(const node* target, const Key& key,
+                         bool& erased) const;
+  static const node* erase_min(const node* target, const node*& minimum);
+  int compare(const Key& key, const node* target) const;
+
+  const node* root_;
+  size_type size_;
+  Comparator tree_comparator;
+};
+
+// A shared slot holding the current version of a persistent_map. Writers
+// store new versions, readers load a snapshot; neither takes a lock. The
+// version a store replaces is released through the epoch domain, so a
+// reader that already read the slot can still take its reference.
+template <typename Key, typename Value, typename Comparator = std::less<Key>>
+class persistent_map_cell {
+ public:
+  using map_type = persistent_map<Key, Value, Comparator>;
+
+  persistent_map_cell();
+  explicit persistent_map_cell(const map_type& version);
+  persistent_map_cell(const persistent_map_cell&) = delete;
+  persistent_map_cell& operator=(const persistent_map_cell&) = delete;
+  ~persistent_map_cell();
+
+  map_type load() const;
+  void store(const map_type& version);
+
+ private:
+  std::atomic<map_type*> current_;
+};
+
+template <typename Key, typename Value, typename Comparator>
+persistent_map<Key, Value, Comparator>::node::node(const value_type& node_item,
+                                                   const node* node_left,
+                                                   const node* node_right)
+    : item(node_item),
+      left(node_left),
+      right(node_right),
+      height(static_cast<std::int8_t>(
+          1 + std::max(persistent_map::height(node_left),
+                       persistent_map::height(node_right)))) {}
+
+template <typename Key, typename Value, typename Comparator>
+const typename persistent_map<Key, Value, Comparator>::value_type&
+persistent_map<Key, Value, Comparator>::const_iterator::operator*() const {
+  return path_[depth_ - 1]->item;
+}
+
+template <typename Key, typename Value, typename Comparator>
+const typename persistent_map<Key, Value, Comparator>::value_type*
+persistent_map<Key, Value, Comparator>::const_iterator::operator->() const {
+  return &path_[depth_ - 1]->item;
+}
+
+// The path holds the current node on top of every ancestor still to be
+// visited, that is, those it lies to the left of.
+template <typename Key, typename Value, typename Comparator>
+typename persistent_map<Key, Value, Comparator>::const_iterator&
+persistent_map<Key, Value, Comparator>::const_iterator::operator++() {
+  const node* current = path_[--depth_];
+  push_left_spine(current->right);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename persistent_map<Key, Value, Comparator>::const_iterator
+persistent_map<Key, Value, Comparator>::const_iterator::operator++(int) {
+  const_iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool persistent_map<Key, Value, Comparator>::const_iterator::operator==(
+    const const_iterator& other) const {
+  if (depth_ == 0 || other.depth_ == 0) {
+    return depth_ == other.depth_;
+  }
+  return path_[depth_ - 1] == other.path_[other.depth_ - 1];
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool persistent_map<Key, Value, Comparator>::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return !(*this == other);
+}
+
+template <typename Key, typename Value, typename Comparator>
+void persistent_map<Key, Value, Comparator>::const_iterator::push_left_spine(
+    const node* from) {
+  for (; from != nullptr; from = from->left) {
+    path_[depth_++] = from;
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+persistent_map<Key, Value, Comparator>::persistent_map()
+    : root_(nullptr), size_(0) {}
+
+template <typename Key, typename Value, typename Comparator>
+persistent_map<Key, Value, Comparator>::persistent_map(
+    std::initializer_list<value_type> const& items)
+    : persistent_map() {
+  for (const value_type& item : items) {
+    insert(item);
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+persistent_map<Key, Value, Comparator>::persistent_map(
+    const persistent_map& other)
+    : root_(retain(other.root_)),
+      size_(other.size_),
+      tree_comparator(other.tree_comparator) {}
+
+template <typename Key, typename Value, typename Comparator>
+persistent_map<Key, Value, Comparator>::persistent_map(
+    persistent_map&& other) noexcept
+    : root_(other.root_),
+      size_(other.size_),
+      tree_comparator(other.tree_comparator) {
+  other.root_ = nullptr;
+  other.size_ = 0;
+}
+
+template <typename Key, typename Value, typename Comparator>
+persistent_map<Key, Value, Comparator>::~persistent_map() {
+  release(root_);
+}
+
+template <typename Key, typename Value, typename Comparator>
+persistent_map<Key, Value, Comparator>&
+persistent_map<Key, Value, Comparator>::operator=(
+    const persistent_map& other) {
+  persistent_map copy(other);
+  swap(copy);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+persistent_map<Key, Value, Comparator>&
+persistent_map<Key, Value, Comparator>::operator=(
+    persistent_map&& other) noexcept {
+  persistent_map moved(std::move(other));
+  swap(moved);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+persistent_map<Key, Value, Comparator>
+persistent_map<Key, Value, Comparator>::snapshot() const {
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+const Value& persistent_map<Key, Value, Comparator>::at(const Key& key) const {
+  const_iterator found = find(key);
+  if (found == end()) {
+    throw std::out_of_range("There is no element with this key");
+  }
+  return found->second;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename persistent_map<Key, Value, Comparator>::const_iterator
+persistent_map<Key, Value, Comparator>::begin() const {
+  const_iterator first;
+  first.push_left_spine(root_);
+  return first;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename persistent_map<Key, Value, Comparator>::const_iterator
+persistent_map<Key, Value, Comparator>::end() const {
+  return const_iterator();
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool persistent_map<Key, Value, Comparator>::empty() const {
+  return size_ == 0;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename persistent_map<Key, Value, Comparator>::size_type
+persistent_map<Key, Value, Comparator>::size() const {
+  return size_;
+}
+
+template <typename Key, typename Value, typename Comparator>
+void persistent_map<Key, Value, Comparator>::clear() {
+  release(root_);
+  root_ = nullptr;
+  size_ = 0;
+}
+
+template <typename Key, typename Value, typename Comparator>
+std::pair<typename persistent_map<Key, Value, Comparator>::iterator, bool>
+persistent_map<Key, Value, Comparator>::insert(const value_type& value) {
+  bool inserted = false;
+  const node* updated = insert_path(root_, value, false, inserted);
+  if (inserted) {
+    release(root_);
+    root_ = updated;
+    ++size_;
+  }
+  return {find(value.first), inserted};
+}
+
+template <typename Key, typename Value, typename Comparator>
+std::pair<typename persistent_map<Key, Value, Comparator>::iterator, bool>
+persistent_map<Key, Value, Comparator>::insert(const Key& key,
+                                               const Value& obj) {
+  return insert(value_type(key, obj));
+}
+
+template <typename Key, typename Value, typename Comparator>
+std::pair<typename persistent_map<Key, Value, Comparator>::iterator, bool>
+persistent_map<Key, Value, Comparator>::insert_or_assign(const Key& key,
+                                                         const Value& obj) {
+  bool inserted = false;
+  const node* updated = insert_path(root_, value_type(key, obj), true,
+                                    inserted);
+  release(root_);
+  root_ = updated;
+  size_ += inserted;
+  return {find(key), inserted};
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename persistent_map<Key, Value, Comparator>::size_type
+persistent_map<Key, Value, Comparator>::erase(const Key& key) {
+  bool erased = false;
+  const node* updated = erase_path(root_, key, erased);
+  if (!erased) {
+    return 0;
+  }
+  release(root_);
+  root_ = updated;
+  --size_;
+  return 1;
+}
+
+template <typename Key, typename Value, typename Comparator>
+void persistent_map<Key, Value, Comparator>::swap(
+    persistent_map& other) noexcept {
+  std::swap(root_, other.root_);
+  std::swap(size_, other.size_);
+  std::swap(tree_comparator, other.tree_comparator);
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename persistent_map<Key, Value, Comparator>::const_iterator
+persistent_map<Key, Value, Comparator>::find(const Key& key) const {
+  const_iterator found = lower_bound(key);
+  if (found != end() && tree_comparator(key, found->first)) {
+    return end();
+  }
+  return found;
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool persistent_map<Key, Value, Comparator>::contains(const Key& key) const {
+  const node* current = root_;
+  while (current != nullptr) {
+    int direction = compare(key, current);
+    if (direction == 0) {
+      return true;
+    }
+    current = direction < 0 ? current->left : current->right;
+  }
+  return false;
+}
+
+// Keeps every node the search turns left at: those are the ancestors the
+// iterator still has to visit.
+template <typename Key, typename Value, typename Comparator>
+typename persistent_map<Key, Value, Comparator>::const_iterator
+persistent_map<Key, Value, Comparator>::lower_bound(const Key& key) const {
+  const_iterator result;
+  for (const node* current = root_; current != nullptr;) {
+    if (tree_comparator(current->item.first, key)) {
+      current = current->right;
+    } else {
+      result.path_[result.depth_++] = current;
+      current = current->left;
+    }
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Comparator>
+const typename persistent_map<Key, Value, Comparator>::node*
+persistent_map<Key, Value, Comparator>::retain(const node* target) {
+  if (target != nullptr) {
+    target->references.fetch_add(1, std::memory_order_relaxed);
+  }
+  return target;
+}
+
+// The last owner frees the node and drops its references to the children.
+template <typename Key, typename Value, typename Comparator>
+void persistent_map<Key, Value, Comparator>::release(const node* target) {
+  if (target != nullptr &&
+      target->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    release(target->left);
+    release(target->right);
+    delete target;
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+int persistent_map<Key, Value, Comparator>::height(const node* target) {
+  return target != nullptr ? target->height : 0;
+}
+
+template <typename Key, typename Value, typename Comparator>
+const typename persistent_map<Key, Value, Comparator>::node*
+persistent_map<Key, Value, Comparator>::make(const value_type& item,
+                                             const node* left,
+                                             const node* right) {
+  try {
+    return new node(item, left, right);
+  } catch (...) {
+    release(left);
+    release(right);
+    throw;
+  }
+}
+
+// Builds a node for item over left and right, rotating when their heights
+// differ by two. Rotated nodes are rebuilt from their parts rather than
+// modified, since the originals may be shared.
+template <typename Key, typename Value, typename Comparator>
+const typename persistent_map<Key, Value, Comparator>::node*
+persistent_map<Key, Value, Comparator>::balance(const value_type& item,
+                                                const node* left,
+                                                const node* right) {
+  int left_height = height(left);
+  int right_height = height(right);
+  if (left_height <= right_height + 1 && right_height <= left_height + 1) {
+    return make(item, left, right);
+  }
+  bool left_heavy = left_height > right_height;
+  const node* heavy = left_heavy ? left : right;
+  const node* light = left_heavy ? right : left;
+  const node* outer = left_heavy ? heavy->left : heavy->right;
+  const node* inner = left_heavy ? heavy->right : heavy->left;
+  const node* result;
+  try {
+    if (height(outer) >= height(inner)) {
+      const node* lowered =
+          left_heavy ? make(item, retain(inner), std::exchange(light, nullptr))
+                     : make(item, std::exchange(light, nullptr), retain(inner));
+      result = left_heavy ? make(heavy->item, retain(outer), lowered)
+                          : make(heavy->item, lowered, retain(outer));
+    } else {
+      const node* lowered =
+          left_heavy
+              ? make(item, retain(inner->right), std::exchange(light, nullptr))
+              : make(item, std::exchange(light, nullptr), retain(inner->left));
+      const node* kept;
+      try {
+        kept = left_heavy
+                   ? make(heavy->item, retain(outer), retain(inner->left))
+                   : make(heavy->item, retain(inner->right), retain(outer));
+      } catch (...) {
+        release(lowered);
+        throw;
+      }
+      result = left_heavy ? make(inner->item, kept, lowered)
+                          : make(inner->item, lowered, kept);
+    }
+  } catch (...) {
+    release(heavy);
+    release(light);
+    throw;
+  }
+  release(heavy);
+  return result;
+}
+
+// Returns a new reference to the updated subtree. inserted tells whether
+// the key was new; when it was present and assign is false nothing is
+// built and the result is nullptr.
+template <typename Key, typename Value, typename Comparator>
+const typename persistent_map<Key, Value, Comparator>::node*
+persistent_map<Key, Value, Comparator>::insert_path(const node* target,
+                                                    const value_type& value,
+                                                    bool assign,
+                                                    bool& inserted) const {
+  if (target == nullptr) {
+    inserted = true;
+    return make(value, nullptr, nullptr);
+  }
+  int direction = compare(value.first, target);
+  if (direction == 0) {
+    if (!assign) {
+      return nullptr;
+    }
+    value_type assigned(target->item.first, value.second);
+    return make(assigned, retain(target->left), retain(target->right));
+  }
+  if (direction < 0) {
+    const node* left = insert_path(target->left, value, assign, inserted);
+    if (left == nullptr) {
+      return nullptr;
+    }
+    return balance(target->item, left, retain(target->right));
+  }
+  const node* right = insert_path(target->right, value, assign, inserted);
+  if (right == nullptr) {
+    return nullptr;
+  }
+  return balance(target->item, retain(target->left), right);
+}
+
+// Returns a new reference to the subtree without key; the result is only
+// meaningful when erased is set.
+template <typename Key, typename Value, typename Comparator>
+const typename persistent_map<Key, Value, Comparator>::node*
+persistent_map<Key, Value, Comparator>::erase_path(const node* target,
+                                                   const Key& key,
+                                                   bool& erased) const {
+  if (target == nullptr) {
+    return nullptr;
+  }
+  int direction = compare(key, target);
+  if (direction < 0) {
+    const node* left = erase_path(target->left, key, erased);
+    return erased ? balance(target->item, left, retain(target->right))
+                  : nullptr;
+  }
+  if (direction > 0) {
+    const node* right = erase_path(target->right, key, erased);
+    return erased ? balance(target->item, retain(target->left), right)
+                  : nullptr;
+  }
+  erased = true;
+  if (target->left == nullptr || target->right == nullptr) {
+    return retain(target->left != nullptr ? target->left : target->right);
+  }
+  const node* minimum = nullptr;
+  const node* right = erase_min(target->right, minimum);
+  return balance(minimum->item, retain(target->left), right);
+}
+
+// minimum is left pointing at the removed node, which stays alive through
+// the tree being updated.
+template <typename Key, typename Value, typename Comparator>
+const typename persistent_map<Key, Value, Comparator>::node*
+persistent_map<Key, Value, Comparator>::erase_min(const node* target,
+                                                  const node*& minimum) {
+  if (target->left == nullptr) {
+    minimum = target;
+    return retain(target->right);
+  }
+  const node* left = erase_min(target->left, minimum);
+  return balance(target->item, left, retain(target->right));
+}
+
+template <typename Key, typename Value, typename Comparator>
+int persistent_map<Key, Value, Comparator>::compare(const Key& key,
+                                                    const node* target) const {
+  if (tree_comparator(key, target->item.first)) {
+    return -1;
+  }
+  return tree_comparator(target->item.first, key) ? 1 : 0;
+}
+
+template <typename Key, typename Value, typename Comparator>
+persistent_map_cell<Key, Value, Comparator>::persistent_map_cell()
+    : current_(new map_type()) {}
+
+template <typename Key, typename Value, typename Comparator>
+persistent_map_cell<Key, Value, Comparator>::persistent_map_cell(
+    const map_type& version)
+    : current_(new map_type(version)) {}
+
+// Destruction must not overlap with load() or store().
+template <typename Key, typename Value, typename Comparator>
+persistent_map_cell<Key, Value, Comparator>::~persistent_map_cell() {
+  delete current_.load();
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename persistent_map_cell<Key, Value, Comparator>::map_type
+persistent_map_cell<Key, Value, Comparator>::load() const {
+  epoch_domain::guard pin;
+  return *current_.load(std::memory_order_acquire);
+}
+
+template <typename Key, typename Value, typename Comparator>
+void persistent_map_cell<Key, Value, Comparator>::store(
+    const map_type& version) {
+  map_type* published = new map_type(version);
+  epoch_domain::guard pin;
+  map_type* replaced =
+      current_.exchange(published, std::memory_order_acq_rel);
+  epoch_domain::instance().retire(replaced);
+}
+
+}  // namespace s21
+
+#endif
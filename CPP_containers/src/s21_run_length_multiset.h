@@ -0,0 +1,437 @@
+#ifndef S21_SRC_RUN_LENGTH_MULTISET_H
+#define S21_SRC_RUN_LENGTH_MULTISET_H
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "AVLtree.h"
+
+namespace s21 {
+
+// Multiset for heavily duplicated data: one AVLtree node per distinct key
+// holding how many copies there are, so the tree and its memory grow with
+// the number of distinct keys instead of the number of elements. insert,
+// erase and count cost O(log distinct). Iteration still yields every copy,
+// stepping through a run before moving to the next node. Copies of a key
+// are interchangeable, so erase(pos) drops one copy of *pos.
+template <typename Key, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, size_t>>>
+class run_length_multiset
+    : private AVLtree<Key, size_t, Comparator, Allocator> {
+  using tree_type = AVLtree<Key, size_t, Comparator, Allocator>;
+  using node = typename tree_type::node;
+
+ public:
+  class run_iterator;
+  using key_type = Key;
+  using value_type = Key;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using iterator = run_iterator;
+  using const_iterator = run_iterator;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  // A run (tree node) and which copy inside it.
+  class run_iterator {
+   public:
+    friend run_length_multiset;
+    run_iterator() = default;
+
+    run_iterator& operator++();
+    run_iterator operator++(int);
+    run_iterator& operator--();
+    run_iterator operator--(int);
+
+    bool operator!=(const run_iterator& other) const;
+    bool operator==(const run_iterator& other) const;
+
+    const_reference operator*();
+    const value_type* operator->();
+
+   private:
+    run_iterator(const typename tree_type::iterator& run, size_type copy);
+
+    typename tree_type::iterator run_;
+    size_type copy_ = 0;
+  };
+
+  run_length_multiset();
+  run_length_multiset(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  run_length_multiset(InputIt first, InputIt last);
+  run_length_multiset(const run_length_multiset& ms);
+  run_length_multiset(run_length_multiset&& ms);
+  ~run_length_multiset() = default;
+  run_length_multiset& operator=(const run_length_multiset& ms);
+  run_length_multiset& operator=(run_length_multiset&& ms);
+
+  iterator begin() const;
+  iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type distinct_size() const;
+  size_type max_size() const;
+
+  void clear();
+  iterator insert(const value_type& value);
+  iterator insert(const value_type& value, size_type copies);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  void insert(InputIt first, InputIt last);
+  iterator erase(iterator pos);
+  size_type erase(const Key& key);
+  void swap(run_length_multiset& other);
+  void merge(run_length_multiset& other);
+
+  size_type count(const Key& key) const;
+  iterator find(const Key& key) const;
+  bool contains(const Key& key) const;
+  std::pair<iterator, iterator> equal_range(const Key& key) const;
+  iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key) const;
+
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+
+ private:
+  node* find_run(const Key& key) const;
+  iterator run_start(node* run) const;
+
+  size_type copies_ = 0;
+};
+
+//----iterator-logic----//
+
+template <typename Key, typename Comparator, typename Allocator>
+run_length_multiset<Key, Comparator, Allocator>::run_iterator::run_iterator(
+    const typename tree_type::iterator& run, size_type copy)
+    : run_(run), copy_(copy) {}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::run_iterator&
+run_length_multiset<Key, Comparator, Allocator>::run_iterator::operator++() {
+  if (++copy_ == run_->second) {
+    ++run_;
+    copy_ = 0;
+  }
+  return *this;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::run_iterator
+run_length_multiset<Key, Comparator, Allocator>::run_iterator::operator++(
+    int) {
+  run_iterator copy = *this;
+  ++*this;
+  return copy;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::run_iterator&
+run_length_multiset<Key, Comparator, Allocator>::run_iterator::operator--() {
+  if (copy_ > 0) {
+    --copy_;
+  } else {
+    --run_;
+    copy_ = run_->second - 1;
+  }
+  return *this;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::run_iterator
+run_length_multiset<Key, Comparator, Allocator>::run_iterator::operator--(
+    int) {
+  run_iterator copy = *this;
+  --*this;
+  return copy;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+bool run_length_multiset<Key, Comparator, Allocator>::run_iterator::operator!=(
+    const run_iterator& other) const {
+  return !(*this == other);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+bool run_length_multiset<Key, Comparator, Allocator>::run_iterator::operator==(
+    const run_iterator& other) const {
+  return run_ == other.run_ && copy_ == other.copy_;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::const_reference
+run_length_multiset<Key, Comparator, Allocator>::run_iterator::operator*() {
+  return run_->first;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+const typename run_length_multiset<Key, Comparator, Allocator>::value_type*
+run_length_multiset<Key, Comparator, Allocator>::run_iterator::operator->() {
+  return &run_->first;
+}
+
+//----multiset-logic----//
+
+template <typename Key, typename Comparator, typename Allocator>
+run_length_multiset<Key, Comparator, Allocator>::run_length_multiset()
+    : tree_type() {}
+
+template <typename Key, typename Comparator, typename Allocator>
+run_length_multiset<Key, Comparator, Allocator>::run_length_multiset(
+    std::initializer_list<value_type> const& items)
+    : run_length_multiset() {
+  insert(items.begin(), items.end());
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+template <typename InputIt, typename>
+run_length_multiset<Key, Comparator, Allocator>::run_length_multiset(
+    InputIt first, InputIt last)
+    : run_length_multiset() {
+  insert(first, last);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+run_length_multiset<Key, Comparator, Allocator>::run_length_multiset(
+    const run_length_multiset& ms)
+    : tree_type(ms), copies_(ms.copies_) {}
+
+template <typename Key, typename Comparator, typename Allocator>
+run_length_multiset<Key, Comparator, Allocator>::run_length_multiset(
+    run_length_multiset&& ms)
+    : tree_type(std::move(ms)), copies_(std::exchange(ms.copies_, 0)) {}
+
+template <typename Key, typename Comparator, typename Allocator>
+run_length_multiset<Key, Comparator, Allocator>&
+run_length_multiset<Key, Comparator, Allocator>::operator=(
+    const run_length_multiset& ms) {
+  tree_type::operator=(ms);
+  copies_ = ms.copies_;
+  return *this;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+run_length_multiset<Key, Comparator, Allocator>&
+run_length_multiset<Key, Comparator, Allocator>::operator=(
+    run_length_multiset&& ms) {
+  if (this != &ms) {
+    tree_type::operator=(std::move(ms));
+    copies_ = std::exchange(ms.copies_, 0);
+  }
+  return *this;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::iterator
+run_length_multiset<Key, Comparator, Allocator>::begin() const {
+  return run_start(tree_type::root->next);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::iterator
+run_length_multiset<Key, Comparator, Allocator>::end() const {
+  return run_start(static_cast<node*>(tree_type::root));
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+bool run_length_multiset<Key, Comparator, Allocator>::empty() const {
+  return copies_ == 0;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::size_type
+run_length_multiset<Key, Comparator, Allocator>::size() const {
+  return copies_;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::size_type
+run_length_multiset<Key, Comparator, Allocator>::distinct_size() const {
+  return tree_type::tree_size();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::size_type
+run_length_multiset<Key, Comparator, Allocator>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+void run_length_multiset<Key, Comparator, Allocator>::clear() {
+  tree_type::tree_clear();
+  copies_ = 0;
+}
+
+// Returns the last copy of value, which is the one just added.
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::iterator
+run_length_multiset<Key, Comparator, Allocator>::insert(
+    const value_type& value) {
+  return insert(value, 1);
+}
+
+// Adds copies of value at once. A repeated key only bumps its count after
+// a plain descent; the insert path runs just for a new key. With copies == 0
+// nothing changes and the result is end() unless value is already present.
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::iterator
+run_length_multiset<Key, Comparator, Allocator>::insert(
+    const value_type& value, size_type copies) {
+  node* run = find_run(value);
+  if (copies == 0) {
+    return run == nullptr ? end() : run_start(run);
+  }
+  typename tree_type::iterator found(run);
+  if (run == nullptr) {
+    found = tree_type::tree_try_emplace(value, size_type(0)).first;
+  }
+  size_type& count = (*found).second;
+  count += copies;
+  copies_ += copies;
+  return iterator(found, count - 1);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+template <typename InputIt, typename>
+void run_length_multiset<Key, Comparator, Allocator>::insert(InputIt first,
+                                                             InputIt last) {
+  for (; first != last; ++first) {
+    insert(*first);
+  }
+}
+
+// Drops the copy at pos; the iterator returned points at what followed it.
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::iterator
+run_length_multiset<Key, Comparator, Allocator>::erase(iterator pos) {
+  size_type& count = (*pos.run_).second;
+  --copies_;
+  if (count > 1) {
+    --count;
+    if (pos.copy_ < count) {
+      return pos;
+    }
+    ++pos.run_;
+    return iterator(pos.run_, 0);
+  }
+  return iterator(tree_type::tree_erase(pos.run_), 0);
+}
+
+// Drops every copy of key and returns how many there were.
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::size_type
+run_length_multiset<Key, Comparator, Allocator>::erase(const Key& key) {
+  node* run = find_run(key);
+  if (run == nullptr) {
+    return 0;
+  }
+  size_type count = run->data_.second;
+  tree_type::tree_erase(typename tree_type::iterator(run));
+  copies_ -= count;
+  return count;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+void run_length_multiset<Key, Comparator, Allocator>::swap(
+    run_length_multiset& other) {
+  tree_type::tree_swap(other);
+  std::swap(copies_, other.copies_);
+}
+
+// Adds each run of other as a single count, then empties other.
+template <typename Key, typename Comparator, typename Allocator>
+void run_length_multiset<Key, Comparator, Allocator>::merge(
+    run_length_multiset& other) {
+  if (this == &other) {
+    return;
+  }
+  for (auto run = other.tree_begin(); run != other.tree_end(); ++run) {
+    insert((*run).first, (*run).second);
+  }
+  other.clear();
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::size_type
+run_length_multiset<Key, Comparator, Allocator>::count(const Key& key) const {
+  node* run = find_run(key);
+  return run == nullptr ? 0 : run->data_.second;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::iterator
+run_length_multiset<Key, Comparator, Allocator>::find(const Key& key) const {
+  node* run = find_run(key);
+  return run == nullptr ? end() : run_start(run);
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+bool run_length_multiset<Key, Comparator, Allocator>::contains(
+    const Key& key) const {
+  return find_run(key) != nullptr;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+std::pair<typename run_length_multiset<Key, Comparator, Allocator>::iterator,
+          typename run_length_multiset<Key, Comparator, Allocator>::iterator>
+run_length_multiset<Key, Comparator, Allocator>::equal_range(
+    const Key& key) const {
+  return {lower_bound(key), upper_bound(key)};
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::iterator
+run_length_multiset<Key, Comparator, Allocator>::lower_bound(
+    const Key& key) const {
+  node* sentinel = static_cast<node*>(tree_type::root);
+  return run_start(
+      tree_type::lower_bound_node(tree_type::tree_root(), sentinel, key));
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::iterator
+run_length_multiset<Key, Comparator, Allocator>::upper_bound(
+    const Key& key) const {
+  node* sentinel = static_cast<node*>(tree_type::root);
+  return run_start(
+      tree_type::upper_bound_node(tree_type::tree_root(), sentinel, key));
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+template <class... Args>
+std::vector<std::pair<
+    typename run_length_multiset<Key, Comparator, Allocator>::iterator, bool>>
+run_length_multiset<Key, Comparator, Allocator>::insert_many(Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  result.reserve(sizeof...(args));
+  (result.emplace_back(insert(std::forward<Args>(args)), true), ...);
+  return result;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::node*
+run_length_multiset<Key, Comparator, Allocator>::find_run(
+    const Key& key) const {
+  node* sentinel = static_cast<node*>(tree_type::root);
+  node* run =
+      tree_type::lower_bound_node(tree_type::tree_root(), sentinel, key);
+  if (run == sentinel || tree_type::tree_comparator(key, run->data_.first)) {
+    return nullptr;
+  }
+  return run;
+}
+
+template <typename Key, typename Comparator, typename Allocator>
+typename run_length_multiset<Key, Comparator, Allocator>::iterator
+run_length_multiset<Key, Comparator, Allocator>::run_start(node* run) const {
+  return iterator(typename tree_type::iterator(run), 0);
+}
+
+}  // namespace s21
+
+#endif
@@ -1,14 +1,21 @@
 #ifndef S21_SRC_SET_H
 #define S21_SRC_SET_H
 
+#include <string>
+#include <type_traits>
 #include <vector>
 
 #include "AVLtree.h"
+#include "s21_frozen_set.h"
 
 namespace s21 {
 
-template <typename Key, typename Comparator = std::less<Key>>
-class set : private AVLtree<Key, Key, Comparator> {
+template <typename Key, typename Comparator = std::less<Key>,
+          typename Allocator = std::allocator<Key>,
+          typename Augment = no_augment>
+class set : private AVLtree<Key, void, Comparator, Allocator, Augment> {
+  using tree_type = AVLtree<Key, void, Comparator, Allocator, Augment>;
+
  public:
   class set_iterator;
   class const_set_iterator;
@@ -21,32 +28,42 @@ class set : private AVLtree<Key, Key, Comparator> {
   using iterator = set_iterator;
   using const_iterator = const_set_iterator;
   using size_type = size_t;
+  using allocator_type = Allocator;
+  using node_type = typename tree_type::node_handle;
+  using insert_return_type =
+      typename tree_type::template node_insert_result<iterator>;
 
-  class set_iterator : public AVLtree<Key, Key, Comparator>::iterator {
+  class set_iterator : public tree_type::iterator {
    public:
     set_iterator() = default;
-    set_iterator(const typename AVLtree<Key, Key, Comparator>::iterator& other);
-    set_iterator(typename AVLtree<Key, Key, Comparator>::node* node);
-    reference operator*();
+    set_iterator(const typename tree_type::iterator& other);
+    set_iterator(typename tree_type::node* node);
+    // The element is the key the node is ordered by, so like std::set's
+    // iterators this one only reads it.
+    const_reference operator*();
+    const_pointer operator->();
   };
 
-  class const_set_iterator
-      : public AVLtree<Key, Key, Comparator>::const_iterator {
+  class const_set_iterator : public tree_type::const_iterator {
    public:
     const_set_iterator() = default;
-    const_set_iterator(
-        const typename AVLtree<Key, Key, Comparator>::const_iterator& other);
-    const_set_iterator(typename AVLtree<Key, Key, Comparator>::node* node);
+    const_set_iterator(const typename tree_type::const_iterator& other);
+    const_set_iterator(typename tree_type::node* node);
     const_reference operator*();
   };
 
   set();
   set(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  set(InputIt first, InputIt last);
   set(const set& s);
   set(set&& s);
   ~set() = default;
   set& operator=(const set& s);
   set& operator=(set&& s);
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
 
   iterator begin();
   const_iterator begin() const;
@@ -56,175 +73,504 @@ class set : private AVLtree<Key, Key, Comparator> {
   bool empty() const;
   size_type size() const;
   size_type max_size() const;
+  allocator_type get_allocator() const;
 
   void clear();
   std::pair<iterator, bool> insert(const value_type& value);
-  void erase(iterator pos);
+  std::pair<iterator, bool> insert(value_type&& value);
+  insert_return_type insert(node_type&& handle);
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  iterator erase(iterator pos);
+  iterator erase(iterator first, iterator last);
+  size_type erase(const Key& key);
   void swap(set& other);
   void merge(set& other);
+  node_type extract(iterator pos);
+  node_type extract(const Key& key);
+  set split(const Key& key);
+  void join(set& greater);
+  frozen_set<Key, Comparator> freeze() const;
 
   iterator find(const Key& key);
+  template <typename K, typename = transparent_key_t<Comparator, K>>
+  iterator find(const K& key);
   bool contains(const Key& key) const;
+  template <typename K, typename = transparent_key_t<Comparator, K>>
+  bool contains(const K& key) const;
+  std::vector<iterator> find_many(const Key* keys, size_type count);
+  std::vector<bool> contains_many(const Key* keys, size_type count) const;
+  iterator nth(size_type index);
+  const_iterator nth(size_type index) const;
+  size_type rank(const Key& key) const;
+  iterator lower_bound(const Key& key);
+  const_iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key);
+  const_iterator upper_bound(const Key& key) const;
+  template <typename Function>
+  void for_each_in_range(const Key& lo, const Key& hi, Function fn) const;
+  size_type erase_range(const Key& lo, const Key& hi);
 
   template <class... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+
+  template <typename K, typename C, typename A, typename G>
+  friend set<K, C, A, G> set_union(set<K, C, A, G> lhs, set<K, C, A, G> rhs);
+  template <typename K, typename C, typename A, typename G>
+  friend set<K, C, A, G> set_intersection(set<K, C, A, G> lhs,
+                                       const set<K, C, A, G>& rhs);
+  template <typename K, typename C, typename A, typename G>
+  friend set<K, C, A, G> set_difference(set<K, C, A, G> lhs,
+                                     const set<K, C, A, G>& rhs);
+  // Defined in s21_snapshot.h, so only code that loads snapshots pulls in
+  // the POSIX headers they need.
+  template <typename K, typename C, typename A, typename G>
+  friend void load(set<K, C, A, G>& s, const std::string& path);
 };
 
-template <typename Key, typename Comparator>
-set<Key, Comparator>::set() : AVLtree<Key, Key, Comparator>() {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator, Augment>::set() : tree_type() {}
 
-template <typename Key, typename Comparator>
-set<Key, Comparator>::set(std::initializer_list<value_type> const& items)
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator, Augment>::set(
+    std::initializer_list<value_type> const& items)
     : set() {
-  for (auto item : items) {
-    AVLtree<Key, Key, Comparator>::tree_unique_insert(item, item);
-  }
+  assign(items.begin(), items.end());
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename InputIt, typename>
+set<Key, Comparator, Allocator, Augment>::set(InputIt first, InputIt last)
+    : set() {
+  assign(first, last);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename InputIt>
+void set<Key, Comparator, Allocator, Augment>::assign(InputIt first,
+                                                      InputIt last) {
+  tree_type::tree_assign(
+      first, last, true,
+      [](auto& emplace, const auto& item) { return emplace(item); });
 }
 
-template <typename Key, typename Comparator>
-set<Key, Comparator>::set(const set& s) : AVLtree<Key, Key, Comparator>(s) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator, Augment>::set(const set& s) : tree_type(s) {}
 
-template <typename Key, typename Comparator>
-set<Key, Comparator>::set(set&& s)
-    : AVLtree<Key, Key, Comparator>(std::move(s)) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator, Augment>::set(set&& s)
+    : tree_type(std::move(s)) {}
 
-template <typename Key, typename Comparator>
-set<Key, Comparator>& set<Key, Comparator>::operator=(const set& s) {
-  AVLtree<Key, Key, Comparator>::operator=(s);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator, Augment>&
+set<Key, Comparator, Allocator, Augment>::operator=(const set& s) {
+  tree_type::operator=(s);
   return *this;
 }
 
-template <typename Key, typename Comparator>
-set<Key, Comparator>& set<Key, Comparator>::operator=(set&& s) {
-  AVLtree<Key, Key, Comparator>::operator=(std::move(s));
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator, Augment>&
+set<Key, Comparator, Allocator, Augment>::operator=(set&& s) {
+  tree_type::operator=(std::move(s));
   return *this;
 }
 
-template <typename Key, typename Comparator>
-typename set<Key, Comparator>::iterator set<Key, Comparator>::begin() {
-  return set_iterator(AVLtree<Key, Key, Comparator>::root->parent_);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::iterator
+set<Key, Comparator, Allocator, Augment>::begin() {
+  return set_iterator(tree_type::root->next);
 }
 
-template <typename Key, typename Comparator>
-typename set<Key, Comparator>::const_iterator set<Key, Comparator>::begin()
-    const {
-  return const_set_iterator(AVLtree<Key, Key, Comparator>::root->parent_);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::const_iterator
+set<Key, Comparator, Allocator, Augment>::begin() const {
+  return const_set_iterator(tree_type::root->next);
 }
 
-template <typename Key, typename Comparator>
-typename set<Key, Comparator>::iterator set<Key, Comparator>::end() {
-  return set_iterator(
-      static_cast<typename AVLtree<Key, Key, Comparator>::node*>(
-          AVLtree<Key, Key, Comparator>::root));
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::iterator
+set<Key, Comparator, Allocator, Augment>::end() {
+  return set_iterator(static_cast<typename tree_type::node*>(tree_type::root));
 }
 
-template <typename Key, typename Comparator>
-typename set<Key, Comparator>::const_iterator set<Key, Comparator>::end()
-    const {
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::const_iterator
+set<Key, Comparator, Allocator, Augment>::end() const {
   return const_set_iterator(
-      static_cast<typename AVLtree<Key, Key, Comparator>::node*>(
-          AVLtree<Key, Key, Comparator>::root));
+      static_cast<typename tree_type::node*>(tree_type::root));
 }
 
-template <typename Key, typename Comparator>
-bool set<Key, Comparator>::empty() const {
-  return AVLtree<Key, Key, Comparator>::tree_empty();
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+bool set<Key, Comparator, Allocator, Augment>::empty() const {
+  return tree_type::tree_empty();
 }
 
-template <typename Key, typename Comparator>
-typename set<Key, Comparator>::size_type set<Key, Comparator>::size() const {
-  return AVLtree<Key, Key, Comparator>::tree_size();
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::size_type
+set<Key, Comparator, Allocator, Augment>::size() const {
+  return tree_type::tree_size();
 }
 
-template <typename Key, typename Comparator>
-typename set<Key, Comparator>::size_type set<Key, Comparator>::max_size()
-    const {
-  return AVLtree<Key, Key, Comparator>::tree_max_size();
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::size_type
+set<Key, Comparator, Allocator, Augment>::max_size() const {
+  return tree_type::tree_max_size();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename set<Key, Comparator, Allocator, Augment>::allocator_type
+set<Key, Comparator, Allocator, Augment>::get_allocator() const {
+  return tree_type::get_allocator();
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void set<Key, Comparator, Allocator, Augment>::clear() {
+  tree_type::tree_clear();
 }
 
-template <typename Key, typename Comparator>
-void set<Key, Comparator>::clear() {
-  AVLtree<Key, Key, Comparator>::tree_clear();
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+std::pair<typename set<Key, Comparator, Allocator, Augment>::iterator, bool>
+set<Key, Comparator, Allocator, Augment>::insert(const value_type& value) {
+  std::pair<set_iterator, bool> result =
+      tree_type::tree_unique_insert(value);
+  return result;
 }
 
-template <typename Key, typename Comparator>
-std::pair<typename set<Key, Comparator>::iterator, bool>
-set<Key, Comparator>::insert(const value_type& value) {
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+std::pair<typename set<Key, Comparator, Allocator, Augment>::iterator, bool>
+set<Key, Comparator, Allocator, Augment>::insert(value_type&& value) {
   std::pair<set_iterator, bool> result =
-      AVLtree<Key, Key, Comparator>::tree_unique_insert(value, value);
+      tree_type::tree_unique_insert(std::move(value));
   return result;
 }
 
-template <typename Key, typename Comparator>
-void set<Key, Comparator>::erase(iterator pos) {
-  AVLtree<Key, Key, Comparator>::tree_erase(pos);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename set<Key, Comparator, Allocator, Augment>::insert_return_type
+set<Key, Comparator, Allocator, Augment>::insert(node_type&& handle) {
+  std::pair<typename tree_type::iterator, bool> result =
+      tree_type::tree_unique_insert(handle);
+  return {iterator(result.first), result.second, std::move(handle)};
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <class... Args>
+std::pair<typename set<Key, Comparator, Allocator, Augment>::iterator, bool>
+set<Key, Comparator, Allocator, Augment>::emplace(Args&&... args) {
+  return insert(value_type(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::iterator
+set<Key, Comparator, Allocator, Augment>::erase(iterator pos) {
+  return tree_type::tree_erase(pos);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::iterator
+set<Key, Comparator, Allocator, Augment>::erase(iterator first,
+                                                iterator last) {
+  return tree_type::tree_erase(first, last);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::size_type
+set<Key, Comparator, Allocator, Augment>::erase(const Key& key) {
+  return tree_type::tree_erase(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void set<Key, Comparator, Allocator, Augment>::swap(set& other) {
+  tree_type::tree_swap(other);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void set<Key, Comparator, Allocator, Augment>::merge(set& other) {
+  tree_type::tree_merge_unique(other);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename set<Key, Comparator, Allocator, Augment>::node_type
+set<Key, Comparator, Allocator, Augment>::extract(iterator pos) {
+  return tree_type::tree_extract(pos);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename set<Key, Comparator, Allocator, Augment>::node_type
+set<Key, Comparator, Allocator, Augment>::extract(const Key& key) {
+  return tree_type::tree_extract(key);
+}
+
+// Moves every key not less than key into the returned set in O(log n).
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator, Augment>
+set<Key, Comparator, Allocator, Augment>::split(const Key& key) {
+  set greater;
+  tree_type::tree_split(key, greater);
+  return greater;
+}
+
+// Appends greater, whose keys must all follow ours, in O(log n); otherwise
+// it behaves like merge().
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void set<Key, Comparator, Allocator, Augment>::join(set& greater) {
+  tree_type::tree_join(greater, true);
+}
+
+// Copies the keys into a read-only frozen_set with faster lookups; the set
+// itself is left as it was.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+frozen_set<Key, Comparator> set<Key, Comparator, Allocator, Augment>::freeze()
+    const {
+  return frozen_set<Key, Comparator>(begin(), end());
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::iterator
+set<Key, Comparator, Allocator, Augment>::find(const Key& key) {
+  return tree_type::tree_find(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+bool set<Key, Comparator, Allocator, Augment>::contains(const Key& key) const {
+  return tree_type::tree_contains(key);
+}
+
+// The heterogeneous overloads compare K against the stored keys directly
+// instead of building a Key for the lookup.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename K, typename>
+typename
+set<Key, Comparator, Allocator, Augment>::iterator
+set<Key, Comparator, Allocator, Augment>::find(const K& key) {
+  return tree_type::tree_find(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename K, typename>
+bool set<Key, Comparator, Allocator, Augment>::contains(const K& key) const {
+  return tree_type::tree_contains(key);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+std::vector<typename set<Key, Comparator, Allocator, Augment>::iterator>
+set<Key, Comparator, Allocator, Augment>::find_many(
+    const Key* keys, size_type count) {
+  return tree_type::template tree_find_many<iterator>(keys, count);
 }
 
-template <typename Key, typename Comparator>
-void set<Key, Comparator>::swap(set& other) {
-  AVLtree<Key, Key, Comparator>::tree_swap(other);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+std::vector<bool> set<Key, Comparator, Allocator, Augment>::contains_many(
+    const Key* keys, size_type count) const {
+  return tree_type::tree_contains_many(keys, count);
 }
 
-template <typename Key, typename Comparator>
-void set<Key, Comparator>::merge(set& other) {
-  AVLtree<Key, Key, Comparator>::tree_merge_unique(other);
+// nth() and rank() need the order_statistics augment.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::iterator
+set<Key, Comparator, Allocator, Augment>::nth(size_type index) {
+  return tree_type::tree_nth(index);
 }
 
-template <typename Key, typename Comparator>
-typename set<Key, Comparator>::iterator set<Key, Comparator>::find(
-    const Key& key) {
-  return AVLtree<Key, Key, Comparator>::tree_find(key);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename set<Key, Comparator, Allocator, Augment>::const_iterator
+set<Key, Comparator, Allocator, Augment>::nth(size_type index) const {
+  return tree_type::tree_nth(index);
 }
 
-template <typename Key, typename Comparator>
-bool set<Key, Comparator>::contains(const Key& key) const {
-  return AVLtree<Key, Key, Comparator>::tree_contains(key);
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::size_type
+set<Key, Comparator, Allocator, Augment>::rank(const Key& key) const {
+  return tree_type::tree_rank(key);
 }
 
-template <typename Key, typename Comparator>
-inline set<Key, Comparator>::set_iterator::set_iterator(
-    const typename AVLtree<Key, Key, Comparator>::iterator& other)
-    : AVLtree<Key, Key, Comparator>::iterator::iterator(other) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::iterator
+set<Key, Comparator, Allocator, Augment>::lower_bound(const Key& key) {
+  return tree_type::tree_lower_bound(key);
+}
 
-template <typename Key, typename Comparator>
-set<Key, Comparator>::set_iterator::set_iterator(
-    typename AVLtree<Key, Key, Comparator>::node* node)
-    : AVLtree<Key, Key, Comparator>::iterator::iterator(node) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename set<Key, Comparator, Allocator, Augment>::const_iterator
+set<Key, Comparator, Allocator, Augment>::lower_bound(const Key& key) const {
+  return tree_type::tree_lower_bound(key);
+}
 
-template <typename Key, typename Comparator>
-typename set<Key, Comparator>::reference
-set<Key, Comparator>::set_iterator::operator*() {
-  return AVLtree<Key, Key, Comparator>::iterator::current_node->data_.second;
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename
+set<Key, Comparator, Allocator, Augment>::iterator
+set<Key, Comparator, Allocator, Augment>::upper_bound(const Key& key) {
+  return tree_type::tree_upper_bound(key);
 }
 
-template <typename Key, typename Comparator>
-set<Key, Comparator>::const_set_iterator::const_set_iterator(
-    const typename AVLtree<Key, Key, Comparator>::const_iterator& other)
-    : AVLtree<Key, Key, Comparator>::const_iterator::const_iterator(other) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename set<Key, Comparator, Allocator, Augment>::const_iterator
+set<Key, Comparator, Allocator, Augment>::upper_bound(const Key& key) const {
+  return tree_type::tree_upper_bound(key);
+}
 
-template <typename Key, typename Comparator>
-set<Key, Comparator>::const_set_iterator::const_set_iterator(
-    typename AVLtree<Key, Key, Comparator>::node* node)
-    : AVLtree<Key, Key, Comparator>::const_iterator::const_iterator(node) {}
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+template <typename Function>
+void set<Key, Comparator, Allocator, Augment>::for_each_in_range(
+    const Key& lo, const Key& hi, Function fn) const {
+  tree_type::tree_for_each_in_range(lo, hi,
+                                    [&fn](const Key& key) { fn(key); });
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename set<Key, Comparator, Allocator, Augment>::size_type
+set<Key, Comparator, Allocator, Augment>::erase_range(
+    const Key& lo, const Key& hi) {
+  return tree_type::tree_erase_range(lo, hi);
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+inline set<Key, Comparator, Allocator, Augment>::set_iterator::set_iterator(
+    const typename tree_type::iterator& other)
+    : tree_type::iterator::iterator(other) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator, Augment>::set_iterator::set_iterator(
+    typename tree_type::node* node)
+    : tree_type::iterator::iterator(node) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename set<Key, Comparator, Allocator, Augment>::const_reference
+set<Key, Comparator, Allocator, Augment>::set_iterator::operator*() {
+  return tree_type::iterator::current_node->data_;
+}
 
-template <typename Key, typename Comparator>
-typename set<Key, Comparator>::const_reference
-set<Key, Comparator>::const_set_iterator::operator*() {
-  return AVLtree<Key, Key, Comparator>::const_iterator::current_node->data_
-      .second;
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename set<Key, Comparator, Allocator, Augment>::const_pointer
+set<Key, Comparator, Allocator, Augment>::set_iterator::operator->() {
+  return &tree_type::iterator::current_node->data_;
 }
 
-template <typename Key, typename Comparator>
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator,
+    Augment>::const_set_iterator::const_set_iterator(
+    const typename tree_type::const_iterator& other)
+    : tree_type::const_iterator::const_iterator(other) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator,
+    Augment>::const_set_iterator::const_set_iterator(
+    typename tree_type::node* node)
+    : tree_type::const_iterator::const_iterator(node) {}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+typename set<Key, Comparator, Allocator, Augment>::const_reference
+set<Key, Comparator, Allocator, Augment>::const_set_iterator::operator*() {
+  return tree_type::const_iterator::current_node->data_;
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
 template <class... Args>
-std::vector<std::pair<typename set<Key, Comparator>::iterator, bool>>
-set<Key, Comparator>::insert_many(Args&&... args) {
-  std::vector<std::pair<typename set<Key, Comparator>::iterator, bool>> result;
-  for (const auto& item : {args...}) {
-    result.push_back(insert(item));
-  }
+std::vector<std::pair<
+    typename set<Key, Comparator, Allocator, Augment>::iterator, bool>>
+set<Key, Comparator, Allocator, Augment>::insert_many(Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  result.reserve(sizeof...(args));
+  (result.push_back(insert(std::forward<Args>(args))), ...);
   return result;
 }
 
+// The set operations consume lhs, which becomes the result, so pass it with
+// std::move to avoid a copy. set_union also consumes rhs; intersection and
+// difference only read it.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator, Augment> set_union(
+    set<Key, Comparator, Allocator, Augment> lhs,
+    set<Key, Comparator, Allocator, Augment> rhs) {
+  lhs.tree_set_union(rhs);
+  return lhs;
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator, Augment> set_intersection(
+    set<Key, Comparator, Allocator, Augment> lhs,
+    const set<Key, Comparator, Allocator, Augment>& rhs) {
+  lhs.tree_set_intersection(rhs);
+  return lhs;
+}
+
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+set<Key, Comparator, Allocator, Augment> set_difference(
+    set<Key, Comparator, Allocator, Augment> lhs,
+    const set<Key, Comparator, Allocator, Augment>& rhs) {
+  lhs.tree_set_difference(rhs);
+  return lhs;
+}
+
 }  // namespace s21
 
 #endif
\ No newline at end of file
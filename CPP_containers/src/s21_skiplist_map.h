@@ -0,0 +1,573 @@
+#ifndef S21_SRC_SKIPLIST_MAP_H
+#define S21_SRC_SKIPLIST_MAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include "s21_epoch.h"
+
+namespace s21 {
+
+// Ordered map that many threads may insert into, erase from and read at
+// once without locks. It is the lock-free skip list of Fraser's thesis and
+// Herlihy and Shavit, "The Art of Multiprocessor Programming": every node
+// sits in a sorted list at level 0 and, with probability 1/2 per level, in
+// the sparser lists above it, so a search drops down the levels in
+// O(log n) expected steps. All links are CASed, and the low bit of a link
+// marks the node that owns it as deleted, which freezes the link. Erasing
+// a key marks its node from the top level down; marking level 0 is the
+// moment the key leaves the map. Any search that meets a marked node
+// unlinks it at that level on the way.
+//
+// The inserter may still be linking the upper levels of a node that has
+// already been erased, so whichever of the two finishes last runs one more
+// search to unlink it everywhere and retires it to the epoch domain. Every
+// operation and every iterator pins the epoch, so a node is never freed
+// while anything can still reach it.
+//
+// Values are immutable once inserted, which lets iterators hand out plain
+// references. Iteration is weakly consistent: it never returns an erased
+// element twice or out of order, and it may or may not see concurrent
+// changes. An iterator keeps its thread pinned and must be destroyed on
+// that thread; holding one for long delays reclamation for everybody.
+template <typename Key, typename Value, typename Comparator = std::less<Key>>
+class skiplist_map {
+  struct node;
+  using link = std::atomic<std::uintptr_t>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using size_type = size_t;
+
+  class const_iterator {
+   public:
+    friend skiplist_map;
+
+    const_iterator() = default;
+    const_iterator(const const_iterator& other);
+    const_iterator& operator=(const const_iterator& other);
+    ~const_iterator() = default;
+
+    const_reference operator*() const;
+    const value_type* operator->() const;
+    const_iterator& operator++();
+    const_iterator operator++(int);
+
+    bool operator==(const const_iterator& other) const;
+    bool operator!=(const const_iterator& other) const;
+
+   private:
+    // Pins the epoch for as long as it points at a node.
+    explicit const_iterator(node* position);
+
+    node* node_ = nullptr;
+    std::optional<epoch_domain::guard> pin_;
+  };
+  using iterator = const_iterator;
+
+  skiplist_map();
+  skiplist_map(std::initializer_list<value_type> const& items);
+  skiplist_map(const skiplist_map&) = delete;
+  skiplist_map& operator=(const skiplist_map&) = delete;
+  ~skiplist_map();
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(const Key& key, const Value& obj);
+  size_type erase(const Key& key);
+
+  const_iterator find(const Key& key) const;
+  bool contains(const Key& key) const;
+
+ private:
+  // Enough for far more elements than fit in memory at p = 1/2.
+  static constexpr int max_level = 32;
+  static constexpr std::uintptr_t marked = 1;
+
+  // The links follow the node in the same allocation, one per level.
+  struct node {
+    template <typename... Args>
+    explicit node(int node_height, Args&&... args);
+
+    link* links();
+
+    value_type data;
+    const int height;
+    // Counts the inserter and the eraser as they finish with the node.
+    std::atomic<int> releases{0};
+  };
+
+  static constexpr std::size_t links_offset =
+      (sizeof(node) + alignof(link) - 1) / alignof(link) * alignof(link);
+  static constexpr std::size_t node_alignment =
+      alignof(node) > alignof(link) ? alignof(node) : alignof(link);
+
+  template <typename... Args>
+  static node* create_node(int height, Args&&... args);
+  static void destroy_node(void* pointer);
+  static node* unpack(std::uintptr_t value);
+  static std::uintptr_t pack(node* node_ptr);
+  static bool is_marked(std::uintptr_t value);
+  static node* first_live(std::uintptr_t value);
+  static int random_height();
+
+  void raise_top_level(int height);
+  bool search(const Key& key, link** preds, node** succs);
+  bool try_search(const Key& key, link** preds, node** succs);
+  node* find_node(const Key& key) const;
+  template <typename... Args>
+  std::pair<iterator, bool> insert_node(const Key& key, Args&&... args);
+  void link_upper_levels(node* fresh, link** preds, node** succs);
+  void release(node* node_ptr);
+
+  link head_[max_level];
+  std::atomic<int> top_level_{1};
+  std::atomic<std::ptrdiff_t> size_{0};
+  Comparator tree_comparator;
+};
+
+template <typename Key, typename Value, typename Comparator>
+skiplist_map<Key, Value, Comparator>::const_iterator::const_iterator(
+    node* position)
+    : node_(position) {
+  if (node_ != nullptr) {
+    pin_.emplace();
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+skiplist_map<Key, Value, Comparator>::const_iterator::const_iterator(
+    const const_iterator& other)
+    : node_(other.node_) {
+  if (other.pin_) {
+    pin_.emplace();
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::const_iterator&
+skiplist_map<Key, Value, Comparator>::const_iterator::operator=(
+    const const_iterator& other) {
+  if (other.pin_ && !pin_) {
+    pin_.emplace();
+  }
+  node_ = other.node_;
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::const_reference
+skiplist_map<Key, Value, Comparator>::const_iterator::operator*() const {
+  return node_->data;
+}
+
+template <typename Key, typename Value, typename Comparator>
+const typename skiplist_map<Key, Value, Comparator>::value_type*
+skiplist_map<Key, Value, Comparator>::const_iterator::operator->() const {
+  return &node_->data;
+}
+
+// The frozen link of an erased node still leads back into the list, so
+// stepping from an element erased in the meantime is safe.
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::const_iterator&
+skiplist_map<Key, Value, Comparator>::const_iterator::operator++() {
+  node_ = first_live(node_->links()[0].load());
+  return *this;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::const_iterator
+skiplist_map<Key, Value, Comparator>::const_iterator::operator++(int) {
+  const_iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool skiplist_map<Key, Value, Comparator>::const_iterator::operator==(
+    const const_iterator& other) const {
+  return node_ == other.node_;
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool skiplist_map<Key, Value, Comparator>::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return node_ != other.node_;
+}
+
+template <typename Key, typename Value, typename Comparator>
+template <typename... Args>
+skiplist_map<Key, Value, Comparator>::node::node(int node_height,
+                                                 Args&&... args)
+    : data(std::forward<Args>(args)...), height(node_height) {}
+
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::link*
+skiplist_map<Key, Value, Comparator>::node::links() {
+  return reinterpret_cast<link*>(reinterpret_cast<char*>(this) +
+                                 links_offset);
+}
+
+template <typename Key, typename Value, typename Comparator>
+skiplist_map<Key, Value, Comparator>::skiplist_map() {
+  for (link& level : head_) {
+    level.store(0, std::memory_order_relaxed);
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+skiplist_map<Key, Value, Comparator>::skiplist_map(
+    std::initializer_list<value_type> const& items)
+    : skiplist_map() {
+  for (const value_type& item : items) {
+    insert(item);
+  }
+}
+
+// Destruction must not overlap with any other call. Every node still on
+// level 0 is live; erased ones have been retired to the epoch domain.
+template <typename Key, typename Value, typename Comparator>
+skiplist_map<Key, Value, Comparator>::~skiplist_map() {
+  node* current = unpack(head_[0].load());
+  while (current != nullptr) {
+    node* next = unpack(current->links()[0].load());
+    destroy_node(current);
+    current = next;
+  }
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::const_iterator
+skiplist_map<Key, Value, Comparator>::begin() const {
+  epoch_domain::guard pin;
+  return const_iterator(first_live(head_[0].load()));
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::const_iterator
+skiplist_map<Key, Value, Comparator>::end() const {
+  return const_iterator();
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool skiplist_map<Key, Value, Comparator>::empty() const {
+  return size() == 0;
+}
+
+// Counts are adjusted after the list changes, so an erase can be counted
+// before the insert it follows; size() never reports that as negative.
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::size_type
+skiplist_map<Key, Value, Comparator>::size() const {
+  std::ptrdiff_t count = size_.load(std::memory_order_relaxed);
+  return count > 0 ? static_cast<size_type>(count) : 0;
+}
+
+// An existing key keeps its value; the iterator points at whichever
+// element holds the key.
+template <typename Key, typename Value, typename Comparator>
+std::pair<typename skiplist_map<Key, Value, Comparator>::iterator, bool>
+skiplist_map<Key, Value, Comparator>::insert(const value_type& value) {
+  return insert_node(value.first, value);
+}
+
+template <typename Key, typename Value, typename Comparator>
+std::pair<typename skiplist_map<Key, Value, Comparator>::iterator, bool>
+skiplist_map<Key, Value, Comparator>::insert(const Key& key,
+                                             const Value& obj) {
+  return insert_node(key, key, obj);
+}
+
+// Marks the upper levels first, so once level 0 is marked no level of the
+// node can be linked anew, then races other erasers for level 0.
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::size_type
+skiplist_map<Key, Value, Comparator>::erase(const Key& key) {
+  epoch_domain::guard pin;
+  link* preds[max_level];
+  node* succs[max_level];
+  if (!search(key, preds, succs)) {
+    return 0;
+  }
+  node* victim = succs[0];
+  for (int level = victim->height - 1; level > 0; --level) {
+    victim->links()[level].fetch_or(marked);
+  }
+  std::uintptr_t next = victim->links()[0].load();
+  while (!is_marked(next)) {
+    if (victim->links()[0].compare_exchange_weak(next, next | marked)) {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      release(victim);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::const_iterator
+skiplist_map<Key, Value, Comparator>::find(const Key& key) const {
+  epoch_domain::guard pin;
+  return const_iterator(find_node(key));
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool skiplist_map<Key, Value, Comparator>::contains(const Key& key) const {
+  epoch_domain::guard pin;
+  return find_node(key) != nullptr;
+}
+
+template <typename Key, typename Value, typename Comparator>
+template <typename... Args>
+typename skiplist_map<Key, Value, Comparator>::node*
+skiplist_map<Key, Value, Comparator>::create_node(int height,
+                                                  Args&&... args) {
+  void* memory =
+      ::operator new(links_offset + height * sizeof(link),
+                     std::align_val_t(node_alignment));
+  node* created;
+  try {
+    created = new (memory) node(height, std::forward<Args>(args)...);
+  } catch (...) {
+    ::operator delete(memory, std::align_val_t(node_alignment));
+    throw;
+  }
+  for (int level = 0; level < height; ++level) {
+    new (created->links() + level) link(0);
+  }
+  return created;
+}
+
+// Takes void* so that it can be handed to the epoch domain as a deleter.
+template <typename Key, typename Value, typename Comparator>
+void skiplist_map<Key, Value, Comparator>::destroy_node(void* pointer) {
+  node* node_ptr = static_cast<node*>(pointer);
+  node_ptr->~node();
+  ::operator delete(pointer, std::align_val_t(node_alignment));
+}
+
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::node*
+skiplist_map<Key, Value, Comparator>::unpack(std::uintptr_t value) {
+  return reinterpret_cast<node*>(value & ~marked);
+}
+
+template <typename Key, typename Value, typename Comparator>
+std::uintptr_t skiplist_map<Key, Value, Comparator>::pack(node* node_ptr) {
+  return reinterpret_cast<std::uintptr_t>(node_ptr);
+}
+
+template <typename Key, typename Value, typename Comparator>
+bool skiplist_map<Key, Value, Comparator>::is_marked(std::uintptr_t value) {
+  return (value & marked) != 0;
+}
+
+// The first node from value on along level 0 that is not erased.
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::node*
+skiplist_map<Key, Value, Comparator>::first_live(std::uintptr_t value) {
+  node* current = unpack(value);
+  while (current != nullptr) {
+    std::uintptr_t next = current->links()[0].load();
+    if (!is_marked(next)) {
+      break;
+    }
+    current = unpack(next);
+  }
+  return current;
+}
+
+// Geometric with p = 1/2: the number of trailing zero bits of a xorshift
+// state, capped at max_level.
+template <typename Key, typename Value, typename Comparator>
+int skiplist_map<Key, Value, Comparator>::random_height() {
+  thread_local std::uint64_t state =
+      reinterpret_cast<std::uintptr_t>(&state) | 1;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return 1 + __builtin_ctzll(state | (1ULL << (max_level - 1)));
+}
+
+// Searches start at the highest level any node has reached, which only
+// grows.
+template <typename Key, typename Value, typename Comparator>
+void skiplist_map<Key, Value, Comparator>::raise_top_level(int height) {
+  int top = top_level_.load();
+  while (top < height && !top_level_.compare_exchange_weak(top, height)) {
+  }
+}
+
+// Fills preds[level] with the links of the last node before key and
+// succs[level] with the first live node not before it, for every level
+// below the top, and unlinks the erased nodes in between. Returns whether
+// succs[0] holds key.
+template <typename Key, typename Value, typename Comparator>
+bool skiplist_map<Key, Value, Comparator>::search(const Key& key,
+                                                  link** preds,
+                                                  node** succs) {
+  while (!try_search(key, preds, succs)) {
+  }
+  return succs[0] != nullptr &&
+         !tree_comparator(key, succs[0]->data.first);
+}
+
+// Gives up when unlinking an erased node fails, because its predecessor
+// was erased or changed in the meantime.
+template <typename Key, typename Value, typename Comparator>
+bool skiplist_map<Key, Value, Comparator>::try_search(const Key& key,
+                                                      link** preds,
+                                                      node** succs) {
+  link* pred = head_;
+  for (int level = top_level_.load() - 1; level >= 0; --level) {
+    node* current = unpack(pred[level].load());
+    while (current != nullptr) {
+      std::uintptr_t next = current->links()[level].load();
+      if (is_marked(next)) {
+        std::uintptr_t expected = pack(current);
+        if (!pred[level].compare_exchange_strong(expected, next & ~marked)) {
+          return false;
+        }
+        current = unpack(next);
+      } else if (tree_comparator(current->data.first, key)) {
+        pred = current->links();
+        current = unpack(next);
+      } else {
+        break;
+      }
+    }
+    preds[level] = pred;
+    succs[level] = current;
+  }
+  return true;
+}
+
+// Lookups only read: erased nodes are stepped over, not unlinked.
+template <typename Key, typename Value, typename Comparator>
+typename skiplist_map<Key, Value, Comparator>::node*
+skiplist_map<Key, Value, Comparator>::find_node(const Key& key) const {
+  const link* pred = head_;
+  node* current = nullptr;
+  for (int level = top_level_.load() - 1; level >= 0; --level) {
+    current = unpack(pred[level].load());
+    while (current != nullptr) {
+      std::uintptr_t next = current->links()[level].load();
+      if (!is_marked(next) && !tree_comparator(current->data.first, key)) {
+        break;
+      }
+      if (!is_marked(next)) {
+        pred = current->links();
+      }
+      current = unpack(next);
+    }
+  }
+  if (current == nullptr || tree_comparator(key, current->data.first) ||
+      is_marked(current->links()[0].load())) {
+    return nullptr;
+  }
+  return current;
+}
+
+// Linking level 0 inserts the key; the levels above only speed up later
+// searches and are added afterwards, one CAS each.
+template <typename Key, typename Value, typename Comparator>
+template <typename... Args>
+std::pair<typename skiplist_map<Key, Value, Comparator>::iterator, bool>
+skiplist_map<Key, Value, Comparator>::insert_node(const Key& key,
+                                                  Args&&... args) {
+  epoch_domain::guard pin;
+  int height = random_height();
+  raise_top_level(height);
+  link* preds[max_level];
+  node* succs[max_level];
+  node* fresh = nullptr;
+  while (true) {
+    if (search(key, preds, succs)) {
+      if (fresh != nullptr) {
+        destroy_node(fresh);
+      }
+      return {iterator(succs[0]), false};
+    }
+    if (fresh == nullptr) {
+      fresh = create_node(height, std::forward<Args>(args)...);
+    }
+    for (int level = 0; level < height; ++level) {
+      fresh->links()[level].store(pack(succs[level]),
+                                  std::memory_order_relaxed);
+    }
+    std::uintptr_t expected = pack(succs[0]);
+    if (preds[0][0].compare_exchange_strong(expected, pack(fresh))) {
+      break;
+    }
+  }
+  size_.fetch_add(1, std::memory_order_relaxed);
+  iterator position(fresh);
+  link_upper_levels(fresh, preds, succs);
+  release(fresh);
+  return {position, true};
+}
+
+// Stops early once the node is erased: a marked link can no longer be
+// pointed at a successor, and a fresh search no longer finds the node.
+template <typename Key, typename Value, typename Comparator>
+void skiplist_map<Key, Value, Comparator>::link_upper_levels(node* fresh,
+                                                             link** preds,
+                                                             node** succs) {
+  for (int level = 1; level < fresh->height; ++level) {
+    while (true) {
+      std::uintptr_t next = fresh->links()[level].load();
+      if (is_marked(next)) {
+        return;
+      }
+      if (unpack(next) != succs[level] &&
+          !fresh->links()[level].compare_exchange_strong(
+              next, pack(succs[level]))) {
+        continue;
+      }
+      std::uintptr_t expected = pack(succs[level]);
+      if (preds[level][level].compare_exchange_strong(expected,
+                                                      pack(fresh))) {
+        break;
+      }
+      search(fresh->data.first, preds, succs);
+      if (succs[0] != fresh) {
+        return;
+      }
+    }
+  }
+}
+
+// Called once by the inserter when it is done linking and once by the
+// eraser that marked level 0. The second caller unlinks the node from
+// every level it may still be on, which one search for its key does: an
+// erased node always precedes any live node with the same key, so the
+// search passes it on each level. Then nothing new can reach it.
+template <typename Key, typename Value, typename Comparator>
+void skiplist_map<Key, Value, Comparator>::release(node* node_ptr) {
+  if (node_ptr->releases.fetch_add(1) == 1) {
+    link* preds[max_level];
+    node* succs[max_level];
+    search(node_ptr->data.first, preds, succs);
+    epoch_domain::instance().retire(node_ptr, &destroy_node);
+  }
+}
+
+}  // namespace s21
+
+#endif
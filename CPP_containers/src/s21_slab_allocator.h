@@ -0,0 +1,204 @@
+#ifndef S21_SRC_SLAB_ALLOCATOR_H
+#define S21_SRC_SLAB_ALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace s21 {
+
+// Arena allocator for node-based containers. Single objects are carved out
+// of large contiguous slabs and freed objects are recycled through an
+// intrusive free list; release() hands every slab back at once.
+//
+// Copies share one arena, rebinding to another type starts a fresh one
+// because slots are sized for T. A container therefore owns the arena of
+// its rebound node allocator exclusively.
+template <typename T, std::size_t SlabBytes = 64 * 1024>
+class slab_allocator {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  template <typename U>
+  struct rebind {
+    using other = slab_allocator<U, SlabBytes>;
+  };
+
+  slab_allocator();
+  slab_allocator(const slab_allocator& other) noexcept = default;
+  template <typename U>
+  slab_allocator(const slab_allocator<U, SlabBytes>& other);
+  slab_allocator& operator=(const slab_allocator& other) noexcept = default;
+  ~slab_allocator() = default;
+
+  T* allocate(size_type n);
+  void deallocate(T* ptr, size_type n) noexcept;
+  void release() noexcept;
+  size_type slab_count() const noexcept;
+  slab_allocator select_on_container_copy_construction() const;
+
+  friend bool operator==(const slab_allocator& lhs,
+                         const slab_allocator& rhs) noexcept {
+    return lhs.arena_ == rhs.arena_;
+  }
+  friend bool operator!=(const slab_allocator& lhs,
+                         const slab_allocator& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+ private:
+  union slot {
+    slot* next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  struct slab {
+    slab* next;
+  };
+
+  class arena {
+   public:
+    arena() = default;
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+    ~arena();
+
+    slot* get();
+    void put(slot* ptr) noexcept;
+    void release() noexcept;
+    size_type slab_count() const noexcept;
+
+   private:
+    static constexpr std::size_t header_size =
+        (sizeof(slab) + alignof(slot) - 1) / alignof(slot) * alignof(slot);
+    static constexpr std::size_t slots_per_slab =
+        SlabBytes > header_size + sizeof(slot)
+            ? (SlabBytes - header_size) / sizeof(slot)
+            : 1;
+    static constexpr std::size_t slab_bytes =
+        header_size + slots_per_slab * sizeof(slot);
+
+    void add_slab();
+
+    slab* slabs_ = nullptr;
+    slot* free_list_ = nullptr;
+    slot* bump_ = nullptr;
+    slot* bump_end_ = nullptr;
+    size_type slab_count_ = 0;
+  };
+
+  std::shared_ptr<arena> arena_;
+};
+
+template <typename T, std::size_t SlabBytes>
+slab_allocator<T, SlabBytes>::slab_allocator()
+    : arena_(std::make_shared<arena>()) {}
+
+template <typename T, std::size_t SlabBytes>
+template <typename U>
+slab_allocator<T, SlabBytes>::slab_allocator(
+    const slab_allocator<U, SlabBytes>&)
+    : slab_allocator() {}
+
+template <typename T, std::size_t SlabBytes>
+T* slab_allocator<T, SlabBytes>::allocate(size_type n) {
+  if (n != 1) {
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+  return reinterpret_cast<T*>(arena_->get());
+}
+
+template <typename T, std::size_t SlabBytes>
+void slab_allocator<T, SlabBytes>::deallocate(T* ptr, size_type n) noexcept {
+  if (n != 1) {
+    ::operator delete(ptr);
+  } else {
+    arena_->put(reinterpret_cast<slot*>(ptr));
+  }
+}
+
+template <typename T, std::size_t SlabBytes>
+void slab_allocator<T, SlabBytes>::release() noexcept {
+  arena_->release();
+}
+
+template <typename T, std::size_t SlabBytes>
+typename slab_allocator<T, SlabBytes>::size_type
+slab_allocator<T, SlabBytes>::slab_count() const noexcept {
+  return arena_->slab_count();
+}
+
+template <typename T, std::size_t SlabBytes>
+slab_allocator<T, SlabBytes>
+slab_allocator<T, SlabBytes>::select_on_container_copy_construction() const {
+  return slab_allocator();
+}
+
+// arena logic //
+
+template <typename T, std::size_t SlabBytes>
+slab_allocator<T, SlabBytes>::arena::~arena() {
+  release();
+}
+
+template <typename T, std::size_t SlabBytes>
+typename slab_allocator<T, SlabBytes>::slot*
+slab_allocator<T, SlabBytes>::arena::get() {
+  if (free_list_ != nullptr) {
+    slot* result = free_list_;
+    free_list_ = free_list_->next;
+    return result;
+  }
+  if (bump_ == bump_end_) {
+    add_slab();
+  }
+  return bump_++;
+}
+
+template <typename T, std::size_t SlabBytes>
+void slab_allocator<T, SlabBytes>::arena::put(slot* ptr) noexcept {
+  ptr->next = free_list_;
+  free_list_ = ptr;
+}
+
+template <typename T, std::size_t SlabBytes>
+void slab_allocator<T, SlabBytes>::arena::release() noexcept {
+  while (slabs_ != nullptr) {
+    slab* next = slabs_->next;
+    ::operator delete(slabs_, std::align_val_t(alignof(slot)));
+    slabs_ = next;
+  }
+  free_list_ = nullptr;
+  bump_ = nullptr;
+  bump_end_ = nullptr;
+  slab_count_ = 0;
+}
+
+template <typename T, std::size_t SlabBytes>
+typename slab_allocator<T, SlabBytes>::size_type
+slab_allocator<T, SlabBytes>::arena::slab_count() const noexcept {
+  return slab_count_;
+}
+
+template <typename T, std::size_t SlabBytes>
+void slab_allocator<T, SlabBytes>::arena::add_slab() {
+  void* memory = ::operator new(slab_bytes, std::align_val_t(alignof(slot)));
+  slab* new_slab = static_cast<slab*>(memory);
+  new_slab->next = slabs_;
+  slabs_ = new_slab;
+  ++slab_count_;
+  bump_ = reinterpret_cast<slot*>(static_cast<unsigned char*>(memory) +
+                                  header_size);
+  bump_end_ = bump_ + slots_per_slab;
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,413 @@
+#ifndef S21_SRC_SNAPSHOT_H
+#define S21_SRC_SNAPSHOT_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "s21_map.h"
+#include "s21_set.h"
+
+namespace s21 {
+
+// Binary snapshots of map and set through save() and load(). They live in
+// their own header because they need mmap and fsync; the containers
+// themselves stay free of POSIX headers. A file is a 64-byte header
+// followed by count fixed-size records in key order. The header pins the
+// format version, the byte order and the shape of the records and carries
+// a checksum of them, so a file from another build, one for other types or
+// one cut short is rejected rather than loaded. Records are the raw bytes
+// of trivially copyable keys and values, which is why loading can map the
+// file and link the tree straight from it.
+struct snapshot_header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t record_size;
+  std::uint64_t count;
+  std::uint64_t checksum;
+  std::uint32_t key_size;
+  std::uint32_t value_size;
+  std::uint16_t key_align;
+  std::uint16_t value_align;
+  std::uint8_t is_map;
+  char reserved[11];
+};
+
+static_assert(sizeof(snapshot_header) == 64,
+              "records must start on a 64-byte boundary of the mapping");
+
+inline constexpr char snapshot_magic[8] = {'S', '2', '1', 'S',
+                                           'N', 'A', 'P', '\0'};
+inline constexpr std::uint32_t snapshot_version = 2;
+inline constexpr std::uint32_t snapshot_byte_order = 0x01020304;
+
+// MAP_POPULATE is Linux-only; elsewhere madvise() alone asks for read-ahead.
+#ifdef MAP_POPULATE
+inline constexpr int populate_flag = MAP_POPULATE;
+#else
+inline constexpr int populate_flag = 0;
+#endif
+
+// One map entry on disk; set snapshots store bare keys.
+template <typename Key, typename Value>
+struct snapshot_record {
+  Key key;
+  Value value;
+};
+
+// What a snapshot's records hold. The record size alone lets a map<int, int>
+// file load into a set<int64_t>, so the key and value layouts are checked
+// too. Set snapshots have no value and leave its size and alignment 0.
+struct snapshot_type {
+  std::uint64_t record_size;
+  std::uint32_t key_size;
+  std::uint32_t value_size;
+  std::uint16_t key_align;
+  std::uint16_t value_align;
+  std::uint8_t is_map;
+};
+
+template <typename Key>
+constexpr snapshot_type set_snapshot_type() {
+  return {sizeof(Key), sizeof(Key), 0, alignof(Key), 0, 0};
+}
+
+template <typename Key, typename Value>
+constexpr snapshot_type map_snapshot_type() {
+  return {sizeof(snapshot_record<Key, Value>), sizeof(Key), sizeof(Value),
+          alignof(Key), alignof(Value), 1};
+}
+
+// Zeroes the padding too, so equal maps produce identical files.
+template <typename Key, typename Value>
+snapshot_record<Key, Value> make_snapshot_record(const Key& key,
+                                                 const Value& value) {
+  snapshot_record<Key, Value> record;
+  std::memset(static_cast<void*>(&record), 0, sizeof(record));
+  record.key = key;
+  record.value = value;
+  return record;
+}
+
+// FNV-1a over 8-byte words instead of bytes, which keeps the checksum far
+// ahead of the disk. Splitting the input only gives the same result when
+// every piece but the last is a multiple of 8 bytes long.
+inline std::uint64_t snapshot_checksum(
+    const unsigned char* data, std::size_t size,
+    std::uint64_t hash = 14695981039346656037ULL) {
+  constexpr std::uint64_t prime = 1099511628211ULL;
+  for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t)) {
+    std::uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    hash = (hash ^ word) * prime;
+    data += sizeof(word);
+  }
+  for (; size > 0; --size) {
+    hash = (hash ^ *data++) * prime;
+  }
+  return hash;
+}
+
+// Streams records to path + ".tmp" and renames it over path in finish(),
+// so a crash mid-save leaves the previous snapshot in place.
+class snapshot_writer {
+ public:
+  snapshot_writer(const std::string& path, const snapshot_type& type);
+  snapshot_writer(const snapshot_writer&) = delete;
+  snapshot_writer& operator=(const snapshot_writer&) = delete;
+  ~snapshot_writer();
+
+  template <typename Record>
+  void append(const Record& record);
+  void finish();
+
+ private:
+  // A multiple of 8, so the checksum can run chunk by chunk.
+  static constexpr std::size_t buffer_size = std::size_t(1) << 20;
+
+  void flush();
+  [[noreturn]] void fail(const char* what);
+
+  std::string path_;
+  std::string temporary_;
+  std::FILE* file_ = nullptr;
+  snapshot_header header_{};
+  std::vector<unsigned char> buffer_;
+};
+
+// Maps a snapshot read-only and validates it against type; records() then
+// points at size() records of type.record_size bytes each until the reader
+// is destroyed.
+class snapshot_reader {
+ public:
+  snapshot_reader(const std::string& path, const snapshot_type& type);
+  snapshot_reader(const snapshot_reader&) = delete;
+  snapshot_reader& operator=(const snapshot_reader&) = delete;
+  ~snapshot_reader();
+
+  std::size_t size() const;
+  const void* records() const;
+
+ private:
+  [[noreturn]] void fail(const std::string& path, const char* what);
+
+  void* mapping_ = MAP_FAILED;
+  std::size_t length_ = 0;
+  snapshot_header header_{};
+};
+
+inline snapshot_writer::snapshot_writer(const std::string& path,
+                                        const snapshot_type& type)
+    : path_(path), temporary_(path + ".tmp") {
+  buffer_.reserve(buffer_size);
+  file_ = std::fopen(temporary_.c_str(), "wb");
+  if (file_ == nullptr) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Cannot create snapshot " + temporary_);
+  }
+  std::memcpy(header_.magic, snapshot_magic, sizeof(header_.magic));
+  header_.version = snapshot_version;
+  header_.byte_order = snapshot_byte_order;
+  header_.record_size = type.record_size;
+  header_.key_size = type.key_size;
+  header_.value_size = type.value_size;
+  header_.key_align = type.key_align;
+  header_.value_align = type.value_align;
+  header_.is_map = type.is_map;
+  header_.checksum = snapshot_checksum(nullptr, 0);
+  // The destructor does not run for a constructor that throws, so the
+  // temporary file is closed and removed here.
+  if (std::fwrite(&header_, sizeof(header_), 1, file_) != 1) {
+    int error = errno;
+    std::fclose(file_);
+    file_ = nullptr;
+    std::remove(temporary_.c_str());
+    throw std::system_error(error, std::generic_category(),
+                            "Cannot write snapshot " + temporary_);
+  }
+}
+
+// Abandons the temporary file unless finish() got to rename it.
+inline snapshot_writer::~snapshot_writer() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+    std::remove(temporary_.c_str());
+  }
+}
+
+template <typename Record>
+void snapshot_writer::append(const Record& record) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&record);
+  std::size_t left = sizeof(Record);
+  while (left > 0) {
+    std::size_t room = buffer_size - buffer_.size();
+    std::size_t taken = left < room ? left : room;
+    buffer_.insert(buffer_.end(), bytes, bytes + taken);
+    bytes += taken;
+    left -= taken;
+    if (buffer_.size() == buffer_size) {
+      flush();
+    }
+  }
+  ++header_.count;
+}
+
+inline void snapshot_writer::finish() {
+  flush();
+  if (std::fseek(file_, 0, SEEK_SET) != 0 ||
+      std::fwrite(&header_, sizeof(header_), 1, file_) != 1 ||
+      std::fflush(file_) != 0 || fsync(fileno(file_)) != 0) {
+    fail("Cannot write snapshot ");
+  }
+  int closed = std::fclose(file_);
+  file_ = nullptr;
+  if (closed != 0 || std::rename(temporary_.c_str(), path_.c_str()) != 0) {
+    int error = errno;
+    std::remove(temporary_.c_str());
+    throw std::system_error(error, std::generic_category(),
+                            "Cannot write snapshot " + path_);
+  }
+}
+
+inline void snapshot_writer::flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+  header_.checksum =
+      snapshot_checksum(buffer_.data(), buffer_.size(), header_.checksum);
+  if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) !=
+      buffer_.size()) {
+    fail("Cannot write snapshot ");
+  }
+  buffer_.clear();
+}
+
+inline void snapshot_writer::fail(const char* what) {
+  throw std::system_error(errno, std::generic_category(), what + temporary_);
+}
+
+inline snapshot_reader::snapshot_reader(const std::string& path,
+                                        const snapshot_type& type) {
+  int descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Cannot open snapshot " + path);
+  }
+  struct stat status;
+  if (fstat(descriptor, &status) != 0) {
+    int error = errno;
+    close(descriptor);
+    throw std::system_error(error, std::generic_category(),
+                            "Cannot open snapshot " + path);
+  }
+  length_ = static_cast<std::size_t>(status.st_size);
+  if (length_ >= sizeof(header_)) {
+    mapping_ = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE | populate_flag,
+                    descriptor, 0);
+  }
+  int error = errno;
+  close(descriptor);
+  if (length_ < sizeof(header_)) {
+    fail(path, "is too short");
+  }
+  if (mapping_ == MAP_FAILED) {
+    throw std::system_error(error, std::generic_category(),
+                            "Cannot map snapshot " + path);
+  }
+  madvise(mapping_, length_, MADV_SEQUENTIAL);
+
+  std::memcpy(&header_, mapping_, sizeof(header_));
+  if (std::memcmp(header_.magic, snapshot_magic, sizeof(snapshot_magic)) !=
+      0) {
+    fail(path, "is not a snapshot");
+  }
+  if (header_.version != snapshot_version ||
+      header_.byte_order != snapshot_byte_order) {
+    fail(path, "was written by an incompatible build");
+  }
+  if (header_.record_size != type.record_size ||
+      header_.key_size != type.key_size ||
+      header_.value_size != type.value_size ||
+      header_.key_align != type.key_align ||
+      header_.value_align != type.value_align ||
+      header_.is_map != type.is_map) {
+    fail(path, "holds records of another type");
+  }
+  std::size_t record_size = type.record_size;
+  std::size_t payload = length_ - sizeof(header_);
+  if (header_.count > payload / record_size ||
+      header_.count * record_size != payload) {
+    fail(path, "is truncated");
+  }
+  const unsigned char* records =
+      static_cast<const unsigned char*>(mapping_) + sizeof(header_);
+  if (snapshot_checksum(records, payload) != header_.checksum) {
+    fail(path, "is corrupt");
+  }
+}
+
+inline snapshot_reader::~snapshot_reader() {
+  if (mapping_ != MAP_FAILED) {
+    munmap(mapping_, length_);
+  }
+}
+
+inline std::size_t snapshot_reader::size() const {
+  return static_cast<std::size_t>(header_.count);
+}
+
+inline const void* snapshot_reader::records() const {
+  return static_cast<const unsigned char*>(mapping_) + sizeof(header_);
+}
+
+// The destructor does not run for a constructor that throws, so the
+// mapping is released here.
+inline void snapshot_reader::fail(const std::string& path, const char* what) {
+  if (mapping_ != MAP_FAILED) {
+    munmap(mapping_, length_);
+    mapping_ = MAP_FAILED;
+  }
+  throw std::runtime_error("Snapshot " + path + " " + what);
+}
+
+// Writes the contents in key order to a binary snapshot. The file is
+// replaced only once it is complete.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void save(const map<Key, Value, Comparator, Allocator, Augment>& m,
+          const std::string& path) {
+  static_assert(std::is_trivially_copyable_v<Key> &&
+                    std::is_trivially_copyable_v<Value>,
+                "snapshots store keys and values as raw bytes");
+  snapshot_writer writer(path, map_snapshot_type<Key, Value>());
+  for (auto it = m.begin(); it != m.end(); ++it) {
+    writer.append(make_snapshot_record(it->first, it->second));
+  }
+  writer.finish();
+}
+
+// Replaces the contents with a snapshot written by save(). The file is
+// mapped and checked, and because its records are already sorted the tree
+// is linked from them in O(n) without a single comparison-driven insert.
+// A missing, foreign or damaged file throws and leaves the map unchanged.
+template <typename Key, typename Value, typename Comparator,
+          typename Allocator, typename Augment>
+void load(map<Key, Value, Comparator, Allocator, Augment>& m,
+          const std::string& path) {
+  static_assert(std::is_trivially_copyable_v<Key> &&
+                    std::is_trivially_copyable_v<Value>,
+                "snapshots store keys and values as raw bytes");
+  using record = snapshot_record<Key, Value>;
+  snapshot_reader reader(path, map_snapshot_type<Key, Value>());
+  const record* first = static_cast<const record*>(reader.records());
+  m.tree_assign(first, first + reader.size(), true,
+                [](auto& emplace, const record& item) {
+                  return emplace(item.key, item.value);
+                });
+}
+
+// Writes the keys in order to a binary snapshot. The file is replaced only
+// once it is complete.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void save(const set<Key, Comparator, Allocator, Augment>& s,
+          const std::string& path) {
+  static_assert(std::is_trivially_copyable_v<Key>,
+                "snapshots store keys as raw bytes");
+  snapshot_writer writer(path, set_snapshot_type<Key>());
+  for (auto it = s.begin(); it != s.end(); ++it) {
+    writer.append(*it);
+  }
+  writer.finish();
+}
+
+// Replaces the contents with a snapshot written by save(), linking the tree
+// from the mapped, already sorted keys in O(n). A missing, foreign or
+// damaged file throws and leaves the set unchanged.
+template <typename Key, typename Comparator, typename Allocator,
+          typename Augment>
+void load(set<Key, Comparator, Allocator, Augment>& s,
+          const std::string& path) {
+  static_assert(std::is_trivially_copyable_v<Key>,
+                "snapshots store keys as raw bytes");
+  snapshot_reader reader(path, set_snapshot_type<Key>());
+  const Key* first = static_cast<const Key*>(reader.records());
+  s.tree_assign(first, first + reader.size(), true,
+                [](auto& emplace, const Key& item) { return emplace(item); });
+}
+
+}  // namespace s21
+
+#endif
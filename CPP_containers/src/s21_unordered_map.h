@@ -0,0 +1,541 @@
+#ifndef S21_SRC_UNORDERED_MAP_H
+#define S21_SRC_UNORDERED_MAP_H
+
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "HashTable.h"
+
+namespace s21 {
+
+// Hash map with open addressing over a Swiss table: average O(1) lookups
+// that touch one group of control bytes and, on a hit, one slot. Unlike
+// std::unordered_map, every insert that grows the table invalidates all
+// iterators and references, and erase leaves a tombstone that is only
+// reclaimed by the next rehash.
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, Value>>>
+class unordered_map
+    : private HashTable<Key, Value, Hash, KeyEqual, Allocator> {
+  using table_type = HashTable<Key, Value, Hash, KeyEqual, Allocator>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename table_type::iterator;
+  using const_iterator = typename table_type::const_iterator;
+  using size_type = size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+
+  unordered_map();
+  unordered_map(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  unordered_map(InputIt first, InputIt last);
+  unordered_map(const unordered_map& m);
+  unordered_map(unordered_map&& m) noexcept;
+  ~unordered_map() = default;
+  unordered_map& operator=(const unordered_map& m);
+  unordered_map& operator=(unordered_map&& m) noexcept;
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
+
+  Value& at(const Key& key);
+  const Value& at(const Key& key) const;
+  template <typename K,
+            typename = transparent_hash_key_t<Hash, KeyEqual, K>>
+  Value& at(const K& key);
+  Value& operator[](const Key& key);
+  Value& operator[](Key&& key);
+
+  iterator begin();
+  const_iterator begin() const;
+  iterator end();
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  allocator_type get_allocator() const;
+
+  size_type bucket_count() const;
+  float load_factor() const;
+  float max_load_factor() const;
+  void reserve(size_type count);
+  void rehash(size_type count);
+
+  void clear();
+  std::pair<iterator, bool> insert(const Key& key, const Value& obj);
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(value_type&& value);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  void insert(InputIt first, InputIt last);
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args);
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args);
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const Value& obj);
+  iterator erase(iterator pos);
+  iterator erase(iterator first, iterator last);
+  size_type erase(const Key& key);
+  void swap(unordered_map& other) noexcept;
+  void merge(unordered_map& other);
+
+  iterator find(const Key& key);
+  const_iterator find(const Key& key) const;
+  template <typename K,
+            typename = transparent_hash_key_t<Hash, KeyEqual, K>>
+  iterator find(const K& key);
+  template <typename K,
+            typename = transparent_hash_key_t<Hash, KeyEqual, K>>
+  const_iterator find(const K& key) const;
+  bool contains(const Key& key) const;
+  template <typename K,
+            typename = transparent_hash_key_t<Hash, KeyEqual, K>>
+  bool contains(const K& key) const;
+  size_type count(const Key& key) const;
+  template <typename K,
+            typename = transparent_hash_key_t<Hash, KeyEqual, K>>
+  size_type count(const K& key) const;
+
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+};
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::unordered_map()
+    : table_type() {}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::unordered_map(
+    std::initializer_list<value_type> const& items)
+    : unordered_map() {
+  assign(items.begin(), items.end());
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename InputIt, typename>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::unordered_map(
+    InputIt first, InputIt last)
+    : unordered_map() {
+  assign(first, last);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::unordered_map(
+    const unordered_map& m)
+    : table_type(m) {}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::unordered_map(
+    unordered_map&& m) noexcept
+    : table_type(std::move(m)) {}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>&
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::operator=(
+    const unordered_map& m) {
+  table_type::operator=(m);
+  return *this;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>&
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::operator=(
+    unordered_map&& m) noexcept {
+  table_type::operator=(std::move(m));
+  return *this;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename InputIt>
+void unordered_map<Key, Value, Hash, KeyEqual, Allocator>::assign(
+    InputIt first, InputIt last) {
+  clear();
+  insert(first, last);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+Value& unordered_map<Key, Value, Hash, KeyEqual, Allocator>::at(
+    const Key& key) {
+  iterator result = find(key);
+  if (result == end()) {
+    throw std::out_of_range("There is no element with this key");
+  }
+  return result->second;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+const Value& unordered_map<Key, Value, Hash, KeyEqual, Allocator>::at(
+    const Key& key) const {
+  const_iterator result = find(key);
+  if (result == end()) {
+    throw std::out_of_range("There is no element with this key");
+  }
+  return result->second;
+}
+
+// Heterogeneous lookups hash and compare K directly, so a std::string_view
+// probe into a map keyed by std::string allocates nothing.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K, typename>
+Value& unordered_map<Key, Value, Hash, KeyEqual, Allocator>::at(
+    const K& key) {
+  iterator result = find(key);
+  if (result == end()) {
+    throw std::out_of_range("There is no element with this key");
+  }
+  return result->second;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+Value& unordered_map<Key, Value, Hash, KeyEqual, Allocator>::operator[](
+    const Key& key) {
+  return try_emplace(key).first->second;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+Value& unordered_map<Key, Value, Hash, KeyEqual, Allocator>::operator[](
+    Key&& key) {
+  return try_emplace(std::move(key)).first->second;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::begin() {
+  return table_type::table_begin();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::const_iterator
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::begin() const {
+  return table_type::table_begin();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::end() {
+  return table_type::table_end();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::const_iterator
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::end() const {
+  return table_type::table_end();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+bool unordered_map<Key, Value, Hash, KeyEqual, Allocator>::empty() const {
+  return table_type::table_empty();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::size_type
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::size() const {
+  return table_type::table_size();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::size_type
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::max_size() const {
+  return table_type::table_max_size();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::allocator_type
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::get_allocator() const {
+  return table_type::table_get_allocator();
+}
+
+// Each slot is its own bucket.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::size_type
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::bucket_count() const {
+  return table_type::table_capacity();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+float unordered_map<Key, Value, Hash, KeyEqual, Allocator>::load_factor()
+    const {
+  return bucket_count() == 0 ? 0.0f
+                             : static_cast<float>(size()) / bucket_count();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+float unordered_map<Key, Value, Hash, KeyEqual, Allocator>::max_load_factor()
+    const {
+  return table_type::table_max_load_factor();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void unordered_map<Key, Value, Hash, KeyEqual, Allocator>::reserve(
+    size_type count) {
+  table_type::table_reserve(count);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void unordered_map<Key, Value, Hash, KeyEqual, Allocator>::rehash(
+    size_type count) {
+  table_type::table_rehash(count);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void unordered_map<Key, Value, Hash, KeyEqual, Allocator>::clear() {
+  table_type::table_clear();
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+std::pair<
+    typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+    bool>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::insert(
+    const Key& key, const Value& obj) {
+  return table_type::table_try_emplace(key, obj);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+std::pair<
+    typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+    bool>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::insert(
+    const value_type& value) {
+  return table_type::table_insert(value);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+std::pair<
+    typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+    bool>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::insert(
+    value_type&& value) {
+  return table_type::table_insert(std::move(value));
+}
+
+// Sized ranges grow the table once up front.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename InputIt, typename>
+void unordered_map<Key, Value, Hash, KeyEqual, Allocator>::insert(
+    InputIt first, InputIt last) {
+  using category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+    reserve(size() + static_cast<size_type>(std::distance(first, last)));
+  }
+  for (; first != last; ++first) {
+    table_type::table_try_emplace(first->first, first->second);
+  }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <class... Args>
+std::pair<
+    typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+    bool>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::emplace(
+    Args&&... args) {
+  return table_type::table_emplace(std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <class... Args>
+std::pair<
+    typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+    bool>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::try_emplace(
+    const Key& key, Args&&... args) {
+  return table_type::table_try_emplace(key, std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <class... Args>
+std::pair<
+    typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+    bool>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::try_emplace(
+    Key&& key, Args&&... args) {
+  return table_type::table_try_emplace(std::move(key),
+                                       std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+std::pair<
+    typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+    bool>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::insert_or_assign(
+    const Key& key, const Value& obj) {
+  auto result = table_type::table_try_emplace(key, obj);
+  if (!result.second) {
+    result.first->second = obj;
+  }
+  return result;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::erase(iterator pos) {
+  table_type::table_erase(pos);
+  return ++pos;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::erase(iterator first,
+                                                            iterator last) {
+  while (first != last) {
+    first = erase(first);
+  }
+  return last;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::size_type
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::erase(const Key& key) {
+  return table_type::table_erase_key(key);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void unordered_map<Key, Value, Hash, KeyEqual, Allocator>::swap(
+    unordered_map& other) noexcept {
+  table_type::table_swap(other);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+void unordered_map<Key, Value, Hash, KeyEqual, Allocator>::merge(
+    unordered_map& other) {
+  table_type::table_merge(other);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::find(const Key& key) {
+  return table_type::table_find(key);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::const_iterator
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::find(
+    const Key& key) const {
+  return table_type::table_find(key);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K, typename>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::find(const K& key) {
+  return table_type::table_find(key);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K, typename>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::const_iterator
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::find(
+    const K& key) const {
+  return table_type::table_find(key);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+bool unordered_map<Key, Value, Hash, KeyEqual, Allocator>::contains(
+    const Key& key) const {
+  return table_type::table_contains(key);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K, typename>
+bool unordered_map<Key, Value, Hash, KeyEqual, Allocator>::contains(
+    const K& key) const {
+  return table_type::table_contains(key);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::size_type
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::count(
+    const Key& key) const {
+  return table_type::table_contains(key);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename K, typename>
+typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::size_type
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::count(
+    const K& key) const {
+  return table_type::table_contains(key);
+}
+
+// Reserving for every value up front means no insert rehashes, so the
+// iterators returned along the way all stay valid.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <class... Args>
+std::vector<std::pair<
+    typename unordered_map<Key, Value, Hash, KeyEqual, Allocator>::iterator,
+    bool>>
+unordered_map<Key, Value, Hash, KeyEqual, Allocator>::insert_many(
+    Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  result.reserve(sizeof...(args));
+  reserve(size() + sizeof...(args));
+  (result.push_back(emplace(std::forward<Args>(args))), ...);
+  return result;
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,337 @@
+#ifndef S21_SRC_UNORDERED_SET_H
+#define S21_SRC_UNORDERED_SET_H
+
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "HashTable.h"
+
+namespace s21 {
+
+// Hash set on the same Swiss table as unordered_map, with slots that hold
+// the bare key. The same iterator invalidation rules apply.
+template <typename Key, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<Key>>
+class unordered_set : private HashTable<Key, void, Hash, KeyEqual, Allocator> {
+  using table_type = HashTable<Key, void, Hash, KeyEqual, Allocator>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename table_type::const_iterator;
+  using const_iterator = typename table_type::const_iterator;
+  using size_type = size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+
+  unordered_set();
+  unordered_set(std::initializer_list<value_type> const& items);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  unordered_set(InputIt first, InputIt last);
+  unordered_set(const unordered_set& s);
+  unordered_set(unordered_set&& s) noexcept;
+  ~unordered_set() = default;
+  unordered_set& operator=(const unordered_set& s);
+  unordered_set& operator=(unordered_set&& s) noexcept;
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last);
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  allocator_type get_allocator() const;
+
+  size_type bucket_count() const;
+  float load_factor() const;
+  float max_load_factor() const;
+  void reserve(size_type count);
+  void rehash(size_type count);
+
+  void clear();
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(value_type&& value);
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  void insert(InputIt first, InputIt last);
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  iterator erase(iterator pos);
+  iterator erase(iterator first, iterator last);
+  size_type erase(const Key& key);
+  void swap(unordered_set& other) noexcept;
+  void merge(unordered_set& other);
+
+  iterator find(const Key& key) const;
+  template <typename K,
+            typename = transparent_hash_key_t<Hash, KeyEqual, K>>
+  iterator find(const K& key) const;
+  bool contains(const Key& key) const;
+  template <typename K,
+            typename = transparent_hash_key_t<Hash, KeyEqual, K>>
+  bool contains(const K& key) const;
+  size_type count(const Key& key) const;
+  template <typename K,
+            typename = transparent_hash_key_t<Hash, KeyEqual, K>>
+  size_type count(const K& key) const;
+
+  template <class... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+};
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+unordered_set<Key, Hash, KeyEqual, Allocator>::unordered_set()
+    : table_type() {}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+unordered_set<Key, Hash, KeyEqual, Allocator>::unordered_set(
+    std::initializer_list<value_type> const& items)
+    : unordered_set() {
+  assign(items.begin(), items.end());
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template <typename InputIt, typename>
+unordered_set<Key, Hash, KeyEqual, Allocator>::unordered_set(InputIt first,
+                                                             InputIt last)
+    : unordered_set() {
+  assign(first, last);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+unordered_set<Key, Hash, KeyEqual, Allocator>::unordered_set(
+    const unordered_set& s)
+    : table_type(s) {}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+unordered_set<Key, Hash, KeyEqual, Allocator>::unordered_set(
+    unordered_set&& s) noexcept
+    : table_type(std::move(s)) {}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+unordered_set<Key, Hash, KeyEqual, Allocator>&
+unordered_set<Key, Hash, KeyEqual, Allocator>::operator=(
+    const unordered_set& s) {
+  table_type::operator=(s);
+  return *this;
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+unordered_set<Key, Hash, KeyEqual, Allocator>&
+unordered_set<Key, Hash, KeyEqual, Allocator>::operator=(
+    unordered_set&& s) noexcept {
+  table_type::operator=(std::move(s));
+  return *this;
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template <typename InputIt>
+void unordered_set<Key, Hash, KeyEqual, Allocator>::assign(InputIt first,
+                                                           InputIt last) {
+  clear();
+  insert(first, last);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+unordered_set<Key, Hash, KeyEqual, Allocator>::begin() const {
+  return table_type::table_begin();
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+unordered_set<Key, Hash, KeyEqual, Allocator>::end() const {
+  return table_type::table_end();
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+bool unordered_set<Key, Hash, KeyEqual, Allocator>::empty() const {
+  return table_type::table_empty();
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::size_type
+unordered_set<Key, Hash, KeyEqual, Allocator>::size() const {
+  return table_type::table_size();
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::size_type
+unordered_set<Key, Hash, KeyEqual, Allocator>::max_size() const {
+  return table_type::table_max_size();
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::allocator_type
+unordered_set<Key, Hash, KeyEqual, Allocator>::get_allocator() const {
+  return table_type::table_get_allocator();
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::size_type
+unordered_set<Key, Hash, KeyEqual, Allocator>::bucket_count() const {
+  return table_type::table_capacity();
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+float unordered_set<Key, Hash, KeyEqual, Allocator>::load_factor() const {
+  return bucket_count() == 0 ? 0.0f
+                             : static_cast<float>(size()) / bucket_count();
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+float unordered_set<Key, Hash, KeyEqual, Allocator>::max_load_factor() const {
+  return table_type::table_max_load_factor();
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void unordered_set<Key, Hash, KeyEqual, Allocator>::reserve(size_type count) {
+  table_type::table_reserve(count);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void unordered_set<Key, Hash, KeyEqual, Allocator>::rehash(size_type count) {
+  table_type::table_rehash(count);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void unordered_set<Key, Hash, KeyEqual, Allocator>::clear() {
+  table_type::table_clear();
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+std::pair<typename unordered_set<Key, Hash, KeyEqual, Allocator>::iterator,
+          bool>
+unordered_set<Key, Hash, KeyEqual, Allocator>::insert(
+    const value_type& value) {
+  return table_type::table_insert(value);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+std::pair<typename unordered_set<Key, Hash, KeyEqual, Allocator>::iterator,
+          bool>
+unordered_set<Key, Hash, KeyEqual, Allocator>::insert(value_type&& value) {
+  return table_type::table_insert(std::move(value));
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template <typename InputIt, typename>
+void unordered_set<Key, Hash, KeyEqual, Allocator>::insert(InputIt first,
+                                                           InputIt last) {
+  using category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+    reserve(size() + static_cast<size_type>(std::distance(first, last)));
+  }
+  for (; first != last; ++first) {
+    table_type::table_insert(*first);
+  }
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template <class... Args>
+std::pair<typename unordered_set<Key, Hash, KeyEqual, Allocator>::iterator,
+          bool>
+unordered_set<Key, Hash, KeyEqual, Allocator>::emplace(Args&&... args) {
+  return table_type::table_emplace(std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::iterator
+unordered_set<Key, Hash, KeyEqual, Allocator>::erase(iterator pos) {
+  table_type::table_erase(pos);
+  return ++pos;
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::iterator
+unordered_set<Key, Hash, KeyEqual, Allocator>::erase(iterator first,
+                                                     iterator last) {
+  while (first != last) {
+    first = erase(first);
+  }
+  return last;
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::size_type
+unordered_set<Key, Hash, KeyEqual, Allocator>::erase(const Key& key) {
+  return table_type::table_erase_key(key);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void unordered_set<Key, Hash, KeyEqual, Allocator>::swap(
+    unordered_set& other) noexcept {
+  table_type::table_swap(other);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void unordered_set<Key, Hash, KeyEqual, Allocator>::merge(
+    unordered_set& other) {
+  table_type::table_merge(other);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::iterator
+unordered_set<Key, Hash, KeyEqual, Allocator>::find(const Key& key) const {
+  return table_type::table_find(key);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template <typename K, typename>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::iterator
+unordered_set<Key, Hash, KeyEqual, Allocator>::find(const K& key) const {
+  return table_type::table_find(key);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+bool unordered_set<Key, Hash, KeyEqual, Allocator>::contains(
+    const Key& key) const {
+  return table_type::table_contains(key);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template <typename K, typename>
+bool unordered_set<Key, Hash, KeyEqual, Allocator>::contains(
+    const K& key) const {
+  return table_type::table_contains(key);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::size_type
+unordered_set<Key, Hash, KeyEqual, Allocator>::count(const Key& key) const {
+  return table_type::table_contains(key);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template <typename K, typename>
+typename unordered_set<Key, Hash, KeyEqual, Allocator>::size_type
+unordered_set<Key, Hash, KeyEqual, Allocator>::count(const K& key) const {
+  return table_type::table_contains(key);
+}
+
+// Reserving for every value up front means no insert rehashes, so the
+// iterators returned along the way all stay valid.
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template <class... Args>
+std::vector<
+    std::pair<typename unordered_set<Key, Hash, KeyEqual, Allocator>::iterator,
+              bool>>
+unordered_set<Key, Hash, KeyEqual, Allocator>::insert_many(Args&&... args) {
+  std::vector<std::pair<iterator, bool>> result;
+  result.reserve(sizeof...(args));
+  reserve(size() + sizeof...(args));
+  (result.push_back(insert(std::forward<Args>(args))), ...);
+  return result;
+}
+
+}  // namespace s21
+
+#endif